@@ -0,0 +1,29 @@
+#include <asap/core/DeviceId.h>
+
+#ifdef ARDUINO
+#include <Arduino.h>  // HAL_GetUIDw0..2
+#endif
+
+namespace asap::core
+{
+
+uint16_t deviceId()
+{
+#if defined(ASAP_DEVICE_ID)
+  const uint32_t folded = ASAP_DEVICE_ID;
+#elif defined(ARDUINO)
+  const uint32_t uid = HAL_GetUIDw0() ^ HAL_GetUIDw1() ^ HAL_GetUIDw2();
+  const uint32_t folded = (uid >> 16) ^ (uid & 0xFFFF);
+#else
+  const uint32_t folded = 1;
+#endif
+  const uint16_t id = static_cast<uint16_t>(folded);
+  return (id == 0 || id == 0xFFFF) ? static_cast<uint16_t>(id ^ 0x5A5A) : id;
+}
+
+}  // namespace asap::core
+//
+// DeviceId.cpp
+// The UID words hold wafer position and lot number; XOR-folding keeps the
+// bits that differ between boards of one batch.
+//
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <stdint.h>
+
+namespace asap::core
+{
+
+// 16-bit radio identity of this device: -D ASAP_DEVICE_ID=<n> when given,
+// otherwise folded from the STM32 96-bit unique ID (1 on native). Never
+// 0 or 0xFFFF (broadcast).
+uint16_t deviceId();
+
+}  // namespace asap::core
+//
+// DeviceId.h
+// Emitters stamp this into every packet and derive their transmit phase from
+// it, so boards flashed from one image still spread out on air.
+//
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <asap/core/Scheduler.h>
+
+namespace asap::core
+{
+
+// Role entry point, implemented once per firmware image (main_detector.cpp,
+// main_beacon.cpp, ...). Called from setup() in main_common.cpp to bring up
+// the role's peripherals and register its tasks; loop() then only runs the
+// scheduler.
+void setupRole(Scheduler& scheduler);
+
+}  // namespace asap::core
+//
+// DeviceRole.h
+// Contract between the shared main_common.cpp and the per-role sources. A
+// role must not define setup()/loop() itself.
+//
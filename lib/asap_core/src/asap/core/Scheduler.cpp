@@ -0,0 +1,281 @@
+#include <asap/core/Scheduler.h>
+
+#ifdef ARDUINO
+#include <Arduino.h>  // millis(), __WFI(), __disable_irq()
+#endif
+
+namespace asap::core
+{
+
+static_assert(Scheduler::kMaxTasks > 0 && Scheduler::kMaxTasks <= 32,
+              "ASAP_CORE_MAX_TASKS must fit the 32-bit signal mask");
+
+namespace
+{
+inline uint32_t taskBit(uint8_t id)
+{
+  return static_cast<uint32_t>(1U) << id;
+}
+
+// PRIMASK only: a pending interrupt still wakes the core from WFI/STOP.
+inline void maskInterrupts()
+{
+#ifdef ARDUINO
+  __disable_irq();
+#endif
+}
+
+inline void unmaskInterrupts()
+{
+#ifdef ARDUINO
+  __enable_irq();
+#endif
+}
+}  // namespace
+
+#ifdef ARDUINO
+
+namespace
+{
+uint32_t hardwareNow(void*)
+{
+  return millis();
+}
+
+void hardwareSleep(void*, uint32_t deadlineMs)
+{
+  // One WFI per call: whatever interrupt ends it (SysTick, joystick sampler,
+  // radio, DMA) sends the scheduler back to check for due work. STOP mode
+  // also halts SysTick and needs an RTC wakeup; images that want it install
+  // asap::power::stopModeClock() through Scheduler::setClock().
+  if (before(millis(), deadlineMs))
+  {
+    __WFI();
+  }
+}
+}  // namespace
+
+SchedulerClock hardwareClock()
+{
+  return SchedulerClock{&hardwareNow, &hardwareSleep, nullptr};
+}
+
+#endif  // ARDUINO
+
+Scheduler::Scheduler(const SchedulerClock& clock)
+    : clock_(clock),
+      tasks_{},
+      signaled_(0),
+      runs_(0),
+      sleeps_(0),
+      overruns_(0),
+      maxLateness_(0)
+{
+}
+
+TaskId Scheduler::addPeriodic(uint32_t periodMs, TaskFn fn, void* context, uint32_t firstDelayMs)
+{
+  return add(firstDelayMs, periodMs ? periodMs : 1, fn, context);
+}
+
+TaskId Scheduler::addOneShot(uint32_t delayMs, TaskFn fn, void* context)
+{
+  return add(delayMs, 0, fn, context);
+}
+
+TaskId Scheduler::add(uint32_t delayMs, uint32_t periodMs, TaskFn fn, void* context)
+{
+  if (!fn)
+  {
+    return kInvalidTask;
+  }
+  for (uint8_t i = 0; i < kMaxTasks; ++i)
+  {
+    if (!tasks_[i].used)
+    {
+      tasks_[i] = Task{fn, context, nowMs() + delayMs, periodMs, true, true};
+      return i;
+    }
+  }
+  return kInvalidTask;
+}
+
+void Scheduler::setDeadline(TaskId id, uint32_t deadlineMs)
+{
+  if (id < kMaxTasks && tasks_[id].used)
+  {
+    tasks_[id].deadlineMs = deadlineMs;
+    tasks_[id].armed = true;
+  }
+}
+
+void Scheduler::cancel(TaskId id)
+{
+  if (id < kMaxTasks)
+  {
+    tasks_[id].used = false;
+    tasks_[id].armed = false;
+    __atomic_fetch_and(&signaled_, ~taskBit(id), __ATOMIC_SEQ_CST);
+  }
+}
+
+void Scheduler::signal(TaskId id)
+{
+  if (id < kMaxTasks)
+  {
+    __atomic_fetch_or(&signaled_, taskBit(id), __ATOMIC_SEQ_CST);
+  }
+}
+
+bool Scheduler::nextDeadline(uint32_t& deadlineMs) const
+{
+  bool found = false;
+  for (const Task& t : tasks_)
+  {
+    if (t.used && t.armed && (!found || before(t.deadlineMs, deadlineMs)))
+    {
+      deadlineMs = t.deadlineMs;
+      found = true;
+    }
+  }
+  return found;
+}
+
+// Earliest deadline among due tasks; a signalled task counts as due now.
+TaskId Scheduler::pickDue(uint32_t nowMs, uint32_t signals) const
+{
+  TaskId best = kInvalidTask;
+  uint32_t bestDeadline = 0;
+  for (uint8_t i = 0; i < kMaxTasks; ++i)
+  {
+    const Task& t = tasks_[i];
+    if (!t.used)
+    {
+      continue;
+    }
+    const bool signalled = (signals & taskBit(i)) != 0;
+    const bool expired = t.armed && !before(nowMs, t.deadlineMs);
+    if (!signalled && !expired)
+    {
+      continue;
+    }
+    const uint32_t deadline = expired ? t.deadlineMs : nowMs;
+    if (best == kInvalidTask || before(deadline, bestDeadline))
+    {
+      best = i;
+      bestDeadline = deadline;
+    }
+  }
+  return best;
+}
+
+uint8_t Scheduler::runDue()
+{
+  uint8_t ran = 0;
+  uint32_t signals = __atomic_exchange_n(&signaled_, 0U, __ATOMIC_SEQ_CST);
+  // Bounded pass: a task that keeps re-arming itself in the past cannot
+  // starve the sleep path (or the other tasks, which are picked by deadline).
+  while (ran < kMaxTasks)
+  {
+    const uint32_t now = nowMs();
+    const TaskId id = pickDue(now, signals);
+    if (id == kInvalidTask)
+    {
+      break;
+    }
+    signals &= ~taskBit(id);
+    Task& t = tasks_[id];
+    const bool expired = t.armed && !before(now, t.deadlineMs);
+    if (expired && now - t.deadlineMs > maxLateness_)
+    {
+      maxLateness_ = now - t.deadlineMs;
+    }
+
+    // Next run before the call, so the task may still override it. A run
+    // triggered only by a signal leaves the deadline where it was.
+    if (expired && t.periodMs != 0)
+    {
+      uint32_t next = t.deadlineMs + t.periodMs;
+      if (!before(now, next))
+      {
+        // Fell a full period behind: skip the missed runs instead of
+        // bursting through them.
+        next = now + t.periodMs;
+        ++overruns_;
+      }
+      t.deadlineMs = next;
+    }
+    else if (expired)
+    {
+      t.armed = false;
+    }
+    ++runs_;
+    ++ran;
+    t.fn(t.context, now);
+  }
+  // Signals not consumed this pass (table full of due work) stay pending.
+  if (signals != 0)
+  {
+    __atomic_fetch_or(&signaled_, signals, __ATOMIC_SEQ_CST);
+  }
+  return ran;
+}
+
+void Scheduler::runOnce()
+{
+  runDue();
+  // Masked from the pending check to the sleep: a signal raised in between
+  // leaves its interrupt pending, which ends WFI/STOP at once, and its
+  // handler runs when the mask is lifted after the wake.
+  maskInterrupts();
+  if (signaled_ != 0)
+  {
+    unmaskInterrupts();
+    return;  // an interrupt handed over work while we were running
+  }
+  uint32_t deadline = 0;
+  const uint32_t now = nowMs();
+  if (!nextDeadline(deadline))
+  {
+    deadline = now + 1000;  // nothing armed: wait for an interrupt
+  }
+  if (before(now, deadline))
+  {
+    ++sleeps_;
+    clock_.sleepUntil(clock_.context, deadline);
+  }
+  unmaskInterrupts();
+}
+
+#ifndef ARDUINO
+
+SchedulerClock VirtualClock::clock()
+{
+  return SchedulerClock{&VirtualClock::now, &VirtualClock::sleepUntil, this};
+}
+
+uint32_t VirtualClock::now(void* context)
+{
+  return static_cast<VirtualClock*>(context)->nowMs_;
+}
+
+void VirtualClock::sleepUntil(void* context, uint32_t deadlineMs)
+{
+  VirtualClock& self = *static_cast<VirtualClock*>(context);
+  if (before(self.nowMs_, deadlineMs))
+  {
+    self.sleptMs_ += deadlineMs - self.nowMs_;
+    self.nowMs_ = deadlineMs;
+  }
+}
+
+#endif  // ARDUINO
+
+}  // namespace asap::core
+//
+// Scheduler.cpp
+// The signal mask is the only state shared with interrupts; it is updated
+// with atomic read-modify-write builtins (LDREX/STREX on the Cortex-M3).
+// runOnce() masks interrupts only across the pending check and the sleep
+// entry, so a signal cannot slip in between and wait for the next tick.
+//
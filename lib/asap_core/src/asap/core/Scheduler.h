@@ -0,0 +1,143 @@
+#pragma once
+
+#include <stdint.h>
+
+// Task table size; every role registers a handful of tasks at setup().
+#ifndef ASAP_CORE_MAX_TASKS
+#define ASAP_CORE_MAX_TASKS 8
+#endif
+
+namespace asap::core
+{
+
+using TaskId = uint8_t;
+constexpr TaskId kInvalidTask = 0xFF;
+
+// a is before b on the millis() clock (wrap-safe signed difference, as for
+// every deadline here).
+constexpr bool before(uint32_t a, uint32_t b)
+{
+  return static_cast<int32_t>(a - b) < 0;
+}
+
+// Time source and sleep primitive of a Scheduler. sleepUntil() is called
+// with interrupts masked (PRIMASK) and may return early: any pending
+// interrupt ends the wait, and its handler runs once the scheduler unmasks.
+// The scheduler re-checks its table after every wake.
+struct SchedulerClock
+{
+  uint32_t (*now)(void* context);
+  void (*sleepUntil)(void* context, uint32_t deadlineMs);
+  void* context;
+};
+
+#ifdef ARDUINO
+// millis() and WFI: the core sleeps until the next interrupt, SysTick at
+// the latest, so a deadline is never missed by more than one tick.
+SchedulerClock hardwareClock();
+#endif
+
+// Fixed-capacity cooperative scheduler. Tasks run to completion on the main
+// loop, earliest deadline first; between them the clock's sleep primitive
+// idles the core until the next deadline. Interrupt handlers hand work over
+// with signal(), which makes a task due immediately.
+class Scheduler
+{
+ public:
+  static constexpr uint8_t kMaxTasks = ASAP_CORE_MAX_TASKS;
+
+  // Task body; `nowMs` is the dispatch time.
+  using TaskFn = void (*)(void* context, uint32_t nowMs);
+
+  explicit Scheduler(const SchedulerClock& clock);
+
+  // Swap the time source, e.g. for a deeper sleep than hardwareClock()'s
+  // (asap::power::stopModeClock()). Both must count the same millis().
+  void setClock(const SchedulerClock& clock) { clock_ = clock; }
+
+  // Run every periodMs, first after firstDelayMs. Returns kInvalidTask when
+  // the table is full.
+  TaskId addPeriodic(uint32_t periodMs, TaskFn fn, void* context, uint32_t firstDelayMs = 0);
+  // Run once after delayMs (re-arm from the task with setDeadline()).
+  TaskId addOneShot(uint32_t delayMs, TaskFn fn, void* context);
+
+  // Move the next run of a task (periodic tasks continue from there). Also
+  // re-arms a one-shot task that has already run.
+  void setDeadline(TaskId id, uint32_t deadlineMs);
+  void cancel(TaskId id);
+
+  // ISR-safe: run `id` at the next dispatch regardless of its deadline.
+  void signal(TaskId id);
+
+  // Dispatch every due task (signalled or deadline reached), earliest
+  // deadline first. Returns the number of tasks run.
+  uint8_t runDue();
+  // runDue(), then sleep until the next deadline unless work is pending.
+  // This is the whole main loop body.
+  void runOnce();
+
+  // Earliest deadline of an armed task; false when nothing is armed.
+  bool nextDeadline(uint32_t& deadlineMs) const;
+
+  uint32_t nowMs() const { return clock_.now(clock_.context); }
+  uint32_t runCount() const { return runs_; }
+  uint32_t sleepCount() const { return sleeps_; }
+  uint32_t overrunCount() const { return overruns_; }  // periodic runs skipped
+  uint32_t maxLatenessMs() const { return maxLateness_; }
+
+ private:
+  struct Task
+  {
+    TaskFn fn;
+    void* context;
+    uint32_t deadlineMs;
+    uint32_t periodMs;  // 0 = one-shot
+    bool used;
+    bool armed;
+  };
+
+  TaskId add(uint32_t delayMs, uint32_t periodMs, TaskFn fn, void* context);
+  TaskId pickDue(uint32_t nowMs, uint32_t signals) const;
+
+  SchedulerClock clock_;
+  Task tasks_[kMaxTasks];
+  volatile uint32_t signaled_;  // one bit per task, set from interrupts
+  uint32_t runs_;
+  uint32_t sleeps_;
+  uint32_t overruns_;
+  uint32_t maxLateness_;
+};
+
+#ifndef ARDUINO
+
+// Host clock for tests: time only moves when the scheduler sleeps (jumping
+// straight to the deadline) or the test advances it, so hours of firmware
+// time run in milliseconds.
+class VirtualClock
+{
+ public:
+  explicit VirtualClock(uint32_t startMs = 0) : nowMs_(startMs) {}
+
+  SchedulerClock clock();
+
+  uint32_t nowMs() const { return nowMs_; }
+  void advance(uint32_t ms) { nowMs_ += ms; }
+  uint64_t sleptMs() const { return sleptMs_; }
+
+ private:
+  static uint32_t now(void* context);
+  static void sleepUntil(void* context, uint32_t deadlineMs);
+
+  uint32_t nowMs_;
+  uint64_t sleptMs_ = 0;
+};
+
+#endif  // ARDUINO
+
+}  // namespace asap::core
+//
+// Scheduler.h
+// Tickless main loop shared by all device roles (see src/main_common.cpp).
+// Deadlines are absolute millis() values compared with wrap-safe signed
+// differences, so uptime rollover after ~49 days is harmless.
+//
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <stdint.h>
+
+namespace asap::core
+{
+
+// xorshift32 (Marsaglia): tiny, seedable, and the same sequence on every
+// build, so anything drawn from it is a function of its seed.
+class Xorshift32
+{
+ public:
+  explicit Xorshift32(uint32_t seed) : state_(seed ? seed : 0x9E3779B9u) {}
+
+  uint32_t next()
+  {
+    state_ ^= state_ << 13;
+    state_ ^= state_ >> 17;
+    state_ ^= state_ << 5;
+    return state_;
+  }
+  // Uniform enough for n far below 2^32: 0..n-1 (0 for n == 0).
+  uint32_t below(uint32_t n) { return n ? next() % n : 0; }
+  // lo..hi inclusive
+  uint32_t range(uint32_t lo, uint32_t hi) { return hi > lo ? lo + below(hi - lo + 1u) : lo; }
+
+  uint32_t state() const { return state_; }
+
+ private:
+  uint32_t state_;
+};
+
+}  // namespace asap::core
+//
+// Xorshift32.h
+// The one PRNG of the firmware: emitter phases and jitter, TDMA join
+// offsets, beacon schedules and anomaly emission patterns all draw from it,
+// seeded from the device ID or the world seed.
+//
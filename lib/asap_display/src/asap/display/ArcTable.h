@@ -0,0 +1,151 @@
+#pragma once
+
+#include <stdint.h>
+
+namespace asap::display
+{
+
+// One-quadrant sine table (0..90° inclusive) with 65 samples (~1.40625°/step),
+// fixed-point scaled by 1024. Full circle reconstructed by mirroring across
+// quadrants. Shared by the runtime arc rasterizer and the constexpr tables.
+constexpr int32_t kArcScale = 1024;
+constexpr uint16_t kArcStepsPerQuadrant = 64;
+constexpr uint16_t kArcFullSteps = kArcStepsPerQuadrant * 4U;  // 256 steps per turn
+constexpr int16_t kArcSinLut[kArcStepsPerQuadrant + 1] = {
+    0,   25,   50,   75,  100,  125,  150,  175,  200,  224,
+  249,  273,  297,  321,  345,  369,  392,  415,  438,  460,
+  483,  505,  526,  548,  569,  590,  610,  630,  650,  669,
+  688,  706,  724,  742,  759,  775,  792,  807,  822,  837,
+  851,  865,  878,  891,  903,  915,  926,  936,  946,  955,
+  964,  972,  980,  987,  993,  999, 1004, 1009, 1013, 1016,
+ 1019, 1021, 1023, 1024, 1024
+};
+
+// Unit vector (scaled by kArcScale) for arc step s, starting at north and
+// sweeping clockwise (Y grows downward).
+constexpr void arcUnitVector(uint16_t s, int32_t& ux, int32_t& uy)
+{
+  const uint16_t q = static_cast<uint16_t>(s / kArcStepsPerQuadrant);  // 0..4
+  const uint16_t w = static_cast<uint16_t>(s % kArcStepsPerQuadrant);  // 0..63
+  const int32_t sinW = kArcSinLut[w];
+  const int32_t cosW = kArcSinLut[kArcStepsPerQuadrant - w];
+  switch (q & 3U)
+  {
+    case 0:  ux =  sinW; uy = -cosW; break;  // 0..90°: right, up
+    case 1:  ux =  cosW; uy =  sinW; break;  // 90..180°: right, down
+    case 2:  ux = -sinW; uy =  cosW; break;  // 180..270°: left, down
+    default: ux = -cosW; uy = -sinW; break;  // 270..360°: left, up
+  }
+}
+
+// Pixel offset of a rasterized ring sample for radius r along a unit vector.
+constexpr int16_t arcOffset(int32_t unit, int16_t r)
+{
+  return static_cast<int16_t>((unit * r + (kArcScale / 2)) / kArcScale);
+}
+
+// Percent (clamped to 100) to the last arc step drawn, 0..kArcFullSteps.
+constexpr uint16_t arcStepsForPercent(uint8_t percent)
+{
+  const uint8_t pc = (percent > 100) ? 100 : percent;
+  return static_cast<uint16_t>((static_cast<uint32_t>(pc) * kArcFullSteps) / 100U);
+}
+
+struct ArcPixel
+{
+  int8_t dx;
+  int8_t dy;
+};
+
+// Rasterization of a full ring, precomputed at compile time. Pixels are the
+// unique offsets produced by the runtime rasterizer, ordered by the first
+// step that draws them, so "draw steps 0..s" is the prefix pixels[0, end[s]).
+template <uint8_t Radius, uint8_t Thickness>
+struct ArcSpanTable
+{
+  static constexpr int16_t kHalf = static_cast<int16_t>(Thickness) / 2;
+  static constexpr int16_t kRMin = static_cast<int16_t>(Radius) - kHalf;
+  static constexpr int16_t kRMax =
+      static_cast<int16_t>(Radius) + (static_cast<int16_t>(Thickness) - 1 - kHalf);
+  static constexpr int16_t kExtent = kRMax + 1;           // |offset| <= kRMax + 1
+  static constexpr int16_t kGrid = kExtent * 2 + 1;
+
+  // Walk every (step, r) sample in draw order; `emit` sees each unique pixel
+  // once, together with the step that first draws it.
+  template <typename Emit>
+  static constexpr void walk(Emit&& emit)
+  {
+    bool seen[kGrid * kGrid] = {};
+    for (uint16_t s = 0; s <= kArcFullSteps; ++s)
+    {
+      int32_t ux = 0;
+      int32_t uy = 0;
+      arcUnitVector(s, ux, uy);
+      for (int16_t r = kRMin; r <= kRMax; ++r)
+      {
+        const int16_t dx = arcOffset(ux, r);
+        const int16_t dy = arcOffset(uy, r);
+        bool& cell = seen[(dy + kExtent) * kGrid + (dx + kExtent)];
+        if (!cell)
+        {
+          cell = true;
+          emit(s, dx, dy);
+        }
+      }
+    }
+  }
+
+  static constexpr uint16_t countPixels()
+  {
+    uint16_t count = 0;
+    walk([&count](uint16_t, int16_t, int16_t) { ++count; });
+    return count;
+  }
+
+  static constexpr uint16_t kCount = countPixels();
+
+  ArcPixel pixels[kCount];
+  uint16_t end[kArcFullSteps + 1];  // pixels drawn by steps 0..s
+
+  static constexpr ArcSpanTable build()
+  {
+    ArcSpanTable t{};
+    uint16_t n = 0;
+    uint16_t step = 0;
+    walk([&](uint16_t s, int16_t dx, int16_t dy) {
+      while (step < s)
+      {
+        t.end[step++] = n;
+      }
+      t.pixels[n++] = ArcPixel{static_cast<int8_t>(dx), static_cast<int8_t>(dy)};
+    });
+    while (step <= kArcFullSteps)
+    {
+      t.end[step++] = n;
+    }
+    return t;
+  }
+};
+
+// The anomaly HUD ring: radius 21 px, thickness 3 px.
+using HudArcTable = ArcSpanTable<21, 3>;
+inline constexpr HudArcTable kHudArc = HudArcTable::build();
+
+static_assert(HudArcTable::kExtent <= 127, "arc offsets must fit in int8_t");
+static_assert(kHudArc.end[kArcFullSteps] == HudArcTable::kCount,
+              "full ring must cover every precomputed pixel");
+
+}  // namespace asap::display
+//
+// ArcTable.h
+// Compile-time rasterization of the anomaly HUD ring. The runtime rasterizer
+// (DrawArcU8g2 in DisplayRenderer.cpp) computes up to 257 steps x thickness
+// fixed-point samples per ring, with duplicates; the table stores each unique
+// pixel once, in first-drawn order, so drawing N percent is a single pass over
+// a prefix of the table with no multiplies or divides.
+//
+// Notes for maintainers
+// - arcUnitVector()/arcOffset() are the single source of truth for ring
+//   geometry; the table and the runtime rasterizer both use them, which keeps
+//   the two pixel-identical.
+// - Add another ArcSpanTable instantiation if the HUD grows a second ring size.
@@ -1,5 +1,7 @@
 #include "asap/display/DetectorDisplay.h"
 #include "asap/display/DisplayRenderer.h"
+#include "asap/display/SpiDmaLink.h"
+#include "asap/profile/Profiler.h"
 
 #include <stddef.h>  // size_t for helper routines
 
@@ -221,7 +223,7 @@ DisplayFrame makeMenuRootFrame(uint8_t selectedIndex)
 }
 
 // Tracking menu page: adjust ID with LEFT/RIGHT, Click to confirm.
-DisplayFrame makeMenuTrackingFrame(uint8_t trackingId)
+DisplayFrame makeMenuTrackingFrame(uint16_t trackingId)
 {
   DisplayFrame frame{};
   frame.lineCount = 0;
@@ -236,13 +238,11 @@ DisplayFrame makeMenuTrackingFrame(uint8_t trackingId)
 
   DisplayLine& idLine = frame.lines[frame.lineCount++];
   copyText(idLine.text, DisplayLine::kMaxLineLength, "ID ");
-  // format 3-digit id
-  char idBuf[4];
-  idBuf[0] = static_cast<char>('0' + (trackingId / 100U) % 10U);
-  idBuf[1] = static_cast<char>('0' + (trackingId / 10U) % 10U);
-  idBuf[2] = static_cast<char>('0' + (trackingId % 10U));
-  idBuf[3] = '\0';
-  appendText(idLine.text, DisplayLine::kMaxLineLength, idBuf);
+  // zero-padded to 3 digits; 16-bit IDs take up to 5
+  if (trackingId < 100U) {
+    appendText(idLine.text, DisplayLine::kMaxLineLength, trackingId < 10U ? "00" : "0");
+  }
+  appendNumber(idLine.text, DisplayLine::kMaxLineLength, trackingId);
   idLine.font = FontStyle::Body;
   idLine.y = 38;
 
@@ -294,7 +294,7 @@ DisplayFrame makeAnomalyMainFrame(uint8_t percent, bool showMenuTag)
 }
 
 // Tracking main page: show ID and averaged RSSI; no bar for now.
-DisplayFrame makeTrackingMainFrame(uint8_t trackingId,
+DisplayFrame makeTrackingMainFrame(uint16_t trackingId,
                                    int16_t rssiAvgDbm,
                                    bool showMenuTag)
 {
@@ -359,6 +359,11 @@ bool DetectorDisplay::begin()
   u8g2_.setDrawColor(1);
   u8g2_.setFontDirection(0);
   u8g2_.clearBuffer();
+#if ASAP_DISPLAY_DIRTY_TILES
+  tiles_.invalidate();  // panel contents unknown until the first full push
+#endif
+  cache_.invalidate();
+  hud_.valid = false;
 
   // Apply runtime rotation preference if set
   if (rotation180_)
@@ -366,10 +371,56 @@ bool DetectorDisplay::begin()
     u8g2_.setDisplayRotation(U8G2_R2);
   }
 
+#if ASAP_DISPLAY_ASYNC_FLUSH
+  // The init sequence above went out blocking (it contains reset delays).
+  // From here on U8g2 only fills the queue and SPI1 DMA drains it.
+  if (SpiDmaLink::begin(queue_,
+                        static_cast<uint8_t>(pins_.chipSelect),
+                        static_cast<uint8_t>(pins_.dataCommand))) {
+    u8x8_t* u8x8 = u8g2_.getU8x8();
+    u8x8_SetUserPtr(u8x8, &queue_);
+    u8x8->byte_cb = u8x8ByteFlushQueue;
+  }
+#endif
+
   initialized_ = true;
   return true;
 }
 
+void DetectorDisplay::flushAsync()
+{
+  if (!initialized_) {
+    return;
+  }
+#if !ASAP_DISPLAY_PAGE_TILES
+  flush();  // page mode already sent every page from nextPage()
+#endif
+#if ASAP_DISPLAY_ASYNC_FLUSH
+  if (!SpiDmaLink::busy() && !queue_.empty()) {
+    SpiDmaLink::kick(nullptr);  // retry after a failed DMA start
+  }
+#endif
+}
+
+bool DetectorDisplay::flushPending() const
+{
+#if ASAP_DISPLAY_ASYNC_FLUSH && ASAP_DISPLAY_DIRTY_TILES
+  // Bytes queued on an idle bus mean a DMA start failed: flushAsync() kicks.
+  return flushPending_ || (!SpiDmaLink::busy() && !queue_.empty());
+#else
+  return false;
+#endif
+}
+
+bool DetectorDisplay::isFlushing() const
+{
+#if ASAP_DISPLAY_ASYNC_FLUSH
+  return SpiDmaLink::busy() || !queue_.empty();
+#else
+  return false;
+#endif
+}
+
 void DetectorDisplay::drawBootScreen(const char* versionText)
 {
   if (!initialized_ && !begin()) {
@@ -425,8 +476,71 @@ void DetectorDisplay::renderCustom(const DisplayFrame& frame, FrameKind kind)
 void DetectorDisplay::renderFrame(const DisplayFrame& frame)
 {
   lastFrame_ = frame;
+  if (!cache_.shouldRender(fingerprintFrame(frame, lastKind_))) {
+    lastDirtyTiles_ = 0;  // nothing redrawn, nothing sent
+    lastSentTiles_ = 0;
+    return;
+  }
+  hud_.valid = false;  // buffer no longer holds the anomaly HUD
+#if ASAP_DISPLAY_PAGE_TILES
+  renderFramePagedU8g2(u8g2_, frame);  // nextPage() sends each page
+  lastDirtyTiles_ = static_cast<uint16_t>(kTileCols) * kTileRows;
+  lastSentTiles_ = lastDirtyTiles_;
+#else
   renderFrameU8g2(u8g2_, frame);
-  u8g2_.sendBuffer();
+  flush();
+#endif
+}
+
+// Transmit the composed buffer. With dirty tiles enabled only the changed tile
+// spans are clocked out; otherwise the whole frame goes through sendBuffer().
+void DetectorDisplay::flush()
+{
+  flush(TileRect{0, 0, kTileCols - 1, kTileRows - 1});
+}
+
+// Flush limited to a tile region known to contain every change (incremental
+// HUD updates). Without dirty tiles the region itself is sent: the bounds of
+// what was drawn stand in for the checksum compare.
+void DetectorDisplay::flush(const TileRect& region)
+{
+  ASAP_PROFILE_SCOPE(asap::profile::kProbeSendBuffer);
+#if ASAP_DISPLAY_DIRTY_TILES
+  TileSpan spans[kTileRows];
+#if ASAP_DISPLAY_ASYNC_FLUSH
+  // Queue only what fits without waiting on DMA; tiles left over stay dirty
+  // and go out from the next flushAsync(). Until then the whole panel is
+  // scanned, since they may lie outside `region`.
+  const TileRect all{0, 0, kTileCols - 1, kTileRows - 1};
+  const uint8_t count = tiles_.scan(u8g2_.getBufferPtr(), spans, flushPending_ ? all : region);
+  if (count > 0) {
+    queue_.beginFrame(++frameSeq_);
+  }
+  uint8_t spansSent = 0;
+  lastSentTiles_ = sendSpansThatFit(u8g2_, tiles_, u8g2_.getBufferPtr(), spans, count,
+                                    queue_, spansSent, flushPending_);
+#else
+  const uint8_t count = tiles_.collect(u8g2_.getBufferPtr(), spans, region);
+  for (uint8_t i = 0; i < count; ++i) {
+    u8g2_.updateDisplayArea(spans[i].firstCol, spans[i].row, spans[i].width, 1);
+  }
+  lastSentTiles_ = tiles_.lastSentTiles();
+#endif
+  lastDirtyTiles_ = tiles_.lastDirtyTiles();
+#else
+#if ASAP_DISPLAY_ASYNC_FLUSH
+  queue_.beginFrame(++frameSeq_);
+#endif
+  const uint8_t width = static_cast<uint8_t>(region.col1 - region.col0 + 1);
+  const uint8_t height = static_cast<uint8_t>(region.row1 - region.row0 + 1);
+  if (width == kTileCols && height == kTileRows) {
+    u8g2_.sendBuffer();
+  } else {
+    u8g2_.updateDisplayArea(region.col0, region.row0, width, height);
+  }
+  lastDirtyTiles_ = static_cast<uint16_t>(width) * height;
+  lastSentTiles_ = lastDirtyTiles_;
+#endif
 }
 
 void DetectorDisplay::drawSpinner(uint8_t activeIndex,
@@ -480,6 +594,8 @@ void DetectorDisplay::setRotation180(bool enabled)
   {
     return;
   }
+  cache_.invalidate();  // same frame, different pixels
+  hud_.valid = false;
   // U8g2 supports runtime rotation changes; switch immediately
   if (rotation180_)
   {
@@ -547,9 +663,40 @@ void DetectorDisplay::drawAnomalyIndicators(uint8_t radPercent, uint8_t thermPer
     return;
   }
   lastKind_ = FrameKind::MainAnomaly;
+  if (!cache_.shouldRender(fingerprintAnomaly(radPercent, thermPercent, chemPercent, psyPercent,
+                                              radStage, thermStage, chemStage, psyStage)))
+  {
+    lastDirtyTiles_ = 0;
+    lastSentTiles_ = 0;
+    return;
+  }
+#if ASAP_DISPLAY_PAGE_TILES
+  drawAnomalyIndicatorsPagedU8g2(u8g2_, radPercent, thermPercent, chemPercent, psyPercent,
+                                 radStage, thermStage, chemStage, psyStage);
+  lastDirtyTiles_ = static_cast<uint16_t>(kTileCols) * kTileRows;
+  lastSentTiles_ = lastDirtyTiles_;
+  lastHudRect_ = DirtyRect{0, 0, static_cast<int16_t>(kDisplayWidth - 1),
+                           static_cast<int16_t>(kDisplayHeight - 1)};
+  lastHudFull_ = true;
+#elif ASAP_DISPLAY_INCREMENTAL_HUD
+  lastHudFull_ = updateAnomalyIndicatorsU8g2(u8g2_, hud_,
+                                             radPercent, thermPercent, chemPercent, psyPercent,
+                                             radStage, thermStage, chemStage, psyStage,
+                                             &lastHudRect_);
+  TileRect region{};
+  if (lastHudFull_ || !tileRectFor(lastHudRect_, rotation180_, region)) {
+    flush();
+  } else {
+    flush(region);
+  }
+#else
   drawAnomalyIndicatorsU8g2(u8g2_, radPercent, thermPercent, chemPercent, psyPercent,
                             radStage, thermStage, chemStage, psyStage);
-  u8g2_.sendBuffer();
+  lastHudRect_ = DirtyRect{0, 0, static_cast<int16_t>(kDisplayWidth - 1),
+                           static_cast<int16_t>(kDisplayHeight - 1)};
+  lastHudFull_ = true;
+  flush();
+#endif
 }
 
 void DetectorDisplay::drawProgressBar(const DisplayFrame& frame)
@@ -1,7 +1,11 @@
 #pragma once
 
 #include <stdint.h>
+#include <asap/display/DisplayConfig.h>
 #include <asap/display/DisplayTypes.h>
+#include <asap/display/DirtyTiles.h>
+#include <asap/display/FrameCache.h>
+#include <asap/display/FlushQueue.h>
 
 #ifdef ARDUINO
 #include <stdlib.h>
@@ -10,6 +14,15 @@
 
 namespace asap::display {
 
+// SSD1322 driver class selected by ASAP_DISPLAY_PAGE_TILES (DisplayConfig.h).
+#if ASAP_DISPLAY_PAGE_TILES == 1
+using Ssd1322Driver = U8G2_SSD1322_NHD_256X64_1_4W_HW_SPI;
+#elif ASAP_DISPLAY_PAGE_TILES == 2
+using Ssd1322Driver = U8G2_SSD1322_NHD_256X64_2_4W_HW_SPI;
+#else
+using Ssd1322Driver = U8G2_SSD1322_NHD_256X64_F_4W_HW_SPI;
+#endif
+
 class DetectorDisplay {
  public:
   explicit DetectorDisplay(const DisplayPins& pins);
@@ -34,20 +47,59 @@ class DetectorDisplay {
   FrameKind lastFrameKind() const { return lastKind_; }
   uint32_t beginCount() const { return beginCalls_; }
 
+  // Tiles changed/transmitted by the last flush (256 = full frame).
+  uint16_t lastDirtyTileCount() const { return lastDirtyTiles_; }
+  uint16_t lastSentTileCount() const { return lastSentTiles_; }
+
+  // Render-skip statistics (unchanged frames are neither redrawn nor sent).
+  uint32_t renderedFrameCount() const { return cache_.renderedCount(); }
+  uint32_t skippedFrameCount() const { return cache_.skippedCount(); }
+
+  // Region touched by the last anomaly HUD update and whether it was a full
+  // redraw (first frame, kind switch, rotation) rather than an increment.
+  const DirtyRect& lastAnomalyDirtyRect() const { return lastHudRect_; }
+  bool lastAnomalyFullRedraw() const { return lastHudFull_; }
+
+  // Queue the composed buffer for the panel and return. With
+  // ASAP_DISPLAY_ASYNC_FLUSH the bytes leave through SPI1 DMA and the buffer
+  // may be redrawn right away; otherwise this is a blocking flush. Render
+  // calls flush on their own, so this is only needed after drawing directly.
+  void flushAsync();
+  bool isFlushing() const;
+  // Dirty tiles the queue could not take yet, or queued bytes left on an
+  // idle bus by a failed DMA start; call flushAsync() again shortly.
+  bool flushPending() const;
+
  private:
   void renderFrame(const DisplayFrame& frame);
+  void flush();
+  void flush(const TileRect& region);
   void drawSpinner(uint8_t activeIndex, uint16_t cx, uint16_t cy);
   void drawCentered(const char* text, uint16_t y);
   void drawMenuTag();
   void drawProgressBar(const DisplayFrame& frame);
 
   DisplayPins pins_;
-  U8G2_SSD1322_NHD_256X64_F_4W_HW_SPI u8g2_;
+  Ssd1322Driver u8g2_;
   bool initialized_;
   DisplayFrame lastFrame_;
   FrameKind lastKind_;
   uint32_t beginCalls_;
   bool rotation180_ = false;
+#if ASAP_DISPLAY_DIRTY_TILES
+  DirtyTileTracker tiles_;
+#endif
+  uint16_t lastDirtyTiles_ = 0;
+  uint16_t lastSentTiles_ = 0;
+  FrameCache cache_;
+  AnomalyHudState hud_{};
+  DirtyRect lastHudRect_ = DirtyRect::none();
+  bool lastHudFull_ = false;
+#if ASAP_DISPLAY_ASYNC_FLUSH
+  FlushQueue queue_;
+  uint16_t frameSeq_ = 0;
+  bool flushPending_ = false;
+#endif
 };
 
 } // namespace asap::display
@@ -0,0 +1,180 @@
+#include <asap/display/DirtyTiles.h>
+
+#include <string.h>  // memset of the checksum table
+
+namespace asap::display
+{
+
+DirtyTileTracker::DirtyTileTracker()
+    : valid_(false),
+      lastDirty_(0),
+      lastSent_(0),
+      lastSpans_(0)
+{
+  memset(sums_, 0, sizeof(sums_));
+}
+
+void DirtyTileTracker::invalidate()
+{
+  valid_ = false;
+}
+
+namespace
+{
+constexpr int16_t kPanelWidth = static_cast<int16_t>(kTileCols) * 8;
+constexpr int16_t kPanelHeight = static_cast<int16_t>(kTileRows) * 8;
+
+// CRC-16/CCITT (poly 0x1021), a nibble at a time: 32 bytes of table.
+constexpr uint16_t kCrcNibble[16] = {
+    0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+    0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF,
+};
+
+uint16_t tileSum(const uint8_t* tile)
+{
+  uint16_t crc = 0xFFFF;
+  for (uint8_t i = 0; i < kTileBytes; ++i)
+  {
+    crc = static_cast<uint16_t>((crc << 4) ^ kCrcNibble[(crc >> 12) ^ (tile[i] >> 4)]);
+    crc = static_cast<uint16_t>((crc << 4) ^ kCrcNibble[(crc >> 12) ^ (tile[i] & 0x0F)]);
+  }
+  return crc;
+}
+
+int16_t clampCoord(int16_t v, int16_t maxExclusive)
+{
+  if (v < 0) return 0;
+  if (v >= maxExclusive) return static_cast<int16_t>(maxExclusive - 1);
+  return v;
+}
+}  // namespace
+
+bool tileRectFor(const DirtyRect& rect, bool rotated180, TileRect& out)
+{
+  if (rect.empty() || rect.x1 < 0 || rect.y1 < 0 ||
+      rect.x0 >= kPanelWidth || rect.y0 >= kPanelHeight)
+  {
+    return false;
+  }
+  int16_t x0 = clampCoord(rect.x0, kPanelWidth);
+  int16_t x1 = clampCoord(rect.x1, kPanelWidth);
+  int16_t y0 = clampCoord(rect.y0, kPanelHeight);
+  int16_t y1 = clampCoord(rect.y1, kPanelHeight);
+  if (rotated180)
+  {
+    // U8G2_R2 maps (x, y) to (W-1-x, H-1-y) in the buffer.
+    const int16_t nx0 = static_cast<int16_t>(kPanelWidth - 1 - x1);
+    const int16_t nx1 = static_cast<int16_t>(kPanelWidth - 1 - x0);
+    const int16_t ny0 = static_cast<int16_t>(kPanelHeight - 1 - y1);
+    const int16_t ny1 = static_cast<int16_t>(kPanelHeight - 1 - y0);
+    x0 = nx0; x1 = nx1; y0 = ny0; y1 = ny1;
+  }
+  out = TileRect{static_cast<uint8_t>(x0 / 8), static_cast<uint8_t>(y0 / 8),
+                 static_cast<uint8_t>(x1 / 8), static_cast<uint8_t>(y1 / 8)};
+  return true;
+}
+
+uint8_t DirtyTileTracker::collect(const uint8_t* buffer, TileSpan* spans)
+{
+  return collect(buffer, spans, TileRect{0, 0, kTileCols - 1, kTileRows - 1});
+}
+
+uint8_t DirtyTileTracker::collect(const uint8_t* buffer, TileSpan* spans,
+                                  const TileRect& region)
+{
+  return diff(buffer, spans, region, true);
+}
+
+uint8_t DirtyTileTracker::scan(const uint8_t* buffer, TileSpan* spans,
+                               const TileRect& region)
+{
+  return diff(buffer, spans, region, false);
+}
+
+void DirtyTileTracker::markSent(const uint8_t* buffer, const TileSpan& span)
+{
+  if (!buffer || span.row >= kTileRows)
+  {
+    return;
+  }
+  const uint16_t rowTile = static_cast<uint16_t>(span.row) * kTileCols;
+  for (uint8_t col = span.firstCol; col < kTileCols && col < span.firstCol + span.width; ++col)
+  {
+    const uint16_t tile = static_cast<uint16_t>(rowTile + col);
+    sums_[tile] = tileSum(&buffer[tile * kTileBytes]);
+  }
+}
+
+uint8_t DirtyTileTracker::diff(const uint8_t* buffer, TileSpan* spans,
+                               const TileRect& region, bool refresh)
+{
+  lastDirty_ = 0;
+  lastSent_ = 0;
+  lastSpans_ = 0;
+  if (!buffer || !spans)
+  {
+    return 0;
+  }
+
+  // Unknown panel contents: report every row as a full-width span. A scan
+  // stores the complement of each sum, so tiles not marked sent stay dirty.
+  if (!valid_)
+  {
+    for (uint16_t tile = 0; tile < static_cast<uint16_t>(kTileCols) * kTileRows; ++tile)
+    {
+      const uint16_t sum = tileSum(&buffer[tile * kTileBytes]);
+      sums_[tile] = refresh ? sum : static_cast<uint16_t>(~sum);
+    }
+    for (uint8_t row = 0; row < kTileRows; ++row)
+    {
+      spans[row] = TileSpan{row, 0, kTileCols};
+    }
+    valid_ = true;
+    lastDirty_ = static_cast<uint16_t>(kTileCols) * kTileRows;
+    lastSent_ = lastDirty_;
+    lastSpans_ = kTileRows;
+    return lastSpans_;
+  }
+
+  const uint8_t rowEnd = (region.row1 < kTileRows) ? region.row1 : static_cast<uint8_t>(kTileRows - 1);
+  const uint8_t colEnd = (region.col1 < kTileCols) ? region.col1 : static_cast<uint8_t>(kTileCols - 1);
+  for (uint8_t row = region.row0; row <= rowEnd; ++row)
+  {
+    const uint16_t rowTile = static_cast<uint16_t>(row) * kTileCols;
+    int16_t first = -1;
+    int16_t last = -1;
+    for (uint8_t col = region.col0; col <= colEnd; ++col)
+    {
+      const uint16_t tile = static_cast<uint16_t>(rowTile + col);
+      const uint16_t sum = tileSum(&buffer[tile * kTileBytes]);
+      if (sum != sums_[tile])
+      {
+        if (refresh)
+        {
+          sums_[tile] = sum;
+        }
+        if (first < 0)
+        {
+          first = col;
+        }
+        last = col;
+        ++lastDirty_;
+      }
+    }
+
+    if (first >= 0)
+    {
+      const uint8_t width = static_cast<uint8_t>(last - first + 1);
+      spans[lastSpans_++] = TileSpan{row, static_cast<uint8_t>(first), width};
+      lastSent_ = static_cast<uint16_t>(lastSent_ + width);
+    }
+  }
+  return lastSpans_;
+}
+
+}  // namespace asap::display
+//
+// DirtyTiles.cpp
+// Tile diffing against the checksums of the last transmitted frame. Each tile
+// is hashed as an 8-byte block; clean tiles between two dirty ones on the same
+// row are included in the span so a row costs a single controller window.
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <stdint.h>
+
+#include <asap/display/DisplayTypes.h>
+#include <asap/display/FlushQueue.h>
+
+namespace asap::display
+{
+
+// SSD1322 256x64 full buffer expressed in U8g2 tiles. A tile is 8x8 pixels
+// stored as 8 consecutive bytes (one byte per column, vertical-top layout),
+// and tile rows are stored one after another.
+constexpr uint8_t kTileCols = 32;
+constexpr uint8_t kTileRows = 8;
+constexpr uint16_t kTileBytes = 8;
+constexpr uint16_t kTileBufferBytes =
+    static_cast<uint16_t>(kTileCols) * kTileRows * kTileBytes;
+
+// Run of tiles on a single tile row that must be pushed to the panel.
+// Maps 1:1 onto U8g2::updateDisplayArea(firstCol, row, width, 1).
+struct TileSpan
+{
+  uint8_t row;
+  uint8_t firstCol;
+  uint8_t width;
+};
+
+// Inclusive tile rectangle (physical panel coordinates).
+struct TileRect
+{
+  uint8_t col0;
+  uint8_t row0;
+  uint8_t col1;
+  uint8_t row1;
+};
+
+// Tiles covering a logical pixel rectangle, accounting for 180° rotation.
+// Returns false when the rectangle is empty or entirely off-screen.
+bool tileRectFor(const DirtyRect& rect, bool rotated180, TileRect& out);
+
+// Tracks which tiles of the U8g2 buffer differ from what was last transmitted
+// to the panel. The tracker keeps a CRC-16 of every tile as last sent and,
+// per tile row, reports the smallest span covering every changed tile.
+class DirtyTileTracker
+{
+ public:
+  DirtyTileTracker();
+
+  // Forget the panel contents; the next collect() reports the full screen.
+  void invalidate();
+
+  // Diff `buffer` (kTileBufferBytes, U8g2 full-buffer layout) against the
+  // sent checksums, write at most kTileRows spans and refresh the checksums
+  // of the reported tiles. Returns the number of spans written.
+  uint8_t collect(const uint8_t* buffer, TileSpan* spans);
+
+  // Same, but only tiles inside `region` are compared. The caller guarantees
+  // nothing outside the region changed since the last collect().
+  uint8_t collect(const uint8_t* buffer, TileSpan* spans, const TileRect& region);
+
+  // collect() without refreshing the checksums: the caller reports what it
+  // actually transmitted with markSent(), and the rest stays dirty.
+  uint8_t scan(const uint8_t* buffer, TileSpan* spans, const TileRect& region);
+  void markSent(const uint8_t* buffer, const TileSpan& span);
+
+  // Statistics of the last collect()/scan() call.
+  uint16_t lastDirtyTiles() const { return lastDirty_; }  // tiles whose bytes changed
+  uint16_t lastSentTiles() const { return lastSent_; }    // tiles covered by spans
+  uint8_t lastSpanCount() const { return lastSpans_; }
+
+ private:
+  uint8_t diff(const uint8_t* buffer, TileSpan* spans, const TileRect& region, bool refresh);
+
+  uint16_t sums_[static_cast<uint16_t>(kTileCols) * kTileRows];
+  bool valid_;
+  uint16_t lastDirty_;
+  uint16_t lastSent_;
+  uint8_t lastSpans_;
+};
+
+// Async flush of scanned spans: pushes each through `u8g2` as far as `queue`
+// takes it without stalling the producer, marks what went out as sent and
+// stops at the first span that does not fit. Returns the tiles sent; sets
+// `pending` when some were left for a later call.
+template <typename Canvas>
+uint16_t sendSpansThatFit(Canvas& u8g2, DirtyTileTracker& tiles, const uint8_t* buffer,
+                          const TileSpan* spans, uint8_t count, const FlushQueue& queue,
+                          uint8_t& spansSent, bool& pending)
+{
+  uint16_t sent = 0;
+  spansSent = 0;
+  pending = false;
+  for (uint8_t i = 0; i < count && !pending; ++i)
+  {
+    TileSpan span = spans[i];
+    const uint8_t fit = queue.spanTilesThatFit();
+    if (fit < span.width)
+    {
+      pending = true;
+      span.width = fit;
+    }
+    if (span.width == 0)
+    {
+      break;
+    }
+    u8g2.updateDisplayArea(span.firstCol, span.row, span.width, 1);
+    tiles.markSent(buffer, span);
+    sent = static_cast<uint16_t>(sent + span.width);
+    ++spansSent;
+  }
+  return sent;
+}
+
+}  // namespace asap::display
+//
+// DirtyTiles.h
+// Dirty-tile bookkeeping shared by DetectorDisplay and NativeDisplay. Instead
+// of clocking the whole 256x64 frame over SPI with sendBuffer(), wrappers ask
+// the tracker which tile spans changed and push only those through
+// updateDisplayArea(). The native wrapper exposes the same counts so snapshot
+// tests can assert how much of the panel a UI change touches.
+//
+// Notes for maintainers
+// - The checksums cost 2 bytes per tile (512 B) instead of a 2 KB shadow of
+//   the frame. CRC-16 catches any one or two flipped pixels in a tile and
+//   any change confined to 16 consecutive bits of it; other changes slip
+//   through with odds of 1 in 65536, and the tile goes out with its next
+//   change.
+// - Only meaningful with full-buffer U8g2 setups; page-buffer modes resend
+//   every page by construction.
@@ -0,0 +1,70 @@
+#pragma once
+
+// Compile-time display options shared by DetectorDisplay and NativeDisplay.
+// Override from platformio.ini build_flags, e.g. -D ASAP_DISPLAY_PAGE_TILES=1.
+
+// U8g2 buffer strategy for the SSD1322:
+//   0 = full buffer (_F_, 2048 B of RAM)
+//   1 = one tile row per page (_1_, 256 B, 8 draw passes per frame)
+//   2 = two tile rows per page (_2_, 512 B, 4 draw passes per frame)
+#ifndef ASAP_DISPLAY_PAGE_TILES
+#define ASAP_DISPLAY_PAGE_TILES 0
+#endif
+
+#if ASAP_DISPLAY_PAGE_TILES != 0 && ASAP_DISPLAY_PAGE_TILES != 1 && ASAP_DISPLAY_PAGE_TILES != 2
+#error "ASAP_DISPLAY_PAGE_TILES must be 0 (full buffer), 1 or 2"
+#endif
+
+// Push only changed tiles over SPI (1) instead of the full frame (0). Needs
+// the full buffer: page modes resend every page by construction. The
+// tracker keeps a 16-bit checksum per tile (512 B of RAM). Without it
+// DetectorDisplay sends the tile rectangle an incremental HUD update drew
+// into, and whole frames otherwise. NativeDisplay always tracks, with the
+// same tracker the detector ships.
+#ifndef ASAP_DISPLAY_DIRTY_TILES
+#define ASAP_DISPLAY_DIRTY_TILES 1
+#endif
+
+#if ASAP_DISPLAY_DIRTY_TILES && ASAP_DISPLAY_PAGE_TILES != 0
+#error "ASAP_DISPLAY_DIRTY_TILES requires the full buffer (ASAP_DISPLAY_PAGE_TILES=0)"
+#endif
+// Update the anomaly HUD incrementally (only changed arc segments and stage
+// labels) instead of clearing and redrawing it. Needs the full buffer, since
+// the previous frame must still be in RAM.
+#ifndef ASAP_DISPLAY_INCREMENTAL_HUD
+#if ASAP_DISPLAY_PAGE_TILES == 0
+#define ASAP_DISPLAY_INCREMENTAL_HUD 1
+#else
+#define ASAP_DISPLAY_INCREMENTAL_HUD 0
+#endif
+#endif
+
+#if ASAP_DISPLAY_INCREMENTAL_HUD && ASAP_DISPLAY_PAGE_TILES != 0
+#error "ASAP_DISPLAY_INCREMENTAL_HUD requires the full buffer (ASAP_DISPLAY_PAGE_TILES=0)"
+#endif
+
+// Flush the SSD1322 through a byte queue drained by SPI1 DMA (1) instead of
+// blocking SPI writes (0). The queue lets the next frame be composed while
+// the previous one is still on the bus. Needs the full buffer.
+#ifndef ASAP_DISPLAY_ASYNC_FLUSH
+#define ASAP_DISPLAY_ASYNC_FLUSH 0
+#endif
+
+#if ASAP_DISPLAY_ASYNC_FLUSH && ASAP_DISPLAY_PAGE_TILES != 0
+#error "ASAP_DISPLAY_ASYNC_FLUSH requires the full buffer (ASAP_DISPLAY_PAGE_TILES=0)"
+#endif
+
+// Size of the flush queue in bytes of controller data (4 bpp on the SSD1322,
+// so 32 bytes per tile plus 4 of window commands; must be a power of two).
+// With dirty tiles a flush queues only the spans that fit and the rest goes
+// out from later flushAsync() calls; without them a full frame stalls the
+// producer until the bus catches up.
+#ifndef ASAP_DISPLAY_FLUSH_QUEUE_BYTES
+#define ASAP_DISPLAY_FLUSH_QUEUE_BYTES 2048
+#endif
+//
+// DisplayConfig.h
+// Build-time switches for the display wrappers. Page mode trades CPU (the
+// frame is drawn once per page) for framebuffer RAM on the 20 KB STM32F103;
+// the native wrapper honours the same switch by default so snapshot runs can
+// exercise the paged path.
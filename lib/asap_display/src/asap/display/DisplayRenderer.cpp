@@ -1,7 +1,9 @@
 #include <asap/display/DisplayRenderer.h>
 
+#include <asap/display/ArcTable.h>
 #include <asap/display/DisplayTypes.h>
 #include <asap/display/assets/AnomalyIcons.h>
+#include <asap/profile/Profiler.h>
 
 namespace asap::display
 {
@@ -25,7 +27,7 @@ static const char* RomanFor(uint8_t stage)
 }
 
 #if 0  // removed legacy arc helper
-static void DrawArcU8g2_old(::U8G2& u8g2,
+static void DrawArcU8g2_old(U8g2Canvas& u8g2,
                         int16_t cx,
                         int16_t cy,
                         uint8_t radius,
@@ -64,31 +66,17 @@ static void DrawArcU8g2_old(::U8G2& u8g2,
 #endif  // removed legacy arc helper
 
 // New LUT-driven implementation (integer-only) replacing the runtime-rotation version.
-static void DrawArcU8g2(::U8G2& u8g2,
+// Kept as the reference rasterizer for arbitrary radius/thickness; the HUD ring
+// uses the precomputed table in ArcTable.h (see DrawArcTableU8g2).
+static void DrawArcU8g2(U8g2Canvas& u8g2,
                         int16_t cx,
                         int16_t cy,
                         uint8_t radius,
                         uint8_t thickness,
                         uint8_t percent)
 {
-  // One-quadrant sine table (0..90° inclusive) with 65 samples (~1.40625°/step),
-  // fixed-point scaled by 1024. Full circle reconstructed by mirroring across quadrants.
-  constexpr int32_t kScale = 1024;
-  static const int16_t kSinLut[65] = {
-      0,   25,   50,   75,  100,  125,  150,  175,  200,  224,
-    249,  273,  297,  321,  345,  369,  392,  415,  438,  460,
-    483,  505,  526,  548,  569,  590,  610,  630,  650,  669,
-    688,  706,  724,  742,  759,  775,  792,  807,  822,  837,
-    851,  865,  878,  891,  903,  915,  926,  936,  946,  955,
-    964,  972,  980,  987,  993,  999, 1004, 1009, 1013, 1016,
-   1019, 1021, 1023, 1024, 1024
-  };
-
-  // Percent to discrete steps: 4 quadrants * 64 steps = 256 steps per full circle.
-  constexpr uint16_t kStepsPerQuadrant = 64;
-  constexpr uint16_t kFullSteps = kStepsPerQuadrant * 4U;
-  const uint8_t pc = (percent > 100) ? 100 : percent;
-  const uint16_t stepsToDraw = static_cast<uint16_t>((static_cast<uint32_t>(pc) * kFullSteps) / 100U);
+  ASAP_PROFILE_SCOPE(asap::profile::kProbeArc);
+  const uint16_t stepsToDraw = arcStepsForPercent(percent);
 
   // Radial thickness bounds around base radius (inclusive)
   const int16_t half = static_cast<int16_t>(thickness) / 2;
@@ -97,44 +85,32 @@ static void DrawArcU8g2(::U8G2& u8g2,
 
   for (uint16_t s = 0; s <= stepsToDraw; ++s)
   {
-    const uint16_t q = static_cast<uint16_t>(s / kStepsPerQuadrant);   // 0..3
-    const uint16_t w = static_cast<uint16_t>(s % kStepsPerQuadrant);   // 0..63
-
-    const int16_t sin_w = kSinLut[w];
-    const int16_t cos_w = kSinLut[kStepsPerQuadrant - w];
-
     int32_t ux = 0;
     int32_t uy = 0;
-    switch (q & 3U)
-    {
-      case 0:  // 0..90°: right, up
-        ux =  sin_w;
-        uy = -cos_w;
-        break;
-      case 1:  // 90..180°: right, down
-        ux =  cos_w;
-        uy =  sin_w;
-        break;
-      case 2:  // 180..270°: left, down
-        ux = -sin_w;
-        uy =  cos_w;
-        break;
-      default: // 270..360°: left, up
-        ux = -cos_w;
-        uy = -sin_w;
-        break;
-    }
+    arcUnitVector(s, ux, uy);
 
     for (int16_t r = rMin; r <= rMax; ++r)
     {
-      const int16_t px = static_cast<int16_t>(cx + static_cast<int16_t>((ux * r + (kScale / 2)) / kScale));
-      const int16_t py = static_cast<int16_t>(cy + static_cast<int16_t>((uy * r + (kScale / 2)) / kScale));
+      const int16_t px = static_cast<int16_t>(cx + arcOffset(ux, r));
+      const int16_t py = static_cast<int16_t>(cy + arcOffset(uy, r));
       u8g2.drawPixel(px, py);
     }
   }
 }
 
-static void drawCentered(::U8G2& u8g2, const char* text, uint16_t y)
+// Table-driven HUD ring: one drawPixel per unique pixel of the arc prefix.
+static void DrawArcTableU8g2(U8g2Canvas& u8g2, int16_t cx, int16_t cy, uint8_t percent)
+{
+  ASAP_PROFILE_SCOPE(asap::profile::kProbeArc);
+  const uint16_t count = kHudArc.end[arcStepsForPercent(percent)];
+  const ArcPixel* px = kHudArc.pixels;
+  for (uint16_t i = 0; i < count; ++i)
+  {
+    u8g2.drawPixel(static_cast<int16_t>(cx + px[i].dx), static_cast<int16_t>(cy + px[i].dy));
+  }
+}
+
+static void drawCentered(U8g2Canvas& u8g2, const char* text, uint16_t y)
 {
   if (!text)
   {
@@ -146,7 +122,7 @@ static void drawCentered(::U8G2& u8g2, const char* text, uint16_t y)
   u8g2.drawStr(x, y, text);
 }
 
-static void drawSpinner(::U8G2& u8g2, uint8_t activeIndex, uint16_t cx, uint16_t cy)
+static void drawSpinner(U8g2Canvas& u8g2, uint8_t activeIndex, uint16_t cx, uint16_t cy)
 {
   static const int8_t offsets[4][2] = {
       {0, -12},
@@ -170,7 +146,7 @@ static void drawSpinner(::U8G2& u8g2, uint8_t activeIndex, uint16_t cx, uint16_t
   }
 }
 
-static void drawMenuTag(::U8G2& u8g2)
+static void drawMenuTag(U8g2Canvas& u8g2)
 {
   u8g2.setFont(u8g2_font_6x13_tr);
   const char* tag = "MENU";
@@ -180,7 +156,7 @@ static void drawMenuTag(::U8G2& u8g2)
   u8g2.drawStr(x, y, tag);
 }
 
-static void drawProgressBar(::U8G2& u8g2, const DisplayFrame& frame)
+static void drawProgressBar(U8g2Canvas& u8g2, const DisplayFrame& frame)
 {
   const uint16_t x = frame.progressX;
   const uint16_t y = frame.progressY;
@@ -197,12 +173,9 @@ static void drawProgressBar(::U8G2& u8g2, const DisplayFrame& frame)
   }
 }
 
-}  // namespace
-
-void renderFrameU8g2(::U8G2& u8g2, const DisplayFrame& frame)
+// Draw frame content into the current buffer/page without clearing it.
+static void drawFrameContent(U8g2Canvas& u8g2, const DisplayFrame& frame)
 {
-  u8g2.clearBuffer();
-
   for (uint8_t i = 0; i < frame.lineCount; ++i)
   {
     const DisplayLine& line = frame.lines[i];
@@ -226,44 +199,236 @@ void renderFrameU8g2(::U8G2& u8g2, const DisplayFrame& frame)
   }
 }
 
-void drawAnomalyIndicatorsU8g2(::U8G2& u8g2,
-                               uint8_t radPercent, uint8_t thermPercent,
-                               uint8_t chemPercent, uint8_t psyPercent,
-                               uint8_t radStage, uint8_t thermStage,
-                               uint8_t chemStage, uint8_t psyStage)
+struct AnomalyArgs
 {
-  u8g2.clearBuffer();
-
-  struct Item { int16_t cx, cy; uint8_t p; uint8_t s; const char* icon; };
-  const Item items[4] = {
-      {32, 23, radPercent,  radStage,  "RAD"},
-      {96, 23, thermPercent, thermStage, "THERM"},
-      {160,23, chemPercent,  chemStage,  "CHEM"},
-      {224,23, psyPercent,   psyStage,  "PSY"},
-  };
+  uint8_t percent[4];
+  uint8_t stage[4];
+};
+
+// Anomaly indicator cells, left to right: rad, therm, chem, psy.
+struct IndicatorCell { int16_t cx, cy; const uint8_t* icon; };
+static const IndicatorCell kCells[AnomalyHudState::kChannels] = {
+    {32, 23, assets::kIconRadiation30x30},
+    {96, 23, assets::kIconFire30x30},
+    {160,23, assets::kIconBiohazard30x30},
+    {224,23, assets::kIconPsy30x30},
+};
+
+// Box reserved for the roman stage label under a cell; wide enough for "III"
+// and clear of the ring (which ends at cy + 22).
+constexpr int16_t kRomanBoxHalfW = 12;
+
+static void drawRoman(U8g2Canvas& u8g2, int16_t cx, uint8_t stage)
+{
+  u8g2.setFont(u8g2_font_6x10_tr);
+  const char* roman = RomanFor(stage);
+  const int16_t rw = u8g2.getStrWidth(roman);
+  u8g2.drawStr(static_cast<int16_t>(cx - rw / 2), kRomanBaselineY, roman);
+}
 
-  for (const auto& it : items)
+// Draw the four anomaly indicators (icon, ring, roman stage) without clearing.
+static void drawAnomalyContent(U8g2Canvas& u8g2, const AnomalyArgs& args)
+{
+  for (uint8_t i = 0; i < AnomalyHudState::kChannels; ++i)
   {
-    const uint8_t radius = 21;
-    const uint8_t thick = 3;
+    const IndicatorCell& it = kCells[i];
     // Draw the icon first so subsequent arc pixels can overlay it.
     const int16_t ix = static_cast<int16_t>(it.cx - assets::kIconW / 2);
     const int16_t iy = static_cast<int16_t>(it.cy - assets::kIconH / 2);
-    const uint8_t* bits = assets::kIconRadiation30x30;
-    if (it.icon[0] == 'T') bits = assets::kIconFire30x30;
-    else if (it.icon[0] == 'C') bits = assets::kIconBiohazard30x30;
-    else if (it.icon[0] == 'P') bits = assets::kIconPsy30x30;
-    u8g2.drawXBMP(ix, iy, assets::kIconW, assets::kIconH, bits);
+    u8g2.drawXBMP(ix, iy, assets::kIconW, assets::kIconH, it.icon);
     // Draw the arc after the icon so the ring has the final say.
-    DrawArcU8g2(u8g2, it.cx, it.cy, radius, thick, it.p);
+    DrawArcTableU8g2(u8g2, it.cx, it.cy, args.percent[i]);
 
-    u8g2.setFont(u8g2_font_6x10_tr);
-    const char* roman = RomanFor(it.s);
-    const int16_t rw = u8g2.getStrWidth(roman);
-    u8g2.drawStr(static_cast<int16_t>(it.cx - rw / 2), kRomanBaselineY, roman);
+    drawRoman(u8g2, it.cx, args.stage[i]);
+  }
+}
+
+// Value a pixel has after a full redraw when the ring does not cover it: the
+// icon bit inside the icon box (drawXBMP is solid), background elsewhere.
+static uint8_t iconBitAt(const IndicatorCell& cell, int16_t dx, int16_t dy)
+{
+  const int16_t rx = static_cast<int16_t>(dx + assets::kIconW / 2);
+  const int16_t ry = static_cast<int16_t>(dy + assets::kIconH / 2);
+  if (rx < 0 || ry < 0 || rx >= assets::kIconW || ry >= assets::kIconH)
+  {
+    return 0;
+  }
+  const uint16_t stride = static_cast<uint16_t>((assets::kIconW + 7) / 8);
+  const uint8_t byte = cell.icon[static_cast<uint16_t>(ry) * stride + static_cast<uint16_t>(rx) / 8U];
+  return static_cast<uint8_t>((byte >> (rx & 7)) & 1U);
+}
+
+// Draw (grow) or erase (shrink) the ring pixels between two table prefixes.
+static void updateArc(U8g2Canvas& u8g2, const IndicatorCell& cell,
+                      uint8_t fromPercent, uint8_t toPercent, DirtyRect& rect)
+{
+  const uint16_t from = kHudArc.end[arcStepsForPercent(fromPercent)];
+  const uint16_t to = kHudArc.end[arcStepsForPercent(toPercent)];
+  if (to > from)
+  {
+    for (uint16_t i = from; i < to; ++i)
+    {
+      const int16_t x = static_cast<int16_t>(cell.cx + kHudArc.pixels[i].dx);
+      const int16_t y = static_cast<int16_t>(cell.cy + kHudArc.pixels[i].dy);
+      u8g2.drawPixel(x, y);
+      rect.include(x, y);
+    }
+  }
+  else
+  {
+    for (uint16_t i = to; i < from; ++i)
+    {
+      const ArcPixel& p = kHudArc.pixels[i];
+      const int16_t x = static_cast<int16_t>(cell.cx + p.dx);
+      const int16_t y = static_cast<int16_t>(cell.cy + p.dy);
+      u8g2.setDrawColor(iconBitAt(cell, p.dx, p.dy));
+      u8g2.drawPixel(x, y);
+      rect.include(x, y);
+    }
+    u8g2.setDrawColor(1);
   }
 }
 
+// Replace the roman label of a cell: clear its box, draw the new stage.
+static void updateRoman(U8g2Canvas& u8g2, const IndicatorCell& cell, uint8_t stage, DirtyRect& rect)
+{
+  u8g2.setFont(u8g2_font_6x10_tr);
+  const int16_t top = static_cast<int16_t>(kRomanBaselineY - u8g2.getAscent());
+  const int16_t bottom = static_cast<int16_t>(kRomanBaselineY - u8g2.getDescent());
+  const int16_t x0 = static_cast<int16_t>(cell.cx - kRomanBoxHalfW);
+  const int16_t w = static_cast<int16_t>(kRomanBoxHalfW * 2);
+  const int16_t h = static_cast<int16_t>(bottom - top + 1);
+  u8g2.setDrawColor(0);
+  u8g2.drawBox(x0, top, w, h);
+  u8g2.setDrawColor(1);
+  drawRoman(u8g2, cell.cx, stage);
+  rect.include(x0, top);
+  rect.include(static_cast<int16_t>(x0 + w - 1), bottom);
+}
+
+}  // namespace
+
+bool updateAnomalyIndicatorsU8g2(U8g2Canvas& u8g2, AnomalyHudState& state,
+                                 uint8_t radPercent, uint8_t thermPercent,
+                                 uint8_t chemPercent, uint8_t psyPercent,
+                                 uint8_t radStage, uint8_t thermStage,
+                                 uint8_t chemStage, uint8_t psyStage,
+                                 DirtyRect* changed)
+{
+  ASAP_PROFILE_SCOPE(asap::profile::kProbeAnomalyUpdate);
+  const AnomalyArgs args{{radPercent, thermPercent, chemPercent, psyPercent},
+                         {radStage, thermStage, chemStage, psyStage}};
+  DirtyRect rect = DirtyRect::none();
+  const bool full = !state.valid;
+  if (full)
+  {
+    u8g2.clearBuffer();
+    drawAnomalyContent(u8g2, args);
+    rect = DirtyRect{0, 0, static_cast<int16_t>(kDisplayWidth - 1),
+                     static_cast<int16_t>(kDisplayHeight - 1)};
+  }
+  else
+  {
+    for (uint8_t i = 0; i < AnomalyHudState::kChannels; ++i)
+    {
+      if (arcStepsForPercent(state.percent[i]) != arcStepsForPercent(args.percent[i]))
+      {
+        updateArc(u8g2, kCells[i], state.percent[i], args.percent[i], rect);
+      }
+      // Compare labels, not raw stages: 0 and out-of-range both render "-".
+      if (RomanFor(state.stage[i]) != RomanFor(args.stage[i]))
+      {
+        updateRoman(u8g2, kCells[i], args.stage[i], rect);
+      }
+    }
+  }
+
+  state.valid = true;
+  for (uint8_t i = 0; i < AnomalyHudState::kChannels; ++i)
+  {
+    state.percent[i] = args.percent[i];
+    state.stage[i] = args.stage[i];
+  }
+  if (changed)
+  {
+    *changed = rect;
+  }
+  return full;
+}
+
+void drawArcU8g2(U8g2Canvas& u8g2, int16_t cx, int16_t cy,
+                 uint8_t radius, uint8_t thickness, uint8_t percent)
+{
+  if (radius == 21 && thickness == 3)
+  {
+    DrawArcTableU8g2(u8g2, cx, cy, percent);
+    return;
+  }
+  DrawArcU8g2(u8g2, cx, cy, radius, thickness, percent);
+}
+
+void drawArcReferenceU8g2(U8g2Canvas& u8g2, int16_t cx, int16_t cy,
+                          uint8_t radius, uint8_t thickness, uint8_t percent)
+{
+  DrawArcU8g2(u8g2, cx, cy, radius, thickness, percent);
+}
+
+void renderFrameU8g2(U8g2Canvas& u8g2, const DisplayFrame& frame)
+{
+  ASAP_PROFILE_SCOPE(asap::profile::kProbeRenderFrame);
+  u8g2.clearBuffer();
+  drawFrameContent(u8g2, frame);
+}
+
+void renderFramePagedU8g2(U8g2Canvas& u8g2, const DisplayFrame& frame,
+                          PageHook onPage, void* context)
+{
+  ASAP_PROFILE_SCOPE(asap::profile::kProbeRenderFrame);
+  u8g2.firstPage();
+  do
+  {
+    drawFrameContent(u8g2, frame);
+    if (onPage)
+    {
+      onPage(u8g2, context);
+    }
+  } while (u8g2.nextPage());
+}
+
+void drawAnomalyIndicatorsU8g2(U8g2Canvas& u8g2,
+                               uint8_t radPercent, uint8_t thermPercent,
+                               uint8_t chemPercent, uint8_t psyPercent,
+                               uint8_t radStage, uint8_t thermStage,
+                               uint8_t chemStage, uint8_t psyStage)
+{
+  ASAP_PROFILE_SCOPE(asap::profile::kProbeAnomalyIndicators);
+  const AnomalyArgs args{{radPercent, thermPercent, chemPercent, psyPercent},
+                         {radStage, thermStage, chemStage, psyStage}};
+  u8g2.clearBuffer();
+  drawAnomalyContent(u8g2, args);
+}
+
+void drawAnomalyIndicatorsPagedU8g2(U8g2Canvas& u8g2,
+                                    uint8_t radPercent, uint8_t thermPercent,
+                                    uint8_t chemPercent, uint8_t psyPercent,
+                                    uint8_t radStage, uint8_t thermStage,
+                                    uint8_t chemStage, uint8_t psyStage,
+                                    PageHook onPage, void* context)
+{
+  ASAP_PROFILE_SCOPE(asap::profile::kProbeAnomalyIndicators);
+  const AnomalyArgs args{{radPercent, thermPercent, chemPercent, psyPercent},
+                         {radStage, thermStage, chemStage, psyStage}};
+  u8g2.firstPage();
+  do
+  {
+    drawAnomalyContent(u8g2, args);
+    if (onPage)
+    {
+      onPage(u8g2, context);
+    }
+  } while (u8g2.nextPage());
+}
+
 }  // namespace asap::display
 //
 // DisplayRenderer.cpp
@@ -276,5 +441,11 @@ void drawAnomalyIndicatorsU8g2(::U8G2& u8g2,
 // - Text centering uses U8g2 string width for consistent alignment.
 // - Anomaly HUD geometry (icon positions, arc radius/thickness, roman baseline)
 //   is kept consistent with embedded requirements documented in AGENTS.md.
+// - The HUD ring (radius 21, thickness 3) is drawn from the constexpr table in
+//   ArcTable.h; other sizes use the LUT rasterizer, which stays pixel-identical.
+// - Paged variants (firstPage/nextPage) draw the same content once per U8g2
+//   page, so full-buffer and page-buffer setups produce identical pixels.
+// - Primitives carry ASAP_PROFILE_SCOPE probes (asap/profile/Profiler.h),
+//   which compile to nothing unless ASAP_PROFILE is set.
 // - Avoid platform-specific conditionals here; divergence should live in
 //   wrapper classes that own U8g2 instances (DetectorDisplay/NativeDisplay).
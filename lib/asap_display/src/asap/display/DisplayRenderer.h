@@ -3,22 +3,73 @@
 #include <stdint.h>
 #include <U8g2lib.h>
 
+#include <asap/display/ArcTable.h>
 #include <asap/display/DisplayTypes.h>
+#ifndef ARDUINO
+#include <asap/display/InstrumentedU8g2.h>
+#endif
 
 namespace asap::display
 {
 
+// Canvas the helpers draw on: the driver's U8G2 on the board, the counting
+// InstrumentedU8g2 on native so every render also reports its DrawCost.
+#ifdef ARDUINO
+using U8g2Canvas = ::U8G2;
+#else
+using U8g2Canvas = InstrumentedU8g2;
+#endif
+
 // Shared U8g2-based rendering helpers used by both hardware and native paths.
-// These routines translate a DisplayFrame into draw calls on a provided U8G2.
+// These routines translate a DisplayFrame into draw calls on a provided U8g2Canvas.
 
-void renderFrameU8g2(::U8G2& u8g2, const DisplayFrame& frame);
+// Full-buffer variants: clear the buffer and draw; the caller sends it.
+void renderFrameU8g2(U8g2Canvas& u8g2, const DisplayFrame& frame);
 
-void drawAnomalyIndicatorsU8g2(::U8G2& u8g2,
+void drawAnomalyIndicatorsU8g2(U8g2Canvas& u8g2,
                                uint8_t radPercent, uint8_t thermPercent,
                                uint8_t chemPercent, uint8_t psyPercent,
                                uint8_t radStage, uint8_t thermStage,
                                uint8_t chemStage, uint8_t psyStage);
 
+// Incremental anomaly HUD update on a full buffer that still holds the frame
+// described by `state`. Only the arc pixels gained or lost since the last call
+// are drawn or erased, and a roman numeral is redrawn only when its stage
+// changes. Falls back to a full redraw when `state` is not valid. Updates
+// `state`, reports the touched region in `changed` (may be null) and returns
+// true when a full redraw happened.
+bool updateAnomalyIndicatorsU8g2(U8g2Canvas& u8g2, AnomalyHudState& state,
+                                 uint8_t radPercent, uint8_t thermPercent,
+                                 uint8_t chemPercent, uint8_t psyPercent,
+                                 uint8_t radStage, uint8_t thermStage,
+                                 uint8_t chemStage, uint8_t psyStage,
+                                 DirtyRect* changed);
+
+// Ring arc from north, clockwise, 0..100%. Uses the precomputed span table for
+// the HUD ring (radius 21, thickness 3) and the LUT rasterizer otherwise.
+void drawArcU8g2(U8g2Canvas& u8g2, int16_t cx, int16_t cy,
+                 uint8_t radius, uint8_t thickness, uint8_t percent);
+
+// Per-pixel LUT rasterizer, always. Reference for parity tests and benchmarks.
+void drawArcReferenceU8g2(U8g2Canvas& u8g2, int16_t cx, int16_t cy,
+                          uint8_t radius, uint8_t thickness, uint8_t percent);
+
+// Page-buffer variants: run the firstPage()/nextPage() loop, drawing the same
+// content into every page (each page is sent by nextPage()). The optional
+// hook runs after a page is drawn and before it is sent, e.g. so the native
+// wrapper can composite pages into a full frame for snapshots.
+using PageHook = void (*)(U8g2Canvas& u8g2, void* context);
+
+void renderFramePagedU8g2(U8g2Canvas& u8g2, const DisplayFrame& frame,
+                          PageHook onPage = nullptr, void* context = nullptr);
+
+void drawAnomalyIndicatorsPagedU8g2(U8g2Canvas& u8g2,
+                                    uint8_t radPercent, uint8_t thermPercent,
+                                    uint8_t chemPercent, uint8_t psyPercent,
+                                    uint8_t radStage, uint8_t thermStage,
+                                    uint8_t chemStage, uint8_t psyStage,
+                                    PageHook onPage = nullptr, void* context = nullptr);
+
 }  // namespace asap::display
 //
 // DisplayRenderer.h
@@ -48,6 +48,43 @@ struct DisplayFrame
   uint8_t progressPercent;
 };
 
+// Inclusive pixel bounding box in logical (pre-rotation) coordinates. Empty
+// when x0 > x1.
+struct DirtyRect
+{
+  int16_t x0;
+  int16_t y0;
+  int16_t x1;
+  int16_t y1;
+
+  static constexpr DirtyRect none() { return DirtyRect{1, 1, 0, 0}; }
+  bool empty() const { return x0 > x1 || y0 > y1; }
+  void include(int16_t x, int16_t y)
+  {
+    if (empty())
+    {
+      x0 = x1 = x;
+      y0 = y1 = y;
+      return;
+    }
+    if (x < x0) x0 = x;
+    if (x > x1) x1 = x;
+    if (y < y0) y0 = y;
+    if (y > y1) y1 = y;
+  }
+};
+
+// What the anomaly HUD currently shows, remembered between incremental
+// updates. `valid` is false until a full redraw, and after anything else
+// (another frame kind, rotation, re-init) touched the buffer.
+struct AnomalyHudState
+{
+  static constexpr uint8_t kChannels = 4;  // rad, therm, chem, psy
+  bool valid;
+  uint8_t percent[kChannels];
+  uint8_t stage[kChannels];
+};
+
 struct DisplayPins
 {
   uint32_t chipSelect;
@@ -61,10 +98,10 @@ DisplayFrame makeHeartbeatFrame(uint32_t uptimeMs);
 DisplayFrame makeStatusFrame(const char* line1, const char* line2);
 DisplayFrame makeJoystickFrame(::asap::input::JoyAction action);
 DisplayFrame makeMenuRootFrame(uint8_t selectedIndex);
-DisplayFrame makeMenuTrackingFrame(uint8_t trackingId);
+DisplayFrame makeMenuTrackingFrame(uint16_t trackingId);
 DisplayFrame makeMenuAnomalyFrame();
 DisplayFrame makeAnomalyMainFrame(uint8_t percent, bool showMenuTag = false);
-DisplayFrame makeTrackingMainFrame(uint8_t trackingId,
+DisplayFrame makeTrackingMainFrame(uint16_t trackingId,
                                    int16_t rssiAvgDbm,
                                    bool showMenuTag = false);
 
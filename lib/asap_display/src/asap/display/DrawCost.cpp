@@ -0,0 +1,109 @@
+#include <asap/display/DrawCost.h>
+
+namespace asap::display
+{
+
+// Estimated from the U8g2 code paths at -Os on the Cortex-M3 (flash at two
+// wait states), to be refined with env:detector_profile: draw N primitives of
+// a known size inside an ASAP_PROFILE_SCOPE and fit perCall / per256Units.
+//   Pixel    clip test, rotation callback, one buffer bit
+//   Box      one horizontal line per row; a bit per pixel in vertical-top tiles
+//   Xbmp     bit test and draw_pixel for every bitmap pixel
+//   Str      glyph lookup plus RLE decode into line runs
+//   StrWidth linear glyph lookup per character in the font
+//   Clear    memset of the tile buffer
+//   Other    circle / frame rasterizers, per outline or area pixel
+const DrawCalibration kStm32DrawCalibration[kDrawPrimitiveCount] = {
+    {70, 0},         // Pixel
+    {150, 1024},     // Box: ~4 cycles per pixel
+    {200, 8192},     // Xbmp: ~32 cycles per pixel
+    {300, 5120},     // Str: ~20 cycles per glyph-box pixel
+    {60, 30720},     // StrWidth: ~120 cycles per glyph
+    {40, 10},        // Clear: ~600 cycles for the full 2 KB buffer
+    {300, 2048},     // Other: ~8 cycles per pixel
+};
+
+namespace
+{
+// Full-buffer ceilings per FrameKind, about 25 % above the largest frame of
+// that kind in the native test suite.
+constexpr DrawBudget kBudgets[] = {
+    {0, 0},              // None
+    {2200, 50000},       // Boot
+    {1600, 36000},       // Heartbeat
+    {900, 21500},        // Status
+    {3900, 90000},       // Menu
+    {6500, 250000},      // MainAnomaly: four icons and rings dominate
+    {1300, 30000},       // MainTracking
+};
+
+constexpr const char* kNames[kDrawPrimitiveCount] = {
+    "drawPixel", "drawBox", "drawXBMP", "drawStr", "getStrWidth", "clearBuffer", "other",
+};
+}  // namespace
+
+void DrawCost::reset()
+{
+  *this = DrawCost{};
+}
+
+void DrawCost::add(DrawPrimitive primitive, uint32_t unitCount)
+{
+  const uint8_t i = static_cast<uint8_t>(primitive);
+  ++calls[i];
+  units[i] += unitCount;
+}
+
+uint32_t DrawCost::totalCalls() const
+{
+  uint32_t total = 0;
+  for (uint32_t c : calls)
+  {
+    total += c;
+  }
+  return total;
+}
+
+uint32_t DrawCost::drawnPixels() const
+{
+  return unitsOf(DrawPrimitive::Pixel) + unitsOf(DrawPrimitive::Box) + unitsOf(DrawPrimitive::Xbmp) +
+         unitsOf(DrawPrimitive::Str) + unitsOf(DrawPrimitive::Other);
+}
+
+uint32_t estimateCycles(const DrawCost& cost, const DrawCalibration* calibration)
+{
+  uint64_t cycles = 0;
+  for (uint8_t i = 0; i < kDrawPrimitiveCount; ++i)
+  {
+    cycles += static_cast<uint64_t>(cost.calls[i]) * calibration[i].perCall +
+              ((static_cast<uint64_t>(cost.units[i]) * calibration[i].per256Units) >> 8);
+  }
+  return cycles > UINT32_MAX ? UINT32_MAX : static_cast<uint32_t>(cycles);
+}
+
+DrawBudget drawBudgetFor(FrameKind kind)
+{
+  const uint8_t i = static_cast<uint8_t>(kind);
+  return i < sizeof(kBudgets) / sizeof(kBudgets[0]) ? kBudgets[i] : DrawBudget{0, 0};
+}
+
+bool withinDrawBudget(const DrawCost& cost, FrameKind kind, uint8_t pages)
+{
+  const DrawBudget budget = drawBudgetFor(kind);
+  return cost.drawnPixels() <= budget.maxDrawnPixels * pages &&
+         estimateCycles(cost) <= budget.maxCycles * pages;
+}
+
+const char* drawPrimitiveName(DrawPrimitive primitive)
+{
+  const uint8_t i = static_cast<uint8_t>(primitive);
+  return i < kDrawPrimitiveCount ? kNames[i] : "?";
+}
+
+}  // namespace asap::display
+//
+// DrawCost.cpp
+// Calibration and budget tables for the draw cost model. Both are estimates:
+// the budgets only have to catch a frame kind getting markedly more expensive,
+// and the calibration only has to rank primitives the way the STM32 does.
+//
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <stdint.h>
+
+#include <asap/display/DisplayTypes.h>
+
+namespace asap::display
+{
+
+// U8g2 primitives the renderer uses, as counted by InstrumentedU8g2.
+enum class DrawPrimitive : uint8_t
+{
+  Pixel,     // drawPixel: 1 unit per call
+  Box,       // drawBox: w * h pixels
+  Xbmp,      // drawXBMP: w * h pixels (solid bitmap mode writes background too)
+  Str,       // drawStr: returned width * font height
+  StrWidth,  // getStrWidth: glyphs measured (no pixels)
+  Clear,     // clearBuffer: every pixel of the tile buffer
+  Other,     // drawFrame / drawDisc / drawCircle: bounding-shape estimate
+};
+
+constexpr uint8_t kDrawPrimitiveCount = static_cast<uint8_t>(DrawPrimitive::Other) + 1;
+
+// Calls and units (pixels, glyphs for StrWidth) issued for one frame. In page
+// modes the renderer repeats every call once per page, and so do the counts.
+struct DrawCost
+{
+  uint32_t calls[kDrawPrimitiveCount];
+  uint32_t units[kDrawPrimitiveCount];
+
+  void reset();
+  void add(DrawPrimitive primitive, uint32_t unitCount);
+
+  uint32_t callsOf(DrawPrimitive p) const { return calls[static_cast<uint8_t>(p)]; }
+  uint32_t unitsOf(DrawPrimitive p) const { return units[static_cast<uint8_t>(p)]; }
+  uint32_t totalCalls() const;
+  // Pixels written by drawing primitives; clearBuffer and getStrWidth excluded.
+  uint32_t drawnPixels() const;
+};
+
+// Cost model of one primitive on the detector (STM32F103, 72 MHz, U8g2 1 bpp
+// vertical-top buffer): cycles = calls * perCall + units * per256Units / 256.
+struct DrawCalibration
+{
+  uint16_t perCall;
+  uint16_t per256Units;
+};
+
+// Calibration in DrawPrimitive order; see DrawCost.cpp for how it was derived.
+extern const DrawCalibration kStm32DrawCalibration[kDrawPrimitiveCount];
+
+uint32_t estimateCycles(const DrawCost& cost,
+                        const DrawCalibration* calibration = kStm32DrawCalibration);
+
+// Per-frame ceilings for one full-buffer frame of a kind. Page modes multiply
+// both by the number of pages.
+struct DrawBudget
+{
+  uint32_t maxDrawnPixels;
+  uint32_t maxCycles;
+};
+
+DrawBudget drawBudgetFor(FrameKind kind);
+bool withinDrawBudget(const DrawCost& cost, FrameKind kind, uint8_t pages = 1);
+
+const char* drawPrimitiveName(DrawPrimitive primitive);
+
+}  // namespace asap::display
+//
+// DrawCost.h
+// Platform-neutral draw cost accounting. The native canvas counts what the
+// renderer asks U8g2 to do; the calibration turns that into an estimate of
+// STM32 cycles so a layout change that doubles the HUD cost fails a native
+// test instead of showing up as lag on the device.
+//
+// Notes for maintainers
+// - Budgets are regression gates, not targets: when a frame legitimately grows,
+//   raise its budget in DrawCost.cpp in the same change.
@@ -0,0 +1,344 @@
+#include <asap/display/FlushQueue.h>
+
+#include <string.h>  // memcpy into the ring arena
+
+#include <U8g2lib.h>
+
+#ifndef U8X8_WITH_USER_PTR
+#error "FlushQueue needs U8X8_WITH_USER_PTR (see build_flags in platformio.ini)"
+#endif
+
+namespace asap::display
+{
+
+static_assert(FlushQueue::kCapacity > 0 && FlushQueue::kCapacity <= 32768,
+              "ASAP_DISPLAY_FLUSH_QUEUE_BYTES out of range");
+static_assert((FlushQueue::kCapacity & (FlushQueue::kCapacity - 1)) == 0,
+              "ASAP_DISPLAY_FLUSH_QUEUE_BYTES must be a power of two: the "
+              "uint32 cursors wrap at 2^32");
+static_assert((256 % FlushQueue::kMaxSegments) == 0,
+              "segment indices wrap at 256");
+
+namespace
+{
+constexpr uint16_t kArenaMask = FlushQueue::kCapacity - 1;
+
+// What U8x8's SSD1322 driver emits for one updateDisplayArea() row: the row
+// window (command + 2 arguments), then per tile the column window (command +
+// 2 arguments), the write-RAM command and 32 bytes of 4 bpp pixels. Each D/C
+// change opens a segment.
+constexpr uint16_t kSpanBytes = 3;
+constexpr uint8_t kSpanSegments = 2;
+constexpr uint16_t kTileWireBytes = 36;
+constexpr uint8_t kTileSegments = 4;
+
+// Compiler barrier: segment descriptors must be written before the index
+// that publishes them (single core, so no hardware fence is needed).
+inline void publishBarrier()
+{
+  __asm__ __volatile__("" ::: "memory");
+}
+}  // namespace
+
+FlushQueue::FlushQueue()
+    : written_(0),
+      read_(0),
+      segHead_(0),
+      segTail_(0),
+      segConsumed_(0),
+      open_(false),
+      openStart_(0),
+      openLength_(0),
+      dc_(0),
+      frame_(0),
+      stalls_(0),
+      kick_(nullptr),
+      stall_(nullptr),
+      context_(nullptr)
+{
+}
+
+void FlushQueue::setHooks(Hook kick, Hook stall, void* context)
+{
+  kick_ = kick;
+  stall_ = stall;
+  context_ = context;
+}
+
+void FlushQueue::beginFrame(uint16_t frame)
+{
+  publish();
+  frame_ = frame;
+}
+
+void FlushQueue::setDc(uint8_t dc)
+{
+  if (dc != dc_)
+  {
+    publish();
+    dc_ = dc;
+  }
+}
+
+void FlushQueue::append(const uint8_t* data, uint16_t length)
+{
+  while (length > 0 && data)
+  {
+    const bool slotFree = static_cast<uint8_t>(segHead_ - segTail_) < kMaxSegments;
+    const uint16_t room = freeBytes();
+    if (room == 0 || (!open_ && !slotFree))
+    {
+      // Out of space: hand what we have to the consumer and wait for it.
+      publish();
+      ++stalls_;
+      if (kick_)
+      {
+        kick_(context_);
+      }
+      if (!stall_)
+      {
+        return;  // no way to wait; drop the rest rather than spin forever
+      }
+      stall_(context_);
+      continue;
+    }
+    if (!open_)
+    {
+      open_ = true;
+      openStart_ = static_cast<uint16_t>(written_ & kArenaMask);
+      openLength_ = 0;
+    }
+
+    const uint16_t n = (length < room) ? length : room;
+    const uint16_t pos = static_cast<uint16_t>(written_ & kArenaMask);
+    const uint16_t first = (n < kCapacity - pos) ? n : static_cast<uint16_t>(kCapacity - pos);
+    memcpy(&arena_[pos], data, first);
+    if (first < n)
+    {
+      memcpy(&arena_[0], data + first, static_cast<size_t>(n - first));
+    }
+    written_ = written_ + n;
+    openLength_ = static_cast<uint16_t>(openLength_ + n);
+    data += n;
+    length = static_cast<uint16_t>(length - n);
+  }
+}
+
+void FlushQueue::endTransfer()
+{
+  publish();
+  if (kick_)
+  {
+    kick_(context_);
+  }
+}
+
+void FlushQueue::publish()
+{
+  if (!open_)
+  {
+    return;
+  }
+  open_ = false;
+  if (openLength_ == 0)
+  {
+    return;
+  }
+  segments_[segHead_ % kMaxSegments] = Segment{openStart_, openLength_, dc_, frame_};
+  publishBarrier();
+  segHead_ = static_cast<uint8_t>(segHead_ + 1);
+}
+
+bool FlushQueue::peek(FlushChunk& out) const
+{
+  if (segTail_ == segHead_)
+  {
+    return false;
+  }
+  const Segment& seg = segments_[segTail_ % kMaxSegments];
+  const uint16_t remaining = static_cast<uint16_t>(seg.length - segConsumed_);
+  const uint16_t pos = static_cast<uint16_t>((seg.start + segConsumed_) & kArenaMask);
+  const uint16_t toEnd = static_cast<uint16_t>(kCapacity - pos);
+  out.data = &arena_[pos];
+  out.length = (remaining < toEnd) ? remaining : toEnd;
+  out.dc = seg.dc;
+  out.frame = seg.frame;
+  out.segmentEnd = (out.length == remaining);
+  return true;
+}
+
+void FlushQueue::consume(uint16_t length)
+{
+  if (segTail_ == segHead_)
+  {
+    return;
+  }
+  const Segment& seg = segments_[segTail_ % kMaxSegments];
+  const uint16_t remaining = static_cast<uint16_t>(seg.length - segConsumed_);
+  if (length > remaining)
+  {
+    length = remaining;
+  }
+  read_ = read_ + length;
+  if (length == remaining)
+  {
+    segConsumed_ = 0;
+    publishBarrier();
+    segTail_ = static_cast<uint8_t>(segTail_ + 1);
+  }
+  else
+  {
+    segConsumed_ = static_cast<uint16_t>(segConsumed_ + length);
+  }
+}
+
+bool FlushQueue::empty() const
+{
+  return segTail_ == segHead_ && !(open_ && openLength_ > 0);
+}
+
+bool FlushQueue::hasRoom() const
+{
+  return freeBytes() > 0 && static_cast<uint8_t>(segHead_ - segTail_) < kMaxSegments;
+}
+
+uint8_t FlushQueue::spanTilesThatFit() const
+{
+  const uint16_t bytes = freeBytes();
+  const uint8_t slots = static_cast<uint8_t>(
+      kMaxSegments - static_cast<uint8_t>(segHead_ - segTail_) - (open_ ? 1 : 0));
+  if (bytes < kSpanBytes + kTileWireBytes || slots < kSpanSegments + kTileSegments)
+  {
+    return 0;
+  }
+  const uint16_t byBytes = static_cast<uint16_t>((bytes - kSpanBytes) / kTileWireBytes);
+  const uint16_t bySlots = static_cast<uint16_t>((slots - kSpanSegments) / kTileSegments);
+  const uint16_t tiles = (byBytes < bySlots) ? byBytes : bySlots;
+  return static_cast<uint8_t>((tiles < 255) ? tiles : 255);
+}
+
+uint8_t u8x8ByteFlushQueue(::u8x8_struct* u8x8, uint8_t msg, uint8_t argInt, void* argPtr)
+{
+  FlushQueue* queue = static_cast<FlushQueue*>(u8x8_GetUserPtr(u8x8));
+  if (!queue)
+  {
+    return 0;
+  }
+  switch (msg)
+  {
+    case U8X8_MSG_BYTE_SEND:
+      queue->append(static_cast<const uint8_t*>(argPtr), argInt);
+      break;
+    case U8X8_MSG_BYTE_SET_DC:
+      queue->setDc(argInt);
+      break;
+    case U8X8_MSG_BYTE_END_TRANSFER:
+      queue->endTransfer();
+      break;
+    case U8X8_MSG_BYTE_INIT:
+    case U8X8_MSG_BYTE_START_TRANSFER:
+      break;  // chip select is owned by the transmitter
+    default:
+      return 0;
+  }
+  return 1;
+}
+
+#ifndef ARDUINO
+
+SimulatedBus::SimulatedBus(uint32_t bytesPerMs)
+    : bytesPerMs_(bytesPerMs ? bytesPerMs : 1)
+{
+}
+
+void SimulatedBus::attach(FlushQueue& queue)
+{
+  queue_ = &queue;
+}
+
+void SimulatedBus::advance(uint32_t elapsedMs)
+{
+  for (uint32_t ms = 0; ms < elapsedMs; ++ms)
+  {
+    if (clockOut(bytesPerMs_) == 0)
+    {
+      break;  // idle bus: the rest of the interval costs nothing
+    }
+    ++busyMs_;
+  }
+}
+
+void SimulatedBus::drainAll()
+{
+  while (queue_ && !queue_->empty())
+  {
+    if (clockOut(bytesPerMs_) == 0)
+    {
+      break;  // only an unpublished open segment is left
+    }
+    ++busyMs_;
+  }
+}
+
+void SimulatedBus::waitForRoom()
+{
+  while (queue_ && !queue_->hasRoom())
+  {
+    if (clockOut(bytesPerMs_) == 0)
+    {
+      break;
+    }
+    ++busyMs_;
+    ++stallMs_;
+  }
+}
+
+uint32_t SimulatedBus::clockOut(uint32_t budget)
+{
+  uint32_t sent = 0;
+  FlushChunk chunk{};
+  while (queue_ && sent < budget && queue_->peek(chunk))
+  {
+    if (!haveFrame_ || chunk.frame != currentFrame_)
+    {
+      if (haveFrame_)
+      {
+        lastFinished_ = currentFrame_;
+        haveFinished_ = true;
+        ++framesCompleted_;
+      }
+      // A frame id at or behind the last finished one means its bytes were
+      // split around another frame's: the panel would show a mix of both.
+      if (haveFinished_ && static_cast<int16_t>(chunk.frame - lastFinished_) <= 0)
+      {
+        ++tornFrames_;
+      }
+      currentFrame_ = chunk.frame;
+      haveFrame_ = true;
+    }
+    const uint32_t left = budget - sent;
+    const uint16_t n = (chunk.length < left) ? chunk.length : static_cast<uint16_t>(left);
+    queue_->consume(n);
+    sent += n;
+  }
+  bytesSent_ += sent;
+  return sent;
+}
+
+uint32_t SimulatedBus::framesCompleted() const
+{
+  // The frame on the wire counts once its last queued byte has gone out.
+  const bool drained = queue_ && queue_->empty();
+  return framesCompleted_ + ((haveFrame_ && drained) ? 1U : 0U);
+}
+
+#endif  // ARDUINO
+
+}  // namespace asap::display
+//
+// FlushQueue.cpp
+// Ring arena plus segment table. The producer only advances written_/segHead_
+// and the consumer only advances read_/segTail_/segConsumed_, so the DMA ISR
+// and the main loop never need a lock; the kick hook is the one place that
+// masks interrupts (see DetectorDisplay.cpp).
+//
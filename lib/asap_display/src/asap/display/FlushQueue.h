@@ -0,0 +1,147 @@
+#pragma once
+
+#include <stdint.h>
+
+#include <asap/display/DisplayConfig.h>
+
+struct u8x8_struct;
+
+namespace asap::display
+{
+
+// Contiguous run of queued bytes sharing one D/C level, as handed to the
+// transmitter (DMA on STM32, simulated bus on native).
+struct FlushChunk
+{
+  const uint8_t* data;
+  uint16_t length;
+  uint8_t dc;         // 0 = command, 1 = data
+  uint16_t frame;     // frame sequence the bytes belong to
+  bool segmentEnd;    // true when this chunk finishes its segment
+};
+
+// Single-producer/single-consumer queue of SPI segments between the U8x8
+// byte callback (producer, main loop) and the transmitter (consumer, DMA ISR
+// or simulated bus). A segment is a run of bytes with one D/C level; bytes are
+// copied out of U8g2's conversion buffers, so the framebuffer can be redrawn
+// as soon as updateDisplayArea() returns.
+class FlushQueue
+{
+ public:
+  static constexpr uint16_t kCapacity = ASAP_DISPLAY_FLUSH_QUEUE_BYTES;
+  static constexpr uint8_t kMaxSegments = 64;
+
+  // kick: consumer should start if idle. stall: producer is out of space and
+  // must wait for the consumer to free some (blocking back-pressure).
+  using Hook = void (*)(void* context);
+
+  FlushQueue();
+
+  void setHooks(Hook kick, Hook stall, void* context);
+
+  // Producer side (driven by the U8x8 byte callback).
+  void beginFrame(uint16_t frame);
+  void setDc(uint8_t dc);
+  void append(const uint8_t* data, uint16_t length);
+  void endTransfer();  // publish the open segment and kick the consumer
+
+  // Consumer side.
+  bool peek(FlushChunk& out) const;
+  void consume(uint16_t length);
+
+  bool empty() const;    // nothing published or open
+  bool hasRoom() const;  // producer can append at least one byte
+  // Tiles of one updateDisplayArea() row the producer can queue right now
+  // without stalling (0 when not even one fits).
+  uint8_t spanTilesThatFit() const;
+  uint16_t used() const { return static_cast<uint16_t>(written_ - read_); }
+  uint16_t freeBytes() const { return static_cast<uint16_t>(kCapacity - used()); }
+  uint32_t stallCount() const { return stalls_; }
+
+ private:
+  struct Segment
+  {
+    uint16_t start;
+    uint16_t length;
+    uint8_t dc;
+    uint16_t frame;
+  };
+
+  void publish();
+
+  uint8_t arena_[kCapacity];
+  Segment segments_[kMaxSegments];
+  volatile uint32_t written_;        // bytes appended (producer)
+  volatile uint32_t read_;           // bytes consumed (consumer)
+  volatile uint8_t segHead_;         // next segment slot to publish (producer)
+  volatile uint8_t segTail_;         // oldest published segment (consumer)
+  volatile uint16_t segConsumed_;    // bytes consumed from the tail segment
+  bool open_;
+  uint16_t openStart_;
+  uint16_t openLength_;
+  uint8_t dc_;
+  uint16_t frame_;
+  uint32_t stalls_;
+  Hook kick_;
+  Hook stall_;
+  void* context_;
+};
+
+// U8x8 byte callback that feeds the FlushQueue stored in the u8x8 user
+// pointer (requires U8X8_WITH_USER_PTR). Chip select and the actual clocking
+// are left to the transmitter.
+uint8_t u8x8ByteFlushQueue(::u8x8_struct* u8x8, uint8_t msg, uint8_t argInt, void* argPtr);
+
+#ifndef ARDUINO
+// Host model of the SPI link: drains a FlushQueue at a fixed byte rate as
+// virtual time advances and checks that frames leave the queue whole and in
+// order (no tearing).
+class SimulatedBus
+{
+ public:
+  explicit SimulatedBus(uint32_t bytesPerMs);
+
+  void attach(FlushQueue& queue);
+  void advance(uint32_t elapsedMs);  // clock out up to bytesPerMs * elapsedMs
+  void drainAll();                   // clock out everything
+  void waitForRoom();                // producer back-pressure, 1 ms steps
+
+  uint32_t bytesPerMs() const { return bytesPerMs_; }
+  uint32_t bytesSent() const { return bytesSent_; }
+  uint32_t busyMs() const { return busyMs_; }
+  uint32_t framesCompleted() const;
+  uint32_t tornFrames() const { return tornFrames_; }
+  uint32_t stallMs() const { return stallMs_; }  // time the producer was blocked
+
+ private:
+  uint32_t clockOut(uint32_t budget);
+
+  FlushQueue* queue_ = nullptr;
+  uint32_t bytesPerMs_;
+  uint32_t bytesSent_ = 0;
+  uint32_t busyMs_ = 0;
+  uint32_t framesCompleted_ = 0;
+  uint32_t tornFrames_ = 0;
+  uint32_t stallMs_ = 0;
+  bool haveFrame_ = false;
+  bool haveFinished_ = false;
+  uint16_t currentFrame_ = 0;
+  uint16_t lastFinished_ = 0;
+};
+#endif  // ARDUINO
+
+}  // namespace asap::display
+//
+// FlushQueue.h
+// Asynchronous panel flush plumbing. DetectorDisplay (ASAP_DISPLAY_ASYNC_FLUSH)
+// routes U8g2 output into this queue and drains it with SPI1 DMA; NativeDisplay
+// can drain it through SimulatedBus so host tests can check that UI ticks do not
+// block on the bus and that frames are never interleaved.
+//
+// Notes for maintainers
+// - The queue holds converted controller bytes (4 bpp for the SSD1322), so a
+//   full frame (about 9.3 KB) is larger than kCapacity. The display wrappers
+//   ask spanTilesThatFit() before each span and leave the rest for a later
+//   flush (flushPending()), so the producer does not wait on the bus; the
+//   stall hook is only the fallback for output that bypasses that check.
+// - Keep the consumer side ISR-safe: no allocation, no blocking.
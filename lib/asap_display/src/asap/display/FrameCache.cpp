@@ -0,0 +1,97 @@
+#include <asap/display/FrameCache.h>
+
+namespace asap::display
+{
+
+namespace
+{
+
+constexpr uint32_t kFnvOffset = 2166136261u;
+constexpr uint32_t kFnvPrime = 16777619u;
+
+inline uint32_t mix(uint32_t hash, uint8_t byte)
+{
+  return (hash ^ byte) * kFnvPrime;
+}
+
+inline uint32_t mix16(uint32_t hash, uint16_t value)
+{
+  hash = mix(hash, static_cast<uint8_t>(value & 0xFFu));
+  return mix(hash, static_cast<uint8_t>(value >> 8));
+}
+
+// Tag values keep frame and anomaly fingerprints in separate domains.
+constexpr uint8_t kTagFrame = 0xF1;
+constexpr uint8_t kTagAnomaly = 0xA7;
+
+}  // namespace
+
+uint32_t fingerprintFrame(const DisplayFrame& frame, FrameKind kind)
+{
+  uint32_t h = mix(kFnvOffset, kTagFrame);
+  h = mix(h, static_cast<uint8_t>(kind));
+  const uint8_t count =
+      (frame.lineCount > DisplayFrame::kMaxLines) ? DisplayFrame::kMaxLines : frame.lineCount;
+  h = mix(h, count);
+  for (uint8_t i = 0; i < count; ++i)
+  {
+    const DisplayLine& line = frame.lines[i];
+    for (uint8_t c = 0; c < DisplayLine::kMaxLineLength && line.text[c] != '\0'; ++c)
+    {
+      h = mix(h, static_cast<uint8_t>(line.text[c]));
+    }
+    h = mix(h, 0);  // terminator keeps "AB"+"C" distinct from "A"+"BC"
+    h = mix(h, static_cast<uint8_t>(line.font));
+    h = mix16(h, line.y);
+  }
+  h = mix(h, frame.spinnerActive ? 1 : 0);
+  h = mix(h, frame.spinnerIndex);
+  h = mix(h, frame.showMenuTag ? 1 : 0);
+  h = mix(h, frame.progressBarEnabled ? 1 : 0);
+  if (frame.progressBarEnabled)
+  {
+    h = mix16(h, frame.progressX);
+    h = mix16(h, frame.progressY);
+    h = mix16(h, frame.progressWidth);
+    h = mix16(h, frame.progressHeight);
+    h = mix(h, frame.progressPercent);
+  }
+  return h;
+}
+
+uint32_t fingerprintAnomaly(uint8_t radPercent, uint8_t thermPercent,
+                            uint8_t chemPercent, uint8_t psyPercent,
+                            uint8_t radStage, uint8_t thermStage,
+                            uint8_t chemStage, uint8_t psyStage)
+{
+  uint32_t h = mix(kFnvOffset, kTagAnomaly);
+  h = mix(h, static_cast<uint8_t>(FrameKind::MainAnomaly));
+  h = mix(h, radPercent);
+  h = mix(h, thermPercent);
+  h = mix(h, chemPercent);
+  h = mix(h, psyPercent);
+  h = mix(h, radStage);
+  h = mix(h, thermStage);
+  h = mix(h, chemStage);
+  h = mix(h, psyStage);
+  return h;
+}
+
+bool FrameCache::shouldRender(uint32_t fingerprint)
+{
+  if (valid_ && fingerprint == last_)
+  {
+    ++skipped_;
+    return false;
+  }
+  last_ = fingerprint;
+  valid_ = true;
+  ++rendered_;
+  return true;
+}
+
+}  // namespace asap::display
+//
+// FrameCache.cpp
+// FNV-1a fingerprints over the render-relevant fields of DisplayFrame and the
+// anomaly HUD arguments, plus the skip/render bookkeeping used by wrappers.
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <stdint.h>
+
+#include <asap/display/DisplayTypes.h>
+
+namespace asap::display
+{
+
+// Cheap 32-bit fingerprints (FNV-1a) of what a wrapper is about to draw. Only
+// fields that influence the rendered pixels are hashed; unused line storage
+// past the terminating NUL is ignored, so frames built from scratch and frames
+// copied around hash identically.
+uint32_t fingerprintFrame(const DisplayFrame& frame, FrameKind kind);
+uint32_t fingerprintAnomaly(uint8_t radPercent, uint8_t thermPercent,
+                            uint8_t chemPercent, uint8_t psyPercent,
+                            uint8_t radStage, uint8_t thermStage,
+                            uint8_t chemStage, uint8_t psyStage);
+
+// Remembers the fingerprint of the last rendered content so wrappers can skip
+// both the redraw and the panel flush when nothing changed.
+class FrameCache
+{
+ public:
+  // Returns true when `fingerprint` differs from the last rendered content
+  // (and records it); false when the draw can be skipped.
+  bool shouldRender(uint32_t fingerprint);
+
+  // Force the next shouldRender() to return true (begin, rotation change).
+  void invalidate() { valid_ = false; }
+
+  uint32_t renderedCount() const { return rendered_; }
+  uint32_t skippedCount() const { return skipped_; }
+
+ private:
+  uint32_t last_ = 0;
+  bool valid_ = false;
+  uint32_t rendered_ = 0;
+  uint32_t skipped_ = 0;
+};
+
+}  // namespace asap::display
+//
+// FrameCache.h
+// Render-skipping support for the display wrappers. Most UI ticks recompose
+// the same idle HUD; fingerprinting the composed DisplayFrame (or the anomaly
+// indicator arguments) lets DetectorDisplay/NativeDisplay avoid clearing,
+// redrawing and flushing an unchanged buffer.
+//
+// Notes for maintainers
+// - When adding fields to DisplayFrame that affect rendering, hash them in
+//   fingerprintFrame() or identical-looking frames will be skipped.
+// - Anything that changes pixels without changing the frame (rotation,
+//   re-initialisation) must call invalidate().
@@ -0,0 +1,63 @@
+#ifndef ARDUINO
+
+#include <asap/display/InstrumentedU8g2.h>
+#include <asap/display/DirtyTiles.h>
+
+#include <string.h>  // strlen for glyph counts
+
+namespace asap::display
+{
+
+// Glyph box of the returned advance width, so the count does not depend on
+// how many pixels of each glyph happen to be set.
+u8g2_uint_t InstrumentedU8g2::drawStr(u8g2_uint_t x, u8g2_uint_t y, const char* s)
+{
+  const u8g2_uint_t width = ::U8G2::drawStr(x, y, s);
+  const int16_t height = static_cast<int16_t>(getAscent() - getDescent());
+  cost_.add(DrawPrimitive::Str, static_cast<uint32_t>(width) * static_cast<uint32_t>(height > 0 ? height : 0));
+  return width;
+}
+
+u8g2_uint_t InstrumentedU8g2::getStrWidth(const char* s)
+{
+  cost_.add(DrawPrimitive::StrWidth, s ? static_cast<uint32_t>(strlen(s)) : 0);
+  return ::U8G2::getStrWidth(s);
+}
+
+// The whole tile buffer: one page in page modes, the frame otherwise.
+void InstrumentedU8g2::clearBuffer()
+{
+  cost_.add(DrawPrimitive::Clear, static_cast<uint32_t>(getBufferTileHeight()) * kTileCols * kTileBytes * 8U);
+  ::U8G2::clearBuffer();
+}
+
+void InstrumentedU8g2::drawFrame(u8g2_uint_t x, u8g2_uint_t y, u8g2_uint_t w, u8g2_uint_t h)
+{
+  cost_.add(DrawPrimitive::Other, 2U * (static_cast<uint32_t>(w) + h));
+  ::U8G2::drawFrame(x, y, w, h);
+}
+
+// Area of the disc (pi/4 of its bounding square, 201/256).
+void InstrumentedU8g2::drawDisc(u8g2_uint_t x0, u8g2_uint_t y0, u8g2_uint_t rad, uint8_t opt)
+{
+  const uint32_t side = 2U * rad + 1U;
+  cost_.add(DrawPrimitive::Other, (side * side * 201U) >> 8);
+  ::U8G2::drawDisc(x0, y0, rad, opt);
+}
+
+// Circumference, 2*pi*r (201/32).
+void InstrumentedU8g2::drawCircle(u8g2_uint_t x0, u8g2_uint_t y0, u8g2_uint_t rad, uint8_t opt)
+{
+  cost_.add(DrawPrimitive::Other, (static_cast<uint32_t>(rad) * 201U) >> 5);
+  ::U8G2::drawCircle(x0, y0, rad, opt);
+}
+
+}  // namespace asap::display
+
+#endif  // ARDUINO
+//
+// InstrumentedU8g2.cpp
+// Out-of-line counters for the primitives whose unit count needs more than a
+// multiply. Pixel counts are what was requested, before clipping to the
+// current page or the panel.
+//
@@ -0,0 +1,60 @@
+#pragma once
+
+#ifndef ARDUINO
+
+#include <stdint.h>
+#include <U8g2lib.h>
+
+#include <asap/display/DrawCost.h>
+
+namespace asap::display
+{
+
+// Native drawing backend: a U8G2 that tallies every primitive the renderer
+// issues before forwarding it. U8G2's methods are not virtual, so the counts
+// only see calls made through this type; the renderer takes a U8g2Canvas
+// (DisplayRenderer.h), which is this class on native and ::U8G2 on the board.
+class InstrumentedU8g2 : public ::U8G2
+{
+ public:
+  void drawPixel(u8g2_uint_t x, u8g2_uint_t y)
+  {
+    cost_.add(DrawPrimitive::Pixel, 1);
+    ::U8G2::drawPixel(x, y);
+  }
+
+  void drawBox(u8g2_uint_t x, u8g2_uint_t y, u8g2_uint_t w, u8g2_uint_t h)
+  {
+    cost_.add(DrawPrimitive::Box, static_cast<uint32_t>(w) * h);
+    ::U8G2::drawBox(x, y, w, h);
+  }
+
+  void drawXBMP(u8g2_uint_t x, u8g2_uint_t y, u8g2_uint_t w, u8g2_uint_t h, const uint8_t* bitmap)
+  {
+    cost_.add(DrawPrimitive::Xbmp, static_cast<uint32_t>(w) * h);
+    ::U8G2::drawXBMP(x, y, w, h, bitmap);
+  }
+
+  u8g2_uint_t drawStr(u8g2_uint_t x, u8g2_uint_t y, const char* s);
+  u8g2_uint_t getStrWidth(const char* s);
+  void clearBuffer();
+
+  void drawFrame(u8g2_uint_t x, u8g2_uint_t y, u8g2_uint_t w, u8g2_uint_t h);
+  void drawDisc(u8g2_uint_t x0, u8g2_uint_t y0, u8g2_uint_t rad, uint8_t opt = U8G2_DRAW_ALL);
+  void drawCircle(u8g2_uint_t x0, u8g2_uint_t y0, u8g2_uint_t rad, uint8_t opt = U8G2_DRAW_ALL);
+
+  const DrawCost& cost() const { return cost_; }
+  void resetCost() { cost_.reset(); }
+
+ private:
+  DrawCost cost_{};
+};
+
+}  // namespace asap::display
+
+#endif  // ARDUINO
+//
+// InstrumentedU8g2.h
+// Counting U8G2 used by NativeDisplay and the renderer primitive tests. The
+// pixels drawn are exactly those of a plain U8G2; only the tallies are extra.
+//
@@ -3,8 +3,11 @@
 #include <asap/display/NativeDisplay.h>
 #include <asap/display/DisplayRenderer.h>
 #include <asap/display/DetectorDisplay.h>
+#include <asap/display/InstrumentedU8g2.h>
+#include <asap/display/PackedFrame.h>
+#include <asap/profile/Profiler.h>
 
-// Native-target U8g2 integration: we construct a plain U8G2 and
+// Native-target U8g2 integration: we construct a counting U8G2 and
 // configure it for the SSD1322 full buffer. The Arduino byte/gpio
 // callbacks are provided as no-ops in U8g2NativeStubs.cpp so we can
 // render entirely in-memory on the host and export snapshots.
@@ -14,6 +17,7 @@
 // Declare Arduino helper from U8x8lib.cpp (C++ linkage)
 void u8x8_SetPin_4Wire_HW_SPI(u8x8_t* u8x8, uint8_t cs, uint8_t dc, uint8_t reset);
 #include <fstream>
+#include <string.h>  // memcpy/memset for page compositing
 
 namespace asap::display
 {
@@ -24,8 +28,9 @@ constexpr uint16_t kDisplayWidth = 256;
 constexpr uint16_t kDisplayHeight = 64;
 }
 
-NativeDisplay::NativeDisplay(const DisplayPins& pins)
-    : pins_(pins)
+NativeDisplay::NativeDisplay(const DisplayPins& pins, BufferMode mode)
+    : pins_(pins),
+      mode_(mode)
 {
   lastFramePtr_ = new DisplayFrame{};
   lastFramePtr_->lineCount = 0;
@@ -33,6 +38,16 @@ NativeDisplay::NativeDisplay(const DisplayPins& pins)
   lastFramePtr_->spinnerIndex = 0;
 }
 
+NativeDisplay::~NativeDisplay()
+{
+  delete u8g2_;
+  delete lastFramePtr_;
+  delete[] ownBuffer_;
+  delete[] composite_;
+  delete bus_;
+  delete queue_;
+}
+
 bool NativeDisplay::begin()
 {
   ++beginCalls_;
@@ -40,14 +55,40 @@ bool NativeDisplay::begin()
   {
     return true;
   }
-  // Lazily construct and configure U8g2 for SSD1322 full-buffer mode.
+  // Lazily construct and configure U8g2 for the SSD1322 in the selected
+  // buffer mode (full frame or 1/2 tile-row pages).
   if (!u8g2_)
   {
-    u8g2_ = new ::U8G2();
-    u8g2_Setup_ssd1322_nhd_256x64_f(u8g2_->getU8g2(), U8G2_R0,
-                                     u8x8_byte_arduino_hw_spi,
-                                     u8x8_gpio_and_delay_arduino);
+    u8g2_ = new InstrumentedU8g2();
+    switch (mode_)
+    {
+      case BufferMode::Page1:
+        u8g2_Setup_ssd1322_nhd_256x64_1(u8g2_->getU8g2(), U8G2_R0,
+                                         u8x8_byte_arduino_hw_spi,
+                                         u8x8_gpio_and_delay_arduino);
+        break;
+      case BufferMode::Page2:
+        u8g2_Setup_ssd1322_nhd_256x64_2(u8g2_->getU8g2(), U8G2_R0,
+                                         u8x8_byte_arduino_hw_spi,
+                                         u8x8_gpio_and_delay_arduino);
+        break;
+      case BufferMode::Full:
+      default:
+        u8g2_Setup_ssd1322_nhd_256x64_f(u8g2_->getU8g2(), U8G2_R0,
+                                         u8x8_byte_arduino_hw_spi,
+                                         u8x8_gpio_and_delay_arduino);
+        break;
+    }
     // No pin mapping required on native; GPIO callback is a no-op
+    // The u8g2_Setup_* helpers hand every instance of a given mode the same
+    // static buffer; give each display its own so instances stay independent.
+    u8g2_t* raw = u8g2_->getU8g2();
+    ownBuffer_ = new uint8_t[static_cast<size_t>(raw->tile_buf_height) * kTileCols * kTileBytes]();
+    raw->tile_buf_ptr = ownBuffer_;
+    if (mode_ != BufferMode::Full)
+    {
+      composite_ = new uint8_t[kTileBufferBytes];
+    }
   }
   // Drive the in-memory buffer; nothing is sent to hardware on native.
   u8g2_->begin();
@@ -56,14 +97,84 @@ bool NativeDisplay::begin()
   u8g2_->setDrawColor(1);
   u8g2_->setFontDirection(0);
   u8g2_->clearBuffer();
+  if (composite_)
+  {
+    memset(composite_, 0, kTileBufferBytes);
+  }
+  tiles_.invalidate();
+  cache_.invalidate();
+  hud_.valid = false;
   if (rotation180_)
   {
     u8g2_->setDisplayRotation(U8G2_R2);
   }
+  attachBus();
   initialized_ = true;
   return true;
 }
 
+void NativeDisplay::enableSimulatedBus(uint32_t bytesPerMs)
+{
+  if (mode_ != BufferMode::Full)
+  {
+    return;  // paged output is sent from nextPage(), outside flush()
+  }
+  if (!queue_)
+  {
+    queue_ = new FlushQueue();
+  }
+  delete bus_;
+  bus_ = new SimulatedBus(bytesPerMs);
+  bus_->attach(*queue_);
+  // No kick hook: the simulated bus only moves when virtual time does.
+  queue_->setHooks(nullptr, &NativeDisplay::waitForBus, this);
+  attachBus();
+}
+
+// Route the U8x8 byte stream into the queue once the panel init sequence has
+// run, as DetectorDisplay does with the DMA link.
+void NativeDisplay::attachBus()
+{
+  if (!u8g2_ || !queue_)
+  {
+    return;
+  }
+  u8x8_t* u8x8 = u8g2_->getU8x8();
+  u8x8_SetUserPtr(u8x8, queue_);
+  u8x8->byte_cb = u8x8ByteFlushQueue;
+}
+
+void NativeDisplay::advanceBus(uint32_t elapsedMs)
+{
+  if (bus_)
+  {
+    bus_->advance(elapsedMs);
+  }
+}
+
+// Queue back-pressure: the producer blocks while the bus frees space.
+void NativeDisplay::waitForBus(void* context)
+{
+  NativeDisplay* self = static_cast<NativeDisplay*>(context);
+  if (self && self->bus_)
+  {
+    self->bus_->waitForRoom();
+  }
+}
+
+void NativeDisplay::flushAsync()
+{
+  if (initialized_)
+  {
+    flush();
+  }
+}
+
+bool NativeDisplay::isFlushing() const
+{
+  return queue_ && !queue_->empty();
+}
+
 void NativeDisplay::drawBootScreen(const char* versionText)
 {
   if (!initialized_ && !begin())
@@ -123,6 +234,8 @@ void NativeDisplay::setRotation180(bool enabled)
   rotation180_ = enabled;
   if (initialized_)
   {
+    cache_.invalidate();  // same frame, different pixels
+    hud_.valid = false;
     if (rotation180_)
     {
     u8g2_->setDisplayRotation(U8G2_R2);
@@ -144,65 +257,210 @@ void NativeDisplay::drawAnomalyIndicators(uint8_t radPercent, uint8_t thermPerce
     return;
   }
   lastKind_ = FrameKind::MainAnomaly;
-  drawAnomalyIndicatorsU8g2(*u8g2_, radPercent, thermPercent, chemPercent, psyPercent,
-                            radStage, thermStage, chemStage, psyStage);
+  if (!cache_.shouldRender(fingerprintAnomaly(radPercent, thermPercent, chemPercent, psyPercent,
+                                              radStage, thermStage, chemStage, psyStage)))
+  {
+    markSkipped();
+    return;
+  }
+  u8g2_->resetCost();
+  if (mode_ == BufferMode::Full && ASAP_DISPLAY_INCREMENTAL_HUD)
+  {
+    lastHudFull_ = updateAnomalyIndicatorsU8g2(*u8g2_, hud_,
+                                               radPercent, thermPercent, chemPercent, psyPercent,
+                                               radStage, thermStage, chemStage, psyStage,
+                                               &lastHudRect_);
+    lastCost_ = u8g2_->cost();
+    TileRect region{};
+    if (lastHudFull_ || !tileRectFor(lastHudRect_, rotation180_, region))
+    {
+      flush();
+    }
+    else
+    {
+      flush(region);
+    }
+    return;
+  }
+
+  if (mode_ == BufferMode::Full)
+  {
+    drawAnomalyIndicatorsU8g2(*u8g2_, radPercent, thermPercent, chemPercent, psyPercent,
+                              radStage, thermStage, chemStage, psyStage);
+  }
+  else
+  {
+    drawAnomalyIndicatorsPagedU8g2(*u8g2_, radPercent, thermPercent, chemPercent, psyPercent,
+                                   radStage, thermStage, chemStage, psyStage,
+                                   &NativeDisplay::capturePage, this);
+  }
+  lastCost_ = u8g2_->cost();
+  lastHudRect_ = DirtyRect{0, 0, static_cast<int16_t>(kDisplayWidth - 1),
+                           static_cast<int16_t>(kDisplayHeight - 1)};
+  lastHudFull_ = true;
+  flush();
 }
 
 void NativeDisplay::renderFrame(const DisplayFrame& frame, FrameKind kind)
 {
-  (void)kind;
   if (lastFramePtr_)
   {
     *lastFramePtr_ = frame;
   }
-  renderFrameU8g2(*u8g2_, frame);
+  if (!cache_.shouldRender(fingerprintFrame(frame, kind)))
+  {
+    markSkipped();
+    return;
+  }
+  hud_.valid = false;  // buffer no longer holds the anomaly HUD
+  u8g2_->resetCost();
+  if (mode_ == BufferMode::Full)
+  {
+    renderFrameU8g2(*u8g2_, frame);
+  }
+  else
+  {
+    renderFramePagedU8g2(*u8g2_, frame, &NativeDisplay::capturePage, this);
+  }
+  lastCost_ = u8g2_->cost();
+  flush();
 }
 
-uint8_t NativeDisplay::getPixel1bit(uint16_t x, uint16_t y) const
+// Page hook: copy the page that is about to be sent into the composite frame
+// so snapshots see exactly what the panel would receive.
+void NativeDisplay::capturePage(InstrumentedU8g2& u8g2, void* context)
 {
-  // U8g2’s SSD1322 full buffer is in “vertical-top” layout:
-  //  - Bytes are organized in strips of 8 vertical pixels.
-  //  - For (x,y): group = y/8, within = y%8, index = group*bytesPerRow + x.
-  //  - The bit for the pixel is (byte >> within)&1.
-  // This matches the library’s own capture helpers and avoids scrambled output.
-  if (!u8g2_)
-    return 0;
-  const uint8_t* buf = u8g2_->getBufferPtr();
-  const uint16_t tileWidthTiles = u8g2_->getBufferTileWidth();
-  const uint32_t bytesPerRow = static_cast<uint32_t>(tileWidthTiles) * 8u;
-  const uint32_t group = static_cast<uint32_t>(y) >> 3;  // y / 8
-  const uint8_t within = static_cast<uint8_t>(y & 7u);
-  const uint32_t index = group * bytesPerRow + static_cast<uint32_t>(x);
-  const uint8_t byte = buf[index];
-  const uint8_t mask = static_cast<uint8_t>(1u << within);
-  return (byte & mask) ? 1u : 0u;
+  NativeDisplay* self = static_cast<NativeDisplay*>(context);
+  const uint8_t row = u8g2.getBufferCurrTileRow();
+  if (!self || !self->composite_ || row >= kTileRows)
+  {
+    return;
+  }
+  uint8_t rows = u8g2.getBufferTileHeight();
+  if (row + rows > kTileRows)
+  {
+    rows = static_cast<uint8_t>(kTileRows - row);
+  }
+  const uint16_t rowBytes = static_cast<uint16_t>(kTileCols) * kTileBytes;
+  memcpy(self->composite_ + static_cast<uint32_t>(row) * rowBytes,
+         u8g2.getBufferPtr(),
+         static_cast<size_t>(rows) * rowBytes);
+}
+
+// Same partial-update path as DetectorDisplay::flush(). The byte callback is a
+// no-op on native, so this only records which tiles would hit the bus, unless
+// the simulated bus is enabled.
+void NativeDisplay::flush()
+{
+  flush(TileRect{0, 0, kTileCols - 1, kTileRows - 1});
+}
+
+void NativeDisplay::flush(const TileRect& region)
+{
+  TileSpan spans[kTileRows];
+  if (queue_)
+  {
+    // DetectorDisplay's async path: queue only what fits on the bus.
+    ASAP_PROFILE_SCOPE(asap::profile::kProbeSendBuffer);
+    const TileRect all{0, 0, kTileCols - 1, kTileRows - 1};
+    const uint8_t count = tiles_.scan(frameBuffer(), spans, flushPending_ ? all : region);
+    if (count > 0)
+    {
+      queue_->beginFrame(++frameSeq_);
+    }
+    lastSentTiles_ = sendSpansThatFit(*u8g2_, tiles_, frameBuffer(), spans, count, *queue_,
+                                      lastTileSpans_, flushPending_);
+    lastDirtyTiles_ = tiles_.lastDirtyTiles();
+    return;
+  }
+  const uint8_t count = tiles_.collect(frameBuffer(), spans, region);
+  if (mode_ != BufferMode::Full)
+  {
+    // Page modes already sent every page from nextPage(); the diff is only
+    // informative here.
+    lastDirtyTiles_ = tiles_.lastDirtyTiles();
+    lastSentTiles_ = static_cast<uint16_t>(kTileCols) * kTileRows;
+    lastTileSpans_ = kTileRows;
+    return;
+  }
+  ASAP_PROFILE_SCOPE(asap::profile::kProbeSendBuffer);
+  for (uint8_t i = 0; i < count; ++i)
+  {
+    u8g2_->updateDisplayArea(spans[i].firstCol, spans[i].row, spans[i].width, 1);
+  }
+  lastDirtyTiles_ = tiles_.lastDirtyTiles();
+  lastSentTiles_ = tiles_.lastSentTiles();
+  lastTileSpans_ = count;
+}
+
+// A skipped frame leaves the buffer untouched and sends nothing.
+void NativeDisplay::markSkipped()
+{
+  lastCost_.reset();
+  lastDirtyTiles_ = 0;
+  lastSentTiles_ = 0;
+  lastTileSpans_ = 0;
 }
 
-bool NativeDisplay::writeSnapshot(const char* filePath) const
+bool NativeDisplay::writeSnapshot(const char* filePath, SnapshotFormat format) const
 {
-  if (!filePath || !initialized_)
+  if (!filePath || !initialized_ || !frameBuffer())
   {
     return false;
   }
+  // Transpose the vertical-top tiles into scanlines once, then write the
+  // whole raster in a single call.
+  uint8_t packed[kPackedFrameBytes];
+  packFrameRowMajor(frameBuffer(), packed);
+
   std::ofstream out(filePath, std::ios::binary);
   if (!out)
   {
     return false;
   }
-  out << "P5\n" << kDisplayWidth << " " << kDisplayHeight << "\n15\n";
-
-  for (uint16_t y = 0; y < kDisplayHeight; ++y)
+  if (format == SnapshotFormat::Pbm1)
   {
-    for (uint16_t x = 0; x < kDisplayWidth; ++x)
+    // PBM bit 1 is black; the panel lights set pixels, so invert.
+    for (uint16_t i = 0; i < kPackedFrameBytes; ++i)
     {
-      const uint8_t bit = getPixel1bit(x, y);
-      const uint8_t val = static_cast<uint8_t>(bit ? 15 : 0);
-      out.put(static_cast<char>(val));
+      packed[i] = static_cast<uint8_t>(~packed[i]);
     }
+    out << "P4\n" << kDisplayWidth << " " << kDisplayHeight << "\n";
+    out.write(reinterpret_cast<const char*>(packed), kPackedFrameBytes);
+    return static_cast<bool>(out);
   }
+
+  static constexpr uint32_t kPixels = static_cast<uint32_t>(kDisplayWidth) * kDisplayHeight;
+  uint8_t pixels[kPixels];
+  expandPackedFrame(packed, 15, pixels);
+  out << "P5\n" << kDisplayWidth << " " << kDisplayHeight << "\n15\n";
+  out.write(reinterpret_cast<const char*>(pixels), kPixels);
   return static_cast<bool>(out);
 }
 
+uint8_t NativeDisplay::pagesPerFrame() const
+{
+  switch (mode_)
+  {
+    case BufferMode::Page1:
+      return kTileRows;
+    case BufferMode::Page2:
+      return kTileRows / 2;
+    case BufferMode::Full:
+    default:
+      return 1;
+  }
+}
+
+const uint8_t* NativeDisplay::frameBuffer() const
+{
+  if (composite_)
+  {
+    return composite_;
+  }
+  return u8g2_ ? u8g2_->getBufferPtr() : nullptr;
+}
+
 const DisplayFrame& NativeDisplay::lastFrame() const
 {
   return *lastFramePtr_;
@@ -216,7 +474,7 @@ extern "C" void asap_display_native_anchor() {}
 //
 // NativeDisplay.cpp
 // Host implementation of the ASAP display using U8g2’s full buffer for the
-// SSD1322 controller. This constructs a base U8G2, configures it with no-op
+// SSD1322 controller. This constructs an InstrumentedU8g2, configures it with no-op
 // Arduino callbacks, and renders via shared helpers. The buffer is decoded as
-// vertical-top for 4-bit PGM snapshot export to mirror hardware.
+// vertical-top for 4-bit PGM (or packed PBM) snapshot export to mirror hardware.
 //
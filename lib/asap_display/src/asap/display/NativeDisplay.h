@@ -4,16 +4,47 @@
 
 #include <stdint.h>
 #include <vector>
+#include <asap/display/DisplayConfig.h>
 #include <asap/display/DisplayTypes.h>
-class U8G2;  // forward declare base class to avoid exposing heavy header here
-
+#include <asap/display/DirtyTiles.h>
+#include <asap/display/DrawCost.h>
+#include <asap/display/FrameCache.h>
+#include <asap/display/FlushQueue.h>
 namespace asap::display
 {
 
+class InstrumentedU8g2;  // counting U8G2; forward declared to keep U8g2lib out of here
+
+// U8g2 buffer strategy of the native display (see ASAP_DISPLAY_PAGE_TILES).
+enum class BufferMode : uint8_t
+{
+  Full,   // _f: whole frame in RAM, drawn once
+  Page1,  // _1: one tile row per page, drawn 8 times
+  Page2,  // _2: two tile rows per page, drawn 4 times
+};
+
+#if ASAP_DISPLAY_PAGE_TILES == 1
+constexpr BufferMode kDefaultBufferMode = BufferMode::Page1;
+#elif ASAP_DISPLAY_PAGE_TILES == 2
+constexpr BufferMode kDefaultBufferMode = BufferMode::Page2;
+#else
+constexpr BufferMode kDefaultBufferMode = BufferMode::Full;
+#endif
+
+// Image format written by NativeDisplay::writeSnapshot().
+enum class SnapshotFormat : uint8_t
+{
+  Pgm4,  // P5, MaxVal 15: lit pixels 15, one byte per pixel
+  Pbm1,  // P4, packed 1 bit per pixel: lit pixels white (bit 0), 2 KB payload
+};
+
 class NativeDisplay
 {
  public:
-  explicit NativeDisplay(const DisplayPins& pins);
+  explicit NativeDisplay(const DisplayPins& pins, BufferMode mode = kDefaultBufferMode);
+  ~NativeDisplay();
+  NativeDisplay(const NativeDisplay&) = delete;
+  NativeDisplay& operator=(const NativeDisplay&) = delete;
 
   bool begin();
   void drawBootScreen(const char* versionText);
@@ -34,19 +65,84 @@ class NativeDisplay
                              uint8_t radStage, uint8_t thermStage,
                              uint8_t chemStage, uint8_t psyStage);
 
-  bool writeSnapshot(const char* filePath) const;  // PGM P5, MaxVal 15
+  bool writeSnapshot(const char* filePath,
+                     SnapshotFormat format = SnapshotFormat::Pgm4) const;
+
+  // Region touched by the last anomaly HUD update and whether it was a full
+  // redraw (first frame, kind switch, rotation) rather than an increment.
+  const DirtyRect& lastAnomalyDirtyRect() const { return lastHudRect_; }
+  bool lastAnomalyFullRedraw() const { return lastHudFull_; }
+
+  // Full 256x64 frame (kTileBufferBytes, U8g2 tile layout). In page modes this
+  // is the composite of every page sent for the last frame.
+  const uint8_t* frameBuffer() const;
+  BufferMode bufferMode() const { return mode_; }
+
+  // Dirty-tile statistics of the last rendered frame, mirroring what the
+  // embedded wrapper pushes over SPI (256 tiles = full frame).
+  uint16_t lastDirtyTileCount() const { return lastDirtyTiles_; }
+  uint16_t lastSentTileCount() const { return lastSentTiles_; }
+  uint8_t lastTileSpanCount() const { return lastTileSpans_; }
+
+  // U8g2 primitives issued for the last rendered frame (all pages in page
+  // modes; zero for a skipped frame). Check against drawBudgetFor(kind) with
+  // withinDrawBudget(cost, kind, pagesPerFrame()).
+  const DrawCost& lastFrameCost() const { return lastCost_; }
+  uint8_t pagesPerFrame() const;
+
+  // Render-skip statistics (unchanged frames are neither redrawn nor sent).
+  uint32_t renderedFrameCount() const { return cache_.renderedCount(); }
+  uint32_t skippedFrameCount() const { return cache_.skippedCount(); }
+
+  // Simulated SPI link (full buffer only): panel output goes through a
+  // FlushQueue that drains at `bytesPerMs` as advanceBus() moves virtual
+  // time forward, mirroring the DMA flush of ASAP_DISPLAY_ASYNC_FLUSH.
+  // Without it the panel is written synchronously (and discarded).
+  void enableSimulatedBus(uint32_t bytesPerMs);
+  void advanceBus(uint32_t elapsedMs);
+  const SimulatedBus* simulatedBus() const { return bus_; }
+
+  // Queue the composed buffer for the panel and return without waiting for
+  // the bus. Render calls do this themselves; isFlushing() stays true until
+  // every queued byte has been clocked out.
+  void flushAsync();
+  bool isFlushing() const;
+  // Dirty tiles the queue could not take yet (simulated bus only); call
+  // flushAsync() again once the bus has drained some.
+  bool flushPending() const { return flushPending_; }
 
  private:
   void renderFrame(const DisplayFrame& frame, FrameKind kind);
-  uint8_t getPixel1bit(uint16_t x, uint16_t y) const;
+  void flush();
+  void flush(const TileRect& region);
+  void markSkipped();
+  static void capturePage(InstrumentedU8g2& u8g2, void* context);
+  static void waitForBus(void* context);
+  void attachBus();
 
   DisplayPins pins_;
-  U8G2* u8g2_ = nullptr;
+  BufferMode mode_;
+  InstrumentedU8g2* u8g2_ = nullptr;
+  uint8_t* ownBuffer_ = nullptr;  // per-instance U8g2 tile buffer
+  uint8_t* composite_ = nullptr;  // page modes only: assembled full frame
   bool initialized_ = false;
   DisplayFrame* lastFramePtr_ = nullptr;
   FrameKind lastKind_ = FrameKind::None;
   uint32_t beginCalls_ = 0;
   bool rotation180_ = false;
+  DirtyTileTracker tiles_;
+  uint16_t lastDirtyTiles_ = 0;
+  uint16_t lastSentTiles_ = 0;
+  uint8_t lastTileSpans_ = 0;
+  DrawCost lastCost_{};
+  FrameCache cache_;
+  AnomalyHudState hud_{};
+  DirtyRect lastHudRect_ = DirtyRect::none();
+  bool lastHudFull_ = false;
+  FlushQueue* queue_ = nullptr;  // simulated bus only
+  SimulatedBus* bus_ = nullptr;
+  uint16_t frameSeq_ = 0;
+  bool flushPending_ = false;
 };
 
 }  // namespace asap::display
@@ -54,13 +150,15 @@ class NativeDisplay
 #endif  // ARDUINO
 //
 // NativeDisplay.h
-// Host-side U8g2 wrapper used by snapshot tests. Owns a plain U8G2 instance
-// configured for SSD1322 full-buffer mode and exposes the same API surface as
+// Host-side U8g2 wrapper used by snapshot tests. Owns an InstrumentedU8g2
+// configured for SSD1322 full-buffer or page-buffer mode and exposes the same API surface as
 // the embedded DetectorDisplay. Rendering is delegated to the shared U8g2
 // renderer so layouts stay pixel-identical across platforms.
 //
 // Notes for maintainers
 // - This header avoids including U8g2 to keep dependencies light; the .cpp
 //   performs the concrete setup with U8g2lib.
-// - Snapshot export writes 4-bit PGM (P5, MaxVal 15) decoded from U8g2’s
-//   vertical-top buffer layout.
+// - The canvas counts draw primitives per frame (lastFrameCost()), so any
+//   test that renders a frame can also gate its estimated STM32 cost.
+// - Snapshot export writes 4-bit PGM (P5, MaxVal 15) or packed PBM (P4),
+//   transposed from U8g2’s vertical-top buffer layout by PackedFrame.h.
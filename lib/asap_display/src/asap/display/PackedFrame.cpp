@@ -0,0 +1,65 @@
+#include <asap/display/PackedFrame.h>
+
+namespace asap::display
+{
+
+namespace
+{
+// Gathers bit 0 of each byte of a 64-bit word into the top byte, byte 0
+// ending up in the MSB.
+constexpr uint64_t kLowBits = 0x0101010101010101ULL;
+constexpr uint64_t kGather = 0x8040201008040201ULL;
+}  // namespace
+
+void packFrameRowMajor(const uint8_t* tileBuffer, uint8_t* packed)
+{
+  if (!tileBuffer || !packed)
+  {
+    return;
+  }
+  for (uint8_t tileRow = 0; tileRow < kTileRows; ++tileRow)
+  {
+    const uint8_t* tiles = tileBuffer + static_cast<uint32_t>(tileRow) * kTileCols * kTileBytes;
+    uint8_t* rows = packed + static_cast<uint32_t>(tileRow) * 8U * kPackedRowBytes;
+    for (uint8_t col = 0; col < kTileCols; ++col)
+    {
+      // Byte c of the tile holds pixel column c, bit r = pixel row r.
+      const uint8_t* tile = tiles + static_cast<uint32_t>(col) * kTileBytes;
+      uint64_t word = 0;
+      for (uint8_t c = 0; c < 8; ++c)
+      {
+        word |= static_cast<uint64_t>(tile[c]) << (8U * c);
+      }
+      for (uint8_t r = 0; r < 8; ++r)
+      {
+        const uint64_t bits = (word >> r) & kLowBits;
+        rows[static_cast<uint32_t>(r) * kPackedRowBytes + col] =
+            static_cast<uint8_t>((bits * kGather) >> 56);
+      }
+    }
+  }
+}
+
+void expandPackedFrame(const uint8_t* packed, uint8_t on, uint8_t* pixels)
+{
+  if (!packed || !pixels)
+  {
+    return;
+  }
+  for (uint16_t i = 0; i < kPackedFrameBytes; ++i)
+  {
+    const uint8_t byte = packed[i];
+    for (uint8_t bit = 0; bit < 8; ++bit)
+    {
+      *pixels++ = (byte & (0x80U >> bit)) ? on : 0;
+    }
+  }
+}
+
+}  // namespace asap::display
+//
+// PackedFrame.cpp
+// The gather multiply moves bit 0 of byte c to bit 63 - c; the partial
+// products of other bytes either overflow past bit 63 or stay below bit 56,
+// so the top byte is exactly one tile scanline.
+//
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <stdint.h>
+
+#include <asap/display/DirtyTiles.h>
+
+namespace asap::display
+{
+
+// Row-major 1 bpp frame: 64 scanlines of 32 bytes, MSB = leftmost pixel,
+// bit set = lit pixel. This is the layout of a PBM (P4) raster.
+constexpr uint16_t kPackedRowBytes = kTileCols;  // 256 px / 8
+constexpr uint16_t kPackedFrameBytes =
+    static_cast<uint16_t>(kPackedRowBytes) * kTileRows * 8U;
+
+// Transpose a U8g2 vertical-top tile buffer (kTileBufferBytes) into the
+// packed row-major layout, one 8x8 tile at a time.
+void packFrameRowMajor(const uint8_t* tileBuffer, uint8_t* packed);
+
+// Expand a packed frame to one byte per pixel (`on` for lit, 0 otherwise),
+// e.g. on = 15 for the 4-bit PGM snapshots.
+void expandPackedFrame(const uint8_t* packed, uint8_t on, uint8_t* pixels);
+
+}  // namespace asap::display
+//
+// PackedFrame.h
+// Frame layout conversion for snapshot export. U8g2 stores each 8-pixel
+// column strip as one byte; image files want scanlines. Converting a whole
+// tile at once replaces 16,384 per-pixel lookups with 256 tile transposes.
+//
@@ -0,0 +1,181 @@
+#ifdef ARDUINO
+
+#include <asap/display/SpiDmaLink.h>
+
+#include <Arduino.h>  // STM32duino core: HAL headers, digitalWrite, IRQ masking
+
+namespace asap::display
+{
+
+namespace
+{
+SPI_HandleTypeDef gSpi;
+DMA_HandleTypeDef gDmaTx;
+FlushQueue* gQueue = nullptr;
+uint8_t gCsPin = 0;
+uint8_t gDcPin = 0;
+uint8_t gDcLevel = 0xFF;  // unknown until the first segment
+volatile bool gBusy = false;
+volatile uint16_t gInFlight = 0;
+volatile uint32_t gErrors = 0;
+
+void waitShifterIdle()
+{
+  while (__HAL_SPI_GET_FLAG(&gSpi, SPI_FLAG_BSY))
+  {
+  }
+}
+
+void releaseBus()
+{
+  waitShifterIdle();
+  digitalWrite(gCsPin, HIGH);
+  gBusy = false;
+}
+
+// Start the next chunk, or release the bus when the queue is empty. Runs with
+// the DMA idle: from kick() (interrupts masked) or the completion interrupt.
+void startNext()
+{
+  FlushChunk chunk{};
+  if (!gQueue || !gQueue->peek(chunk))
+  {
+    releaseBus();
+    return;
+  }
+  if (chunk.dc != gDcLevel)
+  {
+    waitShifterIdle();  // D/C is sampled with the last bit of each byte
+    digitalWrite(gDcPin, chunk.dc ? HIGH : LOW);
+    gDcLevel = chunk.dc;
+  }
+  gBusy = true;
+  gInFlight = chunk.length;
+  if (HAL_SPI_Transmit_DMA(&gSpi, const_cast<uint8_t*>(chunk.data), chunk.length) != HAL_OK)
+  {
+    // Should not happen with the DMA idle. Leave the chunk queued and drop
+    // the bus; the next kick() retries it from thread context.
+    ++gErrors;
+    gInFlight = 0;
+    releaseBus();
+  }
+}
+}  // namespace
+
+bool SpiDmaLink::begin(FlushQueue& queue, uint8_t chipSelectPin, uint8_t dataCommandPin)
+{
+  gQueue = &queue;
+  gCsPin = chipSelectPin;
+  gDcPin = dataCommandPin;
+  gDcLevel = 0xFF;
+
+  __HAL_RCC_SPI1_CLK_ENABLE();
+  __HAL_RCC_DMA1_CLK_ENABLE();
+
+  // SSD1322: mode 0, MSB first, <= 10 MHz. PCLK2 = 72 MHz / 8 = 9 MHz.
+  gSpi.Instance = SPI1;
+  gSpi.Init.Mode = SPI_MODE_MASTER;
+  gSpi.Init.Direction = SPI_DIRECTION_2LINES;
+  gSpi.Init.DataSize = SPI_DATASIZE_8BIT;
+  gSpi.Init.CLKPolarity = SPI_POLARITY_LOW;
+  gSpi.Init.CLKPhase = SPI_PHASE_1EDGE;
+  gSpi.Init.NSS = SPI_NSS_SOFT;
+  gSpi.Init.BaudRatePrescaler = SPI_BAUDRATEPRESCALER_8;
+  gSpi.Init.FirstBit = SPI_FIRSTBIT_MSB;
+  gSpi.Init.TIMode = SPI_TIMODE_DISABLE;
+  gSpi.Init.CRCCalculation = SPI_CRCCALCULATION_DISABLE;
+  gSpi.Init.CRCPolynomial = 7;
+  if (HAL_SPI_Init(&gSpi) != HAL_OK)
+  {
+    return false;
+  }
+
+  gDmaTx.Instance = DMA1_Channel3;  // SPI1_TX request
+  gDmaTx.Init.Direction = DMA_MEMORY_TO_PERIPH;
+  gDmaTx.Init.PeriphInc = DMA_PINC_DISABLE;
+  gDmaTx.Init.MemInc = DMA_MINC_ENABLE;
+  gDmaTx.Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+  gDmaTx.Init.MemDataAlignment = DMA_MDATAALIGN_BYTE;
+  gDmaTx.Init.Mode = DMA_NORMAL;
+  gDmaTx.Init.Priority = DMA_PRIORITY_LOW;
+  if (HAL_DMA_Init(&gDmaTx) != HAL_OK)
+  {
+    return false;
+  }
+  __HAL_LINKDMA(&gSpi, hdmatx, gDmaTx);
+
+  HAL_NVIC_SetPriority(DMA1_Channel3_IRQn, 6, 0);
+  HAL_NVIC_EnableIRQ(DMA1_Channel3_IRQn);
+
+  queue.setHooks(&SpiDmaLink::kick, &SpiDmaLink::stall, nullptr);
+  return true;
+}
+
+bool SpiDmaLink::busy()
+{
+  return gBusy;
+}
+
+uint32_t SpiDmaLink::errors()
+{
+  return gErrors;
+}
+
+void SpiDmaLink::kick(void* context)
+{
+  (void)context;
+  noInterrupts();
+  if (!gBusy)
+  {
+    digitalWrite(gCsPin, LOW);
+    startNext();
+  }
+  interrupts();
+}
+
+void SpiDmaLink::stall(void* context)
+{
+  kick(context);
+  while (gQueue && !gQueue->hasRoom())
+  {
+    // The completion interrupt frees space; if a start failed the bus is
+    // idle with data queued, so try again from here.
+    if (!gBusy)
+    {
+      kick(context);
+    }
+  }
+}
+
+void SpiDmaLink::onTransferComplete()
+{
+  if (gQueue)
+  {
+    gQueue->consume(gInFlight);
+  }
+  gInFlight = 0;
+  startNext();
+}
+
+}  // namespace asap::display
+
+extern "C" void DMA1_Channel3_IRQHandler(void)
+{
+  HAL_DMA_IRQHandler(&::asap::display::gDmaTx);
+}
+
+extern "C" void HAL_SPI_TxCpltCallback(SPI_HandleTypeDef* spi)
+{
+  if (spi == &::asap::display::gSpi)
+  {
+    ::asap::display::SpiDmaLink::onTransferComplete();
+  }
+}
+
+#endif  // ARDUINO
+//
+// SpiDmaLink.cpp
+// HAL plumbing for the SSD1322 DMA flush. HAL_SPI_Transmit_DMA() waits for
+// the shifter to drain before raising TxCplt, so each completion marks the
+// chunk as really on the wire and the next one can start immediately.
+//
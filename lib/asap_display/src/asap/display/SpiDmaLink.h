@@ -0,0 +1,46 @@
+#pragma once
+
+#ifdef ARDUINO
+
+#include <stdint.h>
+#include <asap/display/FlushQueue.h>
+
+namespace asap::display
+{
+
+// Drains a FlushQueue into the SSD1322 over SPI1 with DMA1 channel 3 (the
+// SPI1_TX request on the STM32F103). Chip select is held low while the queue
+// has data and released when it runs dry; D/C is switched between segments
+// once the SPI shifter is idle. There is one SPI1, so the link is a singleton.
+class SpiDmaLink
+{
+ public:
+  // Take over SPI1 for `queue`. Call after U8g2::begin() has run the panel
+  // init sequence (pins are already in their SPI alternate function).
+  static bool begin(FlushQueue& queue, uint8_t chipSelectPin, uint8_t dataCommandPin);
+
+  static bool busy();
+  // DMA starts the HAL refused. The chunk stays queued and goes out on the
+  // next kick().
+  static uint32_t errors();
+
+  // FlushQueue hooks.
+  static void kick(void* context);   // start a DMA transfer if idle
+  // Spin until the DMA frees queue space. Dirty-tile flushes only queue
+  // what fits, so this is reached only by sendBuffer() without them.
+  static void stall(void* context);
+
+  // DMA transfer-complete path (called from the HAL SPI callback).
+  static void onTransferComplete();
+};
+
+}  // namespace asap::display
+
+#endif  // ARDUINO
+//
+// SpiDmaLink.h
+// Embedded back end of ASAP_DISPLAY_ASYNC_FLUSH. The main loop only copies
+// converted tile bytes into the FlushQueue; clocking them out happens in the
+// DMA interrupt, so a dirty-tile update returns long before it reaches the
+// panel.
+//
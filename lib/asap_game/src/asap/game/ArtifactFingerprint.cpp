@@ -0,0 +1,203 @@
+#include <asap/game/ArtifactFingerprint.h>
+
+namespace asap::game
+{
+
+namespace
+{
+// Bits of the hash each gap takes: enough for kGapLevels.
+constexpr uint8_t kGapBits = 3;
+static_assert((1u << kGapBits) >= Fingerprint::kGapLevels, "kGapBits too small for kGapLevels");
+static_assert(static_cast<uint32_t>(Fingerprint::kPings - 1) * kGapBits <= 32, "fingerprint needs more hash bits");
+
+uint32_t mix(uint32_t h)
+{
+  h ^= h >> 16;
+  h *= 0x7FEB352Du;
+  h ^= h >> 15;
+  h *= 0x846CA68Bu;
+  h ^= h >> 16;
+  return h;
+}
+
+// Not heard for forgetMs at nowMs (wrap-safe; a ping stamped just after the
+// caller read the clock is not "older than old").
+inline bool forgotten(const ArtifactTrack& t, uint32_t nowMs, uint32_t forgetMs)
+{
+  return static_cast<int32_t>(nowMs - t.lastMs) >= static_cast<int32_t>(forgetMs);
+}
+}  // namespace
+
+// ---- Fingerprint ------------------------------------------------------------
+
+Fingerprint Fingerprint::of(uint16_t id, uint16_t signature)
+{
+  Fingerprint f;
+  const uint32_t h = mix((static_cast<uint32_t>(signature) << 16) | id);
+  for (uint8_t i = 0; i + 1 < kPings; ++i)
+  {
+    const uint32_t level = ((h >> (kGapBits * i)) & ((1u << kGapBits) - 1u)) % kGapLevels;
+    f.gapMs[i] = static_cast<uint16_t>(kGapBaseMs + level * kGapStepMs);
+  }
+  return f;
+}
+
+uint32_t Fingerprint::offsetMs(uint8_t index) const
+{
+  uint32_t ms = 0;
+  for (uint8_t i = 0; i < index && i + 1 < kPings; ++i)
+  {
+    ms += gapMs[i];
+  }
+  return ms;
+}
+
+// ---- ArtifactCorrelator -----------------------------------------------------
+
+ArtifactCorrelator::ArtifactCorrelator(const CorrelatorConfig& config)
+    : config_(config), slots_{}, matches_(0), mismatches_(0)
+{
+  if (config_.confirmGaps == 0)
+  {
+    config_.confirmGaps = 1;
+  }
+}
+
+ArtifactCorrelator::Ping ArtifactCorrelator::onPing(uint16_t id, uint16_t signature, uint8_t index,
+                                                   uint32_t nowMs)
+{
+  if (id == 0 || index >= Fingerprint::kPings)
+  {
+    return Ping::Ignored;
+  }
+  ArtifactTrack* t = claim(id, nowMs);
+  if (!t)
+  {
+    return Ping::Ignored;
+  }
+  // Heard again after it should have been forgotten (expire() not run yet):
+  // a new sighting, not a long gap in the old one.
+  if (t->id != id || t->signature != signature || forgotten(*t, nowMs, config_.forgetMs))
+  {
+    *t = ArtifactTrack{};
+    t->id = id;
+    t->signature = signature;
+    t->fingerprint = Fingerprint::of(id, signature);
+    t->lastIndex = index;
+    t->firstMs = nowMs;
+    t->lastMs = nowMs;
+    return Ping::First;
+  }
+
+  const Fingerprint& f = t->fingerprint;
+  const uint32_t elapsed = nowMs - t->lastMs;
+  const uint8_t from = t->lastIndex;
+  t->lastIndex = index;
+  t->lastMs = nowMs;
+
+  if (index > from)
+  {
+    const uint32_t expected = f.offsetMs(index) - f.offsetMs(from);
+    const uint32_t slack = static_cast<uint32_t>(config_.toleranceMs) * (index - from);
+    const uint32_t off = elapsed > expected ? elapsed - expected : expected - elapsed;
+    if (off <= slack)
+    {
+      ++matches_;
+      if (t->score < 255)
+      {
+        ++t->score;
+      }
+      if (!t->recognized && t->score >= config_.confirmGaps)
+      {
+        t->recognized = true;
+        t->recognizedMs = nowMs;
+        return Ping::Recognized;
+      }
+      return Ping::Match;
+    }
+  }
+  // The earliest a later cycle's ping `index` can come: the rest of this
+  // cycle, a rest longer than any gap, and the new cycle up to `index`.
+  const uint32_t nextCycleMs = f.spanMs() - f.offsetMs(from) + Fingerprint::kMaxGapMs + f.offsetMs(index);
+  if (elapsed + config_.toleranceMs >= nextCycleMs)
+  {
+    return Ping::NewCycle;
+  }
+  ++mismatches_;
+  t->score = 0;
+  return Ping::Mismatch;
+}
+
+uint8_t ArtifactCorrelator::expire(uint32_t nowMs)
+{
+  uint8_t dropped = 0;
+  for (ArtifactTrack& t : slots_)
+  {
+    if (t.id != 0 && forgotten(t, nowMs, config_.forgetMs))
+    {
+      t = ArtifactTrack{};
+      ++dropped;
+    }
+  }
+  return dropped;
+}
+
+const ArtifactTrack* ArtifactCorrelator::find(uint16_t id) const
+{
+  for (const ArtifactTrack& t : slots_)
+  {
+    if (id != 0 && t.id == id)
+    {
+      return &t;
+    }
+  }
+  return nullptr;
+}
+
+bool ArtifactCorrelator::recognized(uint16_t id) const
+{
+  const ArtifactTrack* t = find(id);
+  return t && t->recognized;
+}
+
+uint8_t ArtifactCorrelator::recognizedCount() const
+{
+  uint8_t n = 0;
+  for (const ArtifactTrack& t : slots_)
+  {
+    n += t.id != 0 && t.recognized;
+  }
+  return n;
+}
+
+// The artifact's slot, else a free one (forgotten counts as free), else the
+// one heard longest ago that is not recognized yet. Recognized artifacts are
+// only dropped once forgotten.
+ArtifactTrack* ArtifactCorrelator::claim(uint16_t id, uint32_t nowMs)
+{
+  ArtifactTrack* free = nullptr;
+  ArtifactTrack* oldest = nullptr;
+  for (ArtifactTrack& t : slots_)
+  {
+    if (t.id == id)
+    {
+      return &t;
+    }
+    if (t.id == 0 || forgotten(t, nowMs, config_.forgetMs))
+    {
+      free = free ? free : &t;
+    }
+    else if (!t.recognized && (!oldest || nowMs - t.lastMs > nowMs - oldest->lastMs))
+    {
+      oldest = &t;
+    }
+  }
+  return free ? free : oldest;
+}
+
+}  // namespace asap::game
+//
+// ArtifactFingerprint.cpp
+// Integer arithmetic on a handful of bytes per reception; the radio task
+// runs it for every artifact packet it decodes.
+//
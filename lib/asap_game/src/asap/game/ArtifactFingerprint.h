@@ -0,0 +1,122 @@
+#pragma once
+
+#include <stdint.h>
+
+// Pings per artifact fingerprint cycle (override with -D in platformio.ini).
+// The gaps between them are the fingerprint; ArtifactMsg PingIndex is the
+// position in the cycle.
+#ifndef ASAP_ARTIFACT_PINGS
+#define ASAP_ARTIFACT_PINGS 4
+#endif
+
+// Artifacts a detector correlates at once, 28 bytes each.
+#ifndef ASAP_ARTIFACT_SLOTS
+#define ASAP_ARTIFACT_SLOTS 8
+#endif
+
+namespace asap::game
+{
+
+// Timing fingerprint of one artifact: the gaps between the pings of a cycle,
+// each one of kGapLevels steps on a kGapStepMs grid, hashed from the
+// artifact's ID and signature. A detector derives the same gaps from the
+// packet's header and Signature field.
+struct Fingerprint
+{
+  static constexpr uint8_t kPings = ASAP_ARTIFACT_PINGS;
+  static constexpr uint16_t kGapBaseMs = 200;
+  static constexpr uint16_t kGapStepMs = 40;
+  static constexpr uint8_t kGapLevels = 8;
+  static constexpr uint16_t kMaxGapMs = kGapBaseMs + (kGapLevels - 1) * kGapStepMs;
+  static constexpr uint32_t kMaxSpanMs = static_cast<uint32_t>(kPings - 1) * kMaxGapMs;
+  // Cycles of an artifact start at least this far apart, so the rest after
+  // the last ping is always longer than any gap inside a cycle.
+  static constexpr uint32_t kMinCycleMs = 2 * (kMaxSpanMs + kMaxGapMs);
+  static_assert(kPings >= 2, "ASAP_ARTIFACT_PINGS must be at least 2");
+
+  uint16_t gapMs[kPings - 1];  // ping i to ping i + 1
+
+  static Fingerprint of(uint16_t id, uint16_t signature);
+
+  // Ping 0 to ping `index`.
+  uint32_t offsetMs(uint8_t index) const;
+  uint32_t spanMs() const { return offsetMs(kPings - 1); }
+};
+
+struct CorrelatorConfig
+{
+  uint16_t toleranceMs = 8;       // per gap: TX/RX latency and timestamp jitter
+  uint8_t confirmGaps = 3;        // gaps that must match before an artifact is recognized
+  uint32_t forgetMs = 300000;     // an artifact not heard for this long is dropped
+};
+
+// What the correlator holds per artifact: the last ping and how many gaps
+// matched the fingerprint since the last one that did not.
+struct ArtifactTrack
+{
+  uint16_t id;  // 0: free slot
+  uint16_t signature;
+  Fingerprint fingerprint;
+  uint8_t lastIndex;
+  uint8_t score;
+  bool recognized;
+  uint32_t firstMs;
+  uint32_t lastMs;
+  uint32_t recognizedMs;
+};
+
+// Detector side of the artifact fingerprints. Each reception is checked
+// against the previous one of the same artifact only: the time between them
+// must be the fingerprint's gaps between the two ping indexes, within
+// toleranceMs per gap, or long enough to be a later cycle (lost pings cost
+// nothing). confirmGaps matches in a row recognize the artifact, latched
+// until it is forgotten; a gap that fits neither resets the count. Nothing
+// older than the last ping is kept, so a slot is a few bytes however sparse
+// the pings are.
+class ArtifactCorrelator
+{
+ public:
+  static constexpr uint8_t kSlots = ASAP_ARTIFACT_SLOTS;
+
+  enum class Ping : uint8_t
+  {
+    Ignored,     // ping index outside the fingerprint, or no slot free
+    First,       // first ping of this artifact (or of its new signature)
+    Match,       // gap fits the fingerprint
+    NewCycle,    // long enough to be a later cycle
+    Mismatch,    // fits neither; the count starts over
+    Recognized,  // Match that completed confirmGaps
+  };
+
+  explicit ArtifactCorrelator(const CorrelatorConfig& config = CorrelatorConfig{});
+
+  Ping onPing(uint16_t id, uint16_t signature, uint8_t index, uint32_t nowMs);
+
+  // Drop artifacts not heard for forgetMs; returns how many.
+  uint8_t expire(uint32_t nowMs);
+
+  const ArtifactTrack* find(uint16_t id) const;
+  bool recognized(uint16_t id) const;
+  uint8_t recognizedCount() const;
+
+  const ArtifactTrack* slot(uint8_t index) const { return slots_[index].id ? &slots_[index] : nullptr; }
+  uint32_t matches() const { return matches_; }
+  uint32_t mismatches() const { return mismatches_; }
+  const CorrelatorConfig& config() const { return config_; }
+
+ private:
+  ArtifactTrack* claim(uint16_t id, uint32_t nowMs);
+
+  CorrelatorConfig config_;
+  ArtifactTrack slots_[kSlots];
+  uint32_t matches_;
+  uint32_t mismatches_;
+};
+
+}  // namespace asap::game
+//
+// ArtifactFingerprint.h
+// Shared by the artifact image (which pings on the fingerprint) and the
+// detector (which checks receptions against it); neither needs a table of
+// known artifacts.
+//
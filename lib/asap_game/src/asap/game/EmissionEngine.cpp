@@ -0,0 +1,129 @@
+#include <asap/game/EmissionEngine.h>
+
+namespace asap::game
+{
+
+EmissionEngine::EmissionEngine(const EmissionConfig& config)
+    : config_(config),
+      rng_(config.seed),
+      table_{},
+      passStarts_{},
+      passStartCount_(0),
+      passStart_(0),
+      index_(0),
+      passes_(0),
+      bursts_{},
+      burstSeq_(0)
+{
+  if (config_.frameMs == 0)
+  {
+    config_.frameMs = 1;
+  }
+  build();
+}
+
+// One channel after the other from the same PRNG, so the table is a function
+// of the whole config and seed, not of each envelope alone.
+void EmissionEngine::build()
+{
+  const uint32_t frameMs = config_.frameMs;
+  for (uint8_t c = 0; c < kChannelCount; ++c)
+  {
+    const BurstEnvelope& env = config_.channels[c];
+    for (EmissionFrame& f : table_)
+    {
+      f.intensity[c] = env.floor;
+    }
+    if (env.peakMax == 0)
+    {
+      continue;
+    }
+    const uint8_t peakMax = env.peakMax > env.floor ? env.peakMax : env.floor;
+    const uint8_t peakMin = env.peakMin < env.floor ? env.floor : (env.peakMin > peakMax ? peakMax : env.peakMin);
+    const uint32_t attackMs = env.attackMs;
+    const uint32_t holdMs = env.holdMs;
+    const uint32_t decayMs = env.decayMs;
+    const uint32_t lengthMs = attackMs + holdMs + decayMs;
+    const uint32_t lengthFrames = lengthMs ? (lengthMs + frameMs - 1) / frameMs : 1;
+
+    uint32_t startMs = rng_.range(env.gapMinMs, env.gapMaxMs);
+    for (;;)
+    {
+      const uint32_t first = (startMs + frameMs - 1) / frameMs;
+      // The last frame stays quiet, so the table loops without a seam.
+      if (first + lengthFrames > kFrames - 1u)
+      {
+        break;
+      }
+      const uint32_t rise = static_cast<uint32_t>(rng_.range(peakMin, peakMax)) - env.floor;
+      for (uint32_t k = 0; k < lengthFrames; ++k)
+      {
+        // Level at the end of the frame's interval, so the first frame of a
+        // burst is already above the floor and the last one back near it.
+        const uint32_t t = (k + 1) * frameMs;
+        uint32_t level;
+        if (t < attackMs)
+        {
+          level = rise * t / attackMs;
+        }
+        else if (t <= attackMs + holdMs)
+        {
+          level = rise;
+        }
+        else
+        {
+          const uint32_t down = t - attackMs - holdMs;
+          level = down >= decayMs ? 0 : rise * (decayMs - down) / decayMs;
+        }
+        EmissionFrame& f = table_[first + k];
+        f.intensity[c] = static_cast<uint8_t>(env.floor + level);
+        f.flags = static_cast<uint8_t>(f.flags | (1u << c) | (k == 0 ? 1u << (4 + c) : 0u));
+      }
+      ++bursts_[c];
+      startMs = (first + lengthFrames) * frameMs + rng_.range(env.gapMinMs, env.gapMaxMs);
+    }
+  }
+
+  // Reservoir sample of quiet frames to start later passes at. The last
+  // frame is always quiet.
+  uint16_t quiet = 0;
+  for (uint16_t k = 0; k < kFrames; ++k)
+  {
+    if ((table_[k].flags & 0x0Fu) != 0)
+    {
+      continue;
+    }
+    if (quiet < kPassStarts)
+    {
+      passStarts_[quiet] = k;
+    }
+    else
+    {
+      const uint32_t slot = rng_.below(quiet + 1u);
+      if (slot < kPassStarts)
+      {
+        passStarts_[slot] = k;
+      }
+    }
+    ++quiet;
+  }
+  passStartCount_ = static_cast<uint8_t>(quiet < kPassStarts ? quiet : kPassStarts);
+}
+
+void EmissionEngine::newPass()
+{
+  ++passes_;
+  if (passStartCount_ == 0)
+  {
+    return;
+  }
+  passStart_ = passStarts_[rng_.below(passStartCount_)];
+  index_ = passStart_;
+}
+
+}  // namespace asap::game
+//
+// EmissionEngine.cpp
+// A zone's whole behaviour costs one table build at boot (a few
+// microseconds on the host); the running cost is a table read per packet.
+//
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <stdint.h>
+#include <asap/core/Xorshift32.h>
+#include <asap/game/ExposureEngine.h>
+
+// Frames (one per anomaly packet) in an anomaly's precomputed emission
+// pattern, five bytes each (override with -D in platformio.ini). At the
+// default 500 ms per packet the table covers a little over four minutes.
+#ifndef ASAP_ANOMALY_PATTERN_FRAMES
+#define ASAP_ANOMALY_PATTERN_FRAMES 512
+#endif
+
+namespace asap::game
+{
+
+// Bursts of one channel. Between bursts the level sits at `floor`; a burst
+// starts after a gap of gapMinMs..gapMaxMs, ramps linearly to a peak of
+// peakMin..peakMax over attackMs, holds it for holdMs and falls back to the
+// floor over decayMs.
+//
+// Levels are ExposureEngine intensities: at point blank, 255 fills one HUD
+// ring in the detector's ringMs, so a level of L fills it in 255 / L times
+// that; the detector scales it down with distance.
+struct BurstEnvelope
+{
+  uint8_t floor = 0;
+  uint8_t peakMin = 0;
+  uint8_t peakMax = 0;  // 0: no bursts on this channel
+  uint16_t attackMs = 1500;
+  uint16_t holdMs = 3000;
+  uint16_t decayMs = 4000;
+  uint16_t gapMinMs = 10000;
+  uint16_t gapMaxMs = 40000;
+};
+
+struct EmissionConfig
+{
+  uint32_t seed = 1;
+  uint16_t frameMs = 500;  // time between packets (the role's period)
+  BurstEnvelope channels[kChannelCount];
+};
+
+// What one anomaly packet carries.
+struct EmissionFrame
+{
+  uint8_t intensity[kChannelCount];
+  uint8_t flags;  // bit c: channel c bursting; bit 4 + c: its burst starts here
+
+  bool bursting(uint8_t channel) const { return (flags >> channel) & 1u; }
+  bool starts(uint8_t channel) const { return (flags >> (4 + channel)) & 1u; }
+};
+
+// Emission pattern of an anomaly. The constructor runs the envelopes
+// through the PRNG once and stores a frame per packet; next() is then a
+// table read, so the transmit path does no arithmetic on intensities.
+//
+// Bursts never straddle the end of the table, so the pattern loops without
+// a seam. Each further pass starts at a different quiet frame (no channel
+// bursting), drawn from a handful picked at build time, so the loop does
+// not repeat in step.
+class EmissionEngine
+{
+ public:
+  static constexpr uint16_t kFrames = ASAP_ANOMALY_PATTERN_FRAMES;
+  static constexpr uint8_t kPassStarts = 16;
+  static_assert(kFrames >= 2, "ASAP_ANOMALY_PATTERN_FRAMES must be at least 2");
+
+  explicit EmissionEngine(const EmissionConfig& config = EmissionConfig{});
+
+  // Frame of the next packet, and the running burst number (AnomalyMsg
+  // BurstSeq: bursts started so far, any channel).
+  const EmissionFrame& next()
+  {
+    const EmissionFrame& f = table_[index_];
+    if (f.flags & 0xF0u)
+    {
+      ++burstSeq_;
+    }
+    if (++index_ == kFrames)
+    {
+      index_ = 0;
+    }
+    if (index_ == passStart_)
+    {
+      newPass();
+    }
+    return f;
+  }
+  uint8_t burstSeq() const { return burstSeq_; }
+
+  const EmissionFrame& frame(uint16_t index) const { return table_[index % kFrames]; }
+  uint16_t position() const { return index_; }
+  uint32_t passes() const { return passes_; }
+  uint16_t burstsInTable(uint8_t channel) const { return bursts_[channel]; }
+  const EmissionConfig& config() const { return config_; }
+
+ private:
+  void build();
+  void newPass();
+
+  EmissionConfig config_;
+  asap::core::Xorshift32 rng_;
+  EmissionFrame table_[kFrames];
+  uint16_t passStarts_[kPassStarts];
+  uint8_t passStartCount_;
+  uint16_t passStart_;
+  uint16_t index_;
+  uint32_t passes_;
+  uint16_t bursts_[kChannelCount];
+  uint8_t burstSeq_;
+};
+
+}  // namespace asap::game
+//
+// EmissionEngine.h
+// Everything random about an anomaly comes from one seed, so a detector
+// test can replay exactly what a zone sends and the host can check the
+// timeline frame by frame.
+//
@@ -0,0 +1,221 @@
+#include <asap/game/ExposureEngine.h>
+
+#include <asap/core/Scheduler.h>  // asap::core::before
+
+namespace asap::game
+{
+
+using asap::core::before;
+
+namespace
+{
+constexpr uint32_t kFullDose = (ExposureEngine::kMaxStage + 1UL) * ExposureEngine::kRing;
+constexpr uint64_t kLn2Q16 = 45426;   // ln 2 * 65536
+constexpr uint32_t kMaxStepMs = 1000;  // keeps every product inside 64 bits
+
+inline uint8_t stageOf(uint32_t dose)
+{
+  const uint32_t rings = dose >> 16;
+  return static_cast<uint8_t>(rings > ExposureEngine::kMaxStage ? ExposureEngine::kMaxStage : rings);
+}
+}  // namespace
+
+ExposureEngine::ExposureEngine(const ExposureConfig& config)
+    : config_(config),
+      dose_{},
+      doseRem_{},
+      decayRem_{},
+      field_{},
+      fieldUntilMs_{},
+      fieldSource_{},
+      lastTickMs_(0),
+      active_(false),
+      changed_(false),
+      ticks_(0),
+      view_{}
+{
+  if (config_.tickMs == 0)
+  {
+    config_.tickMs = 1;
+  }
+  if (config_.decayTickMs < config_.tickMs)
+  {
+    config_.decayTickMs = config_.tickMs;
+  }
+  for (ChannelConfig& channel : config_.channels)
+  {
+    if (channel.ringMs == 0)
+    {
+      channel.ringMs = 1;
+    }
+  }
+}
+
+uint16_t ExposureEngine::proximityQ8(int16_t rssiDbm) const
+{
+  if (rssiDbm <= config_.rssiFloorDbm)
+  {
+    return 0;
+  }
+  if (rssiDbm >= config_.rssiFullDbm)
+  {
+    return 256;
+  }
+  return static_cast<uint16_t>(256 * (rssiDbm - config_.rssiFloorDbm) / (config_.rssiFullDbm - config_.rssiFloorDbm));
+}
+
+// Within holdMs of the last packet a channel keeps the strongest field seen,
+// so two anomalies in range do not flicker between each other's levels. The
+// emitter that set the field moves it either way, so a burst's decay reads
+// as a decay rather than as its peak held.
+bool ExposureEngine::onAnomaly(const uint8_t intensity[kChannelCount], int16_t rssiDbm, uint32_t nowMs,
+                               uint16_t sourceId)
+{
+  if (active_)
+  {
+    integrateTo(nowMs);  // the old fields up to now, the new ones from here
+  }
+  const uint16_t gain = proximityQ8(rssiDbm);
+  bool exposed = false;
+  for (uint8_t c = 0; c < kChannelCount; ++c)
+  {
+    const uint8_t level = static_cast<uint8_t>((intensity[c] * gain) >> 8);
+    const bool owner = field_[c] != 0 && sourceId != 0 && sourceId == fieldSource_[c];
+    if (level == 0)
+    {
+      if (owner)
+      {
+        field_[c] = 0;  // its burst is over; the next packet of another one takes over
+      }
+      continue;
+    }
+    exposed = true;
+    if (field_[c] == 0 || owner || before(fieldUntilMs_[c], nowMs) || level > field_[c])
+    {
+      field_[c] = level;
+      fieldSource_[c] = sourceId;
+    }
+    fieldUntilMs_[c] = nowMs + config_.holdMs;
+  }
+  if (!exposed || active_)
+  {
+    return false;
+  }
+  active_ = true;
+  lastTickMs_ = nowMs;
+  return true;
+}
+
+bool ExposureEngine::tick(uint32_t nowMs, uint32_t& nextMs)
+{
+  if (!active_)
+  {
+    return false;
+  }
+  ++ticks_;
+  integrateTo(nowMs);
+
+  bool exposed = false;
+  bool draining = false;
+  for (uint8_t c = 0; c < kChannelCount; ++c)
+  {
+    if (field_[c] != 0 && !before(nowMs, fieldUntilMs_[c]))
+    {
+      field_[c] = 0;
+    }
+    exposed |= field_[c] != 0;
+  }
+  refreshView();
+  for (uint8_t c = 0; c < kChannelCount; ++c)
+  {
+    draining |= config_.channels[c].decayHalfLifeMs != 0 && view_.percent[c] != 0;
+  }
+  active_ = exposed || draining;
+  nextMs = nowMs + (exposed ? config_.tickMs : config_.decayTickMs);
+  return active_;
+}
+
+void ExposureEngine::integrateTo(uint32_t nowMs)
+{
+  while (before(lastTickMs_, nowMs))
+  {
+    const uint32_t left = nowMs - lastTickMs_;
+    const uint32_t stepMs = left < kMaxStepMs ? left : kMaxStepMs;
+    for (uint8_t c = 0; c < kChannelCount; ++c)
+    {
+      uint32_t fieldMs = 0;
+      if (field_[c] != 0 && before(lastTickMs_, fieldUntilMs_[c]))
+      {
+        const uint32_t held = fieldUntilMs_[c] - lastTickMs_;
+        fieldMs = held < stepMs ? held : stepMs;
+      }
+      integrate(c, fieldMs, stepMs);
+    }
+    lastTickMs_ += stepMs;
+  }
+}
+
+// Decay of the ring the channel is in, then exposure, so a channel held in a
+// field at stage III shows a full ring rather than one a decay step short.
+void ExposureEngine::integrate(uint8_t channel, uint32_t fieldMs, uint32_t dtMs)
+{
+  const ChannelConfig& cfg = config_.channels[channel];
+  uint32_t& dose = dose_[channel];
+  if (cfg.decayHalfLifeMs != 0)
+  {
+    const uint32_t floor = static_cast<uint32_t>(stageOf(dose)) << 16;
+    const uint32_t progress = dose - floor;
+    if (progress == 0)
+    {
+      decayRem_[channel] = 0;
+    }
+    else
+    {
+      const uint64_t den = static_cast<uint64_t>(cfg.decayHalfLifeMs) << 16;
+      decayRem_[channel] += progress * static_cast<uint64_t>(dtMs) * kLn2Q16;
+      const uint64_t loss = decayRem_[channel] / den;
+      decayRem_[channel] %= den;
+      dose -= loss >= progress ? progress : static_cast<uint32_t>(loss);
+    }
+  }
+  if (fieldMs != 0)
+  {
+    const uint64_t den = 255ULL * cfg.ringMs;  // intensity 255 fills a ring in ringMs
+    doseRem_[channel] += static_cast<uint64_t>(field_[channel]) * fieldMs * kRing;
+    const uint64_t add = doseRem_[channel] / den;
+    doseRem_[channel] %= den;
+    dose = add >= kFullDose - dose ? kFullDose : dose + static_cast<uint32_t>(add);
+  }
+}
+
+void ExposureEngine::refreshView()
+{
+  for (uint8_t c = 0; c < kChannelCount; ++c)
+  {
+    const uint8_t stage = stageOf(dose_[c]);
+    const uint8_t percent =
+        dose_[c] >= kFullDose ? 100 : static_cast<uint8_t>(((dose_[c] - (static_cast<uint32_t>(stage) << 16)) * 100) >> 16);
+    if (stage != view_.stage[c] || percent != view_.percent[c])
+    {
+      view_.stage[c] = stage;
+      view_.percent[c] = percent;
+      changed_ = true;
+    }
+  }
+}
+
+bool ExposureEngine::takeChanged()
+{
+  const bool changed = changed_;
+  changed_ = false;
+  return changed;
+}
+
+}  // namespace asap::game
+//
+// ExposureEngine.cpp
+// All state is integer. Doses are integrated up to each packet (onAnomaly())
+// and each tick; the view and the HUD pushes change only on ticks, so the
+// same packets and tick times give the same HUD on the detector, in the
+// simulator and in the native tests.
+//
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <stdint.h>
+
+namespace asap::game
+{
+
+// Anomaly channels, in the order of AnomalyMsg and the HUD.
+enum Channel : uint8_t
+{
+  kRad,
+  kTherm,
+  kChem,
+  kPsy,
+  kChannelCount
+};
+
+struct ChannelConfig
+{
+  uint32_t ringMs = 60000;            // one full HUD ring at intensity 255, point blank
+  uint32_t decayHalfLifeMs = 120000;  // of the current ring's progress; 0 = none
+};
+
+struct ExposureConfig
+{
+  uint16_t tickMs = 100;        // integration step while exposed
+  uint16_t decayTickMs = 1000;  // step while only draining rings
+  uint16_t holdMs = 1200;       // a field lasts this long after its last packet
+  int16_t rssiFloorDbm = -95;   // proximity gain 0 at or below
+  int16_t rssiFullDbm = -45;    // proximity gain 1 at or above
+  ChannelConfig channels[kChannelCount];
+};
+
+// What the anomaly HUD shows per channel (UIController::setAnomalyExposure
+// and setAnomalyStage).
+struct ExposureView
+{
+  uint8_t percent[kChannelCount];  // progress of the current ring, 0..100
+  uint8_t stage[kChannelCount];    // 0 none, 1..3 I..III
+};
+
+// Dose accumulation for the anomaly HUD. Packets only set the field a
+// channel is exposed to (intensity times a proximity gain from the RSSI,
+// held for holdMs); tick() integrates it in fixed point, and so does a
+// packet, up to its arrival, before it changes the field:
+//
+//   dose += field / 255 * dt / ringMs   (rings, Q16)
+//   dose -= ring progress * ln2 * dt / decayHalfLifeMs
+//
+// A full ring carries over into the next stage. Stages are latched: decay
+// only drains the ring of the current stage, and stage III stops filling at
+// a full ring. Remainders of both divisions are carried between ticks, so
+// short ticks lose nothing to rounding.
+class ExposureEngine
+{
+ public:
+  static constexpr uint8_t kMaxStage = 3;
+  static constexpr uint32_t kRing = 1UL << 16;  // dose of one ring
+
+  explicit ExposureEngine(const ExposureConfig& config = ExposureConfig{});
+
+  // One anomaly packet from emitter sourceId: intensity per channel
+  // (0..255, see EmissionEngine) at rssiDbm. Returns true when the engine
+  // was idle and needs tick() from nowMs on.
+  bool onAnomaly(const uint8_t intensity[kChannelCount], int16_t rssiDbm, uint32_t nowMs, uint16_t sourceId = 0);
+
+  // Integrate up to nowMs. Returns true with the next tick in nextMs while
+  // a field is present or a ring still shows progress that decays; false
+  // when idle (the next packet restarts it).
+  bool tick(uint32_t nowMs, uint32_t& nextMs);
+
+  // The HUD values, and whether they changed since the last takeChanged().
+  const ExposureView& view() const { return view_; }
+  bool takeChanged();
+
+  uint32_t dose(uint8_t channel) const { return dose_[channel]; }
+  uint8_t field(uint8_t channel) const { return field_[channel]; }
+  bool active() const { return active_; }
+  uint32_t ticks() const { return ticks_; }
+  const ExposureConfig& config() const { return config_; }
+
+  // Proximity gain (Q8, 0..256) of a packet received at rssiDbm.
+  uint16_t proximityQ8(int16_t rssiDbm) const;
+
+ private:
+  void integrateTo(uint32_t nowMs);
+  void integrate(uint8_t channel, uint32_t fieldMs, uint32_t dtMs);
+  void refreshView();
+
+  ExposureConfig config_;
+  uint32_t dose_[kChannelCount];      // rings, Q16; at most (kMaxStage + 1) rings
+  uint64_t doseRem_[kChannelCount];   // remainder of the accumulation division
+  uint64_t decayRem_[kChannelCount];  // remainder of the decay division
+  uint8_t field_[kChannelCount];      // effective intensity, 0..255
+  uint32_t fieldUntilMs_[kChannelCount];
+  uint16_t fieldSource_[kChannelCount];  // emitter that set field_ (0 = unknown)
+  uint32_t lastTickMs_;
+  bool active_;
+  bool changed_;
+  uint32_t ticks_;
+  ExposureView view_;
+};
+
+}  // namespace asap::game
+//
+// ExposureEngine.h
+// The model behind the anomaly HUD: the detector role feeds it anomaly
+// packets and pushes view() to the UI only when takeChanged() says so.
+//
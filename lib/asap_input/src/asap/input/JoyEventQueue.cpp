@@ -0,0 +1,60 @@
+#include <asap/input/JoyEventQueue.h>
+
+namespace asap::input
+{
+
+static_assert((JoyEventQueue::kCapacity & (JoyEventQueue::kCapacity - 1)) == 0,
+              "JoyEventQueue capacity must be a power of two");
+
+namespace
+{
+// Compiler barrier: the slot must be written (or read) before the index that
+// hands it to the other side moves.
+inline void publishBarrier()
+{
+  __asm__ __volatile__("" ::: "memory");
+}
+}  // namespace
+
+JoyEventQueue::JoyEventQueue()
+    : slots_{},
+      head_(0),
+      tail_(0),
+      dropped_(0)
+{
+}
+
+bool JoyEventQueue::push(const JoyEvent& event)
+{
+  const uint8_t head = head_;
+  if (static_cast<uint8_t>(head - tail_) >= kCapacity)
+  {
+    dropped_ = dropped_ + 1;
+    return false;
+  }
+  slots_[head & (kCapacity - 1)] = event;
+  publishBarrier();
+  head_ = static_cast<uint8_t>(head + 1);
+  return true;
+}
+
+bool JoyEventQueue::pop(JoyEvent& out)
+{
+  const uint8_t tail = tail_;
+  if (tail == head_)
+  {
+    return false;
+  }
+  publishBarrier();
+  out = slots_[tail & (kCapacity - 1)];
+  publishBarrier();
+  tail_ = static_cast<uint8_t>(tail + 1);
+  return true;
+}
+
+}  // namespace asap::input
+//
+// JoyEventQueue.cpp
+// Free-running 8-bit indices; the fill level is their difference, which stays
+// correct across wrap-around because the capacity divides 256.
+//
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <stdint.h>
+#include <asap/input/Joystick.h>
+
+namespace asap::input
+{
+
+// One debounced joystick edge, stamped with the millis() time at which the
+// switch settled. centerDown is the center level after the edge; action is
+// the directional press or the Click emitted when the center is released
+// (Neutral for a plain center press).
+struct JoyEvent
+{
+  uint32_t timeMs;
+  JoyAction action;
+  bool centerDown;
+};
+
+// Lock-free single-producer/single-consumer ring between the joystick ISR
+// (push) and the main loop (pop). Each side only writes its own index, so no
+// interrupt masking is needed on a single core.
+class JoyEventQueue
+{
+ public:
+  static constexpr uint8_t kCapacity = 16;  // power of two
+
+  JoyEventQueue();
+
+  // Producer (ISR). Returns false and counts a drop when the ring is full.
+  bool push(const JoyEvent& event);
+
+  // Consumer (main loop).
+  bool pop(JoyEvent& out);
+
+  bool empty() const { return head_ == tail_; }
+  uint8_t size() const { return static_cast<uint8_t>(head_ - tail_); }
+  uint32_t droppedCount() const { return dropped_; }
+
+ private:
+  JoyEvent slots_[kCapacity];
+  volatile uint8_t head_;  // next slot to write (producer)
+  volatile uint8_t tail_;  // next slot to read (consumer)
+  volatile uint32_t dropped_;
+};
+
+}  // namespace asap::input
+//
+// JoyEventQueue.h
+// Joystick edges travel from the sampling interrupt to UIController::onInput()
+// through this ring, so a flick shorter than a main-loop pass is never lost
+// and long-press timing uses the edge time rather than the time of the poll.
+//
@@ -0,0 +1,207 @@
+#include <asap/input/JoystickDriver.h>
+
+#ifdef ARDUINO
+#include <Arduino.h>  // STM32duino core: HardwareTimer, GPIO
+#endif
+
+namespace asap::input
+{
+
+JoystickDebouncer::JoystickDebouncer(JoyEventQueue& queue)
+    : queue_(queue)
+{
+}
+
+void JoystickDebouncer::setEdgeHook(EdgeHook hook, void* context)
+{
+  edgeContext_ = context;
+  edgeHook_ = hook;
+}
+
+void JoystickDebouncer::sample(uint32_t nowMs, uint8_t rawMask)
+{
+  if (rawMask == stable_)
+  {
+    candidate_ = stable_;  // bounce back to the settled level: start over
+    count_ = 0;
+    if (quiet_ < kStableSamples)
+    {
+      ++quiet_;
+    }
+    return;
+  }
+  quiet_ = 0;
+  if (rawMask != candidate_ || count_ == 0)
+  {
+    candidate_ = rawMask;
+    count_ = 1;
+    changeMs_ = nowMs;
+  }
+  else if (count_ < kStableSamples)
+  {
+    ++count_;
+  }
+  if (count_ >= kStableSamples)
+  {
+    const uint8_t changed = static_cast<uint8_t>(stable_ ^ candidate_);
+    stable_ = candidate_;
+    count_ = 0;
+    emitEdges(changed, changeMs_);
+  }
+}
+
+void JoystickDebouncer::emitEdges(uint8_t changed, uint32_t timeMs)
+{
+  const bool center = (stable_ & kSwitchCenter) != 0;
+  // Center first, so a direction pressed together with it sees the new level.
+  if (changed & kSwitchCenter)
+  {
+    queue_.push(JoyEvent{timeMs, center ? JoyAction::Neutral : JoyAction::Click, center});
+  }
+  struct Direction
+  {
+    uint8_t bit;
+    JoyAction action;
+  };
+  static constexpr Direction kDirections[] = {
+      {kSwitchLeft, JoyAction::Left},
+      {kSwitchRight, JoyAction::Right},
+      {kSwitchUp, JoyAction::Up},
+      {kSwitchDown, JoyAction::Down},
+  };
+  for (const Direction& d : kDirections)
+  {
+    if ((changed & d.bit) && (stable_ & d.bit))
+    {
+      queue_.push(JoyEvent{timeMs, d.action, center});
+    }
+  }
+  if (edgeHook_)
+  {
+    edgeHook_(edgeContext_);
+  }
+}
+
+#ifdef ARDUINO
+
+namespace
+{
+JoystickPins gPins{};
+JoystickDebouncer* gDebouncer = nullptr;
+HardwareTimer* gTimer = nullptr;
+uint8_t gPeriodMs = 0;  // current sample period of gTimer
+
+uint8_t readRawMask()
+{
+  uint8_t mask = 0;
+  if (digitalRead(gPins.left) == LOW) mask |= kSwitchLeft;
+  if (digitalRead(gPins.right) == LOW) mask |= kSwitchRight;
+  if (digitalRead(gPins.up) == LOW) mask |= kSwitchUp;
+  if (digitalRead(gPins.down) == LOW) mask |= kSwitchDown;
+  if (digitalRead(gPins.center) == LOW) mask |= kSwitchCenter;
+  return mask;
+}
+}  // namespace
+
+bool JoystickDriver::begin(const JoystickPins& pins, JoyEventQueue& queue,
+                           JoystickDebouncer::EdgeHook onEdge, void* context)
+{
+  if (gTimer)
+  {
+    return false;  // already running
+  }
+  gPins = pins;
+  pinMode(pins.left, INPUT_PULLUP);
+  pinMode(pins.right, INPUT_PULLUP);
+  pinMode(pins.up, INPUT_PULLUP);
+  pinMode(pins.down, INPUT_PULLUP);
+  pinMode(pins.center, INPUT_PULLUP);
+
+  static JoystickDebouncer debouncer(queue);
+  debouncer.setEdgeHook(onEdge, context);
+  gDebouncer = &debouncer;
+
+  // TIM3 is free on the detector (SPI1 flushes through DMA1, no PWM in use).
+  static HardwareTimer timer(TIM3);
+  gTimer = &timer;
+  gPeriodMs = debouncer.samplePeriodMs();
+  timer.setOverflow(gPeriodMs * 1000U, MICROSEC_FORMAT);
+  timer.setInterruptPriority(7, 0);  // below the display DMA (6)
+  timer.attachInterrupt(&JoystickDriver::onSampleTimer);
+  timer.resume();
+  return true;
+}
+
+uint8_t JoystickDriver::stableMask()
+{
+  return gDebouncer ? gDebouncer->stableMask() : 0;
+}
+
+void JoystickDriver::onSampleTimer()
+{
+  gDebouncer->sample(millis(), readRawMask());
+  const uint8_t periodMs = gDebouncer->samplePeriodMs();
+  if (periodMs != gPeriodMs)
+  {
+    gPeriodMs = periodMs;
+    gTimer->setOverflow(periodMs * 1000U, MICROSEC_FORMAT);
+  }
+}
+
+#else
+
+ScriptedJoystick::ScriptedJoystick(JoyEventQueue& queue)
+    : debouncer_(queue)
+{
+}
+
+void ScriptedJoystick::press(uint8_t switches, uint32_t startMs, uint32_t holdMs, uint8_t bounceMs)
+{
+  presses_.push_back(Press{switches, startMs, startMs + holdMs, bounceMs});
+}
+
+uint8_t ScriptedJoystick::rawAt(uint32_t timeMs) const
+{
+  uint8_t mask = 0;
+  for (const Press& p : presses_)
+  {
+    bool down = (timeMs >= p.startMs && timeMs < p.endMs);
+    // Chatter: odd ms of the bounce window before each edge read the other level.
+    if (p.bounceMs != 0)
+    {
+      if (timeMs + p.bounceMs >= p.startMs && timeMs < p.startMs)
+      {
+        down = ((p.startMs - timeMs) & 1U) != 0;
+      }
+      else if (timeMs + p.bounceMs >= p.endMs && timeMs < p.endMs)
+      {
+        down = ((p.endMs - timeMs) & 1U) == 0;
+      }
+    }
+    if (down)
+    {
+      mask = static_cast<uint8_t>(mask | p.switches);
+    }
+  }
+  return mask;
+}
+
+void ScriptedJoystick::advanceTo(uint32_t nowMs)
+{
+  while (static_cast<int32_t>(nowMs - nextSampleMs_) >= 0)
+  {
+    debouncer_.sample(nextSampleMs_, rawAt(nextSampleMs_));
+    ++samples_;
+    nextSampleMs_ += debouncer_.samplePeriodMs();
+  }
+}
+
+#endif  // ARDUINO
+
+}  // namespace asap::input
+//
+// JoystickDriver.cpp
+// The debouncer is shared by both targets, and so is the sample rate it asks
+// for; only the sample source differs (GPIO in a TIM3 interrupt on STM32, a
+// scripted timeline on native).
+//
@@ -0,0 +1,148 @@
+#pragma once
+
+#include <stdint.h>
+#include <asap/input/JoyEventQueue.h>
+
+#ifndef ARDUINO
+#include <vector>
+#endif
+
+namespace asap::input
+{
+
+// Raw switch bits of the five-way joystick (1 = pressed).
+enum JoySwitch : uint8_t
+{
+  kSwitchLeft = 1U << 0,
+  kSwitchRight = 1U << 1,
+  kSwitchUp = 1U << 2,
+  kSwitchDown = 1U << 3,
+  kSwitchCenter = 1U << 4,
+};
+
+// Integrating debouncer run from the sampling interrupt. A change of the raw
+// switch mask is accepted once it has been stable for kStableSamples
+// consecutive samples; its edges are pushed to the queue stamped with the
+// first sample of that stable run (the real settle time).
+//
+// Samples come every ms while a change is being confirmed, and every
+// kIdleSampleMs once the switches have matched the stable mask for
+// kStableSamples samples (idle()), so a resting joystick does not wake the
+// MCU a thousand times a second. An edge is then stamped up to
+// kIdleSampleMs late, well below what a long-press can tell.
+class JoystickDebouncer
+{
+ public:
+  static constexpr uint8_t kStableSamples = 5;  // ms at 1 kHz
+  static constexpr uint8_t kIdleSampleMs = 10;
+
+  // Called (in ISR context) after edges were queued, e.g. to signal the task
+  // that drains the queue.
+  using EdgeHook = void (*)(void* context);
+
+  explicit JoystickDebouncer(JoyEventQueue& queue);
+
+  void setEdgeHook(EdgeHook hook, void* context);
+
+  // ISR context, once per sample period.
+  void sample(uint32_t nowMs, uint8_t rawMask);
+
+  uint8_t stableMask() const { return stable_; }
+  bool idle() const { return quiet_ >= kStableSamples; }
+  // Time to the next sample: 1 ms, or kIdleSampleMs while idle().
+  uint8_t samplePeriodMs() const { return idle() ? kIdleSampleMs : 1; }
+
+ private:
+  void emitEdges(uint8_t changed, uint32_t timeMs);
+
+  JoyEventQueue& queue_;
+  EdgeHook edgeHook_ = nullptr;
+  void* edgeContext_ = nullptr;
+  uint8_t stable_ = 0;     // debounced switch mask
+  uint8_t candidate_ = 0;  // raw mask currently being confirmed
+  uint8_t count_ = 0;      // consecutive samples of candidate_
+  uint8_t quiet_ = kStableSamples;  // consecutive samples equal to stable_
+  uint32_t changeMs_ = 0;  // first sample of the candidate run
+};
+
+// GPIO lines of the joystick (active low, internal pull-ups).
+struct JoystickPins
+{
+  uint32_t left;
+  uint32_t right;
+  uint32_t up;
+  uint32_t down;
+  uint32_t center;
+};
+
+#ifdef ARDUINO
+
+// Samples the joystick from a hardware timer interrupt and debounces in that
+// interrupt; the timer runs at 1 kHz only while the debouncer is not idle()
+// and at 1 / kIdleSampleMs otherwise. Every interrupt ends WFI, so the main
+// loop can sleep until the queue has events or the UI deadline passes. One
+// joystick per board, so the driver is a singleton like SpiDmaLink.
+//
+// Not EXTI-started: on the detector PA0/PB0 and PA1/PB1 share EXTI lines 0
+// and 1, so not every switch could raise its own edge interrupt.
+class JoystickDriver
+{
+ public:
+  static bool begin(const JoystickPins& pins, JoyEventQueue& queue,
+                    JoystickDebouncer::EdgeHook onEdge = nullptr, void* context = nullptr);
+  static uint8_t stableMask();
+
+ private:
+  static void onSampleTimer();
+};
+
+#else
+
+// Native stand-in for JoystickDriver: replays a scripted timeline of raw
+// switch levels (optionally with contact bounce) through the same debouncer,
+// at the same sample periods on a virtual millisecond clock.
+class ScriptedJoystick
+{
+ public:
+  explicit ScriptedJoystick(JoyEventQueue& queue);
+
+  void setEdgeHook(JoystickDebouncer::EdgeHook hook, void* context) { debouncer_.setEdgeHook(hook, context); }
+
+  // Hold `switches` from startMs for holdMs. bounceMs of chatter (toggling
+  // every ms) precede the press and the release edge.
+  void press(uint8_t switches, uint32_t startMs, uint32_t holdMs, uint8_t bounceMs = 0);
+
+  // Raw (undebounced) switch mask the script produces at timeMs.
+  uint8_t rawAt(uint32_t timeMs) const;
+
+  // Take every sample due up to and including nowMs.
+  void advanceTo(uint32_t nowMs);
+
+  const JoystickDebouncer& debouncer() const { return debouncer_; }
+  uint32_t samples() const { return samples_; }  // sampling interrupts so far
+
+ private:
+  struct Press
+  {
+    uint8_t switches;
+    uint32_t startMs;
+    uint32_t endMs;   // first ms released
+    uint8_t bounceMs;
+  };
+
+  std::vector<Press> presses_;
+  JoystickDebouncer debouncer_;
+  uint32_t nextSampleMs_ = 0;
+  uint32_t samples_ = 0;
+};
+
+#endif  // ARDUINO
+
+}  // namespace asap::input
+//
+// JoystickDriver.h
+// Interrupt-fed joystick input. The sampling ISR (or the native script)
+// produces JoyEvent edges; UIController::onInput() consumes them with their
+// exact times. Center press/release become level changes plus a Click on
+// release, directions become their JoyAction on press.
+//
@@ -0,0 +1,127 @@
+#include <asap/power/PowerModel.h>
+
+namespace asap::power
+{
+
+namespace
+{
+constexpr uint64_t kMsPerHour = 3600000ULL;
+// What a STOP wait leaves to WFI: the lead, plus up to one RTC count of
+// rounding (StopClock.cpp), a millisecond at most.
+constexpr uint32_t kStopRestMs = kStopLeadMs + 1;
+static_assert(ASAP_POWER_STOP_MIN_MS > kStopRestMs, "a STOP wait must leave time in STOP");
+static_assert(ASAP_POWER_RTC_HZ >= 1000 && 32768 % ASAP_POWER_RTC_HZ == 0,
+              "the RTC count must be at most a millisecond and divide the LSE");
+}  // namespace
+
+uint32_t PowerReport::dutyCyclePpm() const
+{
+  if (elapsedMs == 0)
+  {
+    return 0;
+  }
+  const uint64_t awakeMs = static_cast<uint64_t>(elapsedMs) - radioMs[static_cast<uint8_t>(RadioState::Sleep)];
+  return static_cast<uint32_t>(awakeMs * 1000000ULL / elapsedMs);
+}
+
+uint32_t PowerReport::airtimeMsPerHour() const
+{
+  return elapsedMs ? static_cast<uint32_t>(radioMs[static_cast<uint8_t>(RadioState::Tx)] * kMsPerHour / elapsedMs)
+                   : 0;
+}
+
+uint32_t PowerReport::batteryHours(uint32_t capacityMah) const
+{
+  const uint32_t ua = averageUa();
+  return ua ? static_cast<uint32_t>(capacityMah * 1000ULL / ua) : UINT32_MAX;
+}
+
+PowerAccount::PowerAccount(const PowerProfile& profile)
+    : profile_(profile),
+      state_(RadioState::Idle),
+      startMs_(0),
+      sinceMs_(0),
+      radioMs_{},
+      mcuWakes_(0),
+      mcuSleepMs_(0),
+      radioWakes_(0)
+{
+}
+
+void PowerAccount::begin(uint32_t nowMs, RadioState state)
+{
+  state_ = state;
+  startMs_ = nowMs;
+  sinceMs_ = nowMs;
+  for (uint32_t& ms : radioMs_)
+  {
+    ms = 0;
+  }
+  mcuWakes_ = 0;
+  mcuSleepMs_ = 0;
+  radioWakes_ = 0;
+}
+
+void PowerAccount::mcuWait(uint32_t waitMs, bool stopAllowed)
+{
+  if (!stopAllowed || waitMs < ASAP_POWER_STOP_MIN_MS)
+  {
+    mcuSleepMs_ += waitMs;
+    return;
+  }
+  mcuSleepMs_ += kStopRestMs;
+}
+
+// A change dated before the current state began (out of order) only
+// switches the state.
+void PowerAccount::radio(RadioState state, uint32_t atMs)
+{
+  const int32_t spanMs = static_cast<int32_t>(atMs - sinceMs_);
+  if (spanMs > 0)
+  {
+    radioMs_[static_cast<uint8_t>(state_)] += static_cast<uint32_t>(spanMs);
+    sinceMs_ = atMs;
+  }
+  state_ = state;
+}
+
+PowerReport PowerAccount::report(uint32_t nowMs) const
+{
+  PowerReport r{};
+  r.elapsedMs = nowMs - startMs_;
+  for (uint8_t s = 0; s < kRadioStateCount; ++s)
+  {
+    r.radioMs[s] = radioMs_[s];
+  }
+  const int32_t openMs = static_cast<int32_t>(nowMs - sinceMs_);
+  if (openMs > 0)
+  {
+    r.radioMs[static_cast<uint8_t>(state_)] += static_cast<uint32_t>(openMs);
+  }
+  r.mcuWakes = mcuWakes_;
+  r.mcuSleepMs = mcuSleepMs_;
+  r.radioWakes = radioWakes_;
+
+  uint64_t charge = 0;
+  for (uint8_t s = 0; s < kRadioStateCount; ++s)
+  {
+    charge += static_cast<uint64_t>(r.radioMs[s]) * 1000ULL * profile_.radioUa[s];
+  }
+  charge += static_cast<uint64_t>(r.radioWakes) * profile_.radioWakeUs * profile_.radioWakeUa;
+  const uint64_t windowUs = static_cast<uint64_t>(r.elapsedMs) * 1000ULL;
+  uint64_t runUs = static_cast<uint64_t>(r.mcuWakes) * profile_.mcuWakeUs;
+  runUs = runUs < windowUs ? runUs : windowUs;
+  uint64_t sleepUs = static_cast<uint64_t>(r.mcuSleepMs) * 1000ULL;
+  sleepUs = sleepUs < windowUs - runUs ? sleepUs : windowUs - runUs;
+  charge += runUs * profile_.mcuRunUa + sleepUs * profile_.mcuSleepUa +
+            (windowUs - runUs - sleepUs) * profile_.mcuStopUa;
+  r.chargeUaUs = charge;
+  return r;
+}
+
+}  // namespace asap::power
+//
+// PowerModel.cpp
+// Charge is summed in uA x us in 64 bits: a day at the full run current is
+// about 2e15, far from overflow.
+//
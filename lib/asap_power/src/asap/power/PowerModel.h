@@ -0,0 +1,114 @@
+#pragma once
+
+#include <stdint.h>
+
+// RTC counter rate under stopModeClock(): the prescaler divides the
+// 32.768 kHz LSE down to this (RTC_PRL = 32768 / rate - 1), and the alarm
+// matches one count, so STOP can end to within a millisecond.
+#ifndef ASAP_POWER_RTC_HZ
+#define ASAP_POWER_RTC_HZ 1024
+#endif
+
+// Shortest wait spent in STOP mode; shorter ones stay in WFI. A STOP wait
+// ends kStopLeadMs early for the HSE and PLL to restart, so below a few
+// milliseconds there is nothing left to save.
+#ifndef ASAP_POWER_STOP_MIN_MS
+#define ASAP_POWER_STOP_MIN_MS 5
+#endif
+
+namespace asap::power
+{
+
+enum class RadioState : uint8_t
+{
+  Sleep,
+  Idle,
+  Rx,
+  Tx,
+};
+
+constexpr uint8_t kRadioStateCount = 4;
+
+// The RTC alarm of a STOP wait is set this long before the deadline: time
+// for the clocks to come back from HSI, spent in WFI.
+constexpr uint32_t kStopLeadMs = 2;
+
+// Supply current of an emitter board per state, in uA. Datasheet typicals:
+// STM32F103 at 72 MHz from flash with SPI2 on, in Sleep (WFI) with the
+// peripheral clocks off, and in STOP with the regulator in low-power mode
+// and the RTC on the LSE; CC1101 at 433 MHz, 38.4 kBaud, +10 dBm. Bench
+// numbers of a real board go here.
+struct PowerProfile
+{
+  uint32_t mcuRunUa = 24000;
+  uint32_t mcuSleepUa = 5500;
+  uint32_t mcuStopUa = 30;
+  uint16_t mcuWakeUs = 400;  // per task dispatch: clocks back up, task, SPI
+  uint32_t radioUa[kRadioStateCount] = {1, 1700, 16000, 29000};  // by RadioState
+  uint16_t radioWakeUs = 900;    // crystal start plus the calibration before TX
+  uint32_t radioWakeUa = 8000;
+};
+
+// Where the charge of one accounting window went.
+struct PowerReport
+{
+  uint32_t elapsedMs;
+  uint32_t radioMs[kRadioStateCount];
+  uint32_t mcuWakes;
+  uint32_t mcuSleepMs;  // waits spent in WFI rather than STOP
+  uint32_t radioWakes;
+  uint64_t chargeUaUs;  // uA x us
+
+  // Mean supply current, which is also the charge per hour: uAh/h.
+  uint32_t averageUa() const { return elapsedMs ? static_cast<uint32_t>(chargeUaUs / (1000ULL * elapsedMs)) : 0; }
+  // Radio out of SLEEP, in parts per million of the window.
+  uint32_t dutyCyclePpm() const;
+  uint32_t airtimeMsPerHour() const;
+  // Hours a battery of capacityMah lasts at averageUa().
+  uint32_t batteryHours(uint32_t capacityMah) const;
+};
+
+// Time-in-state bookkeeping for a duty-cycled role. The role reports radio
+// state changes (the time may be ahead of now, e.g. the end of a TX it has
+// just started), each time it was woken and each wait it arms; MCU run time
+// is modelled as mcuWakeUs per wake, the WFI share of the waits as Sleep and
+// the rest of the window as STOP.
+class PowerAccount
+{
+ public:
+  explicit PowerAccount(const PowerProfile& profile = PowerProfile{});
+
+  void begin(uint32_t nowMs, RadioState state);
+  void radio(RadioState state, uint32_t atMs);
+  void mcuWake() { ++mcuWakes_; }
+  void radioWake() { ++radioWakes_; }
+  // A wait from the end of a task to the next deadline, spent the way
+  // asap::power::stopModeClock() does: in WFI when shorter than
+  // ASAP_POWER_STOP_MIN_MS or not stopAllowed, otherwise in STOP up to the
+  // RTC alarm and in WFI for the lead and the alarm's rounding after it.
+  void mcuWait(uint32_t waitMs, bool stopAllowed = true);
+
+  // Totals up to nowMs, the current radio state included.
+  PowerReport report(uint32_t nowMs) const;
+
+  RadioState radioState() const { return state_; }
+  const PowerProfile& profile() const { return profile_; }
+
+ private:
+  PowerProfile profile_;
+  RadioState state_;
+  uint32_t startMs_;
+  uint32_t sinceMs_;  // current radio state
+  uint32_t radioMs_[kRadioStateCount];
+  uint32_t mcuWakes_;
+  uint32_t mcuSleepMs_;
+  uint32_t radioWakes_;
+};
+
+}  // namespace asap::power
+//
+// PowerModel.h
+// An estimate, not a measurement: it turns what the firmware did into mA h
+// with the profile's currents, so schedules can be compared on the host
+// before a board sits on a bench meter.
+//
@@ -0,0 +1,198 @@
+#ifdef ARDUINO
+
+#include <asap/power/StopClock.h>
+
+#include <Arduino.h>  // millis(), __WFI(), uwTick, RTC registers
+
+// The RTC prescaler, counter and alarm are programmed directly (PRL, CNT,
+// DIV and ALR exist on the F1 RTC only).
+#if __has_include(<STM32LowPower.h>) && __has_include(<STM32RTC.h>) && defined(STM32F1xx)
+#include <STM32LowPower.h>  // STOP mode entry and clock restore
+#include <STM32RTC.h>       // LSE start-up and the RTC alarm IRQ handler
+#define ASAP_POWER_HAVE_STOP 1
+#else
+#define ASAP_POWER_HAVE_STOP 0
+#endif
+
+namespace asap::power
+{
+
+#if ASAP_POWER_HAVE_STOP
+
+// One RTC count per 1/ASAP_POWER_RTC_HZ s instead of the RTC library's one
+// per second; the library's calendar is not used on these images.
+constexpr uint32_t kPrescaler = LSE_VALUE / ASAP_POWER_RTC_HZ - 1u;
+static_assert(LSE_VALUE % ASAP_POWER_RTC_HZ == 0, "the RTC count must be whole LSE periods");
+static_assert((static_cast<uint64_t>(ASAP_POWER_STOP_MIN_MS) - kStopLeadMs) * ASAP_POWER_RTC_HZ / 1000u >= 2,
+              "a STOP wait needs an alarm at least two RTC counts ahead");
+
+namespace
+{
+StopGate gAllowStop = nullptr;
+void* gStopContext = nullptr;
+uint32_t gCreditRest = 0;  // LSE periods x 1000 not yet a whole millisecond
+
+// After STOP the RTC's APB registers hold stale values until the next
+// RTCCLK edge resynchronizes them.
+void syncRtc()
+{
+  RTC->CRL &= ~RTC_CRL_RSF;
+  while ((RTC->CRL & RTC_CRL_RSF) == 0)
+  {
+  }
+}
+
+// PRL, CNT and ALR are only written in configuration mode, one write
+// sequence at a time (RTOFF).
+void enterRtcConfig()
+{
+  while ((RTC->CRL & RTC_CRL_RTOFF) == 0)
+  {
+  }
+  RTC->CRL |= RTC_CRL_CNF;
+}
+
+void exitRtcConfig()
+{
+  RTC->CRL &= ~RTC_CRL_CNF;
+  while ((RTC->CRL & RTC_CRL_RTOFF) == 0)
+  {
+  }
+}
+
+// The LSE is already running (STM32RTC::begin()); only the prescaler and
+// the alarm interrupt are set here. The RTC library's RTC_Alarm_IRQHandler
+// clears ALRF and EXTI line 17; the interrupt is only a wakeup source.
+void configureRtc()
+{
+  PWR->CR |= PWR_CR_DBP;
+  enterRtcConfig();
+  RTC->PRLH = static_cast<uint16_t>(kPrescaler >> 16);
+  RTC->PRLL = static_cast<uint16_t>(kPrescaler & 0xFFFFu);
+  exitRtcConfig();
+  RTC->CRH |= RTC_CRH_ALRIE;
+  EXTI->IMR |= EXTI_IMR_MR17;
+  EXTI->RTSR |= EXTI_RTSR_TR17;
+  NVIC_EnableIRQ(RTC_Alarm_IRQn);
+}
+
+uint32_t rtcCounter()
+{
+  uint16_t high;
+  uint16_t low;
+  do
+  {
+    high = RTC->CNTH;
+    low = RTC->CNTL;
+  } while (high != RTC->CNTH);
+  return (static_cast<uint32_t>(high) << 16) | low;
+}
+
+// RTC time in LSE periods: (kPrescaler + 1) per count plus the prescaler's
+// progress through the current one (DIV counts down from kPrescaler). CNT
+// is read again after DIV so a count that ticks over in between is
+// retried. Wraps, which differences do not mind.
+uint32_t rtcTicks()
+{
+  uint32_t count;
+  uint32_t divider;
+  do
+  {
+    count = rtcCounter();
+    divider = ((static_cast<uint32_t>(RTC->DIVH) & 0x000Fu) << 16) | RTC->DIVL;
+  } while (count != rtcCounter());
+  return count * (kPrescaler + 1u) + (kPrescaler - divider);
+}
+
+// ALRF rises as CNT passes ALR; a flag left from an earlier wait would end
+// this one at once.
+void setAlarm(uint32_t count)
+{
+  enterRtcConfig();
+  RTC->ALRH = static_cast<uint16_t>(count >> 16);
+  RTC->ALRL = static_cast<uint16_t>(count & 0xFFFFu);
+  RTC->CRL &= ~RTC_CRL_ALRF;
+  exitRtcConfig();
+  EXTI->PR = EXTI_PR_PR17;
+}
+
+// SysTick stood still for `ticks` LSE periods; the fraction of a
+// millisecond is carried to the next sleep so millis() does not drift.
+void creditMillis(uint32_t ticks)
+{
+  const uint64_t scaled = static_cast<uint64_t>(ticks) * 1000u + gCreditRest;
+  gCreditRest = static_cast<uint32_t>(scaled % LSE_VALUE);
+  const uint32_t primask = __get_PRIMASK();
+  __disable_irq();
+  uwTick += static_cast<uint32_t>(scaled / LSE_VALUE);
+  __set_PRIMASK(primask);
+}
+
+uint32_t stopNow(void*)
+{
+  return millis();
+}
+
+void stopSleep(void*, uint32_t deadlineMs)
+{
+  const int32_t waitMs = static_cast<int32_t>(deadlineMs - millis());
+  if (waitMs <= 0)
+  {
+    return;
+  }
+  if (waitMs < ASAP_POWER_STOP_MIN_MS || (gAllowStop && !gAllowStop(gStopContext)))
+  {
+    __WFI();
+    return;
+  }
+  // kStopLeadMs short of the deadline, in whole counts. The current count
+  // is partly gone, so the alarm never ends STOP after the deadline; the
+  // scheduler sleeps what is left in WFI on its next pass.
+  const uint32_t counts = (static_cast<uint32_t>(waitMs) - kStopLeadMs) * ASAP_POWER_RTC_HZ / 1000u;
+  const uint32_t startTicks = rtcTicks();
+  setAlarm(rtcCounter() + counts - 1u);
+  LowPower.deepSleep();  // no argument: the alarm above is the wakeup
+  syncRtc();
+  // However STOP ended: the alarm, or an EXTI (GDO0 end of packet, a
+  // button) before it. A handler that ran on that wakeup still saw
+  // millis() from before.
+  creditMillis(rtcTicks() - startTicks);
+}
+}  // namespace
+
+asap::core::SchedulerClock stopModeClock(StopGate allowStop, void* context)
+{
+  gAllowStop = allowStop;
+  gStopContext = context;
+  static bool started = false;
+  if (!started)
+  {
+    STM32RTC& rtc = STM32RTC::getInstance();
+    rtc.setClockSource(STM32RTC::LSE_CLOCK);
+    rtc.begin();
+    LowPower.begin();
+    configureRtc();
+    started = true;
+  }
+  return asap::core::SchedulerClock{&stopNow, &stopSleep, nullptr};
+}
+
+#else
+
+asap::core::SchedulerClock stopModeClock(StopGate, void*)
+{
+  return asap::core::hardwareClock();
+}
+
+#endif  // ASAP_POWER_HAVE_STOP
+
+}  // namespace asap::power
+
+#endif  // ARDUINO
+//
+// StopClock.cpp
+// The STOP entry itself (regulator mode, clock restore from HSI to the PLL
+// on wakeup) is the Low Power library's; this file runs the RTC at
+// ASAP_POWER_RTC_HZ, sets the alarm for each wait and keeps millis() honest
+// afterwards.
+//
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <stdint.h>
+#include <asap/core/Scheduler.h>
+#include <asap/power/PowerModel.h>  // ASAP_POWER_STOP_MIN_MS, kStopLeadMs
+
+namespace asap::power
+{
+
+#ifdef ARDUINO
+// Scheduler clock for roles with nothing to do between deadlines (battery
+// emitters): waits of ASAP_POWER_STOP_MIN_MS or more are spent in STOP mode
+// with an RTC alarm kStopLeadMs before the deadline (the RTC counts at
+// ASAP_POWER_RTC_HZ), shorter ones in WFI like
+// asap::core::hardwareClock(). SysTick stops in STOP, so millis() is moved
+// on by what the RTC counted across the sleep, whether the alarm or another
+// interrupt (a radio GDO edge) ended it.
+//
+// allowStop, when given, is asked before every STOP wait; false keeps that
+// wait in WFI on SysTick, for a role whose timing between some deadlines
+// must be finer than the STOP wakeup (ArtifactEngine::betweenCycles()).
+//
+// Needs the STM32duino Low Power and RTC libraries (lib_deps of the
+// beacon image); without them this is hardwareClock().
+using StopGate = bool (*)(void* context);
+asap::core::SchedulerClock stopModeClock(StopGate allowStop = nullptr, void* context = nullptr);
+#endif
+
+}  // namespace asap::power
+//
+// StopClock.h
+// Installed with Scheduler::setClock() from the role's setupRole(); the
+// scheduler itself does not know which sleep it gets.
+//
@@ -0,0 +1,233 @@
+#include <asap/profile/Profiler.h>
+
+#if ASAP_PROFILE
+
+#include <stdio.h>  // snprintf for dump lines
+
+#ifdef ARDUINO
+#include <Arduino.h>  // DWT / CoreDebug (CMSIS), Serial
+#else
+#include <chrono>  // steady_clock ticks
+#endif
+
+namespace asap::profile
+{
+
+namespace
+{
+// On native, SnapshotRunner renders on several threads; each profiles its
+// own renders, and dump() reports the calling thread's.
+#ifdef ARDUINO
+Histogram gHistograms[kProbeCount];
+#else
+thread_local Histogram gHistograms[kProbeCount];
+#endif
+
+constexpr const char* kNames[kProbePage0] = {
+    "renderFrame", "anomalyHud", "anomalyUpdate", "arc", "sendBuffer",
+};
+
+// Index of the most significant set bit; v != 0.
+inline uint8_t msb(uint32_t v)
+{
+  return static_cast<uint8_t>(31 - __builtin_clz(v));
+}
+}  // namespace
+
+// ---- Tick source ------------------------------------------------------------
+
+#ifdef ARDUINO
+
+uint32_t ticks()
+{
+  return DWT->CYCCNT;
+}
+
+const char* tickUnit()
+{
+  return "cyc";
+}
+
+void begin()
+{
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CYCCNT = 0;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+#else
+
+uint32_t ticks()
+{
+  using Clock = std::chrono::steady_clock;
+  return static_cast<uint32_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count());
+}
+
+const char* tickUnit()
+{
+  return "ns";
+}
+
+void begin()
+{
+}
+
+#endif  // ARDUINO
+
+// ---- Histogram --------------------------------------------------------------
+
+// Values below 2^kSubBits get a bucket each; above, the top kSubBits bits
+// under the leading one select one of four buckets of its power of two.
+uint8_t Histogram::bucketOf(uint32_t ticks)
+{
+  constexpr uint32_t kSub = 1u << kSubBits;
+  if (ticks < kSub)
+  {
+    return static_cast<uint8_t>(ticks);
+  }
+  const uint8_t top = msb(ticks);
+  if (top >= kMaxBits)
+  {
+    return kBuckets - 1;
+  }
+  const uint32_t sub = (ticks >> (top - kSubBits)) & (kSub - 1);
+  return static_cast<uint8_t>(((top - kSubBits + 1) << kSubBits) + sub);
+}
+
+uint32_t Histogram::bucketFloor(uint8_t bucket)
+{
+  constexpr uint32_t kSub = 1u << kSubBits;
+  if (bucket < kSub)
+  {
+    return bucket;
+  }
+  const uint8_t top = static_cast<uint8_t>((bucket >> kSubBits) + kSubBits - 1);
+  return (kSub + (bucket & (kSub - 1))) << (top - kSubBits);
+}
+
+void Histogram::record(uint32_t ticks)
+{
+  uint16_t& bucket = buckets_[bucketOf(ticks)];
+  if (bucket == UINT16_MAX)
+  {
+    for (uint16_t& b : buckets_)
+    {
+      b = static_cast<uint16_t>((b + 1) >> 1);
+    }
+  }
+  ++bucket;
+  min_ = count_ == 0 || ticks < min_ ? ticks : min_;
+  max_ = ticks > max_ ? ticks : max_;
+  ++count_;
+  sum_ += ticks;
+}
+
+void Histogram::reset()
+{
+  *this = Histogram{};
+}
+
+uint32_t Histogram::percentile(uint8_t pct) const
+{
+  uint32_t total = 0;
+  for (uint16_t b : buckets_)
+  {
+    total += b;
+  }
+  if (total == 0)
+  {
+    return 0;
+  }
+  const uint32_t rank = (total * pct + 99) / 100;
+  uint32_t seen = 0;
+  for (uint8_t i = 0; i < kBuckets; ++i)
+  {
+    seen += buckets_[i];
+    if (seen >= rank && seen > 0)
+    {
+      const uint32_t upper = i + 1 < kBuckets ? bucketFloor(static_cast<uint8_t>(i + 1)) - 1 : max_;
+      return upper < min_ ? min_ : (upper > max_ ? max_ : upper);
+    }
+  }
+  return max_;
+}
+
+// ---- Probe table ------------------------------------------------------------
+
+void record(uint8_t probe, uint32_t ticks)
+{
+  if (probe < kProbeCount)
+  {
+    gHistograms[probe].record(ticks);
+  }
+}
+
+const Histogram& histogram(uint8_t probe)
+{
+  return gHistograms[probe < kProbeCount ? probe : 0];
+}
+
+void reset()
+{
+  for (Histogram& h : gHistograms)
+  {
+    h.reset();
+  }
+}
+
+const char* probeName(uint8_t probe)
+{
+  return probe < kProbePage0 ? kNames[probe] : "page";
+}
+
+void dump(LineWriter write, void* context)
+{
+  char line[96];
+  snprintf(line, sizeof(line), "%-14s %8s %9s %9s %9s %9s %9s  (%s)", "probe", "count", "min", "p50", "p99",
+           "max", "mean", tickUnit());
+  write(line, context);
+  for (uint8_t p = 0; p < kProbeCount; ++p)
+  {
+    const Histogram& h = gHistograms[p];
+    if (h.count() == 0)
+    {
+      continue;
+    }
+    char name[16];
+    if (p < kProbePage0)
+    {
+      snprintf(name, sizeof(name), "%s", kNames[p]);
+    }
+    else
+    {
+      snprintf(name, sizeof(name), "page %u", static_cast<unsigned>(p - kProbePage0));
+    }
+    snprintf(line, sizeof(line), "%-14s %8lu %9lu %9lu %9lu %9lu %9lu", name, static_cast<unsigned long>(h.count()),
+             static_cast<unsigned long>(h.min()), static_cast<unsigned long>(h.percentile(50)),
+             static_cast<unsigned long>(h.percentile(99)), static_cast<unsigned long>(h.max()),
+             static_cast<unsigned long>(h.mean()));
+    write(line, context);
+  }
+}
+
+#ifdef ARDUINO
+void dumpToSerial()
+{
+  dump([](const char* line, void*) { Serial.println(line); }, nullptr);
+}
+#else
+void dumpToStdout()
+{
+  dump([](const char* line, void*) { puts(line); }, nullptr);
+}
+#endif
+
+}  // namespace asap::profile
+
+#endif  // ASAP_PROFILE
+//
+// Profiler.cpp
+// record() is a bucket index (one CLZ) and a few compares: cheap enough to
+// leave around every arc of the HUD, whose own cost is a few hundred cycles.
+//
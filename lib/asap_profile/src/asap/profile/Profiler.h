@@ -0,0 +1,127 @@
+#pragma once
+
+#include <stdint.h>
+
+// Render profiling (override with -D in platformio.ini). With 0 every
+// ASAP_PROFILE_* macro expands to nothing and this module to an empty
+// translation unit, so release images carry neither code nor RAM for it.
+#ifndef ASAP_PROFILE
+#define ASAP_PROFILE 0
+#endif
+
+// Probe slots reserved for UIController page hooks (one per ui::State).
+#ifndef ASAP_PROFILE_PAGES
+#define ASAP_PROFILE_PAGES 12
+#endif
+
+#if ASAP_PROFILE
+
+namespace asap::profile
+{
+
+// Probe IDs: renderer primitives, then one slot per UI page in ui::State
+// order. Probes nest; each one records the time inclusive of the probes it
+// contains.
+enum ProbeId : uint8_t
+{
+  kProbeRenderFrame,        // renderFrameU8g2 / renderFramePagedU8g2 (paged: incl. sending)
+  kProbeAnomalyIndicators,  // drawAnomalyIndicatorsU8g2 / paged variant: full HUD redraw
+  kProbeAnomalyUpdate,      // updateAnomalyIndicatorsU8g2: incremental HUD
+  kProbeArc,                // one ring: span table or LUT rasterizer
+  kProbeSendBuffer,         // full-buffer flush: sendBuffer() or dirty-tile spans
+  kProbePage0,              // UIController page render hook of State 0
+  kProbeCount = kProbePage0 + ASAP_PROFILE_PAGES,
+};
+
+// Tick source: DWT CYCCNT on the Cortex-M3 (CPU cycles, wraps every 59 s at
+// 72 MHz), std::chrono::steady_clock on native (nanoseconds). Differences
+// are wrap-safe for anything shorter than that.
+uint32_t ticks();
+const char* tickUnit();  // "cyc" or "ns"
+
+// Start the cycle counter (DWT trace enable); no-op on native.
+void begin();
+
+// Durations of one probe: a log-linear histogram with four buckets per
+// power of two (each at most 25 % wide) up to 2^kMaxBits ticks, plus exact
+// count, min, max and sum. When a bucket saturates every bucket is halved,
+// so the shape (and the percentiles) keep following recent frames in a
+// fixed 200 bytes.
+class Histogram
+{
+ public:
+  static constexpr uint8_t kSubBits = 2;
+  static constexpr uint8_t kMaxBits = 26;  // 0.9 s of cycles, 67 ms of ns
+  static constexpr uint8_t kBuckets = (kMaxBits - 1) << kSubBits;
+
+  void record(uint32_t ticks);
+  void reset();
+
+  uint32_t count() const { return count_; }
+  uint32_t min() const { return count_ ? min_ : 0; }
+  uint32_t max() const { return max_; }
+  uint32_t mean() const { return count_ ? static_cast<uint32_t>(sum_ / count_) : 0; }
+  // Upper bound of the bucket holding the pct-th percentile, clamped to
+  // [min, max].
+  uint32_t percentile(uint8_t pct) const;
+
+  static uint8_t bucketOf(uint32_t ticks);
+  static uint32_t bucketFloor(uint8_t bucket);
+
+ private:
+  uint16_t buckets_[kBuckets];
+  uint32_t count_;
+  uint32_t min_;
+  uint32_t max_;
+  uint64_t sum_;
+};
+
+void record(uint8_t probe, uint32_t ticks);
+const Histogram& histogram(uint8_t probe);
+void reset();
+
+// "renderFrame", "arc", ... and "page" for the page slots.
+const char* probeName(uint8_t probe);
+
+// One header line, then a line per probe that ran: name, count, min, p50,
+// p99, max and mean in ticks. `write` gets each line without its newline.
+using LineWriter = void (*)(const char* line, void* context);
+void dump(LineWriter write, void* context);
+#ifdef ARDUINO
+void dumpToSerial();  // Serial (USART1 on the detector), 115200 baud set up by the caller
+#else
+void dumpToStdout();
+#endif
+
+// Times its own scope into one probe.
+class ScopedProbe
+{
+ public:
+  explicit ScopedProbe(uint8_t probe) : probe_(probe), start_(ticks()) {}
+  ~ScopedProbe() { record(probe_, ticks() - start_); }
+  ScopedProbe(const ScopedProbe&) = delete;
+  ScopedProbe& operator=(const ScopedProbe&) = delete;
+
+ private:
+  uint8_t probe_;
+  uint32_t start_;
+};
+
+}  // namespace asap::profile
+
+#define ASAP_PROFILE_CAT2(a, b) a##b
+#define ASAP_PROFILE_CAT(a, b) ASAP_PROFILE_CAT2(a, b)
+#define ASAP_PROFILE_SCOPE(probe) \
+  const ::asap::profile::ScopedProbe ASAP_PROFILE_CAT(asapProbe, __LINE__)(static_cast<uint8_t>(probe))
+
+#else  // !ASAP_PROFILE
+
+#define ASAP_PROFILE_SCOPE(probe)
+
+#endif  // ASAP_PROFILE
+//
+// Profiler.h
+// Answers "how long does this frame take on the STM32": wrap a scope with
+// ASAP_PROFILE_SCOPE(kProbeX) and dump the table over UART. Native ticks
+// are wall time of the host, only useful for relative costs.
+//
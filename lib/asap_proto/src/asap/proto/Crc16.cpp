@@ -0,0 +1,46 @@
+#include <asap/proto/Crc16.h>
+
+namespace asap::proto
+{
+
+namespace
+{
+struct CrcTable
+{
+  uint16_t entry[256];
+};
+
+constexpr CrcTable buildTable()
+{
+  CrcTable table{};
+  for (uint16_t i = 0; i < 256; ++i)
+  {
+    uint16_t crc = static_cast<uint16_t>(i << 8);
+    for (uint8_t bitIndex = 0; bitIndex < 8; ++bitIndex)
+    {
+      crc = static_cast<uint16_t>((crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1);
+    }
+    table.entry[i] = crc;
+  }
+  return table;
+}
+
+constexpr CrcTable kTable = buildTable();  // 512 B in flash
+static_assert(kTable.entry[1] == 0x1021 && kTable.entry[255] == 0x1EF0, "CRC table");
+}  // namespace
+
+uint16_t crc16(const uint8_t* data, uint16_t length, uint16_t crc)
+{
+  for (uint16_t i = 0; i < length; ++i)
+  {
+    crc = static_cast<uint16_t>((crc << 8) ^ kTable.entry[((crc >> 8) ^ data[i]) & 0xFF]);
+  }
+  return crc;
+}
+
+}  // namespace asap::proto
+//
+// Crc16.cpp
+// One table lookup per byte: a 61-byte packet costs a few hundred cycles on
+// the Cortex-M3, well below the time the radio takes to receive it.
+//
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <stdint.h>
+
+namespace asap::proto
+{
+
+// CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF, no reflection), table driven.
+// Catches every single- and double-bit error within a packet.
+uint16_t crc16(const uint8_t* data, uint16_t length, uint16_t crc = 0xFFFF);
+
+}  // namespace asap::proto
+//
+// Crc16.h
+// End-to-end check of the packet layouts. The CC1101 CRC only covers the
+// radio hop; this one also rejects frames from other firmware revisions.
+//
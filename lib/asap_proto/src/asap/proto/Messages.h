@@ -0,0 +1,130 @@
+#pragma once
+
+#include <asap/proto/Schema.h>
+
+namespace asap::proto
+{
+
+// Bump a schema's kVersion whenever its field list changes; receivers drop
+// versions they do not know instead of misreading them.
+
+// Beacon presence ping, tracked by detectors by emitter ID and RSSI.
+struct BeaconMsg
+{
+  static constexpr MsgType kType = MsgType::Beacon;
+  static constexpr uint8_t kVersion = 1;
+  enum Field : uint8_t
+  {
+    TxPowerDbm,  // transmit power, for distance estimates
+    PeriodMs,    // nominal interval to the next ping
+    Flags,
+    kFieldCount
+  };
+  static constexpr FieldSpec kFields[kFieldCount] = {
+      {1, true},
+      {2, false},
+      {1, false},
+  };
+};
+
+// Anomaly emission: intensity per HUD channel (0..255, 0 = silent).
+struct AnomalyMsg
+{
+  static constexpr MsgType kType = MsgType::Anomaly;
+  static constexpr uint8_t kVersion = 1;
+  enum Field : uint8_t
+  {
+    Rad,
+    Therm,
+    Chem,
+    Psy,
+    BurstSeq,  // increments per burst, for loss accounting
+    kFieldCount
+  };
+  static constexpr FieldSpec kFields[kFieldCount] = {
+      {1, false},
+      {1, false},
+      {1, false},
+      {1, false},
+      {1, false},
+  };
+};
+
+// Artifact signature ping.
+struct ArtifactMsg
+{
+  static constexpr MsgType kType = MsgType::Artifact;
+  static constexpr uint8_t kVersion = 1;
+  enum Field : uint8_t
+  {
+    Signature,  // artifact class code
+    PingIndex,  // position in the timing fingerprint
+    kFieldCount
+  };
+  static constexpr FieldSpec kFields[kFieldCount] = {
+      {2, false},
+      {1, false},
+  };
+};
+
+// Game-master configuration push: one key/value per packet, addressed to a
+// device ID or kBroadcastId.
+struct GameConfigMsg
+{
+  static constexpr MsgType kType = MsgType::GameConfig;
+  static constexpr uint8_t kVersion = 1;
+  enum Field : uint8_t
+  {
+    TargetId,
+    ConfigVersion,  // receivers ignore versions older than the one applied
+    Key,
+    Value,
+    kFieldCount
+  };
+  static constexpr FieldSpec kFields[kFieldCount] = {
+      {2, false},
+      {2, false},
+      {1, false},
+      {4, true},
+  };
+};
+
+// TDMA time base, sent by the sync source at the start of a superframe
+// (asap::radio::TdmaMac). Followers adopt the frame number and the shape.
+struct SyncMsg
+{
+  static constexpr MsgType kType = MsgType::Sync;
+  static constexpr uint8_t kVersion = 1;
+  enum Field : uint8_t
+  {
+    Frame,  // superframe number this packet opens
+    SlotMs,
+    DataSlots,
+    kFieldCount
+  };
+  static constexpr FieldSpec kFields[kFieldCount] = {
+      {2, false},
+      {1, false},
+      {1, false},
+  };
+};
+
+using BeaconView = View<BeaconMsg>;
+using AnomalyView = View<AnomalyMsg>;
+using ArtifactView = View<ArtifactMsg>;
+using GameConfigView = View<GameConfigMsg>;
+using SyncView = View<SyncMsg>;
+
+// Sizes are part of the wire format too; a change here needs a version bump.
+static_assert(Layout<BeaconMsg>::kPacketBytes == 11, "BeaconMsg layout changed");
+static_assert(Layout<AnomalyMsg>::kPacketBytes == 12, "AnomalyMsg layout changed");
+static_assert(Layout<ArtifactMsg>::kPacketBytes == 10, "ArtifactMsg layout changed");
+static_assert(Layout<GameConfigMsg>::kPacketBytes == 16, "GameConfigMsg layout changed");
+static_assert(Layout<SyncMsg>::kPacketBytes == 11, "SyncMsg layout changed");
+
+}  // namespace asap::proto
+//
+// Messages.h
+// The over-the-air vocabulary shared by all four roles. Packets are a dozen
+// bytes, about 4 ms on air at 38.4 kBaud including preamble and sync.
+//
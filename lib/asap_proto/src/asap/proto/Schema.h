@@ -0,0 +1,207 @@
+#pragma once
+
+#include <stdint.h>
+#include <asap/proto/Crc16.h>
+#include <asap/radio/RadioConfig.h>
+
+namespace asap::proto
+{
+
+// Message types on air. Values are part of the wire format: never reuse one.
+enum class MsgType : uint8_t
+{
+  Unknown = 0,
+  Beacon = 1,
+  Anomaly = 2,
+  Artifact = 3,
+  GameConfig = 4,
+  Sync = 5,
+};
+
+// Every packet: [type][version][emitter lo][emitter hi][seq] body [crc lo][crc hi]
+// Multi-byte fields are little endian; the CRC covers header and body.
+constexpr uint8_t kHeaderBytes = 5;
+constexpr uint8_t kCrcBytes = 2;
+constexpr uint8_t kTypeOffset = 0;
+constexpr uint8_t kVersionOffset = 1;
+constexpr uint8_t kEmitterOffset = 2;
+constexpr uint8_t kSeqOffset = 4;
+constexpr uint16_t kBroadcastId = 0xFFFF;
+
+// One body field: 1..4 bytes, optionally two's complement.
+struct FieldSpec
+{
+  uint8_t width;
+  bool isSigned;
+};
+
+// Type of the packet in data[0..length), or Unknown if it cannot even hold a
+// header. The matching View does the full check.
+inline MsgType peekType(const uint8_t* data, uint8_t length)
+{
+  if (!data || length < kHeaderBytes + kCrcBytes)
+  {
+    return MsgType::Unknown;
+  }
+  return static_cast<MsgType>(data[kTypeOffset]);
+}
+
+// Compile-time layout of a schema S, which provides:
+//   static constexpr MsgType kType;
+//   static constexpr uint8_t kVersion;
+//   enum Field : uint8_t { ..., kFieldCount };
+//   static constexpr FieldSpec kFields[kFieldCount];
+template <class S>
+struct Layout
+{
+  static constexpr uint8_t offset(uint8_t field)
+  {
+    uint8_t at = kHeaderBytes;
+    for (uint8_t i = 0; i < field; ++i)
+    {
+      at = static_cast<uint8_t>(at + S::kFields[i].width);
+    }
+    return at;
+  }
+
+  static constexpr bool widthsValid()
+  {
+    for (uint8_t i = 0; i < S::kFieldCount; ++i)
+    {
+      if (S::kFields[i].width < 1 || S::kFields[i].width > 4)
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  static constexpr uint8_t kBodyBytes = static_cast<uint8_t>(offset(S::kFieldCount) - kHeaderBytes);
+  static constexpr uint8_t kPacketBytes = static_cast<uint8_t>(kHeaderBytes + kBodyBytes + kCrcBytes);
+
+  static_assert(widthsValid(), "schema fields must be 1..4 bytes wide");
+  static_assert(kPacketBytes <= asap::radio::kMaxPayload, "schema does not fit one radio packet");
+  static_assert(S::kType != MsgType::Unknown, "schema needs a message type");
+};
+
+namespace detail
+{
+inline void storeLe(uint8_t* at, uint32_t value, uint8_t width)
+{
+  for (uint8_t i = 0; i < width; ++i)
+  {
+    at[i] = static_cast<uint8_t>(value >> (8 * i));
+  }
+}
+
+inline uint32_t loadLe(const uint8_t* at, uint8_t width)
+{
+  uint32_t value = 0;
+  for (uint8_t i = 0; i < width; ++i)
+  {
+    value |= static_cast<uint32_t>(at[i]) << (8 * i);
+  }
+  return value;
+}
+}  // namespace detail
+
+// Builds one packet of schema S in a fixed buffer: header at construction,
+// fields with set<Field>(), CRC in seal(). Unset fields are zero.
+template <class S>
+class Encoder
+{
+ public:
+  using L = Layout<S>;
+
+  Encoder(uint16_t emitterId, uint8_t seq)
+      : bytes_{}
+  {
+    bytes_[kTypeOffset] = static_cast<uint8_t>(S::kType);
+    bytes_[kVersionOffset] = S::kVersion;
+    detail::storeLe(&bytes_[kEmitterOffset], emitterId, 2);
+    bytes_[kSeqOffset] = seq;
+  }
+
+  // Values are truncated to the field width (signed fields: two's complement).
+  template <uint8_t F>
+  Encoder& set(int32_t value)
+  {
+    static_assert(F < S::kFieldCount, "no such field in this schema");
+    detail::storeLe(&bytes_[L::offset(F)], static_cast<uint32_t>(value), S::kFields[F].width);
+    return *this;
+  }
+
+  // Append the CRC; returns the packet length.
+  uint8_t seal()
+  {
+    const uint16_t crc = crc16(bytes_, L::kPacketBytes - kCrcBytes);
+    detail::storeLe(&bytes_[L::kPacketBytes - kCrcBytes], crc, kCrcBytes);
+    return L::kPacketBytes;
+  }
+
+  const uint8_t* data() const { return bytes_; }
+  static constexpr uint8_t size() { return L::kPacketBytes; }
+
+ private:
+  uint8_t bytes_[L::kPacketBytes];
+};
+
+// Read-only view of a received packet of schema S, parsed in place (e.g. over
+// a radio RxSlot payload). The constructor checks length, type, version and
+// CRC once; accessors read only inside the checked bytes and return zero on
+// an invalid view.
+template <class S>
+class View
+{
+ public:
+  using L = Layout<S>;
+
+  View(const uint8_t* data, uint8_t length)
+      : data_(check(data, length) ? data : nullptr)
+  {
+  }
+
+  bool valid() const { return data_ != nullptr; }
+  uint16_t emitterId() const { return valid() ? static_cast<uint16_t>(detail::loadLe(&data_[kEmitterOffset], 2)) : 0; }
+  uint8_t seq() const { return valid() ? data_[kSeqOffset] : 0; }
+
+  template <uint8_t F>
+  uint32_t get() const
+  {
+    static_assert(F < S::kFieldCount, "no such field in this schema");
+    return valid() ? detail::loadLe(&data_[L::offset(F)], S::kFields[F].width) : 0;
+  }
+
+  template <uint8_t F>
+  int32_t getSigned() const
+  {
+    static_assert(F < S::kFieldCount && S::kFields[F].isSigned, "field is not signed");
+    constexpr uint8_t kShift = static_cast<uint8_t>(32 - 8 * S::kFields[F].width);
+    return static_cast<int32_t>(get<F>() << kShift) >> kShift;
+  }
+
+ private:
+  static bool check(const uint8_t* data, uint8_t length)
+  {
+    if (!data || length != L::kPacketBytes)
+    {
+      return false;
+    }
+    if (data[kTypeOffset] != static_cast<uint8_t>(S::kType) || data[kVersionOffset] != S::kVersion)
+    {
+      return false;
+    }
+    const uint16_t crc = static_cast<uint16_t>(detail::loadLe(&data[L::kPacketBytes - kCrcBytes], kCrcBytes));
+    return crc16(data, L::kPacketBytes - kCrcBytes) == crc;
+  }
+
+  const uint8_t* data_;
+};
+
+}  // namespace asap::proto
+//
+// Schema.h
+// One constexpr description per message drives both directions: Encoder and
+// View take field offsets and widths from Layout<S>, so the two cannot drift
+// apart, and a field index that does not exist fails to compile.
+//
@@ -0,0 +1,348 @@
+#include <asap/radio/Cc1101.h>
+
+#include <string.h>  // memcpy/memset for FIFO transfers
+
+#include <asap/radio/Cc1101Regs.h>
+
+namespace asap::radio
+{
+
+static_assert(Cc1101::kTxSlots > 0 && (256 % Cc1101::kTxSlots) == 0,
+              "ASAP_RADIO_TX_SLOTS must divide 256");
+static_assert(kFrameBytes <= cc1101::kFifoBytes, "a frame must fit the FIFO");
+
+namespace
+{
+struct RegisterValue
+{
+  uint8_t reg;
+  uint8_t value;
+};
+
+// 26 MHz crystal, 433.92 MHz, 38.4 kBaud GFSK, 20 kHz deviation, 100 kHz
+// RX filter (SmartRF Studio), plus the packet/GDO setup the driver relies on.
+constexpr RegisterValue kConfig[] = {
+    {cc1101::IOCFG2, 0x04},    // GDO2: RX FIFO overflow
+    {cc1101::IOCFG0, 0x06},    // GDO0: sync word .. end of packet
+    {cc1101::FIFOTHR, 0x47},
+    {cc1101::SYNC1, 0xD3},
+    {cc1101::SYNC0, 0x91},
+    {cc1101::PKTLEN, kMaxPayload},  // longer frames are discarded by the chip
+    {cc1101::PKTCTRL1, 0x04},  // APPEND_STATUS, no address check
+    {cc1101::PKTCTRL0, 0x05},  // CRC on, variable length
+    {cc1101::ADDR, 0x00},
+    {cc1101::FSCTRL1, 0x06},
+    {cc1101::FREQ2, 0x10},
+    {cc1101::FREQ1, 0xB0},
+    {cc1101::FREQ0, 0x71},
+    {cc1101::MDMCFG4, 0xCA},
+    {cc1101::MDMCFG3, 0x83},
+    {cc1101::MDMCFG2, 0x13},   // GFSK, 30/32 sync bits
+    {cc1101::MDMCFG1, 0x22},
+    {cc1101::MDMCFG0, 0xF8},
+    {cc1101::DEVIATN, 0x35},
+    {cc1101::MCSM1, 0x0F},     // no CCA; RXOFF -> RX, TXOFF -> RX
+    {cc1101::MCSM0, 0x18},     // calibrate IDLE -> RX/TX
+    {cc1101::FOCCFG, 0x16},
+    {cc1101::AGCCTRL2, 0x43},
+    {cc1101::WORCTRL, 0xFB},
+    {cc1101::FREND0, 0x10},
+    {cc1101::FSCAL3, 0xE9},
+    {cc1101::FSCAL2, 0x2A},
+    {cc1101::FSCAL1, 0x00},
+    {cc1101::FSCAL0, 0x1F},
+    {cc1101::TEST2, 0x81},
+    {cc1101::TEST1, 0x35},
+    {cc1101::TEST0, 0x09},
+};
+
+constexpr uint8_t kPaTable10dBm = 0xC0;
+}  // namespace
+
+Cc1101::Cc1101(const Cc1101Port& port)
+    : port_(port),
+      tx_{},
+      txHead_(0),
+      txTail_(0),
+      txActive_(false),
+      asleep_(false),
+      rxPending_(0),
+      rxPackets_(0),
+      rxDropped_(0),
+      crcErrors_(0),
+      overflows_(0),
+      txPackets_(0),
+      wakeups_(0)
+{
+}
+
+bool Cc1101::begin(uint8_t channel)
+{
+  port_.maskIrq(port_.context, true);
+  strobe(cc1101::SRES);
+  const uint8_t version = readStatus(cc1101::VERSION);
+  if (version != cc1101::kExpectedVersion)
+  {
+    port_.maskIrq(port_.context, false);
+    return false;
+  }
+  for (const RegisterValue& rv : kConfig)
+  {
+    writeRegister(rv.reg, rv.value);
+  }
+  writeRegister(cc1101::CHANNR, channel);
+  writeRegister(cc1101::PATABLE, kPaTable10dBm);
+  asleep_ = false;
+  strobe(cc1101::SIDLE);
+  strobe(cc1101::SFRX);
+  strobe(cc1101::SFTX);
+  strobe(cc1101::SRX);
+  port_.maskIrq(port_.context, false);
+  return true;
+}
+
+bool Cc1101::send(const uint8_t* data, uint8_t length)
+{
+  if (!data || length == 0 || length > kMaxPayload)
+  {
+    return false;
+  }
+  if (txQueued() >= kTxSlots)
+  {
+    return false;
+  }
+  TxSlot& slot = tx_[txHead_ % kTxSlots];
+  slot.length = length;
+  memcpy(slot.data, data, length);
+  port_.maskIrq(port_.context, true);
+  txHead_ = static_cast<uint8_t>(txHead_ + 1);
+  if (!txActive_)
+  {
+    startNextTx();
+  }
+  port_.maskIrq(port_.context, false);
+  return true;
+}
+
+bool Cc1101::sleep()
+{
+  port_.maskIrq(port_.context, true);
+  const bool idle = !txActive_ && txQueued() == 0;
+  if (idle && !asleep_)
+  {
+    rxPending_ = 0;
+    strobe(cc1101::SIDLE);
+    strobe(cc1101::SPWD);
+    asleep_ = true;
+  }
+  port_.maskIrq(port_.context, false);
+  return idle;
+}
+
+// Selecting the chip starts its crystal; the port's select() waits for
+// CHIP_RDYn before the first strobe goes out.
+void Cc1101::wake()
+{
+  if (!asleep_)
+  {
+    return;
+  }
+  port_.maskIrq(port_.context, true);
+  strobe(cc1101::SIDLE);
+  for (const RegisterValue& rv : kConfig)
+  {
+    if (rv.reg >= cc1101::TEST2)
+    {
+      writeRegister(rv.reg, rv.value);
+    }
+  }
+  writeRegister(cc1101::PATABLE, kPaTable10dBm);
+  strobe(cc1101::SFRX);
+  strobe(cc1101::SFTX);
+  asleep_ = false;
+  ++wakeups_;
+  port_.maskIrq(port_.context, false);
+}
+
+void Cc1101::listen()
+{
+  wake();
+  port_.maskIrq(port_.context, true);
+  if (!txActive_)
+  {
+    strobe(cc1101::SRX);  // a TX under way ends in RX by itself
+  }
+  port_.maskIrq(port_.context, false);
+}
+
+// End of packet. In TX this is our own packet leaving (the chip is back in
+// RX); otherwise whole frames are waiting in the RX FIFO.
+void Cc1101::onGdo0()
+{
+  if (txActive_)
+  {
+    if (readStatus(cc1101::MARCSTATE) == cc1101::kMarcTx)
+    {
+      return;  // edge from a reception aborted by STX; ours is still on air
+    }
+    txActive_ = false;
+    txTail_ = static_cast<uint8_t>(txTail_ + 1);
+    ++txPackets_;
+  }
+  drainRx();
+  if (!txActive_ && txQueued() > 0)
+  {
+    startNextTx();
+  }
+}
+
+// RX FIFO overflow: the FIFO is unusable until flushed (drainRx sees the
+// overflow flag and does that).
+void Cc1101::onGdo2()
+{
+  drainRx();
+}
+
+// Move every complete frame from the FIFO into the ring, reading the chip
+// straight into the slot. The ring slot is only committed for good frames.
+// A frame still arriving behind the complete ones keeps its length byte in
+// rxPending_ until its own end-of-packet interrupt.
+void Cc1101::drainRx()
+{
+  for (;;)
+  {
+    uint8_t available = rxBytes();
+    if (available & cc1101::kFifoOverflow)
+    {
+      ++overflows_;
+      flushRx();
+      return;
+    }
+    if (rxPending_ == 0)
+    {
+      if (available == 0)
+      {
+        return;
+      }
+      uint8_t length = 0;
+      readFifo(&length, 1);
+      if (length == 0 || length > kMaxPayload)
+      {
+        flushRx();  // out of sync with the frame boundaries
+        return;
+      }
+      rxPending_ = length;
+      --available;
+    }
+    const uint8_t length = rxPending_;
+    if (available < length + 2)
+    {
+      return;
+    }
+    rxPending_ = 0;
+    RxSlot* slot = rx_.acquire();
+    uint8_t scratch[kFrameBytes];
+    uint8_t* frame = slot ? slot->frame : scratch;
+    frame[0] = length;
+    readFifo(frame + 1, static_cast<uint8_t>(length + 2));
+    if ((frame[length + 2] & cc1101::kCrcOk) == 0)
+    {
+      ++crcErrors_;
+      continue;
+    }
+    if (!slot)
+    {
+      ++rxDropped_;
+      continue;
+    }
+    slot->timeMs = port_.nowMs(port_.context);
+    rx_.commit();
+    ++rxPackets_;
+  }
+}
+
+void Cc1101::startNextTx()
+{
+  const TxSlot& slot = tx_[txTail_ % kTxSlots];
+  writeFifo(&slot.length, 1);
+  writeFifo(slot.data, slot.length);
+  txActive_ = true;
+  strobe(cc1101::STX);
+}
+
+void Cc1101::flushRx()
+{
+  rxPending_ = 0;
+  strobe(cc1101::SIDLE);
+  strobe(cc1101::SFRX);
+  strobe(cc1101::SRX);
+}
+
+void Cc1101::strobe(uint8_t command)
+{
+  uint8_t header = command;
+  port_.select(port_.context, true);
+  port_.transfer(port_.context, &header, 1);
+  port_.select(port_.context, false);
+}
+
+uint8_t Cc1101::readStatus(uint8_t reg)
+{
+  uint8_t buf[2] = {static_cast<uint8_t>(reg | cc1101::kRead | cc1101::kBurst), 0};
+  port_.select(port_.context, true);
+  port_.transfer(port_.context, buf, 2);
+  port_.select(port_.context, false);
+  return buf[1];
+}
+
+// RXBYTES can be caught mid-update while a byte arrives: read until two
+// reads agree (CC1101 errata).
+uint8_t Cc1101::rxBytes()
+{
+  uint8_t last = readStatus(cc1101::RXBYTES);
+  for (;;)
+  {
+    const uint8_t again = readStatus(cc1101::RXBYTES);
+    if (again == last)
+    {
+      return static_cast<uint8_t>(last & (cc1101::kFifoOverflow | cc1101::kFifoCountMask));
+    }
+    last = again;
+  }
+}
+
+void Cc1101::writeRegister(uint8_t reg, uint8_t value)
+{
+  uint8_t buf[2] = {reg, value};
+  port_.select(port_.context, true);
+  port_.transfer(port_.context, buf, 2);
+  port_.select(port_.context, false);
+}
+
+void Cc1101::readFifo(uint8_t* dst, uint8_t length)
+{
+  uint8_t header = cc1101::FIFO | cc1101::kRead | cc1101::kBurst;
+  port_.select(port_.context, true);
+  port_.transfer(port_.context, &header, 1);
+  memset(dst, 0, length);
+  port_.transfer(port_.context, dst, length);
+  port_.select(port_.context, false);
+}
+
+void Cc1101::writeFifo(const uint8_t* src, uint8_t length)
+{
+  uint8_t buf[1 + kMaxPayload];
+  buf[0] = cc1101::FIFO | cc1101::kBurst;
+  memcpy(&buf[1], src, length);
+  port_.select(port_.context, true);
+  port_.transfer(port_.context, buf, static_cast<uint16_t>(length + 1));
+  port_.select(port_.context, false);
+}
+
+}  // namespace asap::radio
+//
+// Cc1101.cpp
+// Both interrupt handlers run with the GDO lines masked against each other
+// by priority (same NVIC level), and the main loop masks them around send(),
+// so SPI transactions never interleave.
+//
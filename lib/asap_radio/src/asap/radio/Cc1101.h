@@ -0,0 +1,119 @@
+#pragma once
+
+#include <stdint.h>
+#include <asap/radio/RadioConfig.h>
+#include <asap/radio/PacketRing.h>
+
+namespace asap::radio
+{
+
+// Board glue of the driver: SPI framing, interrupt masking and a millisecond
+// clock. Implemented by Cc1101Link (STM32, SPI2) and VirtualCc1101 (native).
+struct Cc1101Port
+{
+  void (*select)(void* context, bool selected);
+  // Full-duplex, in place: buf is sent and overwritten with what came back.
+  void (*transfer)(void* context, uint8_t* buf, uint16_t length);
+  // Keep the GDO interrupts from running while the main loop uses the chip.
+  void (*maskIrq)(void* context, bool masked);
+  uint32_t (*nowMs)(void* context);
+  void* context;
+};
+
+// Called (in ISR context) after either GDO handler, e.g. to signal the task
+// that consumes the packet ring.
+using IrqHook = void (*)(void* context);
+
+// CC1101 at 433.92 MHz, 38.4 kBaud GFSK, variable-length packets with CRC
+// and appended RSSI/LQI. The chip stays in RX; TX returns to RX by itself.
+//
+// Interrupts (wired by the port):
+//  - GDO0 (IOCFG0 = 0x06) falls at the end of every packet, RX or TX:
+//    onGdo0() drains all complete frames from the RX FIFO into the packet
+//    ring, or starts the next queued transmission.
+//  - GDO2 (IOCFG2 = 0x04) rises on RX FIFO overflow: onGdo2() flushes and
+//    re-enters RX.
+class Cc1101
+{
+ public:
+  static constexpr uint8_t kTxSlots = ASAP_RADIO_TX_SLOTS;
+
+  explicit Cc1101(const Cc1101Port& port);
+
+  // Reset, check the chip version, load the configuration and enter RX.
+  bool begin(uint8_t channel = 0);
+
+  // Queue a packet (1..kMaxPayload bytes). Returns false when the TX queue is
+  // full (back-pressure: retry later) or the length is invalid.
+  bool send(const uint8_t* data, uint8_t length);
+  uint8_t txQueued() const { return static_cast<uint8_t>(txHead_ - txTail_); }
+  bool txBusy() const { return txActive_; }
+
+  // Received packets, in arrival order.
+  PacketRing& rx() { return rx_; }
+
+  // Power down (SLEEP, ~0.2 uA) once nothing is queued or on air; false
+  // otherwise. The chip hears nothing until wake().
+  bool sleep();
+  // Back to IDLE from sleep(): restores what SLEEP does not retain (PATABLE,
+  // TEST registers) and flushes the FIFOs. The next send() starts TX from
+  // IDLE, after which the chip stays in RX as usual.
+  void wake();
+  bool asleep() const { return asleep_; }
+  // RX without a send() first, waking the chip if it sleeps: for roles that
+  // only listen now and then (a slotted BeaconEngine awaiting the sync
+  // beacon). sleep() ends it.
+  void listen();
+
+  // Interrupt entry points.
+  void onGdo0();
+  void onGdo2();
+
+  // Statistics
+  uint32_t rxPackets() const { return rxPackets_; }
+  uint32_t rxDropped() const { return rxDropped_; }  // ring full
+  uint32_t crcErrors() const { return crcErrors_; }
+  uint32_t fifoOverflows() const { return overflows_; }
+  uint32_t txPackets() const { return txPackets_; }
+  uint32_t wakeups() const { return wakeups_; }
+
+ private:
+  struct TxSlot
+  {
+    uint8_t length;
+    uint8_t data[kMaxPayload];
+  };
+
+  void strobe(uint8_t command);
+  uint8_t readStatus(uint8_t reg);
+  uint8_t rxBytes();
+  void writeRegister(uint8_t reg, uint8_t value);
+  void readFifo(uint8_t* dst, uint8_t length);
+  void writeFifo(const uint8_t* src, uint8_t length);
+  void flushRx();
+  void drainRx();
+  void startNextTx();
+
+  Cc1101Port port_;
+  PacketRing rx_;
+  TxSlot tx_[kTxSlots];
+  volatile uint8_t txHead_;  // next slot to fill (main loop)
+  volatile uint8_t txTail_;  // slot on air / next to send (interrupt)
+  volatile bool txActive_;
+  bool asleep_;
+  uint8_t rxPending_;  // length byte of a frame still arriving
+  uint32_t rxPackets_;
+  uint32_t rxDropped_;
+  uint32_t crcErrors_;
+  uint32_t overflows_;
+  uint32_t txPackets_;
+  uint32_t wakeups_;
+};
+
+}  // namespace asap::radio
+//
+// Cc1101.h
+// Driver core shared by the firmware and the host tests; everything below the
+// SPI byte level lives in the port. Packets never exceed the FIFO, so the
+// end-of-packet interrupt always finds whole frames to move.
+//
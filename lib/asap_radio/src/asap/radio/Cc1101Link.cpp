@@ -0,0 +1,122 @@
+#ifdef ARDUINO
+
+#include <asap/radio/Cc1101Link.h>
+
+#include <Arduino.h>  // STM32duino core: GPIO, EXTI, millis
+#include <SPI.h>      // SPIClass on the SPI2 pins
+
+namespace asap::radio
+{
+
+namespace
+{
+constexpr uint32_t kMosi = PB15;
+constexpr uint32_t kMiso = PB14;
+constexpr uint32_t kSck = PB13;
+
+SPIClass gSpi(kMosi, kMiso, kSck);
+const SPISettings kSettings(4500000, MSBFIRST, SPI_MODE0);  // CC1101: <= 6.5 MHz burst
+RadioPins gPins{};
+Cc1101* gRadio = nullptr;
+IrqHook gHook = nullptr;
+void* gHookContext = nullptr;
+
+void select(void*, bool selected)
+{
+  if (selected)
+  {
+    gSpi.beginTransaction(kSettings);
+    digitalWrite(gPins.chipSelect, LOW);
+    // The chip pulls SO low once its crystal runs (after SRES and when
+    // waking from SLEEP).
+    while (digitalRead(kMiso) == HIGH)
+    {
+    }
+  }
+  else
+  {
+    digitalWrite(gPins.chipSelect, HIGH);
+    gSpi.endTransaction();
+  }
+}
+
+void transfer(void*, uint8_t* buf, uint16_t length)
+{
+  gSpi.transfer(buf, length);
+}
+
+void maskIrq(void*, bool masked)
+{
+  if (masked)
+  {
+    NVIC_DisableIRQ(EXTI15_10_IRQn);  // GDO0/GDO2 on lines 10..15
+  }
+  else
+  {
+    NVIC_EnableIRQ(EXTI15_10_IRQn);
+  }
+}
+
+uint32_t nowMs(void*)
+{
+  return millis();
+}
+
+void onGdo0()
+{
+  if (gRadio)
+  {
+    gRadio->onGdo0();
+  }
+  if (gHook)
+  {
+    gHook(gHookContext);
+  }
+}
+
+void onGdo2()
+{
+  if (gRadio)
+  {
+    gRadio->onGdo2();
+  }
+  if (gHook)
+  {
+    gHook(gHookContext);
+  }
+}
+}  // namespace
+
+Cc1101Port Cc1101Link::port()
+{
+  return Cc1101Port{&select, &transfer, &maskIrq, &nowMs, nullptr};
+}
+
+void Cc1101Link::begin(const RadioPins& pins)
+{
+  gPins = pins;
+  pinMode(pins.chipSelect, OUTPUT);
+  digitalWrite(pins.chipSelect, HIGH);
+  pinMode(pins.gdo0, INPUT);
+  pinMode(pins.gdo2, INPUT);
+  gSpi.begin();
+}
+
+void Cc1101Link::attach(Cc1101& radio, IrqHook onIrq, void* context)
+{
+  gRadio = &radio;
+  gHook = onIrq;
+  gHookContext = context;
+  attachInterrupt(digitalPinToInterrupt(gPins.gdo0), &onGdo0, FALLING);
+  attachInterrupt(digitalPinToInterrupt(gPins.gdo2), &onGdo2, RISING);
+}
+
+}  // namespace asap::radio
+
+#endif  // ARDUINO
+//
+// Cc1101Link.cpp
+// maskIrq() assumes both GDO lines sit on EXTI 10..15 (PB10/PB11 on the
+// detector), so masking that one vector keeps the interrupts out of a
+// main-loop SPI transaction without touching the display DMA or SysTick.
+//
@@ -0,0 +1,44 @@
+#pragma once
+
+#ifdef ARDUINO
+
+#include <stdint.h>
+#include <asap/radio/Cc1101.h>
+
+namespace asap::radio
+{
+
+// CC1101 wiring. SCK/MISO/MOSI are fixed to SPI2 (PB13/PB14/PB15); SPI1
+// belongs to the display.
+struct RadioPins
+{
+  uint32_t chipSelect;
+  uint32_t gdo0;
+  uint32_t gdo2;
+};
+
+// STM32 glue for Cc1101: SPI2 at 4.5 MHz and GDO0/GDO2 as EXTI interrupts.
+// One radio per board, so the link is a singleton like SpiDmaLink.
+class Cc1101Link
+{
+ public:
+  // Port for the Cc1101 driver; safe to take during static initialisation.
+  static Cc1101Port port();
+
+  // Configure chip select, the GDO inputs and SPI2. Call before
+  // Cc1101::begin().
+  static void begin(const RadioPins& pins);
+
+  // Route GDO0 (falling: end of packet) and GDO2 (rising: RX overflow) to
+  // `radio`. Call after Cc1101::begin().
+  static void attach(Cc1101& radio, IrqHook onIrq = nullptr, void* context = nullptr);
+};
+
+}  // namespace asap::radio
+
+#endif  // ARDUINO
+//
+// Cc1101Link.h
+// Embedded back end of the radio driver. The packet work happens in the GDO
+// interrupts, so the main loop only ever sees complete packets in the ring.
+//
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <stdint.h>
+
+namespace asap::radio::cc1101
+{
+
+// SPI header bits
+constexpr uint8_t kRead = 0x80;
+constexpr uint8_t kBurst = 0x40;
+
+// Configuration registers (subset used by the driver)
+constexpr uint8_t IOCFG2 = 0x00;
+constexpr uint8_t IOCFG0 = 0x02;
+constexpr uint8_t FIFOTHR = 0x03;
+constexpr uint8_t SYNC1 = 0x04;
+constexpr uint8_t SYNC0 = 0x05;
+constexpr uint8_t PKTLEN = 0x06;
+constexpr uint8_t PKTCTRL1 = 0x07;
+constexpr uint8_t PKTCTRL0 = 0x08;
+constexpr uint8_t ADDR = 0x09;
+constexpr uint8_t CHANNR = 0x0A;
+constexpr uint8_t FSCTRL1 = 0x0B;
+constexpr uint8_t FREQ2 = 0x0D;
+constexpr uint8_t FREQ1 = 0x0E;
+constexpr uint8_t FREQ0 = 0x0F;
+constexpr uint8_t MDMCFG4 = 0x10;
+constexpr uint8_t MDMCFG3 = 0x11;
+constexpr uint8_t MDMCFG2 = 0x12;
+constexpr uint8_t MDMCFG1 = 0x13;
+constexpr uint8_t MDMCFG0 = 0x14;
+constexpr uint8_t DEVIATN = 0x15;
+constexpr uint8_t MCSM1 = 0x17;
+constexpr uint8_t MCSM0 = 0x18;
+constexpr uint8_t FOCCFG = 0x19;
+constexpr uint8_t AGCCTRL2 = 0x1B;
+constexpr uint8_t WORCTRL = 0x20;
+constexpr uint8_t FREND0 = 0x22;
+constexpr uint8_t FSCAL3 = 0x23;
+constexpr uint8_t FSCAL2 = 0x24;
+constexpr uint8_t FSCAL1 = 0x25;
+constexpr uint8_t FSCAL0 = 0x26;
+constexpr uint8_t TEST2 = 0x2C;
+constexpr uint8_t TEST1 = 0x2D;
+constexpr uint8_t TEST0 = 0x2E;
+constexpr uint8_t kConfigRegisters = 0x2F;
+
+// Command strobes (header without the burst bit)
+constexpr uint8_t SRES = 0x30;
+constexpr uint8_t SRX = 0x34;
+constexpr uint8_t STX = 0x35;
+constexpr uint8_t SIDLE = 0x36;
+constexpr uint8_t SPWD = 0x39;  // SLEEP once CSn goes high (from IDLE)
+constexpr uint8_t SFRX = 0x3A;
+constexpr uint8_t SFTX = 0x3B;
+constexpr uint8_t SNOP = 0x3D;
+
+// Status registers (read with kRead | kBurst)
+constexpr uint8_t PARTNUM = 0x30;
+constexpr uint8_t VERSION = 0x31;
+constexpr uint8_t MARCSTATE = 0x35;
+constexpr uint8_t TXBYTES = 0x3A;
+constexpr uint8_t RXBYTES = 0x3B;
+
+constexpr uint8_t PATABLE = 0x3E;
+constexpr uint8_t FIFO = 0x3F;
+constexpr uint8_t kFifoBytes = 64;
+
+// RXBYTES/TXBYTES: bit 7 flags an overflow/underflow, bits 6:0 the count
+constexpr uint8_t kFifoOverflow = 0x80;
+constexpr uint8_t kFifoCountMask = 0x7F;
+
+// MARCSTATE values the driver checks
+constexpr uint8_t kMarcSleep = 0x00;  // never read back: SPI wakes the chip
+constexpr uint8_t kMarcIdle = 0x01;
+constexpr uint8_t kMarcRx = 0x0D;
+constexpr uint8_t kMarcRxOverflow = 0x11;
+constexpr uint8_t kMarcTx = 0x13;
+
+constexpr uint8_t kExpectedVersion = 0x14;
+
+// Appended status byte 2: bit 7 CRC_OK, bits 6:0 LQI
+constexpr uint8_t kCrcOk = 0x80;
+
+}  // namespace asap::radio::cc1101
+//
+// Cc1101Regs.h
+// Register map from the CC1101 datasheet (SWRS061), limited to what the
+// driver and the native chip model touch.
+//
@@ -0,0 +1,88 @@
+#include <asap/radio/PacketRing.h>
+
+#include <asap/radio/Cc1101Regs.h>
+
+namespace asap::radio
+{
+
+static_assert(PacketRing::kSlots > 0 && (256 % PacketRing::kSlots) == 0,
+              "ASAP_RADIO_RX_SLOTS must divide 256 (free-running 8-bit indices)");
+
+namespace
+{
+inline void publishBarrier()
+{
+  __asm__ __volatile__("" ::: "memory");
+}
+}  // namespace
+
+// RSSI status byte: two's complement, 0.5 dB steps, 74 dB offset (433 MHz).
+int16_t RxSlot::rssiDbm() const
+{
+  const int8_t raw = static_cast<int8_t>(frame[length() + 1]);
+  return static_cast<int16_t>(raw / 2 - 74);
+}
+
+uint8_t RxSlot::lqi() const
+{
+  return static_cast<uint8_t>(frame[length() + 2] & ~cc1101::kCrcOk);
+}
+
+bool RxSlot::crcOk() const
+{
+  return (frame[length() + 2] & cc1101::kCrcOk) != 0;
+}
+
+PacketRing::PacketRing()
+    : slots_{},
+      head_(0),
+      tail_(0),
+      highWater_(0)
+{
+}
+
+RxSlot* PacketRing::acquire()
+{
+  if (size() >= kSlots)
+  {
+    return nullptr;
+  }
+  return &slots_[head_ % kSlots];
+}
+
+void PacketRing::commit()
+{
+  publishBarrier();
+  head_ = static_cast<uint8_t>(head_ + 1);
+  if (size() > highWater_)
+  {
+    highWater_ = size();
+  }
+}
+
+const RxSlot* PacketRing::peek() const
+{
+  if (empty())
+  {
+    return nullptr;
+  }
+  publishBarrier();
+  return &slots_[tail_ % kSlots];
+}
+
+void PacketRing::release()
+{
+  if (empty())
+  {
+    return;
+  }
+  publishBarrier();
+  tail_ = static_cast<uint8_t>(tail_ + 1);
+}
+
+}  // namespace asap::radio
+//
+// PacketRing.cpp
+// Same index discipline as FlushQueue and JoyEventQueue: each side only
+// advances its own index, after the slot contents are complete.
+//
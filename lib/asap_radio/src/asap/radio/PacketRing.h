@@ -0,0 +1,59 @@
+#pragma once
+
+#include <stdint.h>
+#include <asap/radio/RadioConfig.h>
+
+namespace asap::radio
+{
+
+// One received packet, exactly as drained from the RX FIFO:
+// [length][payload...][RSSI][LQI|CRC_OK]. The interrupt reads the FIFO
+// straight into `frame` and the consumer parses it in place.
+struct RxSlot
+{
+  uint8_t frame[kFrameBytes];
+  uint32_t timeMs;  // end of reception (millis)
+
+  uint8_t length() const { return frame[0]; }
+  const uint8_t* payload() const { return &frame[1]; }
+  int16_t rssiDbm() const;
+  uint8_t lqi() const;
+  bool crcOk() const;
+};
+
+// Statically allocated single-producer/single-consumer ring of RxSlots. The
+// producer (GDO0 interrupt) fills a slot in place between acquire() and
+// commit(); the consumer (main loop) reads it between peek() and release().
+// No packet is ever copied.
+class PacketRing
+{
+ public:
+  static constexpr uint8_t kSlots = ASAP_RADIO_RX_SLOTS;
+
+  PacketRing();
+
+  // Producer. acquire() returns nullptr when every slot is in use.
+  RxSlot* acquire();
+  void commit();
+
+  // Consumer.
+  const RxSlot* peek() const;
+  void release();
+
+  bool empty() const { return head_ == tail_; }
+  uint8_t size() const { return static_cast<uint8_t>(head_ - tail_); }
+  uint8_t highWater() const { return highWater_; }
+
+ private:
+  RxSlot slots_[kSlots];
+  volatile uint8_t head_;  // next slot to fill (producer)
+  volatile uint8_t tail_;  // oldest filled slot (consumer)
+  uint8_t highWater_;      // most slots ever in use
+};
+
+}  // namespace asap::radio
+//
+// PacketRing.h
+// Receive side of the CC1101 driver. Size it with ASAP_RADIO_RX_SLOTS for
+// the largest burst the main loop may leave unread.
+//
@@ -0,0 +1,46 @@
+#pragma once
+
+// Radio build configuration (override with -D in platformio.ini).
+
+// Received-packet slots between the GDO0 interrupt and the main loop. Each
+// slot holds one whole FIFO frame (64 bytes); 16 slots absorb a burst from a
+// dozen beacons while the loop is busy drawing.
+#ifndef ASAP_RADIO_RX_SLOTS
+#define ASAP_RADIO_RX_SLOTS 16
+#endif
+
+// Outgoing packets queued behind the one on air.
+#ifndef ASAP_RADIO_TX_SLOTS
+#define ASAP_RADIO_TX_SLOTS 4
+#endif
+
+// Largest TDMA superframe (sync slot included) the MAC keeps per-slot
+// airtime counters for, 8 bytes each. Emitter boards have no frame buffer,
+// so the full 256 fit.
+#ifndef ASAP_RADIO_MAX_SLOTS
+#define ASAP_RADIO_MAX_SLOTS 256
+#endif
+
+namespace asap::radio
+{
+
+// Variable-length packets that fit the 64-byte FIFO whole: length byte,
+// payload, and the two status bytes (RSSI, LQI|CRC_OK) the CC1101 appends.
+constexpr uint8_t kMaxPayload = 61;
+constexpr uint8_t kFrameBytes = 1 + kMaxPayload + 2;
+
+// On air per packet: 4 preamble + 4 sync bytes, length, payload and the
+// 16-bit CRC, at 38.4 kBaud (4.8 bytes/ms).
+constexpr uint8_t kOverheadBytes = 4 + 4 + 1 + 2;
+
+constexpr uint8_t airtimeMs(uint8_t payloadBytes)
+{
+  return static_cast<uint8_t>(((kOverheadBytes + payloadBytes) * 5 + 23) / 24);
+}
+
+}  // namespace asap::radio
+//
+// RadioConfig.h
+// Compile-time sizing of the CC1101 driver's static buffers. Nothing in the
+// radio path allocates at runtime.
+//
@@ -0,0 +1,176 @@
+#include <asap/radio/TdmaMac.h>
+
+#include <asap/core/Scheduler.h>  // asap::core::before
+
+namespace asap::radio
+{
+
+using asap::core::before;
+
+TdmaMac::TdmaMac(uint16_t deviceId, const SuperframeConfig& config)
+    : id_(deviceId),
+      config_(config),
+      periodMs_(0),
+      everyFrames_(1),
+      epochMs_(0),
+      lastSyncMs_(0),
+      heardSync_(false),
+      rng_((static_cast<uint32_t>(deviceId) * 2654435761u) | 1u),
+      txAirtimeMs_(0),
+      syncsHeard_(0),
+      resyncs_(0),
+      airtime_{}
+{
+  setShape(config.slotMs, config.dataSlots);
+  if (config_.syncEveryFrames == 0)
+  {
+    config_.syncEveryFrames = 1;
+  }
+}
+
+void TdmaMac::begin(uint32_t nowMs, uint32_t periodMs)
+{
+  periodMs_ = periodMs;
+  epochMs_ = nowMs;
+  setShape(config_.slotMs, config_.dataSlots);
+}
+
+uint8_t TdmaMac::hopSlot(uint16_t id, uint16_t frame, uint8_t dataSlots)
+{
+  if (dataSlots < 2)
+  {
+    return 1;
+  }
+  const uint32_t stride = 1 + (id / dataSlots) % (dataSlots - 1u);
+  return static_cast<uint8_t>(1 + (id + frame * stride) % dataSlots);
+}
+
+uint32_t TdmaMac::nextDataSlotMs(uint32_t nowMs) const
+{
+  const uint32_t first = frameIndex(nowMs);
+  for (uint32_t index = first; index <= first + everyFrames_; ++index)
+  {
+    const uint16_t frame = static_cast<uint16_t>(index);
+    if (!ownFrame(frame))
+    {
+      continue;
+    }
+    const uint32_t atMs = frameStartMs(index) + hopSlot(id_, frame, config_.dataSlots) * config_.slotMs;
+    if (!before(atMs, nowMs))
+    {
+      return atMs;
+    }
+  }
+  return nowMs + superframeMs();  // not reached: some frame in the window is ours
+}
+
+uint32_t TdmaMac::nextSyncMs(uint32_t nowMs) const
+{
+  uint32_t index = frameIndex(nowMs);
+  if (before(frameStartMs(index), nowMs))
+  {
+    ++index;
+  }
+  while (static_cast<uint16_t>(index) % config_.syncEveryFrames != 0)
+  {
+    ++index;
+  }
+  return frameStartMs(index);
+}
+
+uint32_t TdmaMac::acquireDelayMs()
+{
+  return kAcquireFrames * superframeMs() + rng_.below(superframeMs());
+}
+
+bool TdmaMac::mayTransmit(uint32_t nowMs, uint8_t airMs) const
+{
+  const uint16_t frame = frameAt(nowMs);
+  if (!ownFrame(frame) || slotAt(nowMs) != hopSlot(id_, frame, config_.dataSlots))
+  {
+    return false;
+  }
+  const uint32_t intoSlot = (nowMs - epochMs_) % superframeMs() % config_.slotMs;
+  return intoSlot + airMs <= config_.slotMs;
+}
+
+// The sync beacon goes out at the very start of its superframe, so that
+// start is the end of reception minus the packet's airtime. Every beacon
+// is adopted; tolerating a millisecond here would let drift add up to the
+// whole slot guard.
+bool TdmaMac::onSync(uint32_t rxEndMs, uint16_t frame, uint8_t slotMs, uint8_t dataSlots, uint8_t airMs)
+{
+  if (syncSource())
+  {
+    return false;
+  }
+  ++syncsHeard_;
+  lastSyncMs_ = rxEndMs;
+  const bool first = !heardSync_;
+  heardSync_ = true;
+
+  bool moved = first;
+  if (slotMs != config_.slotMs || dataSlots != config_.dataSlots)
+  {
+    setShape(slotMs, dataSlots);
+    moved = true;
+  }
+  const uint32_t epochMs = rxEndMs - airMs - static_cast<uint32_t>(frame) * superframeMs();
+  if (moved || epochMs != epochMs_)
+  {
+    epochMs_ = epochMs;
+    ++resyncs_;
+    return true;
+  }
+  return false;
+}
+
+void TdmaMac::noteTx(uint32_t startMs, uint8_t airMs)
+{
+  airtime_[slotAt(startMs)].txMs += airMs;
+  txAirtimeMs_ += airMs;
+}
+
+void TdmaMac::noteRx(uint32_t endMs, uint8_t airMs)
+{
+  airtime_[slotAt(endMs - airMs)].rxMs += airMs;
+}
+
+uint8_t TdmaMac::slotAt(uint32_t nowMs) const
+{
+  return static_cast<uint8_t>((nowMs - epochMs_) % superframeMs() / config_.slotMs);
+}
+
+bool TdmaMac::synced(uint32_t nowMs) const
+{
+  if (syncSource())
+  {
+    return true;
+  }
+  const uint32_t timeoutMs = static_cast<uint32_t>(kSyncTimeoutFrames) * config_.syncEveryFrames * superframeMs();
+  return heardSync_ && nowMs - lastSyncMs_ < timeoutMs;
+}
+
+// Slot shapes outside the counter table (or degenerate) keep the old one.
+void TdmaMac::setShape(uint8_t slotMs, uint8_t dataSlots)
+{
+  if (slotMs > 0 && dataSlots > 0 && 1u + dataSlots <= kMaxSlots)
+  {
+    config_.slotMs = slotMs;
+    config_.dataSlots = dataSlots;
+  }
+  else if (config_.slotMs == 0 || config_.dataSlots == 0 || 1u + config_.dataSlots > kMaxSlots)
+  {
+    config_.slotMs = SuperframeConfig{}.slotMs;
+    config_.dataSlots = SuperframeConfig{}.dataSlots;
+  }
+  const uint32_t frames = (periodMs_ + superframeMs() / 2) / superframeMs();
+  everyFrames_ = static_cast<uint16_t>(frames == 0 ? 1 : (frames > 0xFFFF ? 0xFFFF : frames));
+}
+
+}  // namespace asap::radio
+//
+// TdmaMac.cpp
+// A follower that loses the sync beacon keeps its last time base: crystal
+// drift over kSyncTimeoutFrames superframes is well inside the slot guard.
+//
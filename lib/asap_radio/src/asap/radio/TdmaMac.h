@@ -0,0 +1,125 @@
+#pragma once
+
+#include <stdint.h>
+#include <asap/core/Xorshift32.h>
+#include <asap/radio/RadioConfig.h>
+
+namespace asap::radio
+{
+
+// Shape of the TDMA superframe: slot 0 carries the time-sync beacon, slots
+// 1..dataSlots one emitter packet each. A slot is the longest emitter packet
+// plus a guard for clock error and interrupt latency.
+struct SuperframeConfig
+{
+  uint8_t slotMs = 8;           // airtimeMs(16) = 6 ms + 2 ms guard
+  uint8_t dataSlots = 61;       // prime (see TdmaMac::hopSlot); 496 ms superframe
+  uint8_t syncEveryFrames = 2;  // sync beacon period, in superframes
+  uint16_t syncSourceId = 1;    // device that owns the time base
+};
+
+// Slotted medium access for the emitter roles. Every device derives its data
+// slot from its ID and the superframe number, so no slot table is exchanged;
+// the only coordination is the time base, which followers take from the sync
+// beacon of syncSourceId (frame number and superframe shape).
+//
+// Timing only: the role encodes and sends the packets and feeds back what it
+// sent and heard. All times are the device's own millis().
+class TdmaMac
+{
+ public:
+  static constexpr uint16_t kMaxSlots = ASAP_RADIO_MAX_SLOTS;  // sync slot included
+  static constexpr uint8_t kSyncSlot = 0;
+  static constexpr uint8_t kAcquireFrames = 2;      // listening before the first packet
+  static constexpr uint8_t kSyncTimeoutFrames = 8;  // sync beacons missed before free-running
+
+  static_assert(kMaxSlots >= 2 && kMaxSlots <= 256, "ASAP_RADIO_MAX_SLOTS must be 2..256");
+
+  // Air time spent in one slot position, over all superframes.
+  struct SlotAirtime
+  {
+    uint32_t txMs;  // sent by this device
+    uint32_t rxMs;  // heard from others
+  };
+
+  explicit TdmaMac(uint16_t deviceId, const SuperframeConfig& config = SuperframeConfig{});
+
+  // Start the local time base at nowMs for a role that nominally sends every
+  // periodMs. The sync source is synchronised from here on; followers
+  // free-run on their own time base until they hear it.
+  void begin(uint32_t nowMs, uint32_t periodMs);
+
+  // Data slot (1..dataSlots) of device `id` in superframe `frame`: the ID
+  // plus the frame number times an ID-block stride, modulo dataSlots. IDs
+  // within one block of dataSlots never share a slot, so up to dataSlots
+  // emitters with consecutive IDs run collision free. With a prime slot
+  // count, two IDs from different blocks share one in 1 of dataSlots frames
+  // instead of colliding for good.
+  static uint8_t hopSlot(uint16_t id, uint16_t frame, uint8_t dataSlots);
+
+  // Start of this device's next data slot at or after nowMs. The device
+  // sends in every everyFrames()-th superframe, phased by its ID.
+  uint32_t nextDataSlotMs(uint32_t nowMs) const;
+  // Start of the next superframe that carries a sync beacon (sync source).
+  uint32_t nextSyncMs(uint32_t nowMs) const;
+  // Delay before a follower's first packet: kAcquireFrames superframes plus
+  // a random fraction of one, so devices powered up together neither talk
+  // over the first sync beacon nor start all at once.
+  uint32_t acquireDelayMs();
+
+  // True when nowMs is in this device's data slot with room left for a
+  // packet of airtime airMs (a late task skips the slot instead of
+  // spilling into the next one).
+  bool mayTransmit(uint32_t nowMs, uint8_t airMs) const;
+
+  // A sync beacon of airtime airMs ended at rxEndMs. Adopts the source's
+  // frame numbering and superframe shape; returns true when the local
+  // schedule moved (the role re-arms its transmit deadline).
+  bool onSync(uint32_t rxEndMs, uint16_t frame, uint8_t slotMs, uint8_t dataSlots, uint8_t airMs);
+
+  // Airtime accounting, by the slot a packet started in.
+  void noteTx(uint32_t startMs, uint8_t airMs);
+  void noteRx(uint32_t endMs, uint8_t airMs);
+
+  uint16_t frameAt(uint32_t nowMs) const { return static_cast<uint16_t>(frameIndex(nowMs)); }
+  uint8_t slotAt(uint32_t nowMs) const;
+  bool synced(uint32_t nowMs) const;
+
+  uint16_t deviceId() const { return id_; }
+  bool syncSource() const { return id_ == config_.syncSourceId; }
+  const SuperframeConfig& config() const { return config_; }
+  uint16_t superframeMs() const { return static_cast<uint16_t>((1 + config_.dataSlots) * config_.slotMs); }
+  uint16_t everyFrames() const { return everyFrames_; }
+
+  const SlotAirtime& slotAirtime(uint8_t slot) const { return airtime_[slot % kMaxSlots]; }
+  uint32_t txAirtimeMs() const { return txAirtimeMs_; }
+  uint32_t syncsHeard() const { return syncsHeard_; }
+  uint32_t resyncs() const { return resyncs_; }  // schedule moved by a sync beacon
+
+ private:
+  uint32_t frameIndex(uint32_t nowMs) const { return (nowMs - epochMs_) / superframeMs(); }
+  uint32_t frameStartMs(uint32_t index) const { return epochMs_ + index * superframeMs(); }
+  bool ownFrame(uint16_t frame) const { return frame % everyFrames_ == id_ % everyFrames_; }
+  void setShape(uint8_t slotMs, uint8_t dataSlots);
+
+  uint16_t id_;
+  SuperframeConfig config_;
+  uint32_t periodMs_;
+  uint16_t everyFrames_;
+  uint32_t epochMs_;  // local start of superframe 0
+  uint32_t lastSyncMs_;
+  bool heardSync_;
+  asap::core::Xorshift32 rng_;  // seeded from the device ID
+  uint32_t txAirtimeMs_;
+  uint32_t syncsHeard_;
+  uint32_t resyncs_;
+  SlotAirtime airtime_[kMaxSlots];
+};
+
+}  // namespace asap::radio
+//
+// TdmaMac.h
+// Replaces per-emitter free-running periods (pure ALOHA) once more than a
+// few dozen emitters share the channel. Frame numbers are 16 bit, so the hop
+// sequence restarts every 65536 superframes (about nine hours).
+//
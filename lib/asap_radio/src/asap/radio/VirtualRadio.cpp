@@ -0,0 +1,496 @@
+#ifndef ARDUINO
+
+#include <asap/radio/VirtualRadio.h>
+
+#include <asap/radio/Cc1101Regs.h>
+
+namespace asap::radio
+{
+
+namespace
+{
+constexpr uint8_t kFramingBytes = kOverheadBytes - 1;  // preamble, sync, CRC
+}  // namespace
+
+// ---- VirtualMedium ----------------------------------------------------------
+
+VirtualMedium::VirtualMedium(uint8_t bytesPerMs)
+    : bytesPerMs_(bytesPerMs ? bytesPerMs : 1)
+{
+}
+
+void VirtualMedium::advance(uint32_t ms)
+{
+  for (uint32_t i = 0; i < ms; ++i)
+  {
+    ++nowMs_;
+    while (!flights_.empty() && flights_.front().endMs <= nowMs_)
+    {
+      ended_.push_back(std::move(flights_.front()));
+      flights_.erase(flights_.begin());
+      const Flight& flight = ended_.back();
+      flight.sender->transmitDone();
+      deliver(flight);
+    }
+    if (ended_.empty())
+    {
+      continue;
+    }
+    // Nothing starting from now on can overlap a packet that ended before
+    // the oldest one still on air.
+    uint32_t horizon = nowMs_;
+    for (const Flight& flight : flights_)
+    {
+      horizon = flight.startMs < horizon ? flight.startMs : horizon;
+    }
+    size_t keep = 0;
+    for (size_t j = 0; j < ended_.size(); ++j)
+    {
+      if (ended_[j].endMs > horizon)
+      {
+        ended_[keep++] = std::move(ended_[j]);
+      }
+    }
+    ended_.resize(keep);
+  }
+}
+
+bool VirtualMedium::nextEventMs(uint32_t& atMs) const
+{
+  if (flights_.empty())
+  {
+    return false;
+  }
+  atMs = flights_.front().endMs;
+  return true;
+}
+
+void VirtualMedium::setLinkRssi(const VirtualCc1101& receiver, const VirtualCc1101& sender, int16_t dBm)
+{
+  rssi_[{&receiver, &sender}] = dBm;
+}
+
+void VirtualMedium::setLinkModel(LinkFn fn, void* context)
+{
+  linkFn_ = fn;
+  linkContext_ = context;
+}
+
+uint16_t VirtualMedium::join(VirtualCc1101* chip)
+{
+  chips_.push_back(chip);
+  return static_cast<uint16_t>(chips_.size() - 1);
+}
+
+// Flights are kept in end-time order.
+void VirtualMedium::transmit(VirtualCc1101* sender, std::vector<uint8_t> frame)
+{
+  const uint32_t bytes = static_cast<uint32_t>(frame.size()) + kFramingBytes;
+  Flight flight{sender, std::move(frame), nowMs_, nowMs_ + (bytes + bytesPerMs_ - 1) / bytesPerMs_, false};
+  ++transmissions_;
+  collisions_ += static_cast<uint32_t>(flights_.size());
+  for (Flight& other : flights_)
+  {
+    overlapped_ += other.overlapped ? 0 : 1;
+    other.overlapped = true;
+  }
+  if (!flights_.empty())
+  {
+    flight.overlapped = true;
+    ++overlapped_;
+  }
+  auto at = flights_.begin();
+  while (at != flights_.end() && at->endMs <= flight.endMs)
+  {
+    ++at;
+  }
+  flights_.insert(at, std::move(flight));
+}
+
+// Judge a finished packet at every other chip. Overlapping packets are the
+// ones still on air and those that ended during it.
+void VirtualMedium::deliver(const Flight& flight)
+{
+  for (VirtualCc1101* chip : chips_)
+  {
+    if (chip == flight.sender)
+    {
+      continue;
+    }
+    const int16_t signal = linkRssi(chip, flight.sender);
+    if (signal < sensitivityDbm_)
+    {
+      ++chip->stats_.outOfRange;
+      continue;
+    }
+    bool busy = chip->marc_ != cc1101::kMarcRx;
+    bool lost = false;
+    for (const std::vector<Flight>* list : {&flights_, &ended_})
+    {
+      for (const Flight& other : *list)
+      {
+        if (&other == &flight || !overlaps(other, flight))
+        {
+          continue;
+        }
+        if (other.sender == chip)
+        {
+          busy = true;
+        }
+        else if (linkRssi(chip, other.sender) > signal - kCaptureDb)
+        {
+          lost = true;
+        }
+      }
+    }
+    if (busy)
+    {
+      ++chip->stats_.busy;
+    }
+    else if (lost)
+    {
+      ++chip->stats_.collided;
+    }
+    else
+    {
+      ++chip->stats_.received;
+      chip->receive(flight.frame, signal);
+    }
+  }
+}
+
+int16_t VirtualMedium::linkRssi(const VirtualCc1101* receiver, const VirtualCc1101* sender) const
+{
+  if (linkFn_)
+  {
+    return linkFn_(linkContext_, receiver->node_, sender->node_);
+  }
+  const auto it = rssi_.find({receiver, sender});
+  return it != rssi_.end() ? it->second : kDefaultRssiDbm;
+}
+
+// ---- VirtualCc1101 ----------------------------------------------------------
+
+VirtualCc1101::VirtualCc1101(VirtualMedium& medium)
+    : medium_(medium)
+{
+  reset();
+  node_ = medium_.join(this);
+}
+
+void VirtualCc1101::attach(Cc1101& radio, IrqHook onIrq, void* context)
+{
+  radio_ = &radio;
+  hook_ = onIrq;
+  hookContext_ = context;
+}
+
+void VirtualCc1101::setClock(uint32_t offsetMs, int32_t driftPpm)
+{
+  clockOffsetMs_ = offsetMs;
+  driftPpm_ = driftPpm > -1000 ? (driftPpm < 1000 ? driftPpm : 999) : -999;
+}
+
+uint32_t VirtualCc1101::localTimeAt(uint32_t mediumMs) const
+{
+  const int64_t driftMs = static_cast<int64_t>(mediumMs) * driftPpm_ / 1000000;
+  return static_cast<uint32_t>(clockOffsetMs_ + mediumMs + driftMs);
+}
+
+// Drift stays below 0.1 %, so the first estimate is within a step or two.
+uint32_t VirtualCc1101::mediumTimeOf(uint32_t localMs) const
+{
+  const uint32_t nowMs = medium_.nowMs();
+  const int32_t aheadMs = static_cast<int32_t>(localMs - localTimeAt(nowMs));
+  if (aheadMs <= 0)
+  {
+    return nowMs;
+  }
+  uint32_t atMs = nowMs + static_cast<uint32_t>(aheadMs - static_cast<int64_t>(aheadMs) * driftPpm_ / 1000000);
+  while (static_cast<int32_t>(localTimeAt(atMs) - localMs) < 0)
+  {
+    ++atMs;
+  }
+  while (atMs != nowMs && static_cast<int32_t>(localTimeAt(atMs - 1) - localMs) >= 0)
+  {
+    --atMs;
+  }
+  return atMs;
+}
+
+Cc1101Port VirtualCc1101::port()
+{
+  return Cc1101Port{&portSelect, &portTransfer, &portMaskIrq, &portNowMs, this};
+}
+
+void VirtualCc1101::setIrqMasked(bool masked)
+{
+  if (masked)
+  {
+    ++maskDepth_;
+    return;
+  }
+  if (maskDepth_ > 0)
+  {
+    --maskDepth_;
+  }
+  dispatch();
+}
+
+// CSn low wakes a sleeping chip into IDLE without what SLEEP drops: the
+// FIFOs, PATABLE and the TEST registers.
+void VirtualCc1101::portSelect(void* context, bool selected)
+{
+  VirtualCc1101* self = static_cast<VirtualCc1101*>(context);
+  if (!selected)
+  {
+    return;
+  }
+  self->firstByte_ = true;
+  if (self->marc_ == cc1101::kMarcSleep)
+  {
+    self->marc_ = cc1101::kMarcIdle;
+    self->regs_[cc1101::TEST2] = 0;
+    self->regs_[cc1101::TEST1] = 0;
+    self->regs_[cc1101::TEST0] = 0;
+    self->paTable_ = 0;
+    self->rxFifo_.clear();
+    self->txFifo_.clear();
+    self->rxOverflow_ = false;
+    ++self->wakeups_;
+  }
+}
+
+void VirtualCc1101::portTransfer(void* context, uint8_t* buf, uint16_t length)
+{
+  VirtualCc1101* self = static_cast<VirtualCc1101*>(context);
+  for (uint16_t i = 0; i < length; ++i)
+  {
+    buf[i] = self->spiByte(buf[i]);
+  }
+}
+
+void VirtualCc1101::portMaskIrq(void* context, bool masked)
+{
+  static_cast<VirtualCc1101*>(context)->setIrqMasked(masked);
+}
+
+uint32_t VirtualCc1101::portNowMs(void* context)
+{
+  return static_cast<VirtualCc1101*>(context)->localNowMs();
+}
+
+// One SPI byte: the first of a transaction is the header (R/W, burst,
+// address), the rest are data with burst auto-increment on config registers.
+uint8_t VirtualCc1101::spiByte(uint8_t mosi)
+{
+  if (firstByte_)
+  {
+    firstByte_ = false;
+    address_ = mosi & 0x3F;
+    read_ = (mosi & cc1101::kRead) != 0;
+    burst_ = (mosi & cc1101::kBurst) != 0;
+    if (address_ >= cc1101::SRES && address_ <= cc1101::SNOP && !burst_)
+    {
+      strobe(address_);
+    }
+    return 0;  // chip status byte (not used by the driver)
+  }
+  if (address_ == cc1101::FIFO)
+  {
+    if (read_)
+    {
+      if (rxFifo_.empty())
+      {
+        return 0;
+      }
+      const uint8_t value = rxFifo_.front();
+      rxFifo_.erase(rxFifo_.begin());
+      return value;
+    }
+    if (txFifo_.size() < cc1101::kFifoBytes)
+    {
+      txFifo_.push_back(mosi);
+    }
+    return 0;
+  }
+  if (address_ == cc1101::PATABLE)
+  {
+    if (!read_)
+    {
+      paTable_ = mosi;
+    }
+    return paTable_;
+  }
+  if (address_ >= cc1101::kConfigRegisters)
+  {
+    return read_ ? readStatus(address_) : 0;
+  }
+  const uint8_t value = regs_[address_];
+  if (!read_)
+  {
+    regs_[address_] = mosi;
+  }
+  if (burst_ && address_ + 1 < cc1101::kConfigRegisters)
+  {
+    ++address_;
+  }
+  return value;
+}
+
+void VirtualCc1101::strobe(uint8_t command)
+{
+  switch (command)
+  {
+    case cc1101::SRES:
+      reset();
+      break;
+    case cc1101::SRX:
+      if (marc_ == cc1101::kMarcIdle)
+      {
+        marc_ = cc1101::kMarcRx;
+      }
+      break;
+    case cc1101::STX:
+      if ((marc_ == cc1101::kMarcIdle || marc_ == cc1101::kMarcRx) && !txFifo_.empty())
+      {
+        marc_ = cc1101::kMarcTx;
+        medium_.transmit(this, txFifo_);
+        txFifo_.clear();
+      }
+      break;
+    case cc1101::SIDLE:
+      if (marc_ != cc1101::kMarcTx)  // aborting TX is not modelled
+      {
+        marc_ = cc1101::kMarcIdle;
+      }
+      break;
+    case cc1101::SPWD:
+      if (marc_ == cc1101::kMarcIdle)
+      {
+        marc_ = cc1101::kMarcSleep;
+      }
+      break;
+    case cc1101::SFRX:
+      if (marc_ == cc1101::kMarcIdle || marc_ == cc1101::kMarcRxOverflow)
+      {
+        rxFifo_.clear();
+        rxOverflow_ = false;
+        marc_ = cc1101::kMarcIdle;
+      }
+      break;
+    case cc1101::SFTX:
+      if (marc_ != cc1101::kMarcTx)
+      {
+        txFifo_.clear();
+      }
+      break;
+    default:
+      break;
+  }
+}
+
+uint8_t VirtualCc1101::readStatus(uint8_t reg) const
+{
+  switch (reg)
+  {
+    case cc1101::PARTNUM:
+      return 0x00;
+    case cc1101::VERSION:
+      return cc1101::kExpectedVersion;
+    case cc1101::MARCSTATE:
+      return marc_;
+    case cc1101::TXBYTES:
+      return static_cast<uint8_t>(txFifo_.size());
+    case cc1101::RXBYTES:
+      return static_cast<uint8_t>((rxOverflow_ ? cc1101::kFifoOverflow : 0) | rxFifo_.size());
+    default:
+      return 0;
+  }
+}
+
+void VirtualCc1101::reset()
+{
+  for (uint8_t& reg : regs_)
+  {
+    reg = 0;
+  }
+  paTable_ = 0;
+  marc_ = cc1101::kMarcIdle;
+  rxFifo_.clear();
+  txFifo_.clear();
+  rxOverflow_ = false;
+}
+
+// End of a clean reception: append the frame plus the RSSI and LQI|CRC_OK
+// status bytes, or overflow if the FIFO cannot hold it.
+void VirtualCc1101::receive(const std::vector<uint8_t>& frame, int16_t rssiDbm)
+{
+  if (marc_ != cc1101::kMarcRx)
+  {
+    return;
+  }
+  if (rxFifo_.size() + frame.size() + 2 > cc1101::kFifoBytes)
+  {
+    rxOverflow_ = true;
+    marc_ = cc1101::kMarcRxOverflow;
+    raise(kGdo2);
+    return;
+  }
+  int raw = (rssiDbm + 74) * 2;
+  raw = raw < -128 ? -128 : (raw > 127 ? 127 : raw);
+  rxFifo_.insert(rxFifo_.end(), frame.begin(), frame.end());
+  rxFifo_.push_back(static_cast<uint8_t>(static_cast<int8_t>(raw)));
+  rxFifo_.push_back(static_cast<uint8_t>(cc1101::kCrcOk | kLqi));
+  raise(kGdo0);
+}
+
+// MCSM1.TXOFF_MODE = RX: back to receive, GDO0 deasserts.
+void VirtualCc1101::transmitDone()
+{
+  marc_ = cc1101::kMarcRx;
+  raise(kGdo0);
+}
+
+void VirtualCc1101::raise(uint8_t gdo)
+{
+  pending_ |= gdo;
+  dispatch();
+}
+
+// Run latched edges unless masked. Handlers run masked, like one NVIC level:
+// edges they cause are latched and served after they return. GDO0 (EXTI 10)
+// is served before GDO2 (EXTI 11), as in the shared EXTI15_10 handler.
+void VirtualCc1101::dispatch()
+{
+  while (pending_ != 0 && maskDepth_ == 0 && radio_)
+  {
+    const uint8_t gdo = (pending_ & kGdo0) ? kGdo0 : kGdo2;
+    pending_ &= static_cast<uint8_t>(~gdo);
+    ++interrupts_;
+    ++maskDepth_;
+    if (gdo == kGdo0)
+    {
+      radio_->onGdo0();
+    }
+    else
+    {
+      radio_->onGdo2();
+    }
+    if (hook_)
+    {
+      hook_(hookContext_);
+    }
+    --maskDepth_;
+  }
+}
+
+}  // namespace asap::radio
+
+#endif  // !ARDUINO
+//
+// VirtualRadio.cpp
+// The model is deliberately strict where the driver depends on the chip:
+// status reads through the burst bit, SFRX only from IDLE or overflow, and
+// nothing received outside RX.
+//
@@ -0,0 +1,195 @@
+#pragma once
+
+#ifndef ARDUINO
+
+#include <stddef.h>
+#include <stdint.h>
+#include <map>
+#include <utility>
+#include <vector>
+#include <asap/radio/Cc1101.h>
+
+namespace asap::radio
+{
+
+class VirtualCc1101;
+
+// Shared 433 MHz channel for host tests and the world simulator. Time only
+// moves in advance(); a packet is on air for its byte count at bytesPerMs and
+// is judged per receiver when it ends: below the sensitivity it is not heard,
+// a receiver that was transmitting meanwhile misses it, and it is lost to any
+// overlapping packet that is not at least kCaptureDb weaker at that receiver.
+class VirtualMedium
+{
+ public:
+  static constexpr int16_t kDefaultRssiDbm = -60;
+  static constexpr int16_t kDefaultSensitivityDbm = -104;  // 38.4 kBaud GFSK
+  static constexpr int16_t kCaptureDb = 6;
+
+  // RSSI at chip `receiver` for packets from chip `sender` (node indices).
+  using LinkFn = int16_t (*)(void* context, uint16_t receiver, uint16_t sender);
+
+  explicit VirtualMedium(uint8_t bytesPerMs = 5);  // ~38.4 kBaud
+
+  // Advance virtual time one millisecond at a time, ending transmissions.
+  void advance(uint32_t ms);
+  uint32_t nowMs() const { return nowMs_; }
+
+  // End time of the next packet on air; false when the channel is idle.
+  bool nextEventMs(uint32_t& atMs) const;
+
+  // RSSI `receiver` sees for packets from `sender` (pairs not set use
+  // kDefaultRssiDbm), or a link model replacing the whole table.
+  void setLinkRssi(const VirtualCc1101& receiver, const VirtualCc1101& sender, int16_t dBm);
+  void setLinkModel(LinkFn fn, void* context);
+  void setSensitivity(int16_t dBm) { sensitivityDbm_ = dBm; }
+
+  uint32_t transmissions() const { return transmissions_; }
+  // Transmissions that started while another packet was on air.
+  uint32_t collisions() const { return collisions_; }
+  // Transmissions that shared air time with at least one other, whoever
+  // started first: overlapped() / transmissions() is the collision
+  // probability of a packet, independent of where the receivers are.
+  uint32_t overlapped() const { return overlapped_; }
+
+ private:
+  friend class VirtualCc1101;
+
+  struct Flight
+  {
+    VirtualCc1101* sender;
+    std::vector<uint8_t> frame;  // [length][payload...]
+    uint32_t startMs;
+    uint32_t endMs;
+    bool overlapped;
+  };
+
+  uint16_t join(VirtualCc1101* chip);
+  void transmit(VirtualCc1101* sender, std::vector<uint8_t> frame);
+  void deliver(const Flight& flight);
+  bool overlaps(const Flight& a, const Flight& b) const { return a.startMs < b.endMs && b.startMs < a.endMs; }
+  int16_t linkRssi(const VirtualCc1101* receiver, const VirtualCc1101* sender) const;
+
+  std::vector<VirtualCc1101*> chips_;
+  std::vector<Flight> flights_;  // on air, by end time
+  std::vector<Flight> ended_;    // may still overlap a packet on air
+  std::map<std::pair<const VirtualCc1101*, const VirtualCc1101*>, int16_t> rssi_;
+  LinkFn linkFn_ = nullptr;
+  void* linkContext_ = nullptr;
+  int16_t sensitivityDbm_ = kDefaultSensitivityDbm;
+  uint8_t bytesPerMs_;
+  uint32_t nowMs_ = 0;
+  uint32_t transmissions_ = 0;
+  uint32_t collisions_ = 0;
+  uint32_t overlapped_ = 0;
+};
+
+// Register-level CC1101 model behind a Cc1101Port: header/burst SPI framing,
+// strobes, status registers, both FIFOs, and the GDO0/GDO2 lines as
+// edge-latched interrupts. Masking the interrupt (from the driver or the
+// test, to model ISR latency) latches edges until it is unmasked, so one
+// handler may find several frames waiting.
+class VirtualCc1101
+{
+ public:
+  static constexpr uint8_t kLqi = 0x2A;
+
+  explicit VirtualCc1101(VirtualMedium& medium);
+  VirtualCc1101(const VirtualCc1101&) = delete;
+  VirtualCc1101& operator=(const VirtualCc1101&) = delete;
+
+  Cc1101Port port();
+
+  // Deliver GDO edges to `radio`, then call `onIrq` (the EXTI wiring of
+  // Cc1101Link::attach).
+  void attach(Cc1101& radio, IrqHook onIrq = nullptr, void* context = nullptr);
+
+  // Nested with the driver's own maskIrq calls.
+  void setIrqMasked(bool masked);
+
+  // The board's millis() (the port's nowMs): medium time plus a fixed
+  // offset (the power-up time of that device), running driftPpm fast or slow
+  // like an uncalibrated crystal.
+  void setClock(uint32_t offsetMs, int32_t driftPpm);
+  uint32_t localNowMs() const { return localTimeAt(medium_.nowMs()); }
+  uint32_t localTimeAt(uint32_t mediumMs) const;
+  // Earliest medium time, not before now, at which millis() reaches localMs.
+  uint32_t mediumTimeOf(uint32_t localMs) const;
+
+  // Fate of every packet that ended while this chip was on the channel.
+  struct LinkStats
+  {
+    uint32_t received;    // reached the RX FIFO
+    uint32_t collided;    // lost to an overlapping packet
+    uint32_t busy;        // missed while transmitting / not in RX
+    uint32_t outOfRange;  // below sensitivity
+  };
+
+  uint16_t node() const { return node_; }
+  const LinkStats& linkStats() const { return stats_; }
+  uint8_t marcState() const { return marc_; }
+  uint8_t paTable() const { return paTable_; }
+  uint32_t wakeups() const { return wakeups_; }  // out of SLEEP
+  uint8_t rxFifoBytes() const { return static_cast<uint8_t>(rxFifo_.size()); }
+  uint32_t interruptCount() const { return interrupts_; }
+
+ private:
+  friend class VirtualMedium;
+
+  enum Gdo : uint8_t
+  {
+    kGdo0 = 1U << 0,  // end of packet
+    kGdo2 = 1U << 1,  // RX FIFO overflow
+  };
+
+  static void portSelect(void* context, bool selected);
+  static void portTransfer(void* context, uint8_t* buf, uint16_t length);
+  static void portMaskIrq(void* context, bool masked);
+  static uint32_t portNowMs(void* context);
+
+  uint8_t spiByte(uint8_t mosi);
+  void strobe(uint8_t command);
+  uint8_t readStatus(uint8_t reg) const;
+  void reset();
+
+  void receive(const std::vector<uint8_t>& frame, int16_t rssiDbm);
+  void transmitDone();
+  void raise(uint8_t gdo);
+  void dispatch();
+
+  VirtualMedium& medium_;
+  uint16_t node_ = 0;
+  uint32_t clockOffsetMs_ = 0;
+  int32_t driftPpm_ = 0;
+  LinkStats stats_ = {};
+  Cc1101* radio_ = nullptr;
+  IrqHook hook_ = nullptr;
+  void* hookContext_ = nullptr;
+  uint8_t regs_[0x30] = {};
+  uint8_t paTable_ = 0;
+  uint8_t marc_ = 0;
+  std::vector<uint8_t> rxFifo_;
+  std::vector<uint8_t> txFifo_;
+  bool rxOverflow_ = false;
+
+  // SPI transaction state
+  bool firstByte_ = true;
+  uint8_t address_ = 0;
+  bool read_ = false;
+  bool burst_ = false;
+
+  uint8_t maskDepth_ = 0;
+  uint8_t pending_ = 0;
+  uint32_t interrupts_ = 0;
+  uint32_t wakeups_ = 0;
+};
+
+}  // namespace asap::radio
+
+#endif  // !ARDUINO
+//
+// VirtualRadio.h
+// Lets the host tests and asap_sim run the real Cc1101 driver, byte for
+// byte, against simulated chips sharing one channel: bursts, collisions, FIFO
+// overflow and late interrupts without hardware.
+//
@@ -0,0 +1,152 @@
+#include <asap/roles/ArtifactEngine.h>
+
+namespace asap::roles
+{
+
+using asap::core::before;
+using asap::game::Fingerprint;
+using asap::power::RadioState;
+
+namespace
+{
+uint32_t cycleFor(const ArtifactConfig& config)
+{
+  const uint32_t ms = config.hidden ? config.hiddenPeriodMs : config.periodMs;
+  return ms > Fingerprint::kMinCycleMs ? ms : Fingerprint::kMinCycleMs;
+}
+
+uint8_t artifactAirMs(const ArtifactConfig& config)
+{
+  uint8_t packet[asap::radio::kMaxPayload];
+  return asap::radio::airtimeMs(encodeArtifact(config.id, 0, config.signature, 0, packet));
+}
+}  // namespace
+
+ArtifactEngine::ArtifactEngine(asap::radio::Cc1101& radio, const ArtifactConfig& config,
+                               const asap::power::PowerProfile& profile)
+    : radio_(radio),
+      config_(config),
+      fingerprint_(Fingerprint::of(config.id, config.signature)),
+      cycleMs_(cycleFor(config)),
+      rng_((config.id * 2654435761u) ^ 0xC2B2AE35u),
+      airMs_(artifactAirMs(config)),
+      power_(profile),
+      packet_{},
+      seq_(0),
+      index_(0),
+      phase_(Phase::Asleep),
+      cycleStartMs_(0),
+      cycles_(0),
+      sent_(0),
+      deferred_(0),
+      skipped_(0),
+      scheduler_(nullptr),
+      task_(asap::core::kInvalidTask)
+{
+}
+
+void ArtifactEngine::begin(asap::core::Scheduler& scheduler)
+{
+  scheduler_ = &scheduler;
+  const uint32_t nowMs = scheduler.nowMs();
+  radio_.sleep();
+  power_.begin(nowMs, RadioState::Sleep);
+  phase_ = Phase::Asleep;
+  const uint32_t delayMs = rng_.below(cycleMs_);
+  cycleStartMs_ = nowMs + delayMs;
+  task_ = scheduler.addOneShot(delayMs, &run, this);
+  power_.mcuWait(delayMs, betweenCycles());
+}
+
+void ArtifactEngine::run(void* context, uint32_t nowMs)
+{
+  ArtifactEngine& self = *static_cast<ArtifactEngine*>(context);
+  self.power_.mcuWake();
+  // The radio is in RX after a ping; nothing it hears is for an artifact.
+  asap::radio::PacketRing& overheard = self.radio_.rx();
+  while (overheard.peek())
+  {
+    overheard.release();
+  }
+  if (self.phase_ == Phase::Asleep)
+  {
+    self.ping(nowMs);
+  }
+  else
+  {
+    self.settle(nowMs);
+  }
+}
+
+// TX from IDLE; the chip returns to RX when the packet is off air.
+void ArtifactEngine::ping(uint32_t nowMs)
+{
+  radio_.wake();
+  power_.radioWake();
+  power_.radio(RadioState::Idle, nowMs);
+  // A cycle's grid starts at its first ping as sent: the STOP wakeup before
+  // it may be up to an alarm step late, and the gaps are what must hold.
+  if (index_ == 0)
+  {
+    cycleStartMs_ = nowMs;
+    ++cycles_;
+  }
+  const uint8_t length = encodeArtifact(config_.id, seq_++, config_.signature, index_, packet_);
+  if (radio_.send(packet_, length))
+  {
+    ++sent_;
+    power_.radio(RadioState::Tx, nowMs);
+    power_.radio(RadioState::Rx, nowMs + airMs_);
+  }
+  else
+  {
+    ++deferred_;
+  }
+  phase_ = Phase::Settle;
+  waitUntil(nowMs, nowMs + airMs_);
+}
+
+void ArtifactEngine::settle(uint32_t nowMs)
+{
+  if (!radio_.sleep())
+  {
+    waitUntil(nowMs, nowMs + 1);  // ping still on air
+    return;
+  }
+  power_.radio(RadioState::Sleep, nowMs);
+  phase_ = Phase::Asleep;
+  nextPing();
+  while (!before(nowMs, pingMs()))
+  {
+    ++skipped_;
+    nextPing();
+  }
+  waitUntil(nowMs, pingMs());
+}
+
+void ArtifactEngine::waitUntil(uint32_t nowMs, uint32_t deadlineMs)
+{
+  power_.mcuWait(deadlineMs - nowMs, betweenCycles());
+  scheduler_->setDeadline(task_, deadlineMs);
+}
+
+// Pings stay on the cycle's grid: a late one is skipped, never sent off its
+// gap, since a detector would count that as a mismatch.
+void ArtifactEngine::nextPing()
+{
+  if (++index_ < Fingerprint::kPings)
+  {
+    return;
+  }
+  index_ = 0;
+  const uint32_t jitterMs = cycleMs_ / 8;
+  cycleStartMs_ += cycleMs_ - jitterMs + rng_.below(2 * jitterMs + 1);
+}
+
+}  // namespace asap::roles
+//
+// ArtifactEngine.cpp
+// A hidden artifact is awake for a few milliseconds per ping and in WFI for
+// the second or so of a cycle, once every two minutes by default: the
+// battery mostly sees STOP-mode current.
+//
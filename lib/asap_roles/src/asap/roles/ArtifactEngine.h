@@ -0,0 +1,92 @@
+#pragma once
+
+#include <stdint.h>
+#include <asap/core/Scheduler.h>
+#include <asap/core/Xorshift32.h>
+#include <asap/game/ArtifactFingerprint.h>
+#include <asap/power/PowerModel.h>
+#include <asap/radio/Cc1101.h>
+#include <asap/roles/EmitterRoles.h>
+
+namespace asap::roles
+{
+
+// Artifact image: short pings on the artifact's timing fingerprint
+// (asap::game::Fingerprint). A cycle is kPings pings, ping i carrying index
+// i, at the fingerprint's gaps; cycles start periodMs apart (hiddenPeriodMs
+// when hidden), moved by up to an eighth of that from an ID-seeded PRNG so
+// two artifacts never stay in step. The period is clamped to
+// Fingerprint::kMinCycleMs.
+//
+// Like BeaconEngine the CC1101 sleeps between pings and the only armed task
+// is the next one; unslotted for the same reason. Only the rest between
+// cycles may be spent in STOP mode (betweenCycles()): the gaps inside a
+// cycle are the fingerprint, matched to a few ms, so they are timed on
+// SysTick in WFI. A PowerAccount reports what a hidden artifact costs.
+class ArtifactEngine
+{
+ public:
+  ArtifactEngine(asap::radio::Cc1101& radio, const ArtifactConfig& config,
+                 const asap::power::PowerProfile& profile = asap::power::PowerProfile{});
+
+  // Register the ping task and put the radio to sleep until the first
+  // cycle. The radio must already be running (Cc1101::begin()).
+  void begin(asap::core::Scheduler& scheduler);
+
+  uint16_t id() const { return config_.id; }
+  uint16_t signature() const { return config_.signature; }
+  const asap::game::Fingerprint& fingerprint() const { return fingerprint_; }
+  uint32_t cycleMs() const { return cycleMs_; }
+  uint8_t packetAirMs() const { return airMs_; }
+  asap::power::PowerReport power(uint32_t nowMs) const { return power_.report(nowMs); }
+
+  // The next deadline starts a cycle, so the wait for it carries no
+  // fingerprint timing (StopGate of asap::power::stopModeClock()).
+  bool betweenCycles() const { return phase_ == Phase::Asleep && index_ == 0; }
+
+  uint32_t cycles() const { return cycles_; }      // cycles started (ping 0 due)
+  uint32_t sent() const { return sent_; }
+  uint32_t deferred() const { return deferred_; }  // TX queue full
+  uint32_t skipped() const { return skipped_; }    // pings found late
+
+ private:
+  enum class Phase : uint8_t
+  {
+    Asleep,  // next run sends ping index_
+    Settle,  // next run puts the radio to sleep
+  };
+
+  static void run(void* context, uint32_t nowMs);
+  void ping(uint32_t nowMs);
+  void settle(uint32_t nowMs);
+  uint32_t pingMs() const { return cycleStartMs_ + fingerprint_.offsetMs(index_); }
+  void nextPing();
+  // Next run at deadlineMs; the wait goes into the power account.
+  void waitUntil(uint32_t nowMs, uint32_t deadlineMs);
+
+  asap::radio::Cc1101& radio_;
+  ArtifactConfig config_;
+  asap::game::Fingerprint fingerprint_;
+  uint32_t cycleMs_;
+  asap::core::Xorshift32 rng_;
+  uint8_t airMs_;
+  asap::power::PowerAccount power_;
+  uint8_t packet_[asap::radio::kMaxPayload];
+  uint8_t seq_;
+  uint8_t index_;
+  Phase phase_;
+  uint32_t cycleStartMs_;
+  uint32_t cycles_;
+  uint32_t sent_;
+  uint32_t deferred_;
+  uint32_t skipped_;
+  asap::core::Scheduler* scheduler_;
+  asap::core::TaskId task_;
+};
+
+}  // namespace asap::roles
+//
+// ArtifactEngine.h
+// Nothing in the packet says "fingerprinted": a detector recognizes the
+// artifact only by the timing, which ArtifactRole does not reproduce.
+//
@@ -0,0 +1,391 @@
+#include <asap/roles/BeaconEngine.h>
+
+#include <asap/core/Xorshift32.h>  // schedule jitter and shuffle
+#include <asap/proto/Messages.h>    // sync beacon
+
+namespace asap::roles
+{
+
+using asap::core::before;
+using asap::power::RadioState;
+
+namespace
+{
+uint8_t beaconAirMs(const BeaconConfig& config)
+{
+  uint8_t packet[asap::radio::kMaxPayload];
+  return asap::radio::airtimeMs(encodeBeacon(config.id, 0, config.txPowerDbm, config.periodMs, packet));
+}
+}  // namespace
+
+// ---- BeaconSchedule ---------------------------------------------------------
+
+BeaconSchedule::BeaconSchedule(const BeaconConfig& config, uint8_t airMs)
+    : intervals_{},
+      firstDelayMs_(0),
+      jitterMs_(0),
+      packets_(config.burstPackets ? config.burstPackets : 1),
+      gapMs_(config.burstGapMs)
+{
+  const uint16_t periodMs = config.periodMs > 2 ? config.periodMs : 2;
+  // Half a period at most, and no more than keeps periodMs + jitter in the
+  // table's 16 bits.
+  uint16_t maxJitterMs = static_cast<uint16_t>(periodMs / 2);
+  if (maxJitterMs > UINT16_MAX - periodMs)
+  {
+    maxJitterMs = static_cast<uint16_t>(UINT16_MAX - periodMs);
+  }
+  jitterMs_ = config.jitterMs < maxJitterMs ? config.jitterMs : maxJitterMs;
+
+  // A copy must be off air before the next one starts, and a whole burst
+  // (radio awake in RX between copies) within half the shortest interval.
+  if (gapMs_ <= airMs)
+  {
+    gapMs_ = static_cast<uint8_t>(airMs + 1);
+  }
+  const uint32_t roomMs = (periodMs - jitterMs_) / 2u;
+  while (packets_ > 1 && static_cast<uint32_t>(packets_ - 1) * gapMs_ + airMs + 1 > roomMs)
+  {
+    --packets_;
+  }
+
+  // Seeded from the ID so every stake has its own table.
+  asap::core::Xorshift32 rng((config.id * 2654435761u) ^ 0x9E3779B9u);
+  firstDelayMs_ = static_cast<uint16_t>(rng.below(periodMs));
+  for (uint8_t i = 0; i < kIntervals; i += 2)
+  {
+    const int32_t jitter =
+        static_cast<int32_t>(rng.below(2u * jitterMs_ + 1u)) - static_cast<int32_t>(jitterMs_);
+    intervals_[i] = static_cast<uint16_t>(periodMs + jitter);
+    intervals_[i + 1] = static_cast<uint16_t>(periodMs - jitter);
+  }
+  // Fisher-Yates, so the pairs do not show as alternating long/short gaps.
+  for (uint8_t i = kIntervals - 1; i > 0; --i)
+  {
+    const uint8_t j = static_cast<uint8_t>(rng.below(i + 1u));
+    const uint16_t t = intervals_[i];
+    intervals_[i] = intervals_[j];
+    intervals_[j] = t;
+  }
+}
+
+uint32_t BeaconSchedule::cycleMs() const
+{
+  uint32_t sum = 0;
+  for (uint16_t ms : intervals_)
+  {
+    sum += ms;
+  }
+  return sum;
+}
+
+// ---- BeaconEngine -----------------------------------------------------------
+
+BeaconEngine::BeaconEngine(asap::radio::Cc1101& radio, const BeaconConfig& config,
+                           const asap::power::PowerProfile& profile)
+    : radio_(radio),
+      config_(config),
+      airMs_(beaconAirMs(config)),
+      schedule_(config, airMs_),
+      power_(profile),
+      packet_{},
+      length_(0),
+      seq_(0),
+      copy_(0),
+      phase_(Phase::Asleep),
+      burstIndex_(0),
+      nextBurstMs_(0),
+      bursts_(0),
+      sent_(0),
+      deferred_(0),
+      skipped_(0),
+      mac_(nullptr),
+      nextTxMs_(0),
+      nextSyncMs_(0),
+      listenEndMs_(0),
+      listening_(false),
+      syncsSent_(0),
+      listens_(0),
+      scheduler_(nullptr),
+      task_(asap::core::kInvalidTask)
+{
+}
+
+void BeaconEngine::begin(asap::core::Scheduler& scheduler, asap::radio::TdmaMac* mac)
+{
+  scheduler_ = &scheduler;
+  mac_ = mac;
+  const uint32_t nowMs = scheduler.nowMs();
+  radio_.sleep();
+  power_.begin(nowMs, RadioState::Sleep);
+  phase_ = Phase::Asleep;
+  if (mac_)
+  {
+    // The source opens superframes from here on; a follower listens for it
+    // right away and holds its first packet back as EmitterRole does.
+    mac_->begin(nowMs, config_.periodMs);
+    const bool source = mac_->syncSource();
+    nextTxMs_ = mac_->nextDataSlotMs(nowMs + (source ? 0 : mac_->acquireDelayMs()));
+    nextSyncMs_ = source ? mac_->nextSyncMs(nowMs) : nowMs;
+    const uint32_t firstMs = before(nextSyncMs_, nextTxMs_) ? nextSyncMs_ : nextTxMs_;
+    task_ = scheduler.addOneShot(firstMs - nowMs, &run, this);
+    power_.mcuWait(firstMs - nowMs);
+    return;
+  }
+  nextBurstMs_ = nowMs + schedule_.firstDelayMs();
+  task_ = scheduler.addOneShot(schedule_.firstDelayMs(), &run, this);
+  power_.mcuWait(schedule_.firstDelayMs());
+}
+
+void BeaconEngine::run(void* context, uint32_t nowMs)
+{
+  BeaconEngine& self = *static_cast<BeaconEngine*>(context);
+  self.power_.mcuWake();
+  if (self.mac_)
+  {
+    self.runSlotted(nowMs);
+    return;
+  }
+  self.dropOverheard();  // RX between copies; nothing in it is for a beacon
+  switch (self.phase_)
+  {
+    case Phase::Asleep:
+      self.radio_.wake();
+      self.power_.radioWake();
+      self.power_.radio(RadioState::Idle, nowMs);
+      self.length_ = encodeBeacon(self.config_.id, self.seq_++, self.config_.txPowerDbm, self.config_.periodMs,
+                                  self.packet_);
+      self.copy_ = 0;
+      ++self.bursts_;
+      self.sendCopy(nowMs);
+      break;
+    case Phase::Burst:
+      self.sendCopy(nowMs);
+      break;
+    case Phase::Settle:
+      self.settle(nowMs);
+      break;
+  }
+}
+
+// TX from IDLE (first copy) or RX (later ones); the chip returns to RX when
+// the packet is off air.
+void BeaconEngine::sendCopy(uint32_t nowMs)
+{
+  if (radio_.send(packet_, length_))
+  {
+    ++sent_;
+    power_.radio(RadioState::Tx, nowMs);
+    power_.radio(RadioState::Rx, nowMs + airMs_);
+  }
+  else
+  {
+    ++deferred_;
+  }
+  if (++copy_ < schedule_.packets())
+  {
+    phase_ = Phase::Burst;
+    waitUntil(nowMs, nowMs + schedule_.gapMs());
+    return;
+  }
+  phase_ = Phase::Settle;
+  waitUntil(nowMs, nowMs + airMs_);
+}
+
+void BeaconEngine::settle(uint32_t nowMs)
+{
+  if (!radio_.sleep())
+  {
+    waitUntil(nowMs, nowMs + 1);  // last copy still on air
+    return;
+  }
+  power_.radio(RadioState::Sleep, nowMs);
+  phase_ = Phase::Asleep;
+  nextBurstMs_ += schedule_.intervalMs(burstIndex_++);
+  while (!before(nowMs, nextBurstMs_))
+  {
+    ++skipped_;
+    nextBurstMs_ += schedule_.intervalMs(burstIndex_++);
+  }
+  waitUntil(nowMs, nextBurstMs_);
+}
+
+// One pass per deadline: close a receive window that is over, then send or
+// listen for what is due, then sleep the radio unless it is listening (or
+// still sending) and wait for the earliest next event.
+void BeaconEngine::runSlotted(uint32_t nowMs)
+{
+  if (listening_ && !before(nowMs, listenEndMs_))
+  {
+    endListen(nowMs);
+  }
+  else if (!listening_)
+  {
+    dropOverheard();
+  }
+  if (!before(nowMs, nextSyncMs_) && !listening_)
+  {
+    if (mac_->syncSource())
+    {
+      sendSync(nowMs);
+      nextSyncMs_ = mac_->nextSyncMs(nowMs + 1);
+    }
+    else
+    {
+      startListen(nowMs);
+    }
+  }
+  if (!before(nowMs, nextTxMs_))
+  {
+    sendSlotted(nowMs);
+    nextTxMs_ = mac_->nextDataSlotMs(nowMs + 1);
+  }
+
+  uint32_t deadlineMs = before(nextSyncMs_, nextTxMs_) ? nextSyncMs_ : nextTxMs_;
+  if (listening_)
+  {
+    deadlineMs = before(listenEndMs_, deadlineMs) ? listenEndMs_ : deadlineMs;
+  }
+  else if (!radio_.asleep())
+  {
+    if (radio_.sleep())
+    {
+      power_.radio(RadioState::Sleep, nowMs);
+    }
+    else if (before(nowMs + airMs_, deadlineMs))
+    {
+      deadlineMs = nowMs + airMs_;  // a packet is still on air
+    }
+  }
+  waitUntil(nowMs, deadlineMs);
+}
+
+void BeaconEngine::sendSlotted(uint32_t nowMs)
+{
+  if (!mac_->mayTransmit(nowMs, airMs_))
+  {
+    ++skipped_;  // found late in the slot
+    return;
+  }
+  wakeRadio(nowMs);
+  length_ = encodeBeacon(config_.id, seq_, config_.txPowerDbm, config_.periodMs, packet_);
+  ++bursts_;
+  if (radio_.send(packet_, length_))
+  {
+    ++seq_;
+    ++sent_;
+    mac_->noteTx(nowMs, airMs_);
+    power_.radio(RadioState::Tx, nowMs);
+    power_.radio(RadioState::Rx, nowMs + airMs_);
+  }
+  else
+  {
+    ++deferred_;
+  }
+}
+
+void BeaconEngine::sendSync(uint32_t nowMs)
+{
+  using asap::proto::SyncMsg;
+  if (mac_->slotAt(nowMs) != asap::radio::TdmaMac::kSyncSlot)
+  {
+    return;
+  }
+  wakeRadio(nowMs);
+  const uint16_t frame = mac_->frameAt(nowMs);
+  asap::proto::Encoder<SyncMsg> encoder(config_.id, static_cast<uint8_t>(frame));
+  encoder.set<SyncMsg::Frame>(frame)
+      .set<SyncMsg::SlotMs>(mac_->config().slotMs)
+      .set<SyncMsg::DataSlots>(mac_->config().dataSlots);
+  const uint8_t length = encoder.seal();
+  const uint8_t airMs = asap::radio::airtimeMs(length);
+  if (radio_.send(encoder.data(), length))
+  {
+    ++syncsSent_;
+    mac_->noteTx(nowMs, airMs);
+    power_.radio(RadioState::Tx, nowMs);
+    power_.radio(RadioState::Rx, nowMs + airMs);
+  }
+}
+
+// Synced, the window opens kListenGuardMs before a sync superframe and
+// closes as long after its sync slot; without a time base it spans a whole
+// sync period plus a slot, so the beacon lands in it wherever it falls.
+void BeaconEngine::startListen(uint32_t nowMs)
+{
+  wakeRadio(nowMs);
+  radio_.listen();
+  power_.radio(RadioState::Rx, nowMs);
+  ++listens_;
+  listening_ = true;
+  const asap::radio::SuperframeConfig& shape = mac_->config();
+  listenEndMs_ = mac_->synced(nowMs)
+                     ? nowMs + 2u * kListenGuardMs + shape.slotMs
+                     : nowMs + static_cast<uint32_t>(shape.syncEveryFrames) * mac_->superframeMs() + shape.slotMs;
+  nextSyncMs_ = listenEndMs_;  // set for real by endListen()
+}
+
+void BeaconEngine::endListen(uint32_t nowMs)
+{
+  using namespace asap::proto;
+  listening_ = false;
+  bool moved = false;
+  asap::radio::PacketRing& packets = radio_.rx();
+  while (const asap::radio::RxSlot* slot = packets.peek())
+  {
+    const uint8_t* payload = slot->payload();
+    const uint8_t length = slot->length();
+    if (peekType(payload, length) == MsgType::Sync)
+    {
+      const SyncView sync(payload, length);
+      if (sync.valid() && sync.emitterId() == mac_->config().syncSourceId)
+      {
+        moved |= mac_->onSync(slot->timeMs, static_cast<uint16_t>(sync.get<SyncMsg::Frame>()),
+                              static_cast<uint8_t>(sync.get<SyncMsg::SlotMs>()),
+                              static_cast<uint8_t>(sync.get<SyncMsg::DataSlots>()), asap::radio::airtimeMs(length));
+      }
+    }
+    packets.release();
+  }
+  if (moved)
+  {
+    nextTxMs_ = mac_->nextDataSlotMs(nowMs);
+  }
+  const uint32_t syncPeriodMs = static_cast<uint32_t>(mac_->config().syncEveryFrames) * mac_->superframeMs();
+  nextSyncMs_ = mac_->synced(nowMs)
+                    ? mac_->nextSyncMs(nowMs + (kListenEverySyncs - 1u) * syncPeriodMs) - kListenGuardMs
+                    : nowMs + kAcquireEverySyncs * syncPeriodMs;
+}
+
+void BeaconEngine::wakeRadio(uint32_t nowMs)
+{
+  if (!radio_.asleep())
+  {
+    return;
+  }
+  radio_.wake();
+  power_.radioWake();
+  power_.radio(RadioState::Idle, nowMs);
+}
+
+void BeaconEngine::dropOverheard()
+{
+  asap::radio::PacketRing& overheard = radio_.rx();
+  while (overheard.peek())
+  {
+    overheard.release();
+  }
+}
+
+void BeaconEngine::waitUntil(uint32_t nowMs, uint32_t deadlineMs)
+{
+  power_.mcuWait(deadlineMs - nowMs);
+  scheduler_->setDeadline(task_, deadlineMs);
+}
+
+}  // namespace asap::roles
+//
+// BeaconEngine.cpp
+// Every burst start is an absolute time on the table's grid, not "now plus
+// an interval", so task latency never accumulates into the period.
+//
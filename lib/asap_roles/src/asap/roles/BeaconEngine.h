@@ -0,0 +1,150 @@
+#pragma once
+
+#include <stdint.h>
+#include <asap/core/Scheduler.h>
+#include <asap/power/PowerModel.h>
+#include <asap/radio/Cc1101.h>
+#include <asap/radio/TdmaMac.h>
+#include <asap/roles/EmitterRoles.h>
+
+// Burst intervals a beacon precomputes at boot and then cycles through, two
+// bytes each (override with -D in platformio.ini). Even, so the jitter can
+// cancel out in pairs.
+#ifndef ASAP_BEACON_SCHEDULE_LEN
+#define ASAP_BEACON_SCHEDULE_LEN 32
+#endif
+
+namespace asap::roles
+{
+
+// When a duty-cycled beacon transmits, computed once from its ID and config:
+// a first delay within one period (ID-derived, like the free-running
+// emitters' phase) and a table of start-to-start intervals of periodMs +-
+// jitterMs. The jitter comes in opposite pairs, shuffled, so the table
+// averages exactly periodMs and airtime per hour is fixed by the config.
+class BeaconSchedule
+{
+ public:
+  static constexpr uint8_t kIntervals = ASAP_BEACON_SCHEDULE_LEN;
+  static_assert(kIntervals >= 2 && kIntervals % 2 == 0, "ASAP_BEACON_SCHEDULE_LEN must be even");
+
+  // airMs: airtime of one beacon packet. The jitter is clamped to half a
+  // period (and so that no interval exceeds 65535 ms), the burst to what
+  // fits in the shortest interval.
+  BeaconSchedule(const BeaconConfig& config, uint8_t airMs);
+
+  uint32_t firstDelayMs() const { return firstDelayMs_; }
+  // Start of burst n to start of burst n + 1.
+  uint16_t intervalMs(uint32_t burst) const { return intervals_[burst % kIntervals]; }
+  uint8_t packets() const { return packets_; }
+  uint8_t gapMs() const { return gapMs_; }
+  uint16_t jitterMs() const { return jitterMs_; }
+  // Length of one pass through the table: kIntervals * periodMs.
+  uint32_t cycleMs() const;
+
+ private:
+  uint16_t intervals_[kIntervals];
+  uint16_t firstDelayMs_;
+  uint16_t jitterMs_;
+  uint8_t packets_;
+  uint8_t gapMs_;
+};
+
+// Beacon image for battery stakes. Between bursts the CC1101 sleeps and the
+// only armed task is the next burst, so the scheduler's clock can park the
+// MCU (asap::power::stopModeClock()). A burst wakes the radio, sends the
+// beacon packet burstPackets times, and puts the radio back to sleep as
+// soon as the last copy is off air. Bursts stay on the precomputed grid;
+// one found late is skipped, not sent back to back with the next.
+//
+// With a TdmaMac the engine runs slotted instead: one copy per own data
+// slot (the burst settings and the schedule table are unused) and the radio
+// asleep in between. The sync source also sends the sync beacon; a follower
+// opens the receiver around one sync slot in kListenEverySyncs, or for a
+// whole sync period while it has no time base, which stays well within
+// TdmaMac::kSyncTimeoutFrames.
+//
+// A PowerAccount follows the radio states and wakes, so the same engine on
+// a virtual clock (tests, asap_sim --duty 1) reports duty cycle, airtime
+// and mA h per hour.
+class BeaconEngine
+{
+ public:
+  BeaconEngine(asap::radio::Cc1101& radio, const BeaconConfig& config,
+               const asap::power::PowerProfile& profile = asap::power::PowerProfile{});
+
+  static constexpr uint8_t kListenEverySyncs = 4;    // synced follower
+  static constexpr uint8_t kAcquireEverySyncs = 32;  // follower without a time base
+  static constexpr uint8_t kListenGuardMs = 2;       // either side of the sync slot
+
+  // Register the burst task and put the radio to sleep until the first
+  // burst. The radio must already be running (Cc1101::begin()).
+  void begin(asap::core::Scheduler& scheduler, asap::radio::TdmaMac* mac = nullptr);
+
+  uint16_t id() const { return config_.id; }
+  const BeaconSchedule& schedule() const { return schedule_; }
+  uint8_t packetAirMs() const { return airMs_; }
+  asap::power::PowerReport power(uint32_t nowMs) const { return power_.report(nowMs); }
+
+  uint32_t bursts() const { return bursts_; }
+  uint32_t sent() const { return sent_; }
+  uint32_t deferred() const { return deferred_; }  // TX queue full
+  uint32_t skipped() const { return skipped_; }    // bursts found late, slots missed
+  uint32_t syncsSent() const { return syncsSent_; }
+  uint32_t listens() const { return listens_; }    // receive windows opened
+
+ private:
+  enum class Phase : uint8_t
+  {
+    Asleep,  // next run starts a burst
+    Burst,   // next run sends the next copy
+    Settle,  // next run puts the radio to sleep
+  };
+
+  static void run(void* context, uint32_t nowMs);
+  void sendCopy(uint32_t nowMs);
+  void settle(uint32_t nowMs);
+  void runSlotted(uint32_t nowMs);
+  void sendSlotted(uint32_t nowMs);
+  void sendSync(uint32_t nowMs);
+  void startListen(uint32_t nowMs);
+  void endListen(uint32_t nowMs);
+  void wakeRadio(uint32_t nowMs);
+  void dropOverheard();
+  // Next run at deadlineMs; the wait goes into the power account.
+  void waitUntil(uint32_t nowMs, uint32_t deadlineMs);
+
+  asap::radio::Cc1101& radio_;
+  BeaconConfig config_;
+  uint8_t airMs_;
+  BeaconSchedule schedule_;
+  asap::power::PowerAccount power_;
+  uint8_t packet_[asap::radio::kMaxPayload];
+  uint8_t length_;
+  uint8_t seq_;
+  uint8_t copy_;
+  Phase phase_;
+  uint32_t burstIndex_;
+  uint32_t nextBurstMs_;
+  uint32_t bursts_;
+  uint32_t sent_;
+  uint32_t deferred_;
+  uint32_t skipped_;
+  // Slotted mode only.
+  asap::radio::TdmaMac* mac_;
+  uint32_t nextTxMs_;
+  uint32_t nextSyncMs_;  // source: next sync beacon; follower: next listen
+  uint32_t listenEndMs_;
+  bool listening_;
+  uint32_t syncsSent_;
+  uint32_t listens_;
+  asap::core::Scheduler* scheduler_;
+  asap::core::TaskId task_;
+};
+
+}  // namespace asap::roles
+//
+// BeaconEngine.h
+// BeaconRole remains for boards on mains power; the packet is the same
+// (encodeBeacon), so detectors cannot tell them apart.
+//
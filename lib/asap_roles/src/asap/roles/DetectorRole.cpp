@@ -0,0 +1,195 @@
+#include <asap/roles/DetectorRole.h>
+
+#include <asap/proto/Messages.h>
+
+namespace asap::roles
+{
+
+DetectorRole::DetectorRole(asap::display::DetectorDisplay& display, asap::radio::Cc1101& radio,
+                           const asap::game::ExposureConfig& exposure,
+                           const asap::game::CorrelatorConfig& artifacts)
+    : radio_(radio),
+      joyEvents_(),
+      ui_(display),
+      scheduler_(nullptr),
+      uiTask_(asap::core::kInvalidTask),
+      radioTask_(asap::core::kInvalidTask),
+      exposureTask_(asap::core::kInvalidTask),
+      rx_{},
+      tracks_(),
+      exposure_(exposure),
+      artifacts_(artifacts)
+{
+}
+
+void DetectorRole::begin(asap::core::Scheduler& scheduler)
+{
+  scheduler_ = &scheduler;
+  uiTask_ = scheduler.addOneShot(0, &runUi, this);
+  radioTask_ = scheduler.addOneShot(0, &runRadio, this);
+  exposureTask_ = scheduler.addOneShot(0, &runExposure, this);
+}
+
+void DetectorRole::onJoystickEdge(void* role)
+{
+  DetectorRole& self = *static_cast<DetectorRole*>(role);
+  if (self.scheduler_)
+  {
+    self.scheduler_->signal(self.uiTask_);
+  }
+}
+
+void DetectorRole::onRadioIrq(void* role)
+{
+  DetectorRole& self = *static_cast<DetectorRole*>(role);
+  if (self.scheduler_)
+  {
+    self.scheduler_->signal(self.radioTask_);
+  }
+}
+
+// Drain joystick edges, render if invalidated, and sleep until the deadline
+// the controller reports (or until the joystick signals again).
+void DetectorRole::runUi(void* context, uint32_t nowMs)
+{
+  DetectorRole& self = *static_cast<DetectorRole*>(context);
+  self.scheduler_->setDeadline(self.uiTask_, self.ui_.onInput(self.joyEvents_, nowMs));
+}
+
+// Slots are decoded in place and released; nothing is copied. A change the
+// UI has to show makes the UI task due right away.
+void DetectorRole::runRadio(void* context, uint32_t nowMs)
+{
+  using namespace asap::proto;
+  DetectorRole& self = *static_cast<DetectorRole*>(context);
+  asap::radio::PacketRing& packets = self.radio_.rx();
+  auto tally = [&self](bool valid, uint32_t& counter) { ++(valid ? counter : self.rx_.invalid); };
+  auto track = [&self](const auto& view, const asap::radio::RxSlot& slot) {
+    if (view.valid())
+    {
+      self.tracks_.update(view.emitterId(), peekType(slot.payload(), slot.length()), slot.rssiDbm(), view.seq(),
+                          slot.timeMs);
+    }
+  };
+  while (const asap::radio::RxSlot* slot = packets.peek())
+  {
+    const uint8_t* payload = slot->payload();
+    const uint8_t length = slot->length();
+    switch (peekType(payload, length))
+    {
+      case MsgType::Beacon: {
+        const BeaconView beacon(payload, length);
+        tally(beacon.valid(), self.rx_.beacons);
+        track(beacon, *slot);
+        break;
+      }
+      case MsgType::Anomaly: {
+        const AnomalyView anomaly(payload, length);
+        tally(anomaly.valid(), self.rx_.anomalies);
+        track(anomaly, *slot);
+        if (anomaly.valid())
+        {
+          const uint8_t intensity[asap::game::kChannelCount] = {
+              static_cast<uint8_t>(anomaly.get<AnomalyMsg::Rad>()),
+              static_cast<uint8_t>(anomaly.get<AnomalyMsg::Therm>()),
+              static_cast<uint8_t>(anomaly.get<AnomalyMsg::Chem>()),
+              static_cast<uint8_t>(anomaly.get<AnomalyMsg::Psy>()),
+          };
+          if (self.exposure_.onAnomaly(intensity, slot->rssiDbm(), slot->timeMs, anomaly.emitterId()))
+          {
+            self.scheduler_->setDeadline(self.exposureTask_, nowMs + self.exposure_.config().tickMs);
+          }
+        }
+        break;
+      }
+      case MsgType::Artifact: {
+        const ArtifactView artifact(payload, length);
+        tally(artifact.valid(), self.rx_.artifacts);
+        track(artifact, *slot);
+        if (artifact.valid())
+        {
+          self.artifacts_.onPing(artifact.emitterId(), static_cast<uint16_t>(artifact.get<ArtifactMsg::Signature>()),
+                                 static_cast<uint8_t>(artifact.get<ArtifactMsg::PingIndex>()), slot->timeMs);
+        }
+        break;
+      }
+      case MsgType::GameConfig:
+        tally(GameConfigView(payload, length).valid(), self.rx_.configs);
+        break;
+      case MsgType::Sync:
+        tally(SyncView(payload, length).valid(), self.rx_.syncs);
+        break;
+      default:
+        ++self.rx_.invalid;
+        break;
+    }
+    packets.release();
+  }
+  self.tracks_.expire(nowMs);
+  self.artifacts_.expire(nowMs);
+  self.showTracked();
+  if (self.tracks_.size() > 0)
+  {
+    self.scheduler_->setDeadline(self.radioTask_, nowMs + kExpireEveryMs);
+  }
+  if (self.ui_.needsRender())
+  {
+    self.scheduler_->signal(self.uiTask_);
+  }
+}
+
+// The tracking HUD shows the selected beacon's table entry, or in auto mode
+// (ID 0) the strongest beacon tracked; its filter already ran on every
+// sample, so the HUD and the table agree. Once that entry ages out the HUD
+// drops its reading.
+void DetectorRole::showTracked()
+{
+  const asap::track::TrackEntry* entry = nullptr;
+  if (ui_.trackingId() == 0)
+  {
+    tracks_.strongest(&entry, 1, asap::proto::MsgType::Beacon);
+  }
+  else
+  {
+    entry = tracks_.find(ui_.trackingId());
+  }
+  if (entry)
+  {
+    ui_.setTrackedEmitter(entry->id, entry->rssiDbm());
+  }
+  else
+  {
+    ui_.clearTrackedEmitter();
+  }
+}
+
+// Integrate the anomaly fields; the HUD is told only when a ring's visible
+// percent or a stage moved. Goes idle with the engine until the next
+// anomaly packet.
+void DetectorRole::runExposure(void* context, uint32_t nowMs)
+{
+  DetectorRole& self = *static_cast<DetectorRole*>(context);
+  uint32_t nextMs = 0;
+  if (self.exposure_.tick(nowMs, nextMs))
+  {
+    self.scheduler_->setDeadline(self.exposureTask_, nextMs);
+  }
+  if (self.exposure_.takeChanged())
+  {
+    const asap::game::ExposureView& v = self.exposure_.view();
+    self.ui_.setAnomalyExposure(v.percent[0], v.percent[1], v.percent[2], v.percent[3]);
+    self.ui_.setAnomalyStage(v.stage[0], v.stage[1], v.stage[2], v.stage[3]);
+    if (self.ui_.needsRender())
+    {
+      self.scheduler_->signal(self.uiTask_);
+    }
+  }
+}
+
+}  // namespace asap::roles
+//
+// DetectorRole.cpp
+// Anomaly and artifact packets are tracked and counted here, config packets
+// only validated; their models (exposure, artifact fingerprints) consume them
+// as they land.
+//
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <stdint.h>
+#include <asap/core/Scheduler.h>
+#include <asap/display/DetectorDisplay.h>
+#include <asap/game/ArtifactFingerprint.h>
+#include <asap/game/ExposureEngine.h>
+#include <asap/input/JoyEventQueue.h>
+#include <asap/radio/Cc1101.h>
+#include <asap/track/TrackingTable.h>
+#include <asap/ui/UIController.h>
+
+namespace asap::roles
+{
+
+// Detector role logic: the UI task (joystick edges, invalidation-driven
+// rendering, sleep until the controller's next wakeup), the radio task
+// (decode packets from the ring in place, record every emitter in the
+// tracking table, feed the tracking HUD from it and check artifact pings
+// against their fingerprints) and the exposure task (integrates anomaly
+// fields into the HUD's rings while exposed). Interrupts only signal these
+// tasks through the static hooks.
+class DetectorRole
+{
+ public:
+  // Packets decoded by type since boot.
+  struct RxCounts
+  {
+    uint32_t beacons;
+    uint32_t anomalies;
+    uint32_t artifacts;
+    uint32_t configs;
+    uint32_t syncs;    // TDMA sync beacons (not used by the detector yet)
+    uint32_t invalid;  // failed the schema check (length, version, CRC)
+  };
+
+  // While anything is tracked, the radio task also wakes this often to age
+  // out emitters that went quiet.
+  static constexpr uint32_t kExpireEveryMs = 1000;
+
+  DetectorRole(asap::display::DetectorDisplay& display, asap::radio::Cc1101& radio,
+               const asap::game::ExposureConfig& exposure = asap::game::ExposureConfig{},
+               const asap::game::CorrelatorConfig& artifacts = asap::game::CorrelatorConfig{});
+
+  // Register the UI and radio tasks.
+  void begin(asap::core::Scheduler& scheduler);
+
+  asap::input::JoyEventQueue& joyEvents() { return joyEvents_; }
+  asap::ui::UIController& ui() { return ui_; }
+  const RxCounts& rxCounts() const { return rx_; }
+  const asap::track::DetectorTracks& tracks() const { return tracks_; }
+  const asap::game::ExposureEngine& exposure() const { return exposure_; }
+  const asap::game::ArtifactCorrelator& artifacts() const { return artifacts_; }
+
+  // ISR hooks (JoystickDebouncer::EdgeHook / asap::radio::IrqHook); `role`
+  // is the DetectorRole.
+  static void onJoystickEdge(void* role);
+  static void onRadioIrq(void* role);
+
+ private:
+  static void runUi(void* context, uint32_t nowMs);
+  static void runRadio(void* context, uint32_t nowMs);
+  static void runExposure(void* context, uint32_t nowMs);
+  void showTracked();
+
+  asap::radio::Cc1101& radio_;
+  asap::input::JoyEventQueue joyEvents_;
+  asap::ui::UIController ui_;
+  asap::core::Scheduler* scheduler_;
+  asap::core::TaskId uiTask_;
+  asap::core::TaskId radioTask_;
+  asap::core::TaskId exposureTask_;
+  RxCounts rx_;
+  asap::track::DetectorTracks tracks_;
+  asap::game::ExposureEngine exposure_;
+  asap::game::ArtifactCorrelator artifacts_;
+};
+
+}  // namespace asap::roles
+//
+// DetectorRole.h
+// Everything main_detector.cpp used to hold except the board wiring, so the
+// world simulator can run dozens of detectors with the firmware's own logic.
+//
@@ -0,0 +1,253 @@
+#include <asap/roles/EmitterRoles.h>
+
+#include <string.h>  // memcpy of encoded packets
+
+#include <asap/proto/Messages.h>
+
+namespace asap::roles
+{
+
+namespace
+{
+// Spread first transmissions over the period (Knuth multiplicative hash).
+uint32_t phaseFor(uint16_t id, uint16_t periodMs)
+{
+  return (static_cast<uint32_t>(id) * 2654435761u) % (periodMs ? periodMs : 1);
+}
+
+template <class S>
+uint8_t copyOut(asap::proto::Encoder<S>& encoder, uint8_t* out)
+{
+  const uint8_t length = encoder.seal();
+  memcpy(out, encoder.data(), length);
+  return length;
+}
+
+// Emission pattern of an anomaly: its config, with a seed of its own.
+asap::game::EmissionConfig emissionConfig(const AnomalyConfig& config)
+{
+  asap::game::EmissionConfig emission;
+  emission.seed = config.seed ? config.seed : (config.id * 2654435761u) ^ 0x85EBCA6Bu;
+  emission.frameMs = config.periodMs;
+  for (uint8_t c = 0; c < 4; ++c)
+  {
+    emission.channels[c] = config.bursts[c];
+    emission.channels[c].floor = config.intensity[c];
+  }
+  return emission;
+}
+}  // namespace
+
+// ---- EmitterRole ------------------------------------------------------------
+
+EmitterRole::EmitterRole(asap::radio::Cc1101& radio, uint16_t id, uint16_t periodMs, EncodeFn encode)
+    : radio_(radio),
+      encode_(encode),
+      id_(id),
+      periodMs_(periodMs),
+      seq_(0),
+      sent_(0),
+      deferred_(0),
+      syncsSent_(0),
+      mac_(nullptr),
+      scheduler_(nullptr),
+      txTask_(asap::core::kInvalidTask),
+      rxTask_(asap::core::kInvalidTask),
+      syncTask_(asap::core::kInvalidTask)
+{
+}
+
+void EmitterRole::begin(asap::core::Scheduler& scheduler, asap::radio::TdmaMac* mac)
+{
+  scheduler_ = &scheduler;
+  mac_ = mac;
+  if (!mac_)
+  {
+    txTask_ = scheduler.addPeriodic(periodMs_, &transmit, this, phaseFor(id_, periodMs_));
+    return;
+  }
+  const uint32_t nowMs = scheduler.nowMs();
+  mac_->begin(nowMs, periodMs_);
+  const uint32_t firstMs = mac_->nextDataSlotMs(nowMs + (mac_->syncSource() ? 0 : mac_->acquireDelayMs()));
+  txTask_ = scheduler.addOneShot(firstMs - nowMs, &transmit, this);
+  rxTask_ = scheduler.addOneShot(0, &receive, this);
+  if (mac_->syncSource())
+  {
+    syncTask_ = scheduler.addOneShot(mac_->nextSyncMs(nowMs) - nowMs, &sendSync, this);
+  }
+}
+
+void EmitterRole::onRadioIrq(void* role)
+{
+  EmitterRole& self = *static_cast<EmitterRole*>(role);
+  if (self.scheduler_ && self.rxTask_ != asap::core::kInvalidTask)
+  {
+    self.scheduler_->signal(self.rxTask_);
+  }
+}
+
+void EmitterRole::transmit(void* context, uint32_t nowMs)
+{
+  EmitterRole& self = *static_cast<EmitterRole*>(context);
+  if (!self.mac_)
+  {
+    // Emitters stay in RX between packets; whatever they overheard is not
+    // for them.
+    asap::radio::PacketRing& overheard = self.radio_.rx();
+    while (overheard.peek())
+    {
+      overheard.release();
+    }
+  }
+  uint8_t packet[asap::radio::kMaxPayload];
+  const uint8_t length = self.encode_(self, packet, self.seq_);
+  const uint8_t airMs = asap::radio::airtimeMs(length);
+  if ((!self.mac_ || self.mac_->mayTransmit(nowMs, airMs)) && self.radio_.send(packet, length))
+  {
+    ++self.seq_;
+    ++self.sent_;
+    if (self.mac_)
+    {
+      self.mac_->noteTx(nowMs, airMs);
+    }
+  }
+  else
+  {
+    ++self.deferred_;
+  }
+  if (self.mac_)
+  {
+    self.scheduler_->setDeadline(self.txTask_, self.mac_->nextDataSlotMs(nowMs + 1));
+  }
+}
+
+// Slotted mode only: account overheard airtime per slot and follow the sync
+// beacon. A moved time base re-arms the transmit task right away, which
+// also ends the acquisition wait.
+void EmitterRole::receive(void* context, uint32_t nowMs)
+{
+  using namespace asap::proto;
+  EmitterRole& self = *static_cast<EmitterRole*>(context);
+  asap::radio::PacketRing& packets = self.radio_.rx();
+  bool moved = false;
+  while (const asap::radio::RxSlot* slot = packets.peek())
+  {
+    const uint8_t* payload = slot->payload();
+    const uint8_t length = slot->length();
+    const uint8_t airMs = asap::radio::airtimeMs(length);
+    self.mac_->noteRx(slot->timeMs, airMs);
+    if (peekType(payload, length) == MsgType::Sync)
+    {
+      const SyncView sync(payload, length);
+      if (sync.valid() && sync.emitterId() == self.mac_->config().syncSourceId)
+      {
+        moved |= self.mac_->onSync(slot->timeMs, static_cast<uint16_t>(sync.get<SyncMsg::Frame>()),
+                                   static_cast<uint8_t>(sync.get<SyncMsg::SlotMs>()),
+                                   static_cast<uint8_t>(sync.get<SyncMsg::DataSlots>()), airMs);
+      }
+    }
+    packets.release();
+  }
+  if (moved)
+  {
+    self.scheduler_->setDeadline(self.txTask_, self.mac_->nextDataSlotMs(nowMs));
+  }
+}
+
+void EmitterRole::sendSync(void* context, uint32_t nowMs)
+{
+  using asap::proto::SyncMsg;
+  EmitterRole& self = *static_cast<EmitterRole*>(context);
+  asap::radio::TdmaMac& mac = *self.mac_;
+  if (mac.slotAt(nowMs) == asap::radio::TdmaMac::kSyncSlot)
+  {
+    const uint16_t frame = mac.frameAt(nowMs);
+    asap::proto::Encoder<SyncMsg> encoder(self.id_, static_cast<uint8_t>(frame));
+    encoder.set<SyncMsg::Frame>(frame)
+        .set<SyncMsg::SlotMs>(mac.config().slotMs)
+        .set<SyncMsg::DataSlots>(mac.config().dataSlots);
+    const uint8_t length = encoder.seal();
+    if (self.radio_.send(encoder.data(), length))
+    {
+      ++self.syncsSent_;
+      mac.noteTx(nowMs, asap::radio::airtimeMs(length));
+    }
+  }
+  self.scheduler_->setDeadline(self.syncTask_, mac.nextSyncMs(nowMs + 1));
+}
+
+// ---- BeaconRole -------------------------------------------------------------
+
+BeaconRole::BeaconRole(asap::radio::Cc1101& radio, const BeaconConfig& config)
+    : EmitterRole(radio, config.id, config.periodMs, &BeaconRole::encode),
+      txPowerDbm_(config.txPowerDbm)
+{
+}
+
+uint8_t BeaconRole::encode(EmitterRole& base, uint8_t* out, uint8_t seq)
+{
+  BeaconRole& self = static_cast<BeaconRole&>(base);
+  return encodeBeacon(self.id(), seq, self.txPowerDbm_, self.periodMs(), out);
+}
+
+uint8_t encodeBeacon(uint16_t id, uint8_t seq, int8_t txPowerDbm, uint16_t periodMs, uint8_t* out)
+{
+  using asap::proto::BeaconMsg;
+  asap::proto::Encoder<BeaconMsg> encoder(id, seq);
+  encoder.set<BeaconMsg::TxPowerDbm>(txPowerDbm).set<BeaconMsg::PeriodMs>(periodMs);
+  return copyOut(encoder, out);
+}
+
+// ---- AnomalyRole ------------------------------------------------------------
+
+AnomalyRole::AnomalyRole(asap::radio::Cc1101& radio, const AnomalyConfig& config)
+    : EmitterRole(radio, config.id, config.periodMs, &AnomalyRole::encode), emission_(emissionConfig(config))
+{
+}
+
+uint8_t AnomalyRole::encode(EmitterRole& base, uint8_t* out, uint8_t seq)
+{
+  AnomalyRole& self = static_cast<AnomalyRole&>(base);
+  using asap::proto::AnomalyMsg;
+  asap::proto::Encoder<AnomalyMsg> encoder(self.id(), seq);
+  const asap::game::EmissionFrame& frame = self.emission_.next();
+  encoder.set<AnomalyMsg::Rad>(frame.intensity[0])
+      .set<AnomalyMsg::Therm>(frame.intensity[1])
+      .set<AnomalyMsg::Chem>(frame.intensity[2])
+      .set<AnomalyMsg::Psy>(frame.intensity[3])
+      .set<AnomalyMsg::BurstSeq>(self.emission_.burstSeq());
+  return copyOut(encoder, out);
+}
+
+// ---- ArtifactRole -----------------------------------------------------------
+
+ArtifactRole::ArtifactRole(asap::radio::Cc1101& radio, const ArtifactConfig& config)
+    : EmitterRole(radio, config.id, config.periodMs, &ArtifactRole::encode),
+      signature_(config.signature),
+      pingIndex_(0)
+{
+}
+
+uint8_t ArtifactRole::encode(EmitterRole& base, uint8_t* out, uint8_t seq)
+{
+  ArtifactRole& self = static_cast<ArtifactRole&>(base);
+  const uint8_t index = self.pingIndex_;
+  self.pingIndex_ = static_cast<uint8_t>((index + 1) % asap::game::Fingerprint::kPings);
+  return encodeArtifact(self.id(), seq, self.signature_, index, out);
+}
+
+uint8_t encodeArtifact(uint16_t id, uint8_t seq, uint16_t signature, uint8_t pingIndex, uint8_t* out)
+{
+  using asap::proto::ArtifactMsg;
+  asap::proto::Encoder<ArtifactMsg> encoder(id, seq);
+  encoder.set<ArtifactMsg::Signature>(signature).set<ArtifactMsg::PingIndex>(pingIndex);
+  return copyOut(encoder, out);
+}
+
+}  // namespace asap::roles
+//
+// EmitterRoles.cpp
+// Transmission is fire-and-forget: with the queue full (or the slot missed)
+// the packet is skipped and counted rather than retried, since the next
+// period carries fresher data anyway.
+//
@@ -0,0 +1,151 @@
+#pragma once
+
+#include <stdint.h>
+#include <asap/core/Scheduler.h>
+#include <asap/game/ArtifactFingerprint.h>
+#include <asap/game/EmissionEngine.h>
+#include <asap/radio/Cc1101.h>
+#include <asap/radio/TdmaMac.h>
+
+namespace asap::roles
+{
+
+// Transmit side shared by the beacon, anomaly and artifact roles: a task
+// that builds one packet and queues it on the radio.
+//
+// Without a MAC the task is periodic and the first transmission is delayed
+// by an ID-derived phase so emitters powered up together do not stay in
+// lockstep. With a TdmaMac it runs at the start of the device's data slot,
+// a receive task feeds sync beacons and overheard airtime to the MAC, and
+// the sync source also sends the sync beacon.
+class EmitterRole
+{
+ public:
+  // Register the tasks. The radio must already be running (Cc1101::begin()),
+  // with onRadioIrq as its interrupt hook when a MAC is used.
+  void begin(asap::core::Scheduler& scheduler, asap::radio::TdmaMac* mac = nullptr);
+
+  // ISR hook (asap::radio::IrqHook); `role` is the EmitterRole.
+  static void onRadioIrq(void* role);
+
+  uint16_t id() const { return id_; }
+  uint16_t periodMs() const { return periodMs_; }
+  uint32_t sent() const { return sent_; }
+  uint32_t deferred() const { return deferred_; }  // TX queue full or slot missed
+  uint32_t syncsSent() const { return syncsSent_; }
+
+ protected:
+  // Fill `out` (kMaxPayload bytes) with the next packet of the concrete
+  // role; return its length.
+  using EncodeFn = uint8_t (*)(EmitterRole& self, uint8_t* out, uint8_t seq);
+
+  EmitterRole(asap::radio::Cc1101& radio, uint16_t id, uint16_t periodMs, EncodeFn encode);
+
+ private:
+  static void transmit(void* context, uint32_t nowMs);
+  static void receive(void* context, uint32_t nowMs);
+  static void sendSync(void* context, uint32_t nowMs);
+
+  asap::radio::Cc1101& radio_;
+  EncodeFn encode_;
+  uint16_t id_;
+  uint16_t periodMs_;
+  uint8_t seq_;
+  uint32_t sent_;
+  uint32_t deferred_;
+  uint32_t syncsSent_;
+  asap::radio::TdmaMac* mac_;
+  asap::core::Scheduler* scheduler_;
+  asap::core::TaskId txTask_;
+  asap::core::TaskId rxTask_;
+  asap::core::TaskId syncTask_;
+};
+
+struct BeaconConfig
+{
+  uint16_t id;
+  uint16_t periodMs = 1000;
+  int8_t txPowerDbm = 10;  // matches the PATABLE setting of Cc1101::begin()
+  // Duty-cycled beacons (BeaconEngine) only:
+  uint16_t jitterMs = 100;   // each interval is periodMs +- up to this
+  uint8_t burstPackets = 1;  // copies per burst, one sequence number
+  uint8_t burstGapMs = 10;   // start to start between copies
+};
+
+// Beacon packet of BeaconRole and BeaconEngine; `out` holds kMaxPayload.
+uint8_t encodeBeacon(uint16_t id, uint8_t seq, int8_t txPowerDbm, uint16_t periodMs, uint8_t* out);
+
+// Presence ping tracked by detectors.
+class BeaconRole : public EmitterRole
+{
+ public:
+  BeaconRole(asap::radio::Cc1101& radio, const BeaconConfig& config);
+
+ private:
+  static uint8_t encode(EmitterRole& self, uint8_t* out, uint8_t seq);
+
+  int8_t txPowerDbm_;
+};
+
+struct AnomalyConfig
+{
+  uint16_t id;
+  uint16_t periodMs = 500;
+  uint8_t intensity[4] = {0, 0, 0, 0};  // rad, therm, chem, psy: level between bursts
+  // Bursts per channel; each envelope's floor is taken from `intensity`.
+  // Default: none, a steady zone.
+  asap::game::BurstEnvelope bursts[4] = {};
+  uint32_t seed = 0;  // of the emission pattern; 0: derived from the ID
+};
+
+// Emission on the four HUD channels, from an EmissionEngine built at
+// construction: a steady floor with bursts on top. BurstSeq counts the
+// bursts started so far.
+class AnomalyRole : public EmitterRole
+{
+ public:
+  AnomalyRole(asap::radio::Cc1101& radio, const AnomalyConfig& config);
+
+  const asap::game::EmissionEngine& emission() const { return emission_; }
+
+ private:
+  static uint8_t encode(EmitterRole& self, uint8_t* out, uint8_t seq);
+
+  asap::game::EmissionEngine emission_;
+};
+
+struct ArtifactConfig
+{
+  uint16_t id;
+  uint16_t signature;
+  uint16_t periodMs = 5000;  // ArtifactRole: ping to ping; ArtifactEngine: cycle to cycle
+  // Fingerprinted artifacts (ArtifactEngine) only:
+  bool hidden = false;               // one cycle per hiddenPeriodMs instead
+  uint32_t hiddenPeriodMs = 120000;
+};
+
+// Artifact packet of ArtifactRole and ArtifactEngine; `out` holds kMaxPayload.
+uint8_t encodeArtifact(uint16_t id, uint8_t seq, uint16_t signature, uint8_t pingIndex, uint8_t* out);
+
+// Signature ping at a fixed period. The ping index runs through the
+// fingerprint's positions without its timing, so detectors track it but do
+// not recognize it (asap::game::ArtifactCorrelator): an artifact for TDMA
+// fields, or a decoy.
+class ArtifactRole : public EmitterRole
+{
+ public:
+  ArtifactRole(asap::radio::Cc1101& radio, const ArtifactConfig& config);
+
+ private:
+  static uint8_t encode(EmitterRole& self, uint8_t* out, uint8_t seq);
+
+  uint16_t signature_;
+  uint8_t pingIndex_;
+};
+
+}  // namespace asap::roles
+//
+// EmitterRoles.h
+// Role logic of the three emitter images, kept out of src/ so the world
+// simulator runs exactly what the boards run.
+//
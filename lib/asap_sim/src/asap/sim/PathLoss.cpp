@@ -0,0 +1,56 @@
+#ifndef ARDUINO
+
+#include <asap/sim/PathLoss.h>
+
+#include <cmath>
+
+namespace asap::sim
+{
+
+namespace
+{
+uint64_t splitmix64(uint64_t x)
+{
+  x += 0x9E3779B97F4A7C15ull;
+  x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+  x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+  return x ^ (x >> 31);
+}
+
+double unit(uint64_t bits)  // (0, 1]
+{
+  return (static_cast<double>(bits >> 11) + 1.0) / 9007199254740992.0;
+}
+}  // namespace
+
+float gaussian(uint64_t seed, uint64_t key)
+{
+  const uint64_t h1 = splitmix64(seed ^ splitmix64(key));
+  const uint64_t h2 = splitmix64(h1);
+  // Box-Muller
+  return static_cast<float>(std::sqrt(-2.0 * std::log(unit(h1))) * std::cos(6.283185307179586 * unit(h2)));
+}
+
+float PathLoss::meanRssiDbm(float distanceM) const
+{
+  const float d = distanceM < 1.0f ? 1.0f : distanceM;
+  return txPowerDbm - (refLossDb + 10.0f * exponent * std::log10(d));
+}
+
+int16_t PathLoss::rssiDbm(float distanceM, uint64_t seed, uint16_t a, uint16_t b) const
+{
+  const uint16_t lo = a < b ? a : b;
+  const uint16_t hi = a < b ? b : a;
+  const float shadow = shadowingDb > 0.0f ? shadowingDb * gaussian(seed, (static_cast<uint64_t>(lo) << 16) | hi) : 0.0f;
+  const float rssi = std::round(meanRssiDbm(distanceM) + shadow);
+  return static_cast<int16_t>(rssi < -150.0f ? -150.0f : (rssi > 0.0f ? 0.0f : rssi));
+}
+
+}  // namespace asap::sim
+
+#endif  // !ARDUINO
+//
+// PathLoss.cpp
+// Hash-based draws instead of a shared generator: a link's fade does not
+// depend on the order devices were created or on which thread runs the world.
+//
@@ -0,0 +1,35 @@
+#pragma once
+
+#ifndef ARDUINO
+
+#include <stdint.h>
+
+namespace asap::sim
+{
+
+// Log-distance path loss with static log-normal shadowing:
+//   RSSI = txPower - (refLoss + 10 * exponent * log10(d / 1 m)) + X
+// X ~ N(0, shadowingDb) is drawn once per device pair from the world seed,
+// so a link keeps its fade for the whole run and both directions agree.
+struct PathLoss
+{
+  float txPowerDbm = 10.0f;   // Cc1101 PATABLE 0xC0
+  float refLossDb = 40.0f;    // at 1 m, 433 MHz, body-worn whip antennas
+  float exponent = 2.7f;      // open terrain with trees and players
+  float shadowingDb = 4.0f;   // 0 disables shadowing
+
+  float meanRssiDbm(float distanceM) const;
+  int16_t rssiDbm(float distanceM, uint64_t seed, uint16_t a, uint16_t b) const;
+};
+
+// Deterministic standard normal sample for (seed, key).
+float gaussian(uint64_t seed, uint64_t key);
+
+}  // namespace asap::sim
+
+#endif  // !ARDUINO
+//
+// PathLoss.h
+// Coarse on purpose: it only has to rank channel plans, and the exponent and
+// shadowing are the knobs to fit against field measurements.
+//
@@ -0,0 +1,454 @@
+#ifndef ARDUINO
+
+#include <asap/sim/World.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <thread>
+
+#include <asap/core/Scheduler.h>
+#include <asap/display/DetectorDisplay.h>
+#include <asap/roles/ArtifactEngine.h>
+#include <asap/roles/BeaconEngine.h>
+#include <asap/roles/DetectorRole.h>
+#include <asap/roles/EmitterRoles.h>
+
+namespace asap::sim
+{
+
+using asap::core::before;
+using asap::radio::Cc1101;
+using asap::radio::VirtualCc1101;
+
+namespace
+{
+constexpr uint16_t kArtifactSignatureBase = 0xA000;
+constexpr uint32_t kMaxPowerUpSpreadMs = 60UL * 60UL * 1000UL;
+
+// xorshift64* for placement and profiles; seeded per world.
+struct Rng
+{
+  uint64_t state;
+
+  uint64_t next()
+  {
+    state ^= state >> 12;
+    state ^= state << 25;
+    state ^= state >> 27;
+    return state * 0x2545F4914F6CDD1Dull;
+  }
+  float unit() { return static_cast<float>(next() >> 40) / 16777216.0f; }  // [0, 1)
+};
+}  // namespace
+
+struct World::Device
+{
+  DeviceKind kind;
+  uint16_t id;
+  float x;
+  float y;
+  std::unique_ptr<VirtualCc1101> chip;
+  std::unique_ptr<Cc1101> radio;
+  std::unique_ptr<asap::core::Scheduler> scheduler;
+  std::unique_ptr<asap::roles::BeaconRole> beacon;
+  std::unique_ptr<asap::roles::BeaconEngine> beaconEngine;
+  std::unique_ptr<asap::roles::AnomalyRole> anomaly;
+  std::unique_ptr<asap::roles::ArtifactRole> artifact;
+  std::unique_ptr<asap::roles::ArtifactEngine> artifactEngine;
+  asap::roles::EmitterRole* emitter = nullptr;
+  std::unique_ptr<asap::radio::TdmaMac> mac;
+  std::unique_ptr<asap::display::DetectorDisplay> display;
+  std::unique_ptr<asap::roles::DetectorRole> detector;
+};
+
+World::World(const WorldConfig& config)
+    : config_(config)
+{
+  medium_.setSensitivity(config_.sensitivityDbm);
+
+  Rng rng{config_.seed * 0x9E3779B97F4A7C15ull + 1};
+  uint16_t nextId = 1;
+  // Fingerprinted artifacts sleep through the sync beacon and stay
+  // unslotted; stakes (BeaconEngine) follow it with short receive windows.
+  auto add = [&](DeviceKind kind, bool sleeps = false) -> Device& {
+    auto device = std::make_unique<Device>();
+    device->kind = kind;
+    device->id = kind == DeviceKind::Detector ? 0 : nextId++;
+    device->chip = std::make_unique<VirtualCc1101>(medium_);
+    const uint32_t powerUpMs = static_cast<uint32_t>(rng.next() % kMaxPowerUpSpreadMs);
+    const uint32_t driftSpan = 2u * config_.clockDriftPpm + 1u;
+    device->chip->setClock(powerUpMs, static_cast<int32_t>(rng.next() % driftSpan) - config_.clockDriftPpm);
+    device->radio = std::make_unique<Cc1101>(device->chip->port());
+    device->scheduler = std::make_unique<asap::core::Scheduler>(
+        asap::core::SchedulerClock{&clockNow, &clockSleep, device->chip.get()});
+    device->radio->begin();
+    if (kind != DeviceKind::Detector && !sleeps && config_.tdma)
+    {
+      device->mac = std::make_unique<asap::radio::TdmaMac>(device->id, config_.superframe);
+    }
+    devices_.push_back(std::move(device));
+    return *devices_.back();
+  };
+
+  for (uint16_t i = 0; i < config_.beacons; ++i)
+  {
+    Device& d = add(DeviceKind::Beacon);
+    asap::roles::BeaconConfig beacon{d.id};
+    beacon.periodMs = config_.beaconPeriodMs;
+    if (config_.dutyCycledBeacons)
+    {
+      d.beaconEngine = std::make_unique<asap::roles::BeaconEngine>(*d.radio, beacon);
+      continue;
+    }
+    d.beacon = std::make_unique<asap::roles::BeaconRole>(*d.radio, beacon);
+    d.emitter = d.beacon.get();
+  }
+  for (uint16_t i = 0; i < config_.anomalies; ++i)
+  {
+    Device& d = add(DeviceKind::Anomaly);
+    asap::roles::AnomalyConfig profile{d.id};
+    profile.periodMs = config_.anomalyPeriodMs;
+    // One active channel: a quarter of the drawn level between bursts, the
+    // full level at the top of the strongest (the pattern's seed is the ID's).
+    const uint8_t level = static_cast<uint8_t>(64 + rng.next() % 192);
+    const uint8_t channel = static_cast<uint8_t>(rng.next() % 4);
+    profile.intensity[channel] = level / 4;
+    profile.bursts[channel].peakMin = level / 2;
+    profile.bursts[channel].peakMax = level;
+    d.anomaly = std::make_unique<asap::roles::AnomalyRole>(*d.radio, profile);
+    d.emitter = d.anomaly.get();
+  }
+  for (uint16_t i = 0; i < config_.artifacts; ++i)
+  {
+    Device& d = add(DeviceKind::Artifact, config_.fingerprintedArtifacts);
+    asap::roles::ArtifactConfig artifact{d.id, static_cast<uint16_t>(kArtifactSignatureBase + i)};
+    artifact.periodMs = config_.artifactPeriodMs;
+    if (config_.fingerprintedArtifacts)
+    {
+      artifact.hidden = config_.hiddenArtifacts;
+      artifact.hiddenPeriodMs = config_.artifactHiddenPeriodMs;
+      d.artifactEngine = std::make_unique<asap::roles::ArtifactEngine>(*d.radio, artifact);
+      continue;
+    }
+    d.artifact = std::make_unique<asap::roles::ArtifactRole>(*d.radio, artifact);
+    d.emitter = d.artifact.get();
+  }
+  for (uint16_t i = 0; i < config_.decoyArtifacts; ++i)
+  {
+    Device& d = add(DeviceKind::Artifact);
+    asap::roles::ArtifactConfig artifact{d.id, static_cast<uint16_t>(kArtifactSignatureBase + config_.artifacts + i)};
+    artifact.periodMs = config_.artifactPeriodMs;
+    d.artifact = std::make_unique<asap::roles::ArtifactRole>(*d.radio, artifact);
+    d.emitter = d.artifact.get();
+  }
+  for (uint16_t i = 0; i < config_.detectors; ++i)
+  {
+    Device& d = add(DeviceKind::Detector);
+    d.display = std::make_unique<asap::display::DetectorDisplay>(asap::display::DisplayPins{0, 0, 0});
+    d.display->begin();
+    d.detector = std::make_unique<asap::roles::DetectorRole>(*d.display, *d.radio);
+  }
+
+  nodes_ = static_cast<uint16_t>(devices_.size());
+  for (uint16_t i = 0; i < nodes_; ++i)
+  {
+    devices_[i]->x = rng.unit() * config_.areaM;
+    devices_[i]->y = rng.unit() * config_.areaM;
+  }
+  place();
+
+  for (std::unique_ptr<Device>& device : devices_)
+  {
+    Device& d = *device;
+    if (d.emitter)
+    {
+      d.chip->attach(*d.radio, &asap::roles::EmitterRole::onRadioIrq, d.emitter);
+      d.emitter->begin(*d.scheduler, d.mac.get());
+    }
+    else if (d.beaconEngine)
+    {
+      d.chip->attach(*d.radio);
+      d.beaconEngine->begin(*d.scheduler, d.mac.get());
+    }
+    else if (d.artifactEngine)
+    {
+      d.chip->attach(*d.radio);
+      d.artifactEngine->begin(*d.scheduler);
+    }
+    else
+    {
+      d.chip->attach(*d.radio, &asap::roles::DetectorRole::onRadioIrq, d.detector.get());
+      d.detector->begin(*d.scheduler);
+    }
+  }
+}
+
+World::~World() = default;
+
+// Link table, once positions are known.
+void World::place()
+{
+  links_.assign(static_cast<size_t>(nodes_) * nodes_, 0);
+  for (uint16_t rx = 0; rx < nodes_; ++rx)
+  {
+    for (uint16_t tx = 0; tx < nodes_; ++tx)
+    {
+      links_[rx * nodes_ + tx] = rx == tx ? 0 : config_.pathLoss.rssiDbm(distanceM(rx, tx), config_.seed, rx, tx);
+    }
+  }
+  medium_.setLinkModel(&linkModel, this);
+  // Detectors keep the UI's default tracking ID 0: each HUD follows the
+  // strongest beacon in its tracking table.
+}
+
+float World::distanceM(uint16_t a, uint16_t b) const
+{
+  const float dx = devices_[a]->x - devices_[b]->x;
+  const float dy = devices_[a]->y - devices_[b]->y;
+  return std::sqrt(dx * dx + dy * dy);
+}
+
+WorldReport World::run()
+{
+  WorldReport report;
+  report.seed = config_.seed;
+  report.devices = nodes_;
+
+  const auto t0 = std::chrono::steady_clock::now();
+  uint32_t nextSampleMs = 0;
+  for (;;)
+  {
+    for (std::unique_ptr<Device>& device : devices_)
+    {
+      device->scheduler->runDue();
+    }
+    const uint32_t nowMs = medium_.nowMs();
+    if (config_.hudSampleMs && !before(nowMs, nextSampleMs))
+    {
+      sampleHud(report, nowMs);
+      nextSampleMs += config_.hudSampleMs;
+    }
+    if (!before(nowMs, config_.durationMs))
+    {
+      break;
+    }
+
+    // Next event: a packet ending, a task deadline, a HUD sample or the end.
+    uint32_t nextMs = config_.durationMs;
+    if (config_.hudSampleMs && before(nextSampleMs, nextMs))
+    {
+      nextMs = nextSampleMs;
+    }
+    uint32_t at = 0;
+    if (medium_.nextEventMs(at) && before(at, nextMs))
+    {
+      nextMs = at;
+    }
+    for (std::unique_ptr<Device>& device : devices_)
+    {
+      // Deadlines are in the device's own millis().
+      if (device->scheduler->nextDeadline(at) && before(at = device->chip->mediumTimeOf(at), nextMs))
+      {
+        nextMs = before(at, nowMs) ? nowMs : at;
+      }
+    }
+    medium_.advance(nextMs - nowMs);
+  }
+  const auto t1 = std::chrono::steady_clock::now();
+
+  report.simulatedMs = medium_.nowMs();
+  report.wallMs = std::chrono::duration<double, std::milli>(t1 - t0).count();
+  report.transmissions = medium_.transmissions();
+  report.overlaps = medium_.collisions();
+  report.overlapped = medium_.overlapped();
+  uint64_t beaconUa = 0;
+  uint64_t beaconPpm = 0;
+  uint64_t beaconAirtime = 0;
+  uint64_t artifactUa = 0;
+  uint64_t artifactPpm = 0;
+  for (const std::unique_ptr<Device>& device : devices_)
+  {
+    const Device& d = *device;
+    if (d.beaconEngine)
+    {
+      const asap::power::PowerReport power = d.beaconEngine->power(d.chip->localNowMs());
+      ++report.emitters;
+      ++report.dutyBeacons;
+      report.deferred += d.beaconEngine->deferred();
+      if (d.mac)
+      {
+        report.txAirtimeMs += d.mac->txAirtimeMs();
+        report.syncedEmitters += d.mac->synced(d.chip->localNowMs()) ? 1 : 0;
+      }
+      beaconUa += power.averageUa();
+      beaconPpm += power.dutyCyclePpm();
+      beaconAirtime += power.airtimeMsPerHour();
+      continue;
+    }
+    if (d.artifactEngine)
+    {
+      const asap::power::PowerReport power = d.artifactEngine->power(d.chip->localNowMs());
+      ++report.emitters;
+      ++report.fingerprinted;
+      report.deferred += d.artifactEngine->deferred();
+      artifactUa += power.averageUa();
+      artifactPpm += power.dutyCyclePpm();
+      continue;
+    }
+    if (d.emitter)
+    {
+      ++report.emitters;
+      report.deferred += d.emitter->deferred();
+      if (d.mac)
+      {
+        report.txAirtimeMs += d.mac->txAirtimeMs();
+        report.syncedEmitters += d.mac->synced(d.chip->localNowMs()) ? 1 : 0;
+      }
+      continue;
+    }
+    const VirtualCc1101::LinkStats& link = d.chip->linkStats();
+    report.received += link.received;
+    report.collided += link.collided;
+    report.busy += link.busy;
+    report.outOfRange += link.outOfRange;
+    report.ringDrops += d.radio->rxDropped();
+    const asap::roles::DetectorRole::RxCounts& rx = d.detector->rxCounts();
+    report.decoded += rx.beacons + rx.anomalies + rx.artifacts + rx.configs + rx.syncs;
+  }
+  if (report.dutyBeacons)
+  {
+    report.beaconAverageUa = static_cast<uint32_t>(beaconUa / report.dutyBeacons);
+    report.beaconDutyPpm = static_cast<uint32_t>(beaconPpm / report.dutyBeacons);
+    report.beaconAirtimeMsPerHour = static_cast<uint32_t>(beaconAirtime / report.dutyBeacons);
+  }
+  if (report.fingerprinted)
+  {
+    report.artifactAverageUa = static_cast<uint32_t>(artifactUa / report.fingerprinted);
+    report.artifactDutyPpm = static_cast<uint32_t>(artifactPpm / report.fingerprinted);
+  }
+  scoreArtifacts(report);
+  return report;
+}
+
+// Ground truth for the correlators: a detector should recognize exactly the
+// fingerprinted artifacts it can hear. Decoys count only when fingerprinted
+// ones exist to confuse them with.
+void World::scoreArtifacts(WorldReport& report) const
+{
+  if (!config_.fingerprintedArtifacts)
+  {
+    return;
+  }
+  for (uint16_t rx = 0; rx < nodes_; ++rx)
+  {
+    const Device& d = *devices_[rx];
+    if (!d.detector)
+    {
+      continue;
+    }
+    const asap::game::ArtifactCorrelator& correlator = d.detector->artifacts();
+    report.correlatorMismatches += correlator.mismatches();
+    for (uint16_t tx = 0; tx < nodes_; ++tx)
+    {
+      const Device& a = *devices_[tx];
+      if (a.kind != DeviceKind::Artifact || linkRssiDbm(rx, tx) < config_.sensitivityDbm)
+      {
+        continue;
+      }
+      const asap::game::ArtifactTrack* track = correlator.find(a.id);
+      const bool recognized = track && track->recognized;
+      if (a.artifactEngine)
+      {
+        ++report.artifactPairs;
+        report.artifactsRecognized += recognized;
+        report.recognizeMsTotal += recognized ? track->recognizedMs - track->firstMs : 0;
+      }
+      else
+      {
+        ++report.decoyPairs;
+        report.decoysRecognized += recognized;
+      }
+    }
+  }
+}
+
+void World::sampleHud(WorldReport& report, uint32_t nowMs) const
+{
+  uint16_t index = 0;
+  for (const std::unique_ptr<Device>& device : devices_)
+  {
+    if (!device->detector)
+    {
+      continue;
+    }
+    asap::roles::DetectorRole& detector = *device->detector;
+    const asap::roles::DetectorRole::RxCounts& rx = detector.rxCounts();
+    report.hud.push_back(HudSample{nowMs, index++, detector.ui().trackedId(), detector.ui().trackingRssi(),
+                                   rx.beacons, rx.anomalies, rx.artifacts, detector.exposure().view()});
+  }
+}
+
+int16_t World::linkModel(void* context, uint16_t receiver, uint16_t sender)
+{
+  return static_cast<const World*>(context)->linkRssiDbm(receiver, sender);
+}
+
+uint32_t World::clockNow(void* context)
+{
+  return static_cast<const VirtualCc1101*>(context)->localNowMs();
+}
+
+// The world loop owns time; device schedulers never sleep on their own.
+void World::clockSleep(void*, uint32_t)
+{
+}
+
+// ---- WorldRunner ------------------------------------------------------------
+
+WorldRunner::WorldRunner(unsigned threads)
+    : threads_(threads ? threads : std::max(1u, std::thread::hardware_concurrency()))
+{
+}
+
+std::vector<WorldReport> WorldRunner::run(const std::vector<WorldConfig>& configs) const
+{
+  std::vector<WorldReport> reports(configs.size());
+  std::atomic<size_t> next{0};
+  auto worker = [&]() {
+    for (size_t i = next.fetch_add(1); i < configs.size(); i = next.fetch_add(1))
+    {
+      World world(configs[i]);
+      reports[i] = world.run();
+    }
+  };
+
+  const size_t workers = std::min<size_t>(threads_, configs.size());
+  if (workers <= 1)
+  {
+    worker();
+    return reports;
+  }
+  std::vector<std::thread> pool;
+  pool.reserve(workers - 1);
+  for (size_t t = 1; t < workers; ++t)
+  {
+    pool.emplace_back(worker);
+  }
+  worker();  // the calling thread takes a share too
+  for (std::thread& thread : pool)
+  {
+    thread.join();
+  }
+  return reports;
+}
+
+}  // namespace asap::sim
+
+#endif  // !ARDUINO
+//
+// World.cpp
+// Device order is fixed (beacons, anomalies, artifacts, detectors) and every
+// draw comes from the world seed, so a report depends on its config alone.
+//
@@ -0,0 +1,201 @@
+#pragma once
+
+#ifndef ARDUINO
+
+#include <stdint.h>
+#include <memory>
+#include <vector>
+
+#include <asap/game/ExposureEngine.h>
+#include <asap/radio/TdmaMac.h>
+#include <asap/radio/VirtualRadio.h>
+#include <asap/sim/PathLoss.h>
+
+namespace asap::sim
+{
+
+enum class DeviceKind : uint8_t
+{
+  Beacon,
+  Anomaly,
+  Artifact,
+  Detector,
+};
+
+// One simulated event: device counts, a square map they are scattered over,
+// the radio environment and how long to run. Everything random (positions,
+// shadowing, anomaly profiles, power-up times) derives from `seed`.
+struct WorldConfig
+{
+  uint64_t seed = 1;
+  uint16_t beacons = 12;  // IDs 1..beacons
+  uint16_t anomalies = 4;  // IDs follow the beacons, then the artifacts and decoys
+  uint16_t artifacts = 2;
+  uint16_t detectors = 8;
+  uint16_t beaconPeriodMs = 1000;
+  uint16_t anomalyPeriodMs = 500;
+  uint16_t artifactPeriodMs = 5000;
+  // Emitters share the channel through asap::radio::TdmaMac (beacon 1 is
+  // the sync source) instead of free-running periods.
+  bool tdma = false;
+  asap::radio::SuperframeConfig superframe;
+  // Beacons run the battery image (asap::roles::BeaconEngine), as the
+  // beacon boards do: bursts on a jittered schedule, radio asleep in
+  // between. With tdma the engine runs slotted, beacon 1 still the sync
+  // source.
+  bool dutyCycledBeacons = false;
+  // Artifacts run the fingerprinted image (asap::roles::ArtifactEngine),
+  // unslotted, one cycle per artifactPeriodMs (or hidden: one per
+  // artifactHiddenPeriodMs). decoyArtifacts more run ArtifactRole, whose
+  // pings carry the same fields without the timing, with IDs after the
+  // artifacts'. Detectors must recognize the first kind only.
+  bool fingerprintedArtifacts = false;
+  bool hiddenArtifacts = false;
+  uint32_t artifactHiddenPeriodMs = 120000;
+  uint16_t decoyArtifacts = 0;
+  float areaM = 150.0f;  // side of the square map
+  uint16_t clockDriftPpm = 40;  // each device's millis() runs up to this fast or slow
+  uint32_t durationMs = 10UL * 60UL * 1000UL;
+  uint32_t hudSampleMs = 1000;  // detector HUD timeline resolution (0 = off)
+  PathLoss pathLoss;
+  int16_t sensitivityDbm = asap::radio::VirtualMedium::kDefaultSensitivityDbm;
+};
+
+// What detector `detector` shows at timeMs, plus its decode counters.
+struct HudSample
+{
+  uint32_t timeMs;
+  uint16_t detector;
+  uint16_t trackingId;      // beacon on the tracking HUD (strongest tracked)
+  int16_t trackingRssiDbm;  // tracking HUD value (-100 = nothing heard yet)
+  uint32_t beacons;
+  uint32_t anomalies;
+  uint32_t artifacts;
+  asap::game::ExposureView exposure;  // anomaly HUD rings and stages
+};
+
+struct WorldReport
+{
+  uint64_t seed = 0;
+  uint16_t devices = 0;
+  uint32_t simulatedMs = 0;
+  double wallMs = 0.0;
+
+  // Channel
+  uint32_t transmissions = 0;
+  uint32_t overlaps = 0;    // transmissions that started on a busy channel
+  uint32_t overlapped = 0;  // transmissions that shared air time with another
+  uint32_t deferred = 0;    // emitter packets skipped (TX queue full, slot missed)
+  uint64_t txAirtimeMs = 0;  // TDMA: emitter airtime as accounted by the MACs
+  uint16_t emitters = 0;
+  uint16_t syncedEmitters = 0;  // TDMA: following the sync source at the end
+
+  // Duty-cycled beacons, mean per beacon (asap::power::PowerReport)
+  uint16_t dutyBeacons = 0;
+  uint32_t beaconAverageUa = 0;
+  uint32_t beaconDutyPpm = 0;
+  uint32_t beaconAirtimeMsPerHour = 0;
+
+  // Fingerprinted artifacts: recognition over (detector, artifact) pairs
+  // whose link is above sensitivity, and mean power per artifact
+  uint16_t fingerprinted = 0;
+  uint32_t artifactPairs = 0;
+  uint32_t artifactsRecognized = 0;
+  uint32_t decoyPairs = 0;
+  uint32_t decoysRecognized = 0;  // false positives
+  uint64_t recognizeMsTotal = 0;  // first ping heard to recognition, summed
+  uint64_t correlatorMismatches = 0;
+  uint32_t artifactAverageUa = 0;
+  uint32_t artifactDutyPpm = 0;
+
+  // Packets above sensitivity at detectors, by fate
+  uint64_t received = 0;
+  uint64_t collided = 0;
+  uint64_t busy = 0;
+  uint64_t outOfRange = 0;  // below sensitivity (not part of the ratios)
+  uint64_t decoded = 0;     // valid packets decoded by DetectorRole
+  uint64_t ringDrops = 0;   // PacketRing full
+
+  std::vector<HudSample> hud;
+
+  uint64_t inRange() const { return received + collided + busy; }
+  double deliveryRatio() const { return inRange() ? static_cast<double>(decoded) / inRange() : 1.0; }
+  double collisionRate() const { return inRange() ? static_cast<double>(collided) / inRange() : 0.0; }
+  // Chance that a packet overlaps another one anywhere on the map.
+  double collisionProbability() const
+  {
+    return transmissions ? static_cast<double>(overlapped) / transmissions : 0.0;
+  }
+  double falseNegativeRate() const
+  {
+    return artifactPairs ? 1.0 - static_cast<double>(artifactsRecognized) / artifactPairs : 0.0;
+  }
+  double falsePositiveRate() const
+  {
+    return decoyPairs ? static_cast<double>(decoysRecognized) / decoyPairs : 0.0;
+  }
+  double meanRecognizeMs() const
+  {
+    return artifactsRecognized ? static_cast<double>(recognizeMsTotal) / artifactsRecognized : 0.0;
+  }
+  double speedup() const { return wallMs > 0.0 ? simulatedMs / wallMs : 0.0; }
+};
+
+// N devices of each role running their firmware role logic (asap_roles) on
+// virtual CC1101s that share one VirtualMedium. Event driven: time jumps to
+// the next scheduler deadline or packet end, so a quiet minute costs nothing.
+class World
+{
+ public:
+  explicit World(const WorldConfig& config);
+  ~World();
+  World(const World&) = delete;
+  World& operator=(const World&) = delete;
+
+  WorldReport run();
+
+  float distanceM(uint16_t a, uint16_t b) const;
+  int16_t linkRssiDbm(uint16_t receiver, uint16_t sender) const { return links_[receiver * nodes_ + sender]; }
+
+ private:
+  struct Device;
+
+  static int16_t linkModel(void* context, uint16_t receiver, uint16_t sender);
+  static uint32_t clockNow(void* context);  // context: the device's VirtualCc1101
+  static void clockSleep(void* context, uint32_t deadlineMs);
+
+  void place();
+  void sampleHud(WorldReport& report, uint32_t nowMs) const;
+  void scoreArtifacts(WorldReport& report) const;
+
+  WorldConfig config_;
+  asap::radio::VirtualMedium medium_;
+  std::vector<std::unique_ptr<Device>> devices_;  // index == medium node
+  std::vector<int16_t> links_;                    // [receiver * nodes_ + sender]
+  uint16_t nodes_ = 0;
+};
+
+// Runs independent worlds (seeds, device counts, channel plans) on a pool of
+// worker threads. Each world owns all of its state, so reports are identical
+// for any thread count and come back in input order.
+class WorldRunner
+{
+ public:
+  explicit WorldRunner(unsigned threads = 0);  // 0 = hardware concurrency
+
+  unsigned threads() const { return threads_; }
+
+  std::vector<WorldReport> run(const std::vector<WorldConfig>& configs) const;
+
+ private:
+  unsigned threads_;
+};
+
+}  // namespace asap::sim
+
+#endif  // !ARDUINO
+//
+// World.h
+// Sizing tool for events: how many emitters a channel carries before
+// detectors stop hearing them, and what players would see meanwhile.
+//
@@ -0,0 +1,265 @@
+#ifndef ARDUINO
+
+#include <asap/snapshot/SnapshotComparator.h>
+
+#include <asap/display/PackedFrame.h>
+
+#include <cstdio>   // std::snprintf for hashes and messages
+#include <cstdlib>  // std::getenv, std::strtoull
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+namespace asap::snapshot
+{
+
+namespace
+{
+using ::asap::display::kPackedFrameBytes;
+using ::asap::display::kPackedRowBytes;
+
+constexpr uint16_t kWidth = kPackedRowBytes * 8U;
+constexpr uint16_t kHeight = kPackedFrameBytes / kPackedRowBytes;
+constexpr uint32_t kPixels = static_cast<uint32_t>(kWidth) * kHeight;
+
+constexpr uint64_t kFnvOffset = 1469598103934665603ULL;
+constexpr uint64_t kFnvPrime = 1099511628211ULL;
+
+// Diff image levels (MaxVal 15).
+constexpr uint8_t kDiffChanged = 15;
+constexpr uint8_t kDiffContext = 3;
+
+bool writePgm(const std::filesystem::path& path, const uint8_t* pixels)
+{
+  std::error_code ec;
+  std::filesystem::create_directories(path.parent_path(), ec);
+  std::ofstream out(path, std::ios::binary);
+  if (!out)
+  {
+    return false;
+  }
+  out << "P5\n" << kWidth << " " << kHeight << "\n15\n";
+  out.write(reinterpret_cast<const char*>(pixels), kPixels);
+  return static_cast<bool>(out);
+}
+
+bool writePackedPgm(const std::filesystem::path& path, const uint8_t* packed)
+{
+  std::vector<uint8_t> pixels(kPixels);
+  ::asap::display::expandPackedFrame(packed, 15, pixels.data());
+  return writePgm(path, pixels.data());
+}
+
+// Read one of our own PGMs (P5 256x64) back as a packed frame, any non-zero
+// sample counting as lit.
+bool readPackedPgm(const std::filesystem::path& path, uint8_t* packed)
+{
+  std::ifstream in(path, std::ios::binary);
+  std::string magic;
+  int width = 0;
+  int height = 0;
+  int maxVal = 0;
+  if (!(in >> magic >> width >> height >> maxVal) || magic != "P5" ||
+      width != kWidth || height != kHeight || maxVal <= 0 || maxVal > 255)
+  {
+    return false;
+  }
+  in.get();  // single whitespace before the raster
+  std::vector<char> pixels(kPixels);
+  if (!in.read(pixels.data(), static_cast<std::streamsize>(pixels.size())))
+  {
+    return false;
+  }
+  for (uint32_t i = 0; i < kPackedFrameBytes; ++i)
+  {
+    uint8_t byte = 0;
+    for (uint8_t bit = 0; bit < 8; ++bit)
+    {
+      if (pixels[i * 8U + bit] != 0)
+      {
+        byte = static_cast<uint8_t>(byte | (0x80U >> bit));
+      }
+    }
+    packed[i] = byte;
+  }
+  return true;
+}
+
+std::string hex64(uint64_t value)
+{
+  char text[17];
+  std::snprintf(text, sizeof(text), "%016llx", static_cast<unsigned long long>(value));
+  return text;
+}
+
+std::string diffName(const std::string& name)
+{
+  const std::filesystem::path p(name);
+  return p.stem().string() + ".diff.pgm";
+}
+}  // namespace
+
+uint64_t hashPackedFrame(const uint8_t* packed)
+{
+  uint64_t hash = kFnvOffset;
+  if (!packed)
+  {
+    return hash;
+  }
+  for (uint16_t i = 0; i < kPackedFrameBytes; ++i)
+  {
+    hash ^= packed[i];
+    hash *= kFnvPrime;
+  }
+  return hash;
+}
+
+SnapshotComparator::SnapshotComparator(std::filesystem::path dir, bool update)
+    : dir_(std::move(dir)),
+      update_(update)
+{
+  loadManifest();
+}
+
+bool SnapshotComparator::updateRequested()
+{
+  const char* value = std::getenv("ASAP_SNAPSHOT_UPDATE");
+  return value && value[0] != '\0' && value[0] != '0';
+}
+
+void SnapshotComparator::loadManifest()
+{
+  std::ifstream in(manifestPath());
+  std::string line;
+  while (std::getline(in, line))
+  {
+    if (line.empty() || line[0] == '#')
+    {
+      continue;
+    }
+    std::istringstream fields(line);
+    std::string name;
+    std::string hash;
+    if (fields >> name >> hash)
+    {
+      golden_[name] = std::strtoull(hash.c_str(), nullptr, 16);
+    }
+  }
+}
+
+SnapshotResult SnapshotComparator::check(const std::string& name, const uint8_t* tileBuffer)
+{
+  SnapshotResult result;
+  if (!tileBuffer || name.empty())
+  {
+    return result;
+  }
+  uint8_t packed[kPackedFrameBytes];
+  ::asap::display::packFrameRowMajor(tileBuffer, packed);
+  result.hash = hashPackedFrame(packed);
+
+  const std::filesystem::path goldenPath = dir_ / name;
+  const auto entry = golden_.find(name);
+  if (entry != golden_.end())
+  {
+    result.golden = entry->second;
+  }
+
+  if (entry != golden_.end() && entry->second == result.hash)
+  {
+    result.status = SnapshotStatus::Match;
+    std::error_code ec;
+    if (!std::filesystem::exists(goldenPath, ec))
+    {
+      result.wroteImage = writePackedPgm(goldenPath, packed);
+    }
+    return result;
+  }
+
+  if (update_)
+  {
+    result.status = SnapshotStatus::Updated;
+    result.wroteImage = writePackedPgm(goldenPath, packed);
+    golden_[name] = result.hash;
+    dirty_ = true;
+    return result;
+  }
+
+  result.status = (entry == golden_.end()) ? SnapshotStatus::Missing : SnapshotStatus::Mismatch;
+  result.wroteImage = writePackedPgm(diffDir() / name, packed);
+
+  uint8_t reference[kPackedFrameBytes];
+  if (readPackedPgm(goldenPath, reference))
+  {
+    std::vector<uint8_t> diff(kPixels);
+    for (uint32_t i = 0; i < kPixels; ++i)
+    {
+      const uint8_t mask = static_cast<uint8_t>(0x80U >> (i % 8U));
+      const bool actual = (packed[i / 8U] & mask) != 0;
+      const bool expected = (reference[i / 8U] & mask) != 0;
+      if (actual != expected)
+      {
+        diff[i] = kDiffChanged;
+        ++result.diffPixels;
+      }
+      else
+      {
+        diff[i] = actual ? kDiffContext : 0;
+      }
+    }
+    writePgm(diffDir() / diffName(name), diff.data());
+  }
+  return result;
+}
+
+bool SnapshotComparator::saveManifest()
+{
+  if (!dirty_)
+  {
+    return true;
+  }
+  std::ofstream out(manifestPath(), std::ios::trunc);
+  if (!out)
+  {
+    return false;
+  }
+  out << "# Golden snapshot hashes: FNV-1a 64 of the packed 1 bpp frame (row-major, lit = 1).\n";
+  out << "# Regenerate with ASAP_SNAPSHOT_UPDATE=1 pio test -e native\n";
+  for (const auto& entry : golden_)
+  {
+    out << entry.first << ' ' << hex64(entry.second) << '\n';
+  }
+  dirty_ = !out;
+  return static_cast<bool>(out);
+}
+
+std::string describe(const std::string& name, const SnapshotResult& result)
+{
+  std::string text = name;
+  switch (result.status)
+  {
+    case SnapshotStatus::Match:
+      text += ": matches golden";
+      break;
+    case SnapshotStatus::Updated:
+      text += ": golden updated to " + hex64(result.hash);
+      break;
+    case SnapshotStatus::Missing:
+      text += ": no golden hash (run with ASAP_SNAPSHOT_UPDATE=1), actual in snapshots/_diff";
+      break;
+    case SnapshotStatus::Mismatch:
+      text += ": hash " + hex64(result.hash) + " != golden " + hex64(result.golden) + ", " +
+              std::to_string(result.diffPixels) + " px differ, see snapshots/_diff";
+      break;
+  }
+  return text;
+}
+
+}  // namespace asap::snapshot
+
+#endif  // ARDUINO
+//
+// SnapshotComparator.cpp
+// Hash-first golden comparison. The golden PGM is only read back on a
+// mismatch, to build the diff image; the pass path never touches the disk.
+//
@@ -0,0 +1,91 @@
+#pragma once
+
+#ifndef ARDUINO
+
+#include <stdint.h>
+#include <filesystem>
+#include <map>
+#include <string>
+
+namespace asap::snapshot
+{
+
+// FNV-1a 64 over a packed row-major 1 bpp frame
+// (asap::display::kPackedFrameBytes, lit = 1). Independent of the image file
+// format, so P5 and P4 exports of the same frame hash alike.
+uint64_t hashPackedFrame(const uint8_t* packed);
+
+enum class SnapshotStatus : uint8_t
+{
+  Match,     // hash equals the golden one; nothing written
+  Mismatch,  // differs from the golden; actual + diff image written
+  Missing,   // no golden entry yet
+  Updated,   // update mode: golden image and manifest entry replaced
+};
+
+struct SnapshotResult
+{
+  SnapshotStatus status = SnapshotStatus::Missing;
+  uint64_t hash = 0;
+  uint64_t golden = 0;      // 0 when there is no manifest entry
+  uint32_t diffPixels = 0;  // Mismatch: pixels differing from the golden image
+  bool wroteImage = false;
+
+  bool ok() const
+  {
+    return status == SnapshotStatus::Match || status == SnapshotStatus::Updated;
+  }
+};
+
+// Compares rendered frames against golden hashes kept in
+// `<dir>/manifest.txt`. Images are only touched when something changed:
+//  - match: no disk I/O (the golden PGM is written only if it is absent);
+//  - mismatch: `<dir>/_diff/<name>` (actual) and `<stem>.diff.pgm` (changed
+//    pixels bright, unchanged lit pixels dim) are written for review;
+//  - update mode (ASAP_SNAPSHOT_UPDATE=1): golden PGM and manifest entry are
+//    replaced, and saveManifest() rewrites the manifest.
+class SnapshotComparator
+{
+ public:
+  explicit SnapshotComparator(std::filesystem::path dir, bool update = updateRequested());
+
+  static bool updateRequested();
+
+  // `tileBuffer` is a U8g2 full frame (asap::display::kTileBufferBytes).
+  SnapshotResult check(const std::string& name, const uint8_t* tileBuffer);
+
+  // Write the manifest back if update mode changed it. Returns false on I/O
+  // errors only.
+  bool saveManifest();
+
+  bool updating() const { return update_; }
+  std::filesystem::path manifestPath() const { return dir_ / "manifest.txt"; }
+  std::filesystem::path diffDir() const { return dir_ / "_diff"; }
+  size_t goldenCount() const { return golden_.size(); }
+
+ private:
+  void loadManifest();
+
+  std::filesystem::path dir_;
+  bool update_;
+  bool dirty_ = false;
+  std::map<std::string, uint64_t> golden_;
+};
+
+// Human-readable one-liner for test failure messages.
+std::string describe(const std::string& name, const SnapshotResult& result);
+
+}  // namespace asap::snapshot
+
+#endif  // ARDUINO
+//
+// SnapshotComparator.h
+// Golden-image checks for the native snapshot suite. Rendering a state and
+// hashing its 2 KB packed frame is far cheaper than writing and re-reading a
+// 16 KB PGM, so hundreds of UI states can be checked on every test run; the
+// PGMs stay in the repo for humans and for diff images.
+//
+// Notes for maintainers
+// - Regenerate goldens with `ASAP_SNAPSHOT_UPDATE=1 pio test -e native` and
+//   review the PGM changes like any other diff.
+// - The manifest is plain text ("name hash"), sorted, one line per image.
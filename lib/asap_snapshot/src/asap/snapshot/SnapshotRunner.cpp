@@ -0,0 +1,118 @@
+#ifndef ARDUINO
+
+#include <asap/snapshot/SnapshotRunner.h>
+
+#include <asap/display/NativeDisplay.h>
+#include <asap/display/PackedFrame.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>  // std::memcpy of captured frames
+#include <thread>
+
+namespace asap::snapshot
+{
+
+namespace
+{
+constexpr asap::display::DisplayPins kNoPins{0, 0, 0};
+}  // namespace
+
+SnapshotRunner::SnapshotRunner(unsigned threads)
+    : threads_(threads ? threads : std::max(1u, std::thread::hardware_concurrency()))
+{
+}
+
+CaseOutput SnapshotRunner::renderCase(const SnapshotCase& snapshotCase)
+{
+  CaseOutput output;
+  output.name = snapshotCase.name;
+
+  asap::display::NativeDisplay display(kNoPins);
+  if (!display.begin())
+  {
+    return output;
+  }
+  asap::ui::UIController ui(display);
+  if (snapshotCase.setup)
+  {
+    snapshotCase.setup(ui);
+  }
+  for (const UiStep& step : snapshotCase.steps)
+  {
+    if (step.before)
+    {
+      step.before(ui);
+    }
+    ui.onTick(step.nowMs, step.input);
+    if (step.snapshot.empty())
+    {
+      continue;
+    }
+    CapturedFrame captured;
+    captured.name = step.snapshot;
+    std::memcpy(captured.frame.data(), display.frameBuffer(), captured.frame.size());
+    uint8_t packed[asap::display::kPackedFrameBytes];
+    asap::display::packFrameRowMajor(captured.frame.data(), packed);
+    captured.hash = hashPackedFrame(packed);
+    captured.kind = display.lastFrameKind();
+    captured.cost = display.lastFrameCost();
+    captured.pages = display.pagesPerFrame();
+    output.frames.push_back(std::move(captured));
+  }
+  return output;
+}
+
+std::vector<CaseOutput> SnapshotRunner::render(const std::vector<SnapshotCase>& cases) const
+{
+  std::vector<CaseOutput> outputs(cases.size());
+  std::atomic<size_t> next{0};
+  auto worker = [&]() {
+    for (size_t i = next.fetch_add(1); i < cases.size(); i = next.fetch_add(1))
+    {
+      outputs[i] = renderCase(cases[i]);
+    }
+  };
+
+  const size_t workers = std::min<size_t>(threads_, cases.size());
+  if (workers <= 1)
+  {
+    worker();
+    return outputs;
+  }
+  std::vector<std::thread> pool;
+  pool.reserve(workers - 1);
+  for (size_t t = 1; t < workers; ++t)
+  {
+    pool.emplace_back(worker);
+  }
+  worker();  // the calling thread takes a share too
+  for (std::thread& thread : pool)
+  {
+    thread.join();
+  }
+  return outputs;
+}
+
+std::vector<std::pair<std::string, SnapshotResult>> SnapshotRunner::compare(
+    const std::vector<CaseOutput>& outputs, SnapshotComparator& comparator)
+{
+  std::vector<std::pair<std::string, SnapshotResult>> results;
+  for (const CaseOutput& output : outputs)
+  {
+    for (const CapturedFrame& captured : output.frames)
+    {
+      results.emplace_back(captured.name, comparator.check(captured.name, captured.frame.data()));
+    }
+  }
+  return results;
+}
+
+}  // namespace asap::snapshot
+
+#endif  // ARDUINO
+//
+// SnapshotRunner.cpp
+// Work distribution is a shared atomic cursor: cases vary a lot in length
+// (one tick vs. a full menu walk), so pulling work beats static partitioning.
+//
@@ -0,0 +1,94 @@
+#pragma once
+
+#ifndef ARDUINO
+
+#include <stdint.h>
+#include <array>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <asap/display/DirtyTiles.h>
+#include <asap/display/DrawCost.h>
+#include <asap/snapshot/SnapshotComparator.h>
+#include <asap/ui/UIController.h>
+
+namespace asap::snapshot
+{
+
+// One UI tick of a scripted case. `before` may feed external signals
+// (exposure, RSSI, ...) right before the tick; `snapshot` names the frame to
+// capture after it (empty = no capture). Names are golden keys, so they must
+// be unique across every case compared against the same manifest.
+struct UiStep
+{
+  using Hook = std::function<void(asap::ui::UIController&)>;
+
+  uint32_t nowMs;
+  asap::ui::InputSample input;
+  std::string snapshot = {};
+  Hook before = {};
+};
+
+// Independent scripted session: a fresh NativeDisplay + UIController, an
+// optional setup hook, then the steps in order.
+struct SnapshotCase
+{
+  std::string name;
+  UiStep::Hook setup;
+  std::vector<UiStep> steps;
+};
+
+struct CapturedFrame
+{
+  std::string name;
+  uint64_t hash;  // hashPackedFrame() of the frame
+  std::array<uint8_t, asap::display::kTileBufferBytes> frame;
+  // Draw cost of the last render before the capture (see DrawCost.h).
+  asap::display::FrameKind kind = asap::display::FrameKind::None;
+  asap::display::DrawCost cost{};
+  uint8_t pages = 1;
+};
+
+// Frames captured by one case, in step order.
+struct CaseOutput
+{
+  std::string name;
+  std::vector<CapturedFrame> frames;
+};
+
+// Renders snapshot cases on a pool of worker threads. Cases share nothing (each
+// gets its own display, U8g2 buffer and controller), so workers just pull the
+// next case index; results are stored by index, so the output order is the
+// input order whatever the thread count.
+class SnapshotRunner
+{
+ public:
+  explicit SnapshotRunner(unsigned threads = 0);  // 0 = hardware concurrency
+
+  unsigned threads() const { return threads_; }
+
+  std::vector<CaseOutput> render(const std::vector<SnapshotCase>& cases) const;
+
+  // Check every captured frame against the goldens, case by case and step by
+  // step, on the calling thread (the comparator is not thread-safe).
+  static std::vector<std::pair<std::string, SnapshotResult>> compare(
+      const std::vector<CaseOutput>& outputs, SnapshotComparator& comparator);
+
+ private:
+  static CaseOutput renderCase(const SnapshotCase& snapshotCase);
+
+  unsigned threads_;
+};
+
+}  // namespace asap::snapshot
+
+#endif  // ARDUINO
+//
+// SnapshotRunner.h
+// Parallel front end for the golden snapshot suite. Test code declares cases
+// as data (input script -> snapshot names); the runner renders them on all
+// cores and hands the frames back for comparison in a fixed order, so reports
+// and golden updates are identical to a serial run.
+//
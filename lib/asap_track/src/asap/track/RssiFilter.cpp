@@ -0,0 +1,128 @@
+#include <asap/track/RssiFilter.h>
+
+namespace asap::track
+{
+
+namespace
+{
+// Round-to-nearest division of a signed value by a positive one.
+inline int32_t divRound(int32_t num, int32_t den)
+{
+  return (num >= 0 ? num + den / 2 : num - den / 2) / den;
+}
+
+// Insertion sort; windows are a handful of samples.
+void sortSmall(int16_t* v, uint8_t n)
+{
+  for (uint8_t i = 1; i < n; ++i)
+  {
+    const int16_t x = v[i];
+    uint8_t j = i;
+    while (j > 0 && v[j - 1] > x)
+    {
+      v[j] = v[j - 1];
+      --j;
+    }
+    v[j] = x;
+  }
+}
+
+int16_t middleQ4(int16_t* sortedQ4, uint8_t n)
+{
+  if (n == 0)
+  {
+    return 0;
+  }
+  return (n & 1) ? sortedQ4[n / 2] : static_cast<int16_t>(divRound(sortedQ4[n / 2 - 1] + sortedQ4[n / 2], 2));
+}
+}  // namespace
+
+const char* filterName(FilterKind kind)
+{
+  switch (kind)
+  {
+    case FilterKind::Ema:
+      return "ema";
+    case FilterKind::Median:
+      return "median";
+    case FilterKind::Hampel:
+      return "hampel";
+    case FilterKind::Kalman:
+      return "kalman";
+  }
+  return "?";
+}
+
+int16_t EmaFilter::feedQ4(int16_t sampleQ4, const FilterConfig& config)
+{
+  if (!primed)
+  {
+    primed = true;
+    yQ4 = sampleQ4;
+  }
+  else
+  {
+    yQ4 = static_cast<int16_t>(yQ4 + divRound(config.emaAlphaQ8 * (sampleQ4 - yQ4), 256));
+  }
+  return yQ4;
+}
+
+// Scalar Kalman filter on a random walk. The gain is kept in Q15, the
+// variance in dB^2 * 16, so a near-steady-state gain of a few percent still
+// has three significant digits.
+int16_t KalmanFilter::feed(int16_t sampleDbm, const FilterConfig& config)
+{
+  const int32_t zQ4 = 16 * static_cast<int32_t>(sampleDbm);
+  if (p == 0)
+  {
+    xQ4 = static_cast<int16_t>(zQ4);
+    p = config.kalmanR > 0 ? config.kalmanR : 1;
+    return xQ4;
+  }
+  const uint32_t predicted = static_cast<uint32_t>(p) + config.kalmanQ;
+  const uint32_t gainQ15 = (predicted << 15) / (predicted + config.kalmanR);
+  xQ4 = static_cast<int16_t>(xQ4 + divRound(static_cast<int32_t>(gainQ15) * (zQ4 - xQ4), 32768));
+  const uint32_t updated = predicted - ((predicted * gainQ15) >> 15);
+  p = static_cast<uint16_t>(updated == 0 ? 1 : (updated > 0xFFFF ? 0xFFFF : updated));
+  return xQ4;
+}
+
+namespace detail
+{
+
+int8_t clampDbm(int16_t dBm)
+{
+  return static_cast<int8_t>(dBm < -128 ? -128 : (dBm > 127 ? 127 : dBm));
+}
+
+int16_t medianQ4(const int8_t* samples, uint8_t n)
+{
+  int16_t v[32];
+  for (uint8_t i = 0; i < n; ++i)
+  {
+    v[i] = static_cast<int16_t>(16 * samples[i]);
+  }
+  sortSmall(v, n);
+  return middleQ4(v, n);
+}
+
+int16_t madQ4(const int8_t* samples, uint8_t n, int16_t medQ4)
+{
+  int16_t v[32];
+  for (uint8_t i = 0; i < n; ++i)
+  {
+    const int16_t d = static_cast<int16_t>(16 * samples[i] - medQ4);
+    v[i] = d < 0 ? static_cast<int16_t>(-d) : d;
+  }
+  sortSmall(v, n);
+  return middleQ4(v, n);
+}
+
+}  // namespace detail
+
+}  // namespace asap::track
+//
+// RssiFilter.cpp
+// The window helpers live here rather than in the templates so each window
+// size only instantiates the ring itself.
+//
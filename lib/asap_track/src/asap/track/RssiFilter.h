@@ -0,0 +1,208 @@
+#pragma once
+
+#include <stdint.h>
+
+// Samples kept by the median and Hampel filters of each tracked emitter, one
+// byte each (override with -D in platformio.ini). Odd, so the median is a
+// sample.
+#ifndef ASAP_TRACK_FILTER_WINDOW
+#define ASAP_TRACK_FILTER_WINDOW 5
+#endif
+
+namespace asap::track
+{
+
+// RSSI smoothing filters. Input is one sample in dBm, output the filtered
+// level in 1/16 dB (Q4). Everything is integer arithmetic on fixed-size
+// state; nothing allocates. The first sample after a reset is passed
+// through.
+enum class FilterKind : uint8_t
+{
+  Ema,     // exponential moving average, alpha = emaAlphaQ8 / 256
+  Median,  // median of the last N samples
+  Hampel,  // samples further than hampelK sigma (from the MAD) from the
+           // window median are replaced by it, then EMA
+  Kalman,  // 1-D random walk: process noise kalmanQ, measurement noise kalmanR
+};
+
+constexpr uint8_t kFilterKindCount = 4;
+
+const char* filterName(FilterKind kind);
+
+// Tuning shared by every emitter that uses a filter. Defaults: the UI's old
+// alpha of 1/4; a Hampel gate of 3 sigma but never under 3 dB; a Kalman
+// filter that trusts a sample to about 4 dB and lets the level wander by
+// 0.5 dB per sample.
+struct FilterConfig
+{
+  uint8_t emaAlphaQ8 = 64;
+  uint8_t hampelK = 3;
+  uint8_t hampelFloorDb = 3;
+  uint16_t kalmanQ = 4;    // dB^2 * 16 per sample
+  uint16_t kalmanR = 256;  // dB^2 * 16
+};
+
+struct EmaFilter
+{
+  int16_t yQ4;
+  bool primed;
+
+  int16_t feedQ4(int16_t sampleQ4, const FilterConfig& config);
+};
+
+struct KalmanFilter
+{
+  int16_t xQ4;
+  uint16_t p;  // estimate variance, dB^2 * 16; 0 until primed
+  int16_t feed(int16_t sampleDbm, const FilterConfig& config);
+};
+
+namespace detail
+{
+// Median (Q4) of n samples, and the median absolute deviation from medQ4
+// (Q4). n <= 32.
+int16_t medianQ4(const int8_t* samples, uint8_t n);
+int16_t madQ4(const int8_t* samples, uint8_t n, int16_t medQ4);
+int8_t clampDbm(int16_t dBm);
+}  // namespace detail
+
+// Ring of the last N samples, one byte each (RSSI fits -128..127 dBm).
+template <uint8_t N>
+struct SampleWindow
+{
+  static_assert(N >= 1 && N <= 32, "filter window must be 1..32 samples");
+
+  int8_t samples[N];
+  uint8_t head;
+  uint8_t count;
+
+  void push(int16_t dBm)
+  {
+    samples[head] = detail::clampDbm(dBm);
+    head = static_cast<uint8_t>((head + 1) % N);
+    if (count < N)
+    {
+      ++count;
+    }
+  }
+  // Order does not matter to the median; while filling, the valid samples
+  // are [0, count).
+  int16_t medianQ4() const { return detail::medianQ4(samples, count); }
+};
+
+template <uint8_t N>
+struct MedianFilter
+{
+  SampleWindow<N> window;
+
+  int16_t feed(int16_t sampleDbm, const FilterConfig&)
+  {
+    window.push(sampleDbm);
+    return window.medianQ4();
+  }
+};
+
+template <uint8_t N>
+struct HampelFilter
+{
+  SampleWindow<N> window;
+  EmaFilter ema;
+  uint16_t rejected;  // samples replaced by the median (saturating)
+
+  int16_t feed(int16_t sampleDbm, const FilterConfig& config)
+  {
+    window.push(sampleDbm);
+    const int16_t medQ4 = window.medianQ4();
+    const int32_t madQ4 = detail::madQ4(window.samples, window.count, medQ4);
+    // sigma ~ 1.4826 * MAD
+    int32_t gateQ4 = config.hampelK * madQ4 * 1518 / 1024;
+    if (gateQ4 < 16 * config.hampelFloorDb)
+    {
+      gateQ4 = 16 * config.hampelFloorDb;
+    }
+    int32_t sampleQ4 = 16 * static_cast<int32_t>(sampleDbm);
+    if (sampleQ4 - medQ4 > gateQ4 || medQ4 - sampleQ4 > gateQ4)
+    {
+      sampleQ4 = medQ4;
+      if (rejected != 0xFFFF)
+      {
+        ++rejected;
+      }
+    }
+    return ema.feedQ4(static_cast<int16_t>(sampleQ4), config);
+  }
+};
+
+// One emitter's filter, selectable at runtime: a tag and the state of the
+// selected filter in a union, so every kind costs the size of the largest.
+template <uint8_t N>
+class RssiFilter
+{
+ public:
+  RssiFilter() { reset(FilterKind::Ema); }
+
+  // Select a filter and drop the history.
+  void reset(FilterKind kind)
+  {
+    kind_ = kind;
+    switch (kind)
+    {
+      case FilterKind::Median:
+        state_.median = MedianFilter<N>{};
+        break;
+      case FilterKind::Hampel:
+        state_.hampel = HampelFilter<N>{};
+        break;
+      case FilterKind::Kalman:
+        state_.kalman = KalmanFilter{};
+        break;
+      case FilterKind::Ema:
+      default:
+        kind_ = FilterKind::Ema;
+        state_.ema = EmaFilter{};
+        break;
+    }
+  }
+
+  // Filtered level (Q4) after this sample (dBm).
+  int16_t feed(int16_t sampleDbm, const FilterConfig& config)
+  {
+    switch (kind_)
+    {
+      case FilterKind::Median:
+        return state_.median.feed(sampleDbm, config);
+      case FilterKind::Hampel:
+        return state_.hampel.feed(sampleDbm, config);
+      case FilterKind::Kalman:
+        return state_.kalman.feed(sampleDbm, config);
+      case FilterKind::Ema:
+      default:
+        return state_.ema.feedQ4(static_cast<int16_t>(16 * sampleDbm), config);
+    }
+  }
+
+  FilterKind kind() const { return kind_; }
+  // Outliers the Hampel filter replaced since the last reset (0 otherwise).
+  uint16_t rejected() const { return kind_ == FilterKind::Hampel ? state_.hampel.rejected : 0; }
+
+ private:
+  FilterKind kind_;
+  union State
+  {
+    EmaFilter ema;
+    MedianFilter<N> median;
+    HampelFilter<N> hampel;
+    KalmanFilter kalman;
+  } state_;
+};
+
+// Per-emitter filter of the tracking table.
+using TrackFilter = RssiFilter<ASAP_TRACK_FILTER_WINDOW>;
+
+}  // namespace asap::track
+//
+// RssiFilter.h
+// Which filter suits the field is an open question (stationary beacons want
+// heavy smoothing, walking players a short lag); the native test runs the
+// same traces through all of them and reports noise, lag and cost.
+//
@@ -0,0 +1,214 @@
+#include <asap/track/TrackingTable.h>
+
+namespace asap::track
+{
+
+namespace
+{
+// Quiet for longer than ageOutMs at nowMs (wrap-safe; a packet stamped by the
+// ISR just after the task read the clock is not "older than old").
+inline bool stale(const TrackEntry& e, uint32_t nowMs, uint32_t ageOutMs)
+{
+  return static_cast<int32_t>(nowMs - e.lastSeenMs) > static_cast<int32_t>(ageOutMs);
+}
+}  // namespace
+
+TrackingTableBase::TrackingTableBase(TrackEntry* slots, uint16_t capacity, uint32_t ageOutMs)
+    : slots_(slots),
+      mask_(static_cast<uint16_t>(capacity - 1u)),
+      shift_(32),
+      size_(0),
+      maxProbe_(0),
+      ageOutMs_(ageOutMs),
+      dropped_(0),
+      filterConfig_(),
+      defaultFilter_(FilterKind::Ema)
+{
+  for (uint16_t c = capacity; c > 1; c >>= 1)
+  {
+    --shift_;
+  }
+}
+
+// Fibonacci hashing: consecutive IDs (as the simulator and a freshly flashed
+// batch hand out) land far apart instead of in one probe run.
+uint16_t TrackingTableBase::home(uint16_t id) const
+{
+  return static_cast<uint16_t>((id * 2654435769u) >> shift_) & mask_;
+}
+
+TrackEntry* TrackingTableBase::update(uint16_t id, asap::proto::MsgType kind, int16_t rssiDbm, uint8_t seq,
+                                      uint32_t nowMs)
+{
+  if (id == 0)
+  {
+    return nullptr;
+  }
+  uint16_t index = home(id);
+  uint16_t probe = 1;
+  while (slots_[index].id != 0 && slots_[index].id != id)
+  {
+    index = (index + 1u) & mask_;
+    ++probe;
+  }
+  TrackEntry& e = slots_[index];
+
+  // Heard again after it would have aged out (expire() not run yet): a new
+  // appearance, not a long gap in the same one.
+  if (e.id == id && !stale(e, nowMs, ageOutMs_))
+  {
+    const uint8_t step = static_cast<uint8_t>(seq - e.lastSeq);
+    if (step > 1 && step < 128)  // 0: duplicate, >= 128: reordered or rebooted
+    {
+      e.missed += step - 1u;
+    }
+  }
+  else
+  {
+    if (e.id == 0)
+    {
+      if (size_ >= maxSize())
+      {
+        ++dropped_;
+        return nullptr;
+      }
+      ++size_;
+      if (probe > maxProbe_)
+      {
+        maxProbe_ = probe;
+      }
+    }
+    e = TrackEntry{};
+    e.id = id;
+    e.firstSeenMs = nowMs;
+    e.filter.reset(defaultFilter_);
+  }
+  e.rssiQ4 = e.filter.feed(rssiDbm, filterConfig_);
+  e.kind = kind;
+  e.lastSeq = seq;
+  e.lastRssiDbm = rssiDbm;
+  e.lastSeenMs = nowMs;
+  ++e.packets;
+  return &e;
+}
+
+const TrackEntry* TrackingTableBase::find(uint16_t id) const
+{
+  if (id == 0)
+  {
+    return nullptr;
+  }
+  for (uint16_t index = home(id); slots_[index].id != 0; index = (index + 1u) & mask_)
+  {
+    if (slots_[index].id == id)
+    {
+      return &slots_[index];
+    }
+  }
+  return nullptr;
+}
+
+bool TrackingTableBase::setFilter(uint16_t id, FilterKind kind)
+{
+  TrackEntry* e = const_cast<TrackEntry*>(find(id));
+  if (!e)
+  {
+    return false;
+  }
+  e->filter.reset(kind);
+  return true;
+}
+
+bool TrackingTableBase::remove(uint16_t id)
+{
+  const TrackEntry* e = find(id);
+  if (!e)
+  {
+    return false;
+  }
+  eraseAt(static_cast<uint16_t>(e - slots_));
+  return true;
+}
+
+// Backward-shift deletion: pull later members of the probe run into the
+// hole unless that would move one in front of its home slot.
+void TrackingTableBase::eraseAt(uint16_t index)
+{
+  uint16_t hole = index;
+  for (uint16_t next = (hole + 1u) & mask_; slots_[next].id != 0; next = (next + 1u) & mask_)
+  {
+    const uint16_t want = home(slots_[next].id);
+    // `want` cyclically in (hole, next]: the entry must stay put.
+    const bool stays = ((next - want) & mask_) < ((next - hole) & mask_);
+    if (!stays)
+    {
+      slots_[hole] = slots_[next];
+      hole = next;
+    }
+  }
+  slots_[hole] = TrackEntry{};
+  --size_;
+}
+
+// A deletion only moves entries backwards into the hole, so re-checking the
+// same index after one visits every entry at least once.
+uint16_t TrackingTableBase::expire(uint32_t nowMs)
+{
+  uint16_t removed = 0;
+  for (uint16_t index = 0; index <= mask_;)
+  {
+    const TrackEntry& e = slots_[index];
+    if (e.id != 0 && stale(e, nowMs, ageOutMs_))
+    {
+      eraseAt(index);
+      ++removed;
+    }
+    else
+    {
+      ++index;
+    }
+  }
+  return removed;
+}
+
+void TrackingTableBase::clear()
+{
+  for (uint16_t index = 0; index <= mask_; ++index)
+  {
+    slots_[index] = TrackEntry{};
+  }
+  size_ = 0;
+}
+
+// Partial insertion sort into out[0..n): n is a handful of HUD rows.
+uint8_t TrackingTableBase::strongest(const TrackEntry** out, uint8_t n, asap::proto::MsgType kind) const
+{
+  uint8_t found = 0;
+  for (uint16_t index = 0; index <= mask_ && n > 0; ++index)
+  {
+    const TrackEntry* e = &slots_[index];
+    if (e->id == 0 || (kind != asap::proto::MsgType::Unknown && e->kind != kind))
+    {
+      continue;
+    }
+    if (found == n && e->rssiQ4 <= out[n - 1]->rssiQ4)
+    {
+      continue;
+    }
+    uint8_t at = found < n ? found++ : static_cast<uint8_t>(n - 1);
+    while (at > 0 && out[at - 1]->rssiQ4 < e->rssiQ4)
+    {
+      out[at] = out[at - 1];
+      --at;
+    }
+    out[at] = e;
+  }
+  return found;
+}
+
+}  // namespace asap::track
+//
+// TrackingTable.cpp
+// Ties in strongest() keep slot order, so the HUD rows do not swap places
+// while two emitters hover at the same level.
+//
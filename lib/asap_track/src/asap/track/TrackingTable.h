@@ -0,0 +1,122 @@
+#pragma once
+
+#include <stdint.h>
+#include <asap/proto/Schema.h>
+#include <asap/track/RssiFilter.h>
+
+// Tracked emitters on the detector (override with -D in platformio.ini).
+// Power of two; the table holds up to 3/4 of it, 40 bytes per slot with the
+// default filter window.
+#ifndef ASAP_TRACK_SLOTS
+#define ASAP_TRACK_SLOTS 64
+#endif
+
+namespace asap::track
+{
+
+// One emitter heard by the detector. The RSSI goes through the entry's own
+// filter (see RssiFilter.h) and is kept in 1/16 dB so small steps are not
+// lost to rounding.
+struct TrackEntry
+{
+  uint16_t id;  // 0: free slot (asap::core::deviceId() is never 0)
+  asap::proto::MsgType kind;
+  uint8_t lastSeq;
+  int16_t rssiQ4;       // filtered RSSI, dBm * 16
+  int16_t lastRssiDbm;  // latest sample
+  TrackFilter filter;
+  uint32_t firstSeenMs;
+  uint32_t lastSeenMs;
+  uint32_t packets;  // received
+  uint32_t missed;   // sequence numbers skipped between received packets
+
+  int16_t rssiDbm() const { return static_cast<int16_t>((rssiQ4 + (rssiQ4 >= 0 ? 8 : -8)) / 16); }
+};
+
+// Open-addressed hash map from emitter ID to TrackEntry over caller-sized
+// storage (see TrackingTable<Slots>). Linear probing with backward-shift
+// deletion, so there are no tombstones and a lookup stops at the first free
+// slot: insert and update are O(1) from the radio task as long as the table
+// stays below its 3/4 load limit. Iteration walks the flat slot array.
+//
+// Entries not heard for ageOutMs are dropped by expire(); a new emitter that
+// finds the table full is not tracked (dropped()) until one ages out.
+class TrackingTableBase
+{
+ public:
+  static constexpr uint32_t kDefaultAgeOutMs = 10000;  // ten beacon periods
+
+  // Record one packet from `id`. Returns the entry, or nullptr when `id` is
+  // new and the table is full (or `id` is 0).
+  TrackEntry* update(uint16_t id, asap::proto::MsgType kind, int16_t rssiDbm, uint8_t seq, uint32_t nowMs);
+
+  const TrackEntry* find(uint16_t id) const;
+  bool remove(uint16_t id);
+
+  // Filter of one tracked emitter (restarts it from the next sample) and
+  // of emitters tracked from now on; false when `id` is not tracked.
+  bool setFilter(uint16_t id, FilterKind kind);
+  void setDefaultFilter(FilterKind kind) { defaultFilter_ = kind; }
+  FilterKind defaultFilter() const { return defaultFilter_; }
+  FilterConfig& filterConfig() { return filterConfig_; }
+
+  // Drop every entry not heard for ageOutMs; returns how many.
+  uint16_t expire(uint32_t nowMs);
+  void clear();
+
+  // Up to `n` entries with the strongest filtered RSSI, strongest first,
+  // written to `out`; `kind` restricts the query to one message type
+  // (MsgType::Unknown: any). Returns how many were found. One pass over the
+  // slots, O(capacity * n).
+  uint8_t strongest(const TrackEntry** out, uint8_t n, asap::proto::MsgType kind = asap::proto::MsgType::Unknown) const;
+
+  // Flat iteration: slot(i) is nullptr for free slots.
+  uint16_t capacity() const { return mask_ + 1u; }
+  const TrackEntry* slot(uint16_t index) const { return slots_[index].id ? &slots_[index] : nullptr; }
+
+  uint16_t size() const { return size_; }
+  uint16_t maxSize() const { return static_cast<uint16_t>(capacity() * 3u / 4u); }
+  uint32_t ageOutMs() const { return ageOutMs_; }
+  void setAgeOutMs(uint32_t ms) { ageOutMs_ = ms; }
+  uint32_t dropped() const { return dropped_; }        // packets of untracked new emitters
+  uint16_t longestProbe() const { return maxProbe_; }  // slots visited by the worst insert
+
+ protected:
+  TrackingTableBase(TrackEntry* slots, uint16_t capacity, uint32_t ageOutMs);
+
+ private:
+  uint16_t home(uint16_t id) const;
+  void eraseAt(uint16_t index);
+
+  TrackEntry* slots_;
+  uint16_t mask_;
+  uint8_t shift_;  // 32 - log2(capacity), for the multiplicative hash
+  uint16_t size_;
+  uint16_t maxProbe_;
+  uint32_t ageOutMs_;
+  uint32_t dropped_;
+  FilterConfig filterConfig_;
+  FilterKind defaultFilter_;
+};
+
+template <uint16_t Slots>
+class TrackingTable : public TrackingTableBase
+{
+  static_assert(Slots >= 4 && (Slots & (Slots - 1)) == 0, "tracking slots must be a power of two");
+
+ public:
+  explicit TrackingTable(uint32_t ageOutMs = kDefaultAgeOutMs) : TrackingTableBase(storage_, Slots, ageOutMs) {}
+
+ private:
+  TrackEntry storage_[Slots] = {};
+};
+
+// The detector's table.
+using DetectorTracks = TrackingTable<ASAP_TRACK_SLOTS>;
+
+}  // namespace asap::track
+//
+// TrackingTable.h
+// Replaces the UI's single tracked ID as the detector's record of who is
+// around; the tracking page shows its entry's filtered RSSI as is.
+//
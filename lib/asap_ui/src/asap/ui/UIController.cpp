@@ -12,6 +12,7 @@ UIController::UIController(asap::display::DetectorDisplay& display)
       state_(State::MainAnomaly),
       selectedIndex_(0),
       trackingId_(0),
+      trackedId_(0),
       rssiAvg_(-100),
       rssiInit_(false),
       anomalyStrength_(0),
@@ -19,7 +20,8 @@ UIController::UIController(asap::display::DetectorDisplay& display)
       stageRad_(0), stageTherm_(0), stageChem_(0), stagePsy_(0),
       firstActionDone_(false),
       centerPrev_(false),
-      pressStartMs_(0)
+      pressStartMs_(0),
+      longPressFired_(false)
 {
 }
 
@@ -34,61 +36,149 @@ void UIController::setAnomalyStrength(uint8_t percent)
 // Set per-channel arc progress for anomaly indicators (0..100% of current turn)
 void UIController::setAnomalyExposure(uint8_t rad, uint8_t therm, uint8_t chem, uint8_t psy)
 {
-  anomalyRad_ = (rad > 100) ? 100 : rad;
-  anomalyTherm_ = (therm > 100) ? 100 : therm;
-  anomalyChem_ = (chem > 100) ? 100 : chem;
-  anomalyPsy_ = (psy > 100) ? 100 : psy;
+  rad = (rad > 100) ? 100 : rad;
+  therm = (therm > 100) ? 100 : therm;
+  chem = (chem > 100) ? 100 : chem;
+  psy = (psy > 100) ? 100 : psy;
+  if (rad == anomalyRad_ && therm == anomalyTherm_ && chem == anomalyChem_ && psy == anomalyPsy_)
+  {
+    return;
+  }
+  anomalyRad_ = rad;
+  anomalyTherm_ = therm;
+  anomalyChem_ = chem;
+  anomalyPsy_ = psy;
+  if (state_ == State::MainAnomaly)
+  {
+    dirty_ = true;
+  }
 }
 
 // Set per-channel stage (0 none/-, 1 I, 2 II, 3 III)
 void UIController::setAnomalyStage(uint8_t rad, uint8_t therm, uint8_t chem, uint8_t psy)
 {
-  stageRad_ = (rad > 3) ? 3 : rad;
-  stageTherm_ = (therm > 3) ? 3 : therm;
-  stageChem_ = (chem > 3) ? 3 : chem;
-  stagePsy_ = (psy > 3) ? 3 : psy;
+  rad = (rad > 3) ? 3 : rad;
+  therm = (therm > 3) ? 3 : therm;
+  chem = (chem > 3) ? 3 : chem;
+  psy = (psy > 3) ? 3 : psy;
+  if (rad == stageRad_ && therm == stageTherm_ && chem == stageChem_ && psy == stagePsy_)
+  {
+    return;
+  }
+  stageRad_ = rad;
+  stageTherm_ = therm;
+  stageChem_ = chem;
+  stagePsy_ = psy;
+  if (state_ == State::MainAnomaly)
+  {
+    dirty_ = true;
+  }
+}
+
+// Show the tracked emitter and its RSSI (in dBm), already filtered by its
+// entry in the detector's tracking table. Only a change of what is displayed
+// invalidates the tracking page.
+void UIController::setTrackedEmitter(uint16_t id, int16_t rssiDbm)
+{
+  const bool changed = !rssiInit_ || id != trackedId_ || rssiDbm != rssiAvg_;
+  trackedId_ = id;
+  rssiAvg_ = rssiDbm;
+  rssiInit_ = true;
+  if (changed && state_ == State::MainTracking)
+  {
+    dirty_ = true;
+  }
 }
 
-// Feed a new RSSI sample (in dBm) into the tracking EMA. Uses alpha=0.25 for a
-// responsive yet stable display.
-void UIController::feedTrackingRssi(int16_t rssiDbm)
+// The tracked emitter left the table: show the selection with no reading
+// rather than its last value.
+void UIController::clearTrackedEmitter()
 {
-  // EMA with alpha ~0.25
-  if (!rssiInit_) {
-    rssiAvg_ = rssiDbm;
-    rssiInit_ = true;
+  if (!rssiInit_)
+  {
     return;
   }
-  const int32_t alphaNum = 1;   // 1/4
-  const int32_t alphaDen = 4;
-  rssiAvg_ = static_cast<int16_t>((alphaNum * static_cast<int32_t>(rssiDbm) +
-                                   (alphaDen - alphaNum) * static_cast<int32_t>(rssiAvg_)) /
-                                  alphaDen);
+  rssiInit_ = false;
+  if (state_ == State::MainTracking)
+  {
+    dirty_ = true;
+  }
 }
 
-// Advance the UI state machine and render the resulting page. Applies first
-// action gating so that the very first user interaction must be a long-press
-// on the center button (>=1000ms) to enter the menu. Subsequent long-presses
-// also open the menu, as expected.
-void UIController::onTick(uint32_t nowMs, const InputSample& sample)
+void UIController::setTrackingId(uint16_t id)
 {
-  // Long-press handling (always allowed)
+  if (id == trackingId_)
+  {
+    return;
+  }
+  trackingId_ = id;
+  rssiInit_ = false;
+  if (state_ == State::MainTracking || state_ == State::MenuTracking)
+  {
+    dirty_ = true;
+  }
+}
+
+// Advance the UI state machine and render the resulting page if it was
+// invalidated. Applies first action gating so that the very first user
+// interaction must be a long-press on the center button (>=1000ms) to enter
+// the menu. Subsequent long-presses also open the menu, as expected.
+uint32_t UIController::onTick(uint32_t nowMs, const InputSample& sample)
+{
+  step(nowMs, sample);
+  return present(nowMs);
+}
+
+// Event-driven variant: apply every queued joystick edge at its own timestamp
+// (exact long-press timing, no lost flicks), then catch up to nowMs so a
+// long-press still held fires on time.
+uint32_t UIController::onInput(asap::input::JoyEventQueue& events, uint32_t nowMs)
+{
+  asap::input::JoyEvent e{};
+  uint32_t lastMs = nowMs;
+  while (events.pop(e))
+  {
+    step(e.timeMs, {e.centerDown, e.action});
+    // An edge may be stamped after the caller read the clock.
+    if (static_cast<int32_t>(e.timeMs - lastMs) > 0)
+    {
+      lastMs = e.timeMs;
+    }
+  }
+  step(lastMs, {centerPrev_, asap::input::JoyAction::Neutral});
+  return present(lastMs);
+}
+
+// One state machine step for an input sample taken at timeMs.
+void UIController::step(uint32_t timeMs, const InputSample& sample)
+{
+  // Long-press handling (always allowed). It fires once per press, at the
+  // latest when the release is seen, so the threshold does not depend on how
+  // often the controller is ticked.
   if (sample.centerDown && !centerPrev_)
   {
-    pressStartMs_ = nowMs;
+    pressStartMs_ = timeMs;
+    longPressFired_ = false;
   }
-  if (sample.centerDown && (nowMs - pressStartMs_ >= kLongPressMs))
+  const bool held = sample.centerDown || centerPrev_;
+  if (held && !longPressFired_ && (timeMs - pressStartMs_ >= kLongPressMs))
   {
+    if (state_ != State::MenuRoot || selectedIndex_ != 0)
+    {
+      dirty_ = true;
+    }
     state_ = State::MenuRoot;
     selectedIndex_ = 0;
     firstActionDone_ = true;  // first action performed
+    longPressFired_ = true;
   }
+  // The Click that ends a long-press belongs to it, not to the menu.
+  const bool releasedAfterLongPress = centerPrev_ && !sample.centerDown && longPressFired_;
   centerPrev_ = sample.centerDown;
 
   // Before first long-press, ignore all non-long-press actions
   if (!firstActionDone_)
   {
-    render();
     return;
   }
 
@@ -96,6 +186,10 @@ void UIController::onTick(uint32_t nowMs, const InputSample& sample)
   // The physical device may be mounted differently between builds; invert
   // mapping here so the rest of the state machine can stay agnostic.
   asap::input::JoyAction act = sample.action;
+  if (releasedAfterLongPress && act == asap::input::JoyAction::Click)
+  {
+    act = asap::input::JoyAction::Neutral;
+  }
   if (invertX_)
   {
     if (act == asap::input::JoyAction::Left) act = asap::input::JoyAction::Right;
@@ -109,8 +203,52 @@ void UIController::onTick(uint32_t nowMs, const InputSample& sample)
 
   // Handle navigation using declarative graph with transformed action.
   navigate(act);
+}
 
-  render();
+// Render if invalidated or an animated page is due, then work out when the
+// controller next needs the CPU without new input.
+uint32_t UIController::present(uint32_t nowMs)
+{
+  const uint16_t period = findPage(state_).framePeriodMs;
+  if (period != 0 && static_cast<int32_t>(nowMs - nextFrameMs_) >= 0)
+  {
+    dirty_ = true;
+  }
+  if (dirty_)
+  {
+    dirty_ = false;
+    render();
+    if (period != 0)
+    {
+      nextFrameMs_ = nowMs + period;
+    }
+  }
+  else if (display_.flushPending())
+  {
+    display_.flushAsync();  // tiles the flush queue could not take last time
+  }
+
+  uint32_t wakeMs = nowMs + kMaxSleepMs;
+  const auto earlier = [&wakeMs](uint32_t t) {
+    if (static_cast<int32_t>(t - wakeMs) < 0)
+    {
+      wakeMs = t;
+    }
+  };
+  if (period != 0)
+  {
+    earlier(nextFrameMs_);
+  }
+  // Held center button: the long-press fires without any further edge.
+  if (centerPrev_ && !longPressFired_)
+  {
+    earlier(pressStartMs_ + kLongPressMs);
+  }
+  if (display_.flushPending())
+  {
+    earlier(nowMs + kFlushRetryMs);
+  }
+  return wakeMs;
 }
 
 // Render the current UI state using the display frame factories and the
@@ -120,11 +258,12 @@ void UIController::render()
   using asap::display::FrameKind;
   using asap::display::DisplayFrame;
 
-  // Use the declarative render hook
-  const PageNode* page = findPage(state_);
-  if (page && page->render)
+  // Use the declarative render hook, timed per page
+  const PageNode& page = findPage(state_);
+  if (page.render)
   {
-    page->render(*this);
+    ASAP_PROFILE_SCOPE(asap::profile::kProbePage0 + static_cast<uint8_t>(state_));
+    page.render(*this);
   }
 }
 
@@ -135,25 +274,21 @@ void UIController::render()
 //     jump to the configured confirmTarget
 void UIController::navigate(asap::input::JoyAction action)
 {
-  const PageNode* page = findPage(state_);
-  if (!page)
-  {
-    return;
-  }
+  const PageNode& page = findPage(state_);
 
   // Per-page action hook (selection changes, ID tweaks, etc.)
-  if (page->onAction)
+  if (page.onAction)
   {
-    page->onAction(*this, action);
+    page.onAction(*this, action);
   }
 
   // Back navigation
-  if (page->backAction != asap::input::JoyAction::Neutral && action == page->backAction)
+  if (page.backAction != asap::input::JoyAction::Neutral && action == page.backAction)
   {
-    state_ = page->parent;
+    state_ = page.parent;
+    dirty_ = true;
     // Clamp selection for the new page
-    const PageNode* np = findPage(state_);
-    const uint8_t ncount = (np && np->childCount > 0) ? np->childCount : 0;
+    const uint8_t ncount = findPage(state_).childCount;
     if (ncount == 0)
     {
       selectedIndex_ = 0;
@@ -167,26 +302,25 @@ void UIController::navigate(asap::input::JoyAction action)
 
   // Confirmation / Enter
   const uint8_t bit = ActionBit(action);
-  if (bit != 0 && (page->confirmMask & bit) != 0)
+  if (bit != 0 && (page.confirmMask & bit) != 0)
   {
-    if (page->confirm == ConfirmBehavior::EnterSelectedChild && page->children && page->childCount > 0)
+    if (page.confirm == ConfirmBehavior::EnterSelectedChild && page.childCount > 0)
     {
-      const uint8_t idx = (selectedIndex_ < page->childCount) ? selectedIndex_ : 0;
-      state_ = page->children[idx];
+      const uint8_t idx = (selectedIndex_ < page.childCount) ? selectedIndex_ : 0;
+      state_ = page.children[idx];
+      dirty_ = true;
       // When entering a new menu/list, start at the first item
-      const PageNode* np = findPage(state_);
-      if (np && np->childCount > 0)
+      if (findPage(state_).childCount > 0)
       {
         selectedIndex_ = 0;
       }
       return;
     }
-    if (page->confirm == ConfirmBehavior::GoToTarget)
+    if (page.confirm == ConfirmBehavior::GoToTarget)
     {
-      state_ = page->confirmTarget;
-      const PageNode* np = findPage(state_);
-      const uint8_t ncount = (np && np->childCount > 0) ? np->childCount : 0;
-      if (ncount == 0)
+      state_ = page.confirmTarget;
+      dirty_ = true;
+      if (findPage(state_).childCount == 0)
       {
         selectedIndex_ = 0;
       }
@@ -195,17 +329,10 @@ void UIController::navigate(asap::input::JoyAction action)
   }
 }
 
-  // Page lookup against the static definition in the header
-const UIController::PageNode* UIController::findPage(State id)
+// Page lookup: one load from the compile-time index (see kPageIndex).
+const UIController::PageNode& UIController::findPage(State id)
 {
-  for (const auto& n : kPages)
-  {
-    if (n.id == id)
-    {
-      return &n;
-    }
-  }
-  return nullptr;
+  return kPages[kPageIndex.slot[static_cast<uint8_t>(id)]];
 }
 
 // Render hooks
@@ -251,15 +378,14 @@ void UIController::RenderMainTracking(UIController& self)
 {
   using asap::display::FrameKind;
   const int16_t rssi = self.rssiInit_ ? self.rssiAvg_ : -100;
-  asap::display::DisplayFrame f = asap::display::makeTrackingMainFrame(self.trackingId_, rssi, false);
+  asap::display::DisplayFrame f = asap::display::makeTrackingMainFrame(self.trackedId(), rssi, false);
   self.display_.renderCustom(f, FrameKind::MainTracking);
 }
 
 // Action hooks
 void UIController::ActionMenuRoot(UIController& self, asap::input::JoyAction action)
 {
-  const PageNode* page = UIController::findPage(self.state_);
-  const uint8_t count = (page && page->childCount > 0) ? page->childCount : 0;
+  const uint8_t count = UIController::findPage(self.state_).childCount;
   if (count == 0)
   {
     return;
@@ -286,12 +412,16 @@ void UIController::ActionMenuRoot(UIController& self, asap::input::JoyAction act
   {
     self.selectedIndex_ = static_cast<uint8_t>((self.selectedIndex_ + 1) % count);
   }
+  else
+  {
+    return;
+  }
+  self.invalidate();
 }
 
 void UIController::ActionMenuList(UIController& self, asap::input::JoyAction action)
 {
-  const PageNode* page = UIController::findPage(self.state_);
-  const uint8_t count = (page && page->childCount > 0) ? page->childCount : 0;
+  const uint8_t count = UIController::findPage(self.state_).childCount;
   if (count == 0)
   {
     return;
@@ -317,6 +447,11 @@ void UIController::ActionMenuList(UIController& self, asap::input::JoyAction act
   {
     self.selectedIndex_ = static_cast<uint8_t>((self.selectedIndex_ + 1) % count);
   }
+  else
+  {
+    return;
+  }
+  self.invalidate();
 }
 
 void UIController::RenderMenuConfigList(UIController& self)
@@ -332,8 +467,7 @@ void UIController::RenderMenuConfigList(UIController& self)
   const char* labels[5] = {"INVERT X JOYSTICK", "INVERT Y JOYSTICK", "ROTATE DISPLAY", "RSSI CALIB", "VERSION"};
   const uint16_t ys[3] = {20, 38, 56};
 
-  const PageNode* page = UIController::findPage(self.state_);
-  const uint8_t count = (page && page->childCount > 0) ? page->childCount : 0;
+  const uint8_t count = UIController::findPage(self.state_).childCount;
   if (count == 0)
   {
     self.display_.renderCustom(f, FrameKind::Menu);
@@ -478,6 +612,7 @@ void UIController::ActionConfigToggleX(UIController& self, asap::input::JoyActio
   if (action == asap::input::JoyAction::Right || action == asap::input::JoyAction::Click)
   {
     self.invertX_ = !self.invertX_;
+    self.invalidate();
   }
 }
 
@@ -486,6 +621,7 @@ void UIController::ActionConfigToggleY(UIController& self, asap::input::JoyActio
   if (action == asap::input::JoyAction::Right || action == asap::input::JoyAction::Click)
   {
     self.invertY_ = !self.invertY_;
+    self.invalidate();
   }
 }
 
@@ -496,6 +632,7 @@ void UIController::ActionConfigToggleRotate(UIController& self, asap::input::Joy
     self.rotateDisplay_ = !self.rotateDisplay_;
     // Propagate to display backends
     self.display_.setRotation180(self.rotateDisplay_);
+    self.invalidate();
   }
 }
 
@@ -503,12 +640,17 @@ void UIController::ActionMenuTracking(UIController& self, asap::input::JoyAction
 {
   if (action == asap::input::JoyAction::Left)
   {
-    self.trackingId_ = static_cast<uint8_t>((self.trackingId_ + 255) % 256);
+    self.trackingId_ = static_cast<uint16_t>(self.trackingId_ - 1);
   }
   else if (action == asap::input::JoyAction::Right)
   {
-    self.trackingId_ = static_cast<uint8_t>((self.trackingId_ + 1) % 256);
+    self.trackingId_ = static_cast<uint16_t>(self.trackingId_ + 1);
+  }
+  else
+  {
+    return;
   }
+  self.invalidate();
 }
 
 void UIController::ActionNoop(UIController&, asap::input::JoyAction)
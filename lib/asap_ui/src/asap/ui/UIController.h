@@ -10,6 +10,8 @@
 
 #include <asap/display/DetectorDisplay.h>
 #include <asap/input/Joystick.h>
+#include <asap/input/JoyEventQueue.h>
+#include <asap/profile/Profiler.h>
 
 namespace asap::ui
 {
@@ -40,8 +42,13 @@ enum class State : uint8_t
   MenuConfigRotate,
   MenuConfigRssiCal,
   MenuConfigVersion,
+  // Keep last: number of states (sizes the page index, not a page itself).
+  Count,
 };
 
+inline constexpr uint8_t kStateCount = static_cast<uint8_t>(State::Count);
+static_assert(kStateCount <= ASAP_PROFILE_PAGES, "raise ASAP_PROFILE_PAGES: one profiling probe per page");
+
 // Debounced input snapshot passed to the controller on each tick.
 // - centerDown: level signal for long-press detection
 // - action: edge-triggered high-level joystick action for navigation
@@ -67,18 +74,38 @@ enum class ConfirmBehavior : uint8_t
   GoToTarget,
 };
 
+struct PageGraphValidator;  // compile-time checks of UIController::kPages
+
 class UIController
 {
  public:
   explicit UIController(asap::display::DetectorDisplay& display);
 
-  // Advance UI state machine and render.
-  // Call at a fixed cadence with current time and input sample.
-  void onTick(uint32_t nowMs, const InputSample& sample);
+  // Advance the UI state machine and render if anything visible changed.
+  // Returns the time (millis) by which onTick must run again even without new
+  // input: a pending long-press, the next frame of an animated page, tiles
+  // still waiting for room in the flush queue, or nowMs + kMaxSleepMs when
+  // idle. Call earlier whenever input arrives.
+  uint32_t onTick(uint32_t nowMs, const InputSample& sample);
+
+  // Same, fed by the interrupt-driven joystick: drains `events` (each applied
+  // at its edge time), then advances to nowMs. Returns the next wakeup.
+  uint32_t onInput(asap::input::JoyEventQueue& events, uint32_t nowMs);
+
+  // Force a redraw on the next tick (e.g. after the panel was re-initialized).
+  void invalidate() { dirty_ = true; }
+  bool needsRender() const { return dirty_; }
+
+  static constexpr uint32_t kMaxSleepMs = 10000;  // idle wakeup bound
+  static constexpr uint32_t kFlushRetryMs = 1;    // pending flush poll
 
   // External signal hooks
   void setAnomalyStrength(uint8_t percent);  // 0..100 (legacy bar fill)
-  void feedTrackingRssi(int16_t rssiDbm);    // EMA input (dBm)
+  // Emitter on the tracking page and its filtered RSSI (dBm, from its
+  // TrackEntry): the selected one, or the strongest beacon in auto mode.
+  void setTrackedEmitter(uint16_t id, int16_t rssiDbm);
+  void clearTrackedEmitter();                // it aged out: back to the selection and -100 dBm
+  void setTrackingId(uint16_t id);           // select the tracked emitter, 0 = auto (clears the RSSI)
   // New anomaly HUD inputs used by DetectorDisplay::drawAnomalyIndicators:
   // - setAnomalyExposure: arc progress for current revolution (0..100%)
   // - setAnomalyStage: roman stage label (0 none/-, 1 I, 2 II, 3 III)
@@ -87,7 +114,9 @@ class UIController
 
   // For testing/inspection
   State state() const { return state_; }
-  uint8_t trackingId() const { return trackingId_; }
+  uint16_t trackingId() const { return trackingId_; }  // selection (0: strongest beacon)
+  uint16_t trackedId() const { return rssiInit_ ? trackedId_ : trackingId_; }  // as shown
+  int16_t trackingRssi() const { return rssiInit_ ? rssiAvg_ : -100; }  // as shown (dBm)
 
  private:
   // Hook signatures for declarative pages
@@ -106,6 +135,7 @@ class UIController
     State confirmTarget;        // used when confirm == GoToTarget
     ActionHook onAction;        // optional per-page action hook (selection/ID changes)
     RenderHook render;          // page render function
+    uint16_t framePeriodMs;     // animated pages: redraw cadence (0 = static page)
   };
 
   // (removed) actionBit moved to free function at namespace scope
@@ -113,7 +143,20 @@ class UIController
   // Core driver
   void render();
   void navigate(asap::input::JoyAction action);
-  static const PageNode* findPage(State id);
+  void step(uint32_t timeMs, const InputSample& sample);
+  uint32_t present(uint32_t nowMs);
+  static const PageNode& findPage(State id);
+
+  // kPages slot of every State, built at compile time (defined after the
+  // class, once kPages is complete). PageGraphValidator guarantees every
+  // State has exactly one page, so a lookup is a single table load.
+  struct PageIndex
+  {
+    uint8_t slot[kStateCount];
+  };
+  static constexpr PageIndex buildPageIndex();
+  static const PageIndex kPageIndex;
+  friend struct PageGraphValidator;
 
   // Page hooks (declared here, defined in .cpp)
   static void RenderMenuRoot(UIController& self);
@@ -142,8 +185,9 @@ class UIController
   asap::display::DetectorDisplay& display_;
   State state_;
   uint8_t selectedIndex_;  // root menu selection 0..2
-  uint8_t trackingId_;
-  int16_t rssiAvg_;        // EMA accumulator (in dBm)
+  uint16_t trackingId_;    // selected emitter, 0 = auto
+  uint16_t trackedId_;     // emitter rssiAvg_ belongs to
+  int16_t rssiAvg_;        // tracking table's filtered RSSI, dBm
   bool rssiInit_;
   uint8_t anomalyStrength_;
   // Per-channel anomaly state for the new HUD
@@ -167,8 +211,15 @@ class UIController
   bool firstActionDone_;   // becomes true after initial long-press
   bool centerPrev_;        // last sampled level for center button
   uint32_t pressStartMs_;  // timestamp when center transitioned to down
+  bool longPressFired_;    // current press already opened the menu
   static constexpr uint32_t kLongPressMs = 1000;  // confirmed requirement
 
+  // Invalidation: setters, navigation and config toggles set dirty_ when they
+  // change what the current page shows; onTick renders only then (or when an
+  // animated page is due), so an idle HUD costs no drawing or SPI traffic.
+  bool dirty_ = true;        // first tick always draws
+  uint32_t nextFrameMs_ = 0; // next frame of an animated page
+
   /*
    Developer Guide: Adding or Modifying Pages
 
@@ -192,6 +243,10 @@ class UIController
         - confirm behavior: EnterSelectedChild or GoToTarget (+ confirmTarget)
         - onAction hook (or ActionNoop)
         - render hook
+        - framePeriodMs (0 unless the page animates)
+
+      Action hooks that change what the page shows must call
+      self.invalidate(); state changes made by the navigation core already do.
 
    4) For a main (operational HUD) page, typically set:
         backAction = Neutral, confirmMask = 0, confirm = None,
@@ -211,13 +266,19 @@ class UIController
      //   asap::input::JoyAction::Left,
      //   static_cast<uint8_t>(ActionBit(asap::input::JoyAction::Right) | ActionBit(asap::input::JoyAction::Click)),
      //   ConfirmBehavior::GoToTarget, State::MainFoo,
-     //   &UIController::ActionMenuFoo, &UIController::RenderMenuFoo },
+     //   &UIController::ActionMenuFoo, &UIController::RenderMenuFoo, 0 },
      // { State::MainFoo, State::MainFoo, nullptr, 0,
      //   asap::input::JoyAction::Neutral, 0, ConfirmBehavior::None, State::MainFoo,
-     //   &UIController::ActionNoop, &UIController::RenderMainFoo },
+     //   &UIController::ActionNoop, &UIController::RenderMainFoo, 0 },
 
    This keeps Up/Down scrolling driven by childCount and all transitions
    declaratively defined here.
+
+   5) Add the State enumerator (before Count). The static_asserts after the
+      class reject a state without a page, duplicate pages, parents that do
+      not list the page as a child, children that do not exist or do not
+      point back, and confirm targets without a page, so graph mistakes fail
+      the build.
   */
 
   // Declarative navigation graph data
@@ -247,6 +308,7 @@ class UIController
           /*confirmTarget=*/State::MenuRoot,
           /*onAction=*/&UIController::ActionMenuRoot,
           /*render=*/&UIController::RenderMenuRoot,
+          /*framePeriodMs=*/0,
       },
       // Anomaly menu page: Left back, Right/Click confirm -> MainAnomaly
       {
@@ -261,6 +323,7 @@ class UIController
           /*confirmTarget=*/State::MainAnomaly,
           /*onAction=*/&UIController::ActionNoop,
           /*render=*/&UIController::RenderMenuAnomaly,
+          /*framePeriodMs=*/0,
       },
       // Tracking menu page: Up back, Left/Right adjust ID, Click confirm -> MainTracking
       {
@@ -274,6 +337,7 @@ class UIController
           /*confirmTarget=*/State::MainTracking,
           /*onAction=*/&UIController::ActionMenuTracking,
           /*render=*/&UIController::RenderMenuTracking,
+          /*framePeriodMs=*/0,
       },
       // Config menu page: Left back, no confirm target
       {
@@ -288,6 +352,7 @@ class UIController
           /*confirmTarget=*/State::MenuConfig,
           /*onAction=*/&UIController::ActionMenuList,
           /*render=*/&UIController::RenderMenuConfigList,
+          /*framePeriodMs=*/0,
       },
       // Main pages (no navigation; rendered from external state data)
       {
@@ -301,6 +366,7 @@ class UIController
           /*confirmTarget=*/State::MainAnomaly,
           /*onAction=*/&UIController::ActionNoop,
           /*render=*/&UIController::RenderMainAnomaly,
+          /*framePeriodMs=*/0,
       },
       {
           State::MainTracking,
@@ -313,6 +379,7 @@ class UIController
           /*confirmTarget=*/State::MainTracking,
           /*onAction=*/&UIController::ActionNoop,
           /*render=*/&UIController::RenderMainTracking,
+          /*framePeriodMs=*/0,
       },
       // Config leaf pages
       {
@@ -326,6 +393,7 @@ class UIController
           /*confirmTarget=*/State::MenuConfigInvertX,
           /*onAction=*/&UIController::ActionConfigToggleX,
           /*render=*/&UIController::RenderConfigInvertX,
+          /*framePeriodMs=*/0,
       },
       {
           State::MenuConfigInvertY,
@@ -338,6 +406,7 @@ class UIController
           /*confirmTarget=*/State::MenuConfigInvertY,
           /*onAction=*/&UIController::ActionConfigToggleY,
           /*render=*/&UIController::RenderConfigInvertY,
+          /*framePeriodMs=*/0,
       },
       {
           State::MenuConfigRotate,
@@ -350,6 +419,7 @@ class UIController
           /*confirmTarget=*/State::MenuConfigRotate,
           /*onAction=*/&UIController::ActionConfigToggleRotate,
           /*render=*/&UIController::RenderConfigRotate,
+          /*framePeriodMs=*/0,
       },
       {
           State::MenuConfigRssiCal,
@@ -362,6 +432,7 @@ class UIController
           /*confirmTarget=*/State::MenuConfigRssiCal,
           /*onAction=*/&UIController::ActionNoop,
           /*render=*/&UIController::RenderConfigRssi,
+          /*framePeriodMs=*/0,
       },
       {
           State::MenuConfigVersion,
@@ -374,8 +445,164 @@ class UIController
           /*confirmTarget=*/State::MenuConfigVersion,
           /*onAction=*/&UIController::ActionNoop,
           /*render=*/&UIController::RenderConfigVersion,
+          /*framePeriodMs=*/0,
       },
   };
+
+  static constexpr uint8_t kPageCount = static_cast<uint8_t>(sizeof(kPages) / sizeof(kPages[0]));
 };
 
+// Compile-time validation of the declarative navigation graph.
+struct PageGraphValidator
+{
+  using Page = UIController::PageNode;
+
+  static constexpr bool validState(State id)
+  {
+    return static_cast<uint8_t>(id) < kStateCount;
+  }
+
+  static constexpr uint8_t pagesFor(State id)
+  {
+    uint8_t n = 0;
+    for (const Page& p : UIController::kPages)
+    {
+      if (p.id == id)
+      {
+        ++n;
+      }
+    }
+    return n;
+  }
+
+  // kPages slot of `id`, or kPageCount when it has no page. Slots rather than
+  // pointers: pointer/null comparisons are not constant expressions under
+  // some sanitizer builds.
+  static constexpr uint8_t slotFor(State id)
+  {
+    for (uint8_t slot = 0; slot < UIController::kPageCount; ++slot)
+    {
+      if (UIController::kPages[slot].id == id)
+      {
+        return slot;
+      }
+    }
+    return UIController::kPageCount;
+  }
+
+  static constexpr bool hasPage(State id)
+  {
+    return validState(id) && slotFor(id) < UIController::kPageCount;
+  }
+
+  static constexpr bool listsChild(const Page& parent, State child)
+  {
+    for (uint8_t i = 0; i < parent.childCount; ++i)
+    {
+      if (parent.children[i] == child)
+      {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Every State has exactly one page (and no page has an out-of-range id).
+  static constexpr bool everyStateHasOnePage()
+  {
+    for (uint8_t s = 0; s < kStateCount; ++s)
+    {
+      if (pagesFor(static_cast<State>(s)) != 1)
+      {
+        return false;
+      }
+    }
+    for (const Page& p : UIController::kPages)
+    {
+      if (!validState(p.id))
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // A parent is either the page itself (top-level pages) or an existing menu
+  // listing the page as a child; back navigation needs a real parent.
+  static constexpr bool parentsResolve()
+  {
+    for (const Page& p : UIController::kPages)
+    {
+      if (p.parent == p.id)
+      {
+        if (p.backAction != asap::input::JoyAction::Neutral)
+        {
+          return false;
+        }
+        continue;
+      }
+      if (!hasPage(p.parent) || !listsChild(UIController::kPages[slotFor(p.parent)], p.id))
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // Children exist, have pages and name this page as their parent (a
+  // childCount without a children array fails evaluation outright).
+  static constexpr bool childrenResolve()
+  {
+    for (const Page& p : UIController::kPages)
+    {
+      if (p.confirm == ConfirmBehavior::EnterSelectedChild && p.childCount == 0)
+      {
+        return false;
+      }
+      for (uint8_t i = 0; i < p.childCount; ++i)
+      {
+        const State c = p.children[i];
+        if (!hasPage(c) || UIController::kPages[slotFor(c)].parent != p.id)
+        {
+          return false;
+        }
+      }
+    }
+    return true;
+  }
+
+  static constexpr bool confirmTargetsResolve()
+  {
+    for (const Page& p : UIController::kPages)
+    {
+      if (p.confirm == ConfirmBehavior::GoToTarget && !hasPage(p.confirmTarget))
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+};
+
+static_assert(PageGraphValidator::everyStateHasOnePage(),
+              "kPages: every State needs exactly one PageNode");
+static_assert(PageGraphValidator::parentsResolve(),
+              "kPages: parent must be the page itself (no back action) or a menu listing it as a child");
+static_assert(PageGraphValidator::childrenResolve(),
+              "kPages: children must exist, point back to their parent, and match childCount");
+static_assert(PageGraphValidator::confirmTargetsResolve(),
+              "kPages: GoToTarget needs a confirmTarget with a page");
+
+constexpr UIController::PageIndex UIController::buildPageIndex()
+{
+  PageIndex index{};
+  for (uint8_t slot = 0; slot < kPageCount; ++slot)
+  {
+    index.slot[static_cast<uint8_t>(kPages[slot].id)] = slot;
+  }
+  return index;
+}
+
+inline constexpr UIController::PageIndex UIController::kPageIndex = UIController::buildPageIndex();
+
 }  // namespace asap::ui
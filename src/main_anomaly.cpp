@@ -1,15 +1,59 @@
 #include <Arduino.h>
 
-void setup()
+#include <asap/core/DeviceId.h>      // radio identity
+#include <asap/core/DeviceRole.h>    // setupRole() entry point
+#include <asap/radio/Cc1101Link.h>   // CC1101 on SPI2 + GDO interrupts
+#include <asap/radio/TdmaMac.h>      // slotted medium access
+#include <asap/roles/EmitterRoles.h>  // transmit task of the role
+
+namespace
 {
+
+// Same CC1101 footprint as the detector board.
+constexpr asap::radio::RadioPins kRadioPins = {
+    .chipSelect = PB12,
+    .gdo0 = PB10,
+    .gdo2 = PB11,
+};
+
+// Zone profile: background radiation with bursts every half minute or so,
+// and now and then a short psy spike. Levels are ExposureEngine intensities.
+constexpr uint16_t kPeriodMs = 500;
+constexpr uint8_t kRadFloor = 24;
+
+asap::roles::AnomalyConfig zoneProfile()
+{
+  asap::roles::AnomalyConfig profile{asap::core::deviceId()};
+  profile.periodMs = kPeriodMs;
+  profile.intensity[0] = kRadFloor;
+  asap::game::BurstEnvelope& rad = profile.bursts[0];
+  rad.peakMin = 96;
+  rad.peakMax = 200;
+  rad.gapMinMs = 15000;
+  rad.gapMaxMs = 45000;
+  asap::game::BurstEnvelope& psy = profile.bursts[3];
+  psy.peakMin = 120;
+  psy.peakMax = 255;
+  psy.attackMs = 500;
+  psy.holdMs = 1000;
+  psy.decayMs = 1500;
+  psy.gapMinMs = 40000;
+  psy.gapMaxMs = 65000;
+  return profile;
 }
 
-void loop()
+asap::radio::Cc1101 emitterRadio(asap::radio::Cc1101Link::port());
+
+}  // namespace
+
+void asap::core::setupRole(Scheduler& scheduler)
 {
-  static uint32_t last = 0;
-  if (millis() - last > 1500)
-  {
-    last = millis();
-    // logging removed to save flash (USB CDC disabled)
+  static asap::roles::AnomalyRole anomaly(emitterRadio, zoneProfile());
+  asap::radio::Cc1101Link::begin(kRadioPins);
+  if (emitterRadio.begin()) {
+    static asap::radio::TdmaMac mac(deviceId());
+    asap::roles::EmitterRole& role = anomaly;
+    asap::radio::Cc1101Link::attach(emitterRadio, &asap::roles::EmitterRole::onRadioIrq, &role);
+    anomaly.begin(scheduler, &mac);
   }
 }
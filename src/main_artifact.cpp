@@ -1,15 +1,45 @@
 #include <Arduino.h>
 
-void setup()
+#include <asap/core/DeviceId.h>        // radio identity
+#include <asap/core/DeviceRole.h>      // setupRole() entry point
+#include <asap/power/StopClock.h>      // STOP mode between cycles
+#include <asap/radio/Cc1101Link.h>     // CC1101 on SPI2 + GDO interrupts
+#include <asap/roles/ArtifactEngine.h>  // fingerprinted ping cycles
+
+namespace
 {
-}
 
-void loop()
+// Same CC1101 footprint as the detector board.
+constexpr asap::radio::RadioPins kRadioPins = {
+    .chipSelect = PB12,
+    .gdo0 = PB10,
+    .gdo2 = PB11,
+};
+
+// Artifact class broadcast in every ping; with the ID it also selects the
+// timing fingerprint detectors recognize.
+constexpr uint16_t kSignature = 0xA001;
+
+// Hidden artifacts ping one cycle every two minutes instead of every five
+// seconds: rare to stumble upon, months on a battery.
+constexpr bool kHidden = false;
+
+asap::radio::Cc1101 emitterRadio(asap::radio::Cc1101Link::port());
+
+}  // namespace
+
+// Battery artifact: the radio sleeps between pings. The MCU waits for the
+// next cycle in STOP mode and for the pings within one in WFI.
+void asap::core::setupRole(Scheduler& scheduler)
 {
-  static uint32_t last = 0;
-  if (millis() - last > 3000)
-  {
-    last = millis();
-    // logging removed to save flash (USB CDC disabled)
+  asap::roles::ArtifactConfig config{deviceId(), kSignature};
+  config.hidden = kHidden;
+  static asap::roles::ArtifactEngine artifact(emitterRadio, config);
+  asap::radio::Cc1101Link::begin(kRadioPins);
+  if (emitterRadio.begin()) {
+    asap::radio::Cc1101Link::attach(emitterRadio);
+    scheduler.setClock(asap::power::stopModeClock(
+        [](void* engine) { return static_cast<asap::roles::ArtifactEngine*>(engine)->betweenCycles(); }, &artifact));
+    artifact.begin(scheduler);
   }
 }
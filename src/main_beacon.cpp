@@ -1,15 +1,36 @@
 #include <Arduino.h>
 
-void setup()
+#include <asap/core/DeviceId.h>      // radio identity
+#include <asap/core/DeviceRole.h>    // setupRole() entry point
+#include <asap/power/StopClock.h>    // STOP mode between bursts
+#include <asap/radio/Cc1101Link.h>   // CC1101 on SPI2 + GDO interrupts
+#include <asap/radio/TdmaMac.h>      // slotted medium access
+#include <asap/roles/BeaconEngine.h>  // duty-cycled beacon bursts
+
+namespace
 {
-}
 
-void loop()
+// Same CC1101 footprint as the detector board.
+constexpr asap::radio::RadioPins kRadioPins = {
+    .chipSelect = PB12,
+    .gdo0 = PB10,
+    .gdo2 = PB11,
+};
+
+asap::radio::Cc1101 emitterRadio(asap::radio::Cc1101Link::port());
+
+}  // namespace
+
+// Battery stake on the TDMA field: the radio sleeps between its slots (and
+// the sync beacon's) and the MCU waits for the next one in STOP mode.
+void asap::core::setupRole(Scheduler& scheduler)
 {
-  static uint32_t last = 0;
-  if (millis() - last > 2000)
-  {
-    last = millis();
-    // logging removed to save flash (USB CDC disabled)
+  static asap::roles::BeaconEngine beacon(emitterRadio, asap::roles::BeaconConfig{deviceId()});
+  asap::radio::Cc1101Link::begin(kRadioPins);
+  if (emitterRadio.begin()) {
+    asap::radio::Cc1101Link::attach(emitterRadio);
+    scheduler.setClock(asap::power::stopModeClock());
+    static asap::radio::TdmaMac mac(deviceId());
+    beacon.begin(scheduler, &mac);
   }
 }
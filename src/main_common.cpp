@@ -0,0 +1,23 @@
+#include <Arduino.h>  // core Arduino API for STM32 targets
+
+#include <asap/core/DeviceRole.h>  // per-role task registration
+#include <asap/core/Scheduler.h>   // tickless cooperative scheduler
+
+namespace
+{
+
+asap::core::Scheduler scheduler(asap::core::hardwareClock());  // shared main loop
+
+}  // namespace
+
+void setup()
+{
+  asap::core::setupRole(scheduler);
+}
+
+void loop()
+{
+  // Run due tasks (earliest deadline first), then WFI until the next
+  // deadline or interrupt.
+  scheduler.runOnce();
+}
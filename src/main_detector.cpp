@@ -1,11 +1,15 @@
 #include <Arduino.h>  // core Arduino API for STM32 targets
 
+#include <asap/core/DeviceRole.h>          // setupRole() entry point
 #include <asap/display/DetectorDisplay.h>  // SSD1322 display driver abstraction
-#include <asap/input/Joystick.h>          // JoyAction for debug page
-#include <asap/ui/UIController.h>         // UI state machine
+#include <asap/input/JoystickDriver.h>    // interrupt-fed joystick edges
+#include <asap/profile/Profiler.h>        // render probes (env:detector_profile)
+#include <asap/radio/Cc1101Link.h>        // CC1101 on SPI2 + GDO interrupts
+#include <asap/roles/DetectorRole.h>      // UI + radio tasks
 
 using asap::display::DetectorDisplay;
 using asap::display::DisplayPins;
+using asap::roles::DetectorRole;
 
 namespace
 {
@@ -17,34 +21,55 @@ constexpr DisplayPins kDisplayPins = {
     .reset = PA2,
 };
 
-constexpr uint32_t kHeartbeatIntervalMs = 250;  // refresh cadence for UI/serial
+// Five-way joystick switches (active low, to GND). PB12..PB15 belong to the
+// radio's SPI2.
+constexpr asap::input::JoystickPins kJoystickPins = {
+    .left = PA0,
+    .right = PA1,
+    .up = PB0,
+    .down = PB1,
+    .center = PA8,
+};
+
+// CC1101 module on SPI2 (PB13 SCK, PB14 MISO, PB15 MOSI).
+constexpr asap::radio::RadioPins kRadioPins = {
+    .chipSelect = PB12,
+    .gdo0 = PB10,
+    .gdo2 = PB11,
+};
 
 DetectorDisplay detectorDisplay(kDisplayPins);  // global display instance
-uint32_t lastHeartbeat = 0;                     // last time the heartbeat ran
-asap::ui::UIController ui(detectorDisplay);     // UI controller
+asap::radio::Cc1101 detectorRadio(asap::radio::Cc1101Link::port());
+DetectorRole detector(detectorDisplay, detectorRadio);
+
+#if ASAP_PROFILE
+// Render probe table on USART1 (PA9) every kProfileDumpMs.
+constexpr uint32_t kProfileDumpMs = 10000;
+
+void dumpProfile(void*, uint32_t)
+{
+  asap::profile::dumpToSerial();
+}
+#endif
 
 }  // namespace
 
-void setup()
+void asap::core::setupRole(Scheduler& scheduler)
 {
+#if ASAP_PROFILE
+  Serial.begin(115200);
+  asap::profile::begin();
+  scheduler.addPeriodic(kProfileDumpMs, &dumpProfile, nullptr, kProfileDumpMs);
+#endif
   if (detectorDisplay.begin()) {
     detectorDisplay.drawBootScreen(ASAP_VERSION);  // show boot splash
   } else {
     // no-op: logging disabled to save flash (USB CDC removed)
   }
-}
-
-void loop()
-{
-  const uint32_t now = millis();  // current uptime snapshot
-  if (now - lastHeartbeat >= kHeartbeatIntervalMs)
-  {
-    lastHeartbeat = now;
-    // heartbeat log removed (USB CDC disabled)
-
-    // TODO: Read actual joystick hardware states.
-    const bool centerDown = false;  // placeholder until hardware driver is wired
-    const asap::input::JoyAction action = asap::input::JoyAction::Neutral;
-    ui.onTick(now, {centerDown, action});
+  detector.begin(scheduler);
+  asap::input::JoystickDriver::begin(kJoystickPins, detector.joyEvents(), &DetectorRole::onJoystickEdge, &detector);
+  asap::radio::Cc1101Link::begin(kRadioPins);
+  if (detectorRadio.begin()) {
+    asap::radio::Cc1101Link::attach(detectorRadio, &DetectorRole::onRadioIrq, &detector);
   }
 }
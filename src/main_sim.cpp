@@ -0,0 +1,253 @@
+// Host-side RF world simulator (env:sim). Runs every device role's firmware
+// logic on virtual radios and prints channel statistics per run, e.g.
+//
+//   asap_sim --beacons 40 --anomalies 12 --detectors 30 --minutes 30 --runs 8
+//   asap_sim --detectors 4 --hud hud.csv
+//   asap_sim --tdma 1 --slot-ms 8 --slots 61
+//   asap_sim --tdma 1 --duty 1 --minutes 60
+//   asap_sim --sweep 1
+//   asap_sim --fingerprint 1 --hidden 1 --decoys 4 --minutes 30
+//
+// Runs differ only in their seed (seed, seed + 1, ...) and are spread over
+// all cores; the output does not depend on the thread count. --sweep
+// compares free-running emitters with the TDMA MAC at 10, 50 and 200
+// transmitters instead. --duty runs the beacons as battery stakes, the
+// image the beacon boards are built with (slotted under --tdma), and adds
+// their duty cycle, airtime and current draw per run. --fingerprint runs the
+// artifacts as fingerprinted images (--hidden: one cycle every two minutes)
+// next to --decoys plain artifact roles, and adds how often detectors missed
+// an artifact they could hear or recognized a decoy.
+
+#include <cstdio>   // report output
+#include <cstdlib>  // strtoul / strtof
+#include <cstring>  // option parsing
+#include <vector>
+
+#include <asap/sim/World.h>
+
+namespace
+{
+
+void usage()
+{
+  std::printf(
+      "usage: asap_sim [--beacons N] [--anomalies N] [--artifacts N] [--detectors N]\n"
+      "                [--area M] [--minutes M] [--seed S] [--runs R] [--threads T]\n"
+      "                [--exponent X] [--shadowing DB] [--hud FILE.csv]\n"
+      "                [--tdma 0|1] [--slot-ms MS] [--slots N] [--sweep 0|1]\n"
+      "                [--duty 0|1] [--fingerprint 0|1] [--hidden 0|1] [--decoys N]\n");
+}
+
+// Collision probability per packet, ALOHA against TDMA, for 10/50/200
+// emitters (70 % beacons, 20 % anomalies, 10 % artifacts). 200 emitters at
+// the default rates need more slots than the superframe has, so the last
+// point runs them on a 251-slot superframe with every emitter (free-running
+// ones too) sending once per superframe, artifacts every third.
+int sweep(const asap::sim::WorldConfig& base, unsigned runs, unsigned threads)
+{
+  struct Point
+  {
+    uint16_t emitters;
+    asap::radio::SuperframeConfig superframe;
+    bool ownPeriods;  // emitter periods follow the superframe
+  };
+  asap::radio::SuperframeConfig wide = base.superframe;
+  wide.slotMs = 7;
+  wide.dataSlots = 251;
+  const Point points[] = {{10, base.superframe, false},
+                          {50, base.superframe, false},
+                          {200, base.superframe, false},
+                          {200, wide, true}};
+  std::vector<asap::sim::WorldConfig> configs;
+  for (const Point& point : points)
+  {
+    for (int tdma = 0; tdma < 2; ++tdma)
+    {
+      for (unsigned r = 0; r < runs; ++r)
+      {
+        asap::sim::WorldConfig config = base;
+        config.beacons = static_cast<uint16_t>(point.emitters * 7 / 10);
+        config.anomalies = static_cast<uint16_t>(point.emitters * 2 / 10);
+        config.artifacts = static_cast<uint16_t>(point.emitters - config.beacons - config.anomalies);
+        config.superframe = point.superframe;
+        if (point.ownPeriods)
+        {
+          const uint16_t frameMs = static_cast<uint16_t>((1 + point.superframe.dataSlots) * point.superframe.slotMs);
+          config.beaconPeriodMs = frameMs;
+          config.anomalyPeriodMs = frameMs;
+          config.artifactPeriodMs = static_cast<uint16_t>(3 * frameMs);
+        }
+        config.tdma = tdma != 0;
+        config.seed = base.seed + r;
+        config.hudSampleMs = 0;
+        configs.push_back(config);
+      }
+    }
+  }
+  const asap::sim::WorldRunner runner(threads);
+  const std::vector<asap::sim::WorldReport> reports = runner.run(configs);
+
+  std::printf("%lu s, %u runs per point\n", static_cast<unsigned long>(base.durationMs / 1000), runs);
+  std::printf("%-6s %12s %14s %14s %14s %14s\n", "tx", "superframe", "aloha p(coll)", "tdma p(coll)",
+              "aloha deliv", "tdma deliv");
+  size_t at = 0;
+  for (const Point& point : points)
+  {
+    double collision[2] = {0.0, 0.0};
+    double delivery[2] = {0.0, 0.0};
+    for (int tdma = 0; tdma < 2; ++tdma)
+    {
+      for (unsigned r = 0; r < runs; ++r, ++at)
+      {
+        collision[tdma] += reports[at].collisionProbability() / runs;
+        delivery[tdma] += reports[at].deliveryRatio() / runs;
+      }
+    }
+    char shape[16];
+    std::snprintf(shape, sizeof(shape), "%ux%u ms", 1 + point.superframe.dataSlots, point.superframe.slotMs);
+    std::printf("%-6u %12s %13.2f%% %13.2f%% %13.2f%% %13.2f%%\n", point.emitters, shape, 100.0 * collision[0],
+                100.0 * collision[1], 100.0 * delivery[0], 100.0 * delivery[1]);
+  }
+  return 0;
+}
+
+bool writeHud(const char* path, const std::vector<asap::sim::WorldReport>& reports)
+{
+  std::FILE* out = std::fopen(path, "w");
+  if (!out)
+  {
+    return false;
+  }
+  std::fprintf(out,
+               "seed,time_ms,detector,tracking_id,tracking_rssi_dbm,beacons,anomalies,artifacts,"
+               "rad_pct,rad_stage,therm_pct,therm_stage,chem_pct,chem_stage,psy_pct,psy_stage\n");
+  for (const asap::sim::WorldReport& report : reports)
+  {
+    for (const asap::sim::HudSample& s : report.hud)
+    {
+      std::fprintf(out, "%llu,%lu,%u,%u,%d,%lu,%lu,%lu", static_cast<unsigned long long>(report.seed),
+                   static_cast<unsigned long>(s.timeMs), s.detector, s.trackingId, s.trackingRssiDbm,
+                   static_cast<unsigned long>(s.beacons), static_cast<unsigned long>(s.anomalies),
+                   static_cast<unsigned long>(s.artifacts));
+      for (uint8_t c = 0; c < asap::game::kChannelCount; ++c)
+      {
+        std::fprintf(out, ",%u,%u", s.exposure.percent[c], s.exposure.stage[c]);
+      }
+      std::fputc('\n', out);
+    }
+  }
+  return std::fclose(out) == 0;
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+  asap::sim::WorldConfig base;
+  unsigned runs = 4;
+  unsigned threads = 0;
+  const char* hudPath = nullptr;
+  bool sweepMode = false;
+
+  for (int i = 1; i < argc; ++i)
+  {
+    const char* opt = argv[i];
+    const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+    if (!value || std::strncmp(opt, "--", 2) != 0)
+    {
+      usage();
+      return 2;
+    }
+    ++i;
+    const unsigned long n = std::strtoul(value, nullptr, 10);
+    if (!std::strcmp(opt, "--beacons")) base.beacons = static_cast<uint16_t>(n);
+    else if (!std::strcmp(opt, "--anomalies")) base.anomalies = static_cast<uint16_t>(n);
+    else if (!std::strcmp(opt, "--artifacts")) base.artifacts = static_cast<uint16_t>(n);
+    else if (!std::strcmp(opt, "--detectors")) base.detectors = static_cast<uint16_t>(n);
+    else if (!std::strcmp(opt, "--area")) base.areaM = std::strtof(value, nullptr);
+    else if (!std::strcmp(opt, "--minutes")) base.durationMs = static_cast<uint32_t>(n * 60000UL);
+    else if (!std::strcmp(opt, "--seed")) base.seed = n;
+    else if (!std::strcmp(opt, "--runs")) runs = static_cast<unsigned>(n ? n : 1);
+    else if (!std::strcmp(opt, "--threads")) threads = static_cast<unsigned>(n);
+    else if (!std::strcmp(opt, "--exponent")) base.pathLoss.exponent = std::strtof(value, nullptr);
+    else if (!std::strcmp(opt, "--shadowing")) base.pathLoss.shadowingDb = std::strtof(value, nullptr);
+    else if (!std::strcmp(opt, "--hud")) hudPath = value;
+    else if (!std::strcmp(opt, "--tdma")) base.tdma = n != 0;
+    else if (!std::strcmp(opt, "--slot-ms")) base.superframe.slotMs = static_cast<uint8_t>(n);
+    else if (!std::strcmp(opt, "--slots")) base.superframe.dataSlots = static_cast<uint8_t>(n);
+    else if (!std::strcmp(opt, "--sweep")) sweepMode = n != 0;
+    else if (!std::strcmp(opt, "--duty")) base.dutyCycledBeacons = n != 0;
+    else if (!std::strcmp(opt, "--fingerprint")) base.fingerprintedArtifacts = n != 0;
+    else if (!std::strcmp(opt, "--hidden")) base.hiddenArtifacts = n != 0;
+    else if (!std::strcmp(opt, "--decoys")) base.decoyArtifacts = static_cast<uint16_t>(n);
+    else
+    {
+      usage();
+      return 2;
+    }
+  }
+  if (sweepMode)
+  {
+    return sweep(base, runs, threads);
+  }
+  if (!hudPath)
+  {
+    base.hudSampleMs = 0;
+  }
+
+  std::vector<asap::sim::WorldConfig> configs(runs, base);
+  for (unsigned r = 0; r < runs; ++r)
+  {
+    configs[r].seed = base.seed + r;
+  }
+  const asap::sim::WorldRunner runner(threads);
+  const std::vector<asap::sim::WorldReport> reports = runner.run(configs);
+
+  std::printf("%u beacons, %u anomalies, %u artifacts, %u detectors on %.0f m x %.0f m, %lu s, %u runs on %u threads\n",
+              base.beacons, base.anomalies, base.artifacts, base.detectors, base.areaM, base.areaM,
+              static_cast<unsigned long>(base.durationMs / 1000), runs, runner.threads());
+  std::printf("%-6s %8s %8s %9s %9s %9s %8s %7s %9s\n", "seed", "tx", "overlap", "in-range", "delivery",
+              "collision", "deferred", "synced", "speedup");
+  double delivery = 0.0;
+  double collision = 0.0;
+  for (const asap::sim::WorldReport& r : reports)
+  {
+    std::printf("%-6llu %8lu %8lu %9llu %8.2f%% %8.2f%% %8lu %3u/%-3u %8.0fx\n",
+                static_cast<unsigned long long>(r.seed), static_cast<unsigned long>(r.transmissions),
+                static_cast<unsigned long>(r.overlapped), static_cast<unsigned long long>(r.inRange()),
+                100.0 * r.deliveryRatio(), 100.0 * r.collisionRate(), static_cast<unsigned long>(r.deferred),
+                r.syncedEmitters, r.emitters, r.speedup());
+    delivery += r.deliveryRatio();
+    collision += r.collisionRate();
+  }
+  std::printf("mean delivery %.2f%%, mean collision rate %.2f%%\n", 100.0 * delivery / runs, 100.0 * collision / runs);
+  if (base.dutyCycledBeacons)
+  {
+    std::printf("%-6s %10s %12s %10s %10s\n", "seed", "duty", "airtime/h", "mAh/h", "days@1Ah");
+    for (const asap::sim::WorldReport& r : reports)
+    {
+      std::printf("%-6llu %9.3f%% %9lu ms %10.3f %10.0f\n", static_cast<unsigned long long>(r.seed),
+                  r.beaconDutyPpm / 10000.0, static_cast<unsigned long>(r.beaconAirtimeMsPerHour),
+                  r.beaconAverageUa / 1000.0, r.beaconAverageUa ? 1000000.0 / r.beaconAverageUa / 24.0 : 0.0);
+    }
+  }
+  if (base.fingerprintedArtifacts)
+  {
+    std::printf("%-6s %8s %8s %8s %8s %10s %10s %10s\n", "seed", "pairs", "false-", "decoys", "false+",
+                "recognize", "mismatch", "mAh/h");
+    for (const asap::sim::WorldReport& r : reports)
+    {
+      std::printf("%-6llu %8lu %7.2f%% %8lu %7.2f%% %8.1f s %10llu %10.3f\n", static_cast<unsigned long long>(r.seed),
+                  static_cast<unsigned long>(r.artifactPairs), 100.0 * r.falseNegativeRate(),
+                  static_cast<unsigned long>(r.decoyPairs), 100.0 * r.falsePositiveRate(), r.meanRecognizeMs() / 1000.0,
+                  static_cast<unsigned long long>(r.correlatorMismatches), r.artifactAverageUa / 1000.0);
+    }
+  }
+
+  if (hudPath && !writeHud(hudPath, reports))
+  {
+    std::fprintf(stderr, "cannot write %s\n", hudPath);
+    return 1;
+  }
+  return 0;
+}
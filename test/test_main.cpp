@@ -3,9 +3,16 @@
 #include <stdint.h>  // fixed-width integer helpers for uptime math
 #ifndef ARDUINO
 #include <cstdio>      // std::remove for snapshot cleanup
+#include <cstring>     // std::memcpy for frame buffer comparisons
 #include <filesystem>  // snapshot directory management
 #include <fstream>     // std::ifstream to inspect exported images
+#include <iterator>    // std::istreambuf_iterator for whole-file reads
 #include <string>      // parse PGM header tokens
+#include <chrono>      // micro-benchmarks on the host
+#include <cmath>       // RMS of filter errors
+#include <vector>      // generated RSSI traces
+#include <thread>      // per-thread profiling tables
+#include <U8g2lib.h>   // raw U8G2 canvas for renderer primitive tests
 
 namespace
 {
@@ -40,8 +47,31 @@ int& SnapCounter() {
 }  // namespace
 #endif
 #include <asap/display/DetectorDisplay.h>  // display driver under test
+#include <asap/display/DisplayRenderer.h>  // shared renderer primitives
+#include <asap/display/DrawCost.h>         // per-frame draw cost budgets
+#include <asap/display/PackedFrame.h>      // packed 1 bpp frames for hashing
 #include <asap/input/Joystick.h>
+#include <asap/input/JoystickDriver.h>  // debouncer + scripted joystick
 #include <asap/ui/UIController.h>
+#include <asap/snapshot/SnapshotComparator.h>  // golden hash checks
+#include <asap/snapshot/SnapshotRunner.h>      // parallel snapshot cases
+#include <asap/core/Scheduler.h>               // cooperative scheduler + virtual clock
+#include <asap/radio/VirtualRadio.h>            // CC1101 driver on simulated chips
+#include <asap/radio/TdmaMac.h>                 // slotted medium access
+#include <asap/proto/Messages.h>                // over-the-air schemas, encoders, views
+#include <asap/sim/World.h>                     // multi-device RF world
+#include <asap/track/TrackingTable.h>           // detector's emitter table
+#include <asap/track/RssiFilter.h>              // fixed-point RSSI filters
+#include <asap/game/EmissionEngine.h>           // anomaly burst patterns
+#include <asap/game/ExposureEngine.h>           // anomaly dose model
+#include <asap/roles/BeaconEngine.h>            // duty-cycled beacon image
+#include <asap/roles/ArtifactEngine.h>          // fingerprinted artifact image
+#include <asap/roles/DetectorRole.h>            // detector tasks on a virtual radio
+#include <asap/game/ArtifactFingerprint.h>      // detector-side correlator
+#include <asap/profile/Profiler.h>              // render probes
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>  // __rdtsc for cycles per sample
+#endif
 
 using asap::display::DetectorDisplay;
 using asap::display::DisplayFrame;
@@ -54,6 +84,44 @@ constexpr DisplayPins kDummyPins{0, 0, 0};  // unused pins for the native mock
 }  // namespace
 
 #ifndef ARDUINO
+// Golden snapshots live next to their PGMs in snapshots/manifest.txt.
+asap::snapshot::SnapshotComparator& Goldens()
+{
+  static asap::snapshot::SnapshotComparator comparator(SnapshotsDir());
+  return comparator;
+}
+
+// Draw cost gate: the frame behind a snapshot must stay within the budget of
+// its kind (DrawCost.cpp).
+void CheckDrawBudget(const char* filename, FrameKind kind,
+                     const asap::display::DrawCost& cost, uint8_t pages)
+{
+  if (!asap::display::withinDrawBudget(cost, kind, pages))
+  {
+    const asap::display::DrawBudget budget = asap::display::drawBudgetFor(kind);
+    char msg[160];
+    std::snprintf(msg, sizeof(msg), "%s: %lu px / %lu cyc over budget %lu px / %lu cyc (kind %u, %u pages)",
+                  filename, static_cast<unsigned long>(cost.drawnPixels()),
+                  static_cast<unsigned long>(asap::display::estimateCycles(cost)),
+                  static_cast<unsigned long>(budget.maxDrawnPixels) * pages,
+                  static_cast<unsigned long>(budget.maxCycles) * pages,
+                  static_cast<unsigned>(kind), static_cast<unsigned>(pages));
+    TEST_FAIL_MESSAGE(msg);
+  }
+}
+
+// Compare the current frame with its golden hash; on failure the actual and
+// diff images land in snapshots/_diff. Every snapshot also gates draw cost.
+void CheckSnapshot(DetectorDisplay& display, const char* filename)
+{
+  const asap::snapshot::SnapshotResult result = Goldens().check(filename, display.frameBuffer());
+  if (!result.ok())
+  {
+    TEST_FAIL_MESSAGE(asap::snapshot::describe(filename, result).c_str());
+  }
+  CheckDrawBudget(filename, display.lastFrameKind(), display.lastFrameCost(), display.pagesPerFrame());
+}
+
 // Snapshot helper defined after DetectorDisplay is visible.
 // Use short action mnemonics: longpress, up, down, left, right, click, neutral.
 void SaveActionSnapshot(DetectorDisplay& display, const char* action)
@@ -62,9 +130,7 @@ void SaveActionSnapshot(DetectorDisplay& display, const char* action)
   ++c;
   char fname[64];
   std::snprintf(fname, sizeof(fname), "%03d_%s.pgm", c, action);
-  const auto path = SnapshotPath(fname);
-  RemoveIfExists(path);
-  TEST_ASSERT_TRUE(display.writeSnapshot(path.string().c_str()));
+  CheckSnapshot(display, fname);
 }
 #endif
 
@@ -152,11 +218,12 @@ void test_snapshot_export_creates_pgm(void)
 
   display.drawBootScreen("0.1.0");
 
-  const auto bootPath = SnapshotPath("boot_screen.pgm");
-  RemoveIfExists(bootPath);
-  TEST_ASSERT_TRUE(display.writeSnapshot(bootPath.string().c_str()));
+  // Export format check on a scratch file; goldens are checked by hash.
+  const auto probePath = SnapshotPath("export_probe.pgm");
+  RemoveIfExists(probePath);
+  TEST_ASSERT_TRUE(display.writeSnapshot(probePath.string().c_str()));
 
-  std::ifstream in(bootPath, std::ios::binary);
+  std::ifstream in(probePath, std::ios::binary);
   TEST_ASSERT_TRUE(in.good());
 
   std::string magic;
@@ -175,53 +242,38 @@ void test_snapshot_export_creates_pgm(void)
 
   in.get();  // consume the single whitespace between header and data
   in.close();
+  RemoveIfExists(probePath);
 
-  // Native path does not expose raw buffer; rely on snapshot presence instead.
+  CheckSnapshot(display, "boot_screen.pgm");
 
   display.drawHeartbeatFrame(1750U);
-  const auto heartbeatPath = SnapshotPath("heartbeat_screen.pgm");
-  RemoveIfExists(heartbeatPath);
-  TEST_ASSERT_TRUE(display.writeSnapshot(heartbeatPath.string().c_str()));
+  CheckSnapshot(display, "heartbeat_screen.pgm");
 
   display.showStatus("RF LINK", "LOCKED");
-  const auto statusPath = SnapshotPath("status_rf_link.pgm");
-  RemoveIfExists(statusPath);
-  TEST_ASSERT_TRUE(display.writeSnapshot(statusPath.string().c_str()));
+  CheckSnapshot(display, "status_rf_link.pgm");
 
   // Joystick snapshots for LEFT/RIGHT/UP/DOWN/CLICK/NEUTRAL
   display.showJoystick(asap::input::JoyAction::Left);
-  const auto jsLeft = SnapshotPath("joystick_left.pgm");
-  RemoveIfExists(jsLeft);
-  TEST_ASSERT_TRUE(display.writeSnapshot(jsLeft.string().c_str()));
+  CheckSnapshot(display, "joystick_left.pgm");
 
   display.showJoystick(asap::input::JoyAction::Right);
-  const auto jsRight = SnapshotPath("joystick_right.pgm");
-  RemoveIfExists(jsRight);
-  TEST_ASSERT_TRUE(display.writeSnapshot(jsRight.string().c_str()));
+  CheckSnapshot(display, "joystick_right.pgm");
 
   display.showJoystick(asap::input::JoyAction::Up);
-  const auto jsUp = SnapshotPath("joystick_up.pgm");
-  RemoveIfExists(jsUp);
-  TEST_ASSERT_TRUE(display.writeSnapshot(jsUp.string().c_str()));
+  CheckSnapshot(display, "joystick_up.pgm");
 
   display.showJoystick(asap::input::JoyAction::Down);
-  const auto jsDown = SnapshotPath("joystick_down.pgm");
-  RemoveIfExists(jsDown);
-  TEST_ASSERT_TRUE(display.writeSnapshot(jsDown.string().c_str()));
+  CheckSnapshot(display, "joystick_down.pgm");
 
   // Click is an edge in hardware; for snapshot we render the word
   display.showJoystick(asap::input::JoyAction::Click);
-  const auto jsClick = SnapshotPath("joystick_click.pgm");
-  RemoveIfExists(jsClick);
-  TEST_ASSERT_TRUE(display.writeSnapshot(jsClick.string().c_str()));
+  CheckSnapshot(display, "joystick_click.pgm");
 
   display.showJoystick(asap::input::JoyAction::Neutral);
-  const auto jsNeutral = SnapshotPath("joystick_neutral.pgm");
-  RemoveIfExists(jsNeutral);
-  TEST_ASSERT_TRUE(display.writeSnapshot(jsNeutral.string().c_str()));
+  CheckSnapshot(display, "joystick_neutral.pgm");
 
-  // Confirm the boot snapshot is still present for manual inspection.
-  TEST_ASSERT_TRUE(std::ifstream(bootPath, std::ios::binary).good());
+  // Goldens stay on disk for manual inspection.
+  TEST_ASSERT_TRUE(std::ifstream(SnapshotPath("boot_screen.pgm"), std::ios::binary).good());
 }
 #endif  // ARDUINO
 
@@ -358,7 +410,3113 @@ void test_ui_menu_navigation_snapshots(void)
 }
 #endif  // ARDUINO
 
+#ifndef ARDUINO
+// Dirty tiles — first frame pushes the whole panel, a caret move only a few
+// tiles, and an identical frame nothing at all; the tile checksums catch a
+// single flipped pixel anywhere. Dirty tiles need the full buffer, so this
+// test pins the mode regardless of ASAP_DISPLAY_PAGE_TILES.
+void test_dirty_tiles_menu_caret_move(void)
+{
+  DetectorDisplay display(kDummyPins, asap::display::BufferMode::Full);
+  TEST_ASSERT_TRUE(display.begin());
+
+  display.renderCustom(asap::display::makeMenuRootFrame(0), FrameKind::Menu);
+  TEST_ASSERT_EQUAL_UINT16(256, display.lastDirtyTileCount());
+  TEST_ASSERT_EQUAL_UINT16(256, display.lastSentTileCount());
+
+  display.renderCustom(asap::display::makeMenuRootFrame(1), FrameKind::Menu);
+  TEST_ASSERT_TRUE(display.lastDirtyTileCount() > 0);
+  TEST_ASSERT_TRUE(display.lastDirtyTileCount() <= 8);
+  TEST_ASSERT_TRUE(display.lastSentTileCount() <= 8);
+  TEST_ASSERT_TRUE(display.lastTileSpanCount() <= 4);
+
+  display.renderCustom(asap::display::makeMenuRootFrame(1), FrameKind::Menu);
+  TEST_ASSERT_EQUAL_UINT16(0, display.lastDirtyTileCount());
+  TEST_ASSERT_EQUAL_UINT8(0, display.lastTileSpanCount());
+
+  using asap::display::kTileBufferBytes;
+  using asap::display::kTileBytes;
+  using asap::display::TileSpan;
+  static uint8_t buffer[kTileBufferBytes];
+  std::memcpy(buffer, display.frameBuffer(), kTileBufferBytes);
+  asap::display::DirtyTileTracker tracker;
+  TileSpan spans[asap::display::kTileRows];
+  tracker.collect(buffer, spans);
+  for (uint8_t bit = 0; bit < 8 * kTileBytes; ++bit)
+  {
+    for (uint16_t tile = 0; tile < kTileBufferBytes / kTileBytes; ++tile)
+    {
+      buffer[tile * kTileBytes + bit / 8] ^= static_cast<uint8_t>(1u << (bit % 8));
+    }
+    TEST_ASSERT_EQUAL_UINT8(asap::display::kTileRows, tracker.collect(buffer, spans));
+    TEST_ASSERT_EQUAL_UINT16(kTileBufferBytes / kTileBytes, tracker.lastDirtyTiles());
+  }
+  TEST_ASSERT_EQUAL_UINT8(0, tracker.collect(buffer, spans));
+}
+#endif  // ARDUINO
+
+#ifndef ARDUINO
+// Render skipping — idle HUD ticks do not even reach the display, and an
+// unchanged frame handed to it directly is not redrawn until the composed
+// content (or the rotation) changes.
+void test_render_skip_unchanged_frames(void)
+{
+  using asap::ui::UIController;
+  using asap::input::JoyAction;
+
+  DetectorDisplay display(kDummyPins);
+  TEST_ASSERT_TRUE(display.begin());
+  UIController ui(display);
+
+  ui.setAnomalyExposure(10, 20, 30, 40);
+  ui.onTick(0, {false, JoyAction::Neutral});
+  ui.onTick(250, {false, JoyAction::Neutral});
+  ui.onTick(500, {false, JoyAction::Neutral});
+  TEST_ASSERT_EQUAL_UINT32(1, display.renderedFrameCount());
+  TEST_ASSERT_EQUAL_UINT32(0, display.skippedFrameCount());
+
+  ui.setAnomalyExposure(11, 20, 30, 40);
+  ui.onTick(750, {false, JoyAction::Neutral});
+  TEST_ASSERT_EQUAL_UINT32(2, display.renderedFrameCount());
+
+  // Same frame content, but switching kind must not be skipped either.
+  const DisplayFrame menu = asap::display::makeMenuRootFrame(0);
+  display.renderCustom(menu, FrameKind::Menu);
+  display.renderCustom(menu, FrameKind::Menu);
+  TEST_ASSERT_EQUAL_UINT32(3, display.renderedFrameCount());
+  TEST_ASSERT_EQUAL_UINT32(1, display.skippedFrameCount());
+  TEST_ASSERT_EQUAL_UINT16(0, display.lastSentTileCount());
+
+  display.setRotation180(true);
+  display.renderCustom(menu, FrameKind::Menu);
+  TEST_ASSERT_EQUAL_UINT32(4, display.renderedFrameCount());
+}
+#endif  // ARDUINO
+
+#ifndef ARDUINO
+// Invalidation — onTick draws only after a visible change and reports when it
+// must run again without input (pending long-press, otherwise kMaxSleepMs).
+void test_ui_invalidation_and_wakeup(void)
+{
+  using asap::ui::UIController;
+  using asap::ui::State;
+  using asap::input::JoyAction;
+
+  DetectorDisplay display(kDummyPins);
+  TEST_ASSERT_TRUE(display.begin());
+  UIController ui(display);
+
+  ui.setAnomalyExposure(10, 20, 30, 40);
+  TEST_ASSERT_EQUAL_UINT32(UIController::kMaxSleepMs, ui.onTick(0, {false, JoyAction::Neutral}));
+  TEST_ASSERT_EQUAL_UINT32(1, display.renderedFrameCount());
+  TEST_ASSERT_FALSE(ui.needsRender());
+
+  // Unchanged values and data for pages not on screen leave the UI clean.
+  ui.setAnomalyExposure(10, 20, 30, 40);
+  ui.setAnomalyStage(0, 0, 0, 0);
+  ui.setTrackedEmitter(0, -60);
+  TEST_ASSERT_FALSE(ui.needsRender());
+  ui.setAnomalyStage(0, 1, 0, 0);
+  TEST_ASSERT_TRUE(ui.needsRender());
+  ui.onTick(250, {false, JoyAction::Neutral});
+  TEST_ASSERT_EQUAL_UINT32(2, display.renderedFrameCount());
+
+  // Holding center: wake exactly when the long-press fires, then draw the menu.
+  TEST_ASSERT_EQUAL_UINT32(2000 + 1000, ui.onTick(2000, {true, JoyAction::Neutral}));
+  TEST_ASSERT_EQUAL_UINT32(2, display.renderedFrameCount());
+  ui.onTick(3000, {true, JoyAction::Neutral});
+  TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(State::MenuRoot), static_cast<uint8_t>(ui.state()));
+  TEST_ASSERT_EQUAL_UINT32(3, display.renderedFrameCount());
+  ui.onTick(3100, {true, JoyAction::Neutral});
+  ui.onTick(3200, {false, JoyAction::Neutral});
+  TEST_ASSERT_EQUAL_UINT32(3, display.renderedFrameCount());
+
+  // Navigation invalidates; an action the page ignores does not.
+  ui.onTick(3300, {false, JoyAction::Down});
+  TEST_ASSERT_EQUAL_UINT32(4, display.renderedFrameCount());
+  ui.onTick(3400, {false, JoyAction::Left});
+  TEST_ASSERT_EQUAL_UINT32(4, display.renderedFrameCount());
+  TEST_ASSERT_EQUAL_UINT32(3500 + UIController::kMaxSleepMs, ui.onTick(3500, {false, JoyAction::Neutral}));
+
+  // External invalidation hands the frame to the display again (whose frame
+  // cache then finds it unchanged).
+  ui.invalidate();
+  ui.onTick(3600, {false, JoyAction::Neutral});
+  TEST_ASSERT_EQUAL_UINT32(4, display.renderedFrameCount());
+  TEST_ASSERT_EQUAL_UINT32(1, display.skippedFrameCount());
+
+  // On the tracking page, losing the tracked emitter redraws it without a
+  // reading; losing it again changes nothing.
+  ui.onTick(3700, {false, JoyAction::Click});
+  ui.onTick(3800, {false, JoyAction::Click});
+  TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(State::MainTracking), static_cast<uint8_t>(ui.state()));
+  ui.setTrackedEmitter(300, -70);
+  TEST_ASSERT_TRUE(ui.needsRender());
+  ui.onTick(3900, {false, JoyAction::Neutral});
+  TEST_ASSERT_EQUAL_STRING("RSSI -70dBm", display.lastFrame().lines[1].text);
+  ui.clearTrackedEmitter();
+  TEST_ASSERT_TRUE(ui.needsRender());
+  ui.onTick(4000, {false, JoyAction::Neutral});
+  TEST_ASSERT_EQUAL_STRING("TRACK 0", display.lastFrame().lines[0].text);
+  TEST_ASSERT_EQUAL_STRING("RSSI -100dBm", display.lastFrame().lines[1].text);
+  ui.clearTrackedEmitter();
+  TEST_ASSERT_FALSE(ui.needsRender());
+}
+#endif  // ARDUINO
+
+#ifndef ARDUINO
+// Interrupt-fed joystick — the debouncer turns bouncy scripted switch levels
+// into single timestamped edges while sampling at the idle rate between
+// them, and the UI applies them at their edge times however rarely it is
+// woken.
+void test_joystick_event_queue_drives_ui(void)
+{
+  using asap::input::JoyAction;
+  using asap::input::JoyEvent;
+  using asap::input::JoyEventQueue;
+  using asap::input::JoystickDebouncer;
+  using asap::input::ScriptedJoystick;
+  using asap::input::kSwitchCenter;
+  using asap::input::kSwitchDown;
+  using asap::input::kSwitchUp;
+  using asap::ui::UIController;
+  using asap::ui::State;
+
+  // Debouncing: chatter yields one edge; a 3 ms glitch yields none.
+  {
+    JoyEventQueue q;
+    ScriptedJoystick js(q);
+    js.press(kSwitchUp, 100, 40, /*bounceMs=*/4);
+    js.press(kSwitchDown, 300, 3);
+    js.advanceTo(400);
+    JoyEvent e{};
+    TEST_ASSERT_EQUAL_UINT8(1, q.size());
+    TEST_ASSERT_TRUE(q.pop(e));
+    TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(JoyAction::Up), static_cast<uint8_t>(e.action));
+    TEST_ASSERT_TRUE(e.timeMs >= 96 && e.timeMs <= 100);
+    TEST_ASSERT_FALSE(e.centerDown);
+    TEST_ASSERT_EQUAL_UINT8(0, js.debouncer().stableMask());
+    // Only the edges are sampled every ms, the rest at the idle rate: under a
+    // fifth of the 401 wakeups of a free-running 1 kHz timer.
+    TEST_ASSERT_TRUE(js.debouncer().idle());
+    TEST_ASSERT_TRUE(js.samples() * 5 < 401);
+    TEST_ASSERT_TRUE(js.samples() > 400 / JoystickDebouncer::kIdleSampleMs);
+  }
+
+  // Overflow drops (and counts) instead of overwriting unread edges.
+  {
+    JoyEventQueue q;
+    for (uint8_t i = 0; i <= JoyEventQueue::kCapacity; ++i)
+    {
+      q.push(JoyEvent{i, JoyAction::Down, false});
+    }
+    TEST_ASSERT_EQUAL_UINT8(JoyEventQueue::kCapacity, q.size());
+    TEST_ASSERT_EQUAL_UINT32(1, q.droppedCount());
+    JoyEvent e{};
+    TEST_ASSERT_TRUE(q.pop(e));
+    TEST_ASSERT_EQUAL_UINT32(0, e.timeMs);
+  }
+
+  DetectorDisplay display(kDummyPins);
+  TEST_ASSERT_TRUE(display.begin());
+  UIController ui(display);
+  JoyEventQueue q;
+  ScriptedJoystick js(q);
+
+  // Hold center from 1000 to 2200 ms. Woken at 1500, the UI asks to run again
+  // exactly when the long-press matures (edge time + 1000 ms).
+  js.press(kSwitchCenter, 1000, 1200, /*bounceMs=*/2);
+  js.advanceTo(1500);
+  const uint32_t wake = ui.onInput(q, 1500);
+  TEST_ASSERT_TRUE(wake >= 1998 && wake <= 2000);
+  TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(State::MainAnomaly), static_cast<uint8_t>(ui.state()));
+
+  // Not woken again until after the release: the long-press still fires, and
+  // the Click produced by the release does not enter the selected child.
+  js.advanceTo(2600);
+  ui.onInput(q, 2600);
+  TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(State::MenuRoot), static_cast<uint8_t>(ui.state()));
+
+  // A 20 ms flick and a short click between two wakeups are both applied.
+  js.press(kSwitchDown, 2700, 20);
+  js.press(kSwitchCenter, 2800, 60);
+  js.advanceTo(3000);
+  TEST_ASSERT_EQUAL_UINT8(3, q.size());  // Down, center press, Click on release
+  ui.onInput(q, 3000);
+  TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(State::MenuTracking), static_cast<uint8_t>(ui.state()));
+  TEST_ASSERT_EQUAL_UINT32(0, q.droppedCount());
+}
+#endif  // ARDUINO
+
+#ifndef ARDUINO
+namespace
+{
+std::string ReadFileBytes(const std::filesystem::path& path)
+{
+  std::ifstream in(path, std::ios::binary);
+  return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+}  // namespace
+
+// Page-buffer parity — the paged renderer must produce the same frame and
+// snapshot bytes as the full-buffer renderer for menus, HUDs and rotation.
+void test_page_buffer_modes_match_full_buffer(void)
+{
+  using asap::display::BufferMode;
+  using asap::display::kTileBufferBytes;
+
+  const BufferMode modes[3] = {BufferMode::Full, BufferMode::Page1, BufferMode::Page2};
+  const char* names[3] = {"parity_full.pgm", "parity_page1.pgm", "parity_page2.pgm"};
+  std::string snapshots[3];
+  uint8_t frames[3][2][kTileBufferBytes];
+
+  for (uint8_t m = 0; m < 3; ++m)
+  {
+    DetectorDisplay display(kDummyPins, modes[m]);
+    TEST_ASSERT_TRUE(display.begin());
+
+    display.renderCustom(asap::display::makeMenuRootFrame(2), FrameKind::Menu);
+    std::memcpy(frames[m][0], display.frameBuffer(), kTileBufferBytes);
+
+    display.setRotation180(true);
+    display.drawAnomalyIndicators(25, 50, 75, 100, 0, 1, 2, 3);
+    std::memcpy(frames[m][1], display.frameBuffer(), kTileBufferBytes);
+
+    const auto path = SnapshotPath(names[m]);
+    RemoveIfExists(path);
+    TEST_ASSERT_TRUE(display.writeSnapshot(path.string().c_str()));
+    snapshots[m] = ReadFileBytes(path);
+    RemoveIfExists(path);
+  }
+
+  for (uint8_t m = 1; m < 3; ++m)
+  {
+    TEST_ASSERT_EQUAL_MEMORY(frames[0][0], frames[m][0], kTileBufferBytes);
+    TEST_ASSERT_EQUAL_MEMORY(frames[0][1], frames[m][1], kTileBufferBytes);
+    TEST_ASSERT_TRUE(snapshots[0] == snapshots[m]);
+  }
+  TEST_ASSERT_TRUE(!snapshots[0].empty());
+}
+#endif  // ARDUINO
+
+#ifndef ARDUINO
+namespace
+{
+// Standalone SSD1322 full-buffer canvas for exercising renderer primitives.
+void SetupRawCanvas(asap::display::U8g2Canvas& u8g2)
+{
+  u8g2_Setup_ssd1322_nhd_256x64_f(u8g2.getU8g2(), U8G2_R0,
+                                   u8x8_byte_arduino_hw_spi,
+                                   u8x8_gpio_and_delay_arduino);
+  u8g2.begin();
+  u8g2.setDrawColor(1);
+}
+}  // namespace
+
+// Arc span table — the precomputed HUD ring must match the LUT rasterizer
+// pixel for pixel at every percent; also reports the speedup.
+void test_arc_table_matches_reference(void)
+{
+  using asap::display::kTileBufferBytes;
+  asap::display::U8g2Canvas u8g2;
+  SetupRawCanvas(u8g2);
+
+  static uint8_t reference[kTileBufferBytes];
+  for (uint8_t pc = 0; pc <= 101; ++pc)
+  {
+    u8g2.clearBuffer();
+    asap::display::drawArcReferenceU8g2(u8g2, 96, 23, 21, 3, pc);
+    std::memcpy(reference, u8g2.getBufferPtr(), kTileBufferBytes);
+
+    u8g2.clearBuffer();
+    asap::display::drawArcU8g2(u8g2, 96, 23, 21, 3, pc);
+    TEST_ASSERT_EQUAL_MEMORY(reference, u8g2.getBufferPtr(), kTileBufferBytes);
+  }
+
+  constexpr int kRounds = 200;
+  using Clock = std::chrono::steady_clock;
+  const auto t0 = Clock::now();
+  for (int round = 0; round < kRounds; ++round)
+  {
+    for (uint8_t pc = 0; pc <= 100; ++pc)
+    {
+      asap::display::drawArcReferenceU8g2(u8g2, 96, 23, 21, 3, pc);
+    }
+  }
+  const auto t1 = Clock::now();
+  for (int round = 0; round < kRounds; ++round)
+  {
+    for (uint8_t pc = 0; pc <= 100; ++pc)
+    {
+      asap::display::drawArcU8g2(u8g2, 96, 23, 21, 3, pc);
+    }
+  }
+  const auto t2 = Clock::now();
+  const double refUs = std::chrono::duration<double, std::micro>(t1 - t0).count();
+  const double tabUs = std::chrono::duration<double, std::micro>(t2 - t1).count();
+  char msg[128];
+  std::snprintf(msg, sizeof(msg), "arc bench: reference %.0f us, table %.0f us (x%.2f, %u px)",
+                refUs, tabUs, tabUs > 0 ? refUs / tabUs : 0.0,
+                static_cast<unsigned>(asap::display::HudArcTable::kCount));
+  TEST_MESSAGE(msg);
+}
+#endif  // ARDUINO
+
+#ifndef ARDUINO
+// Draw cost accounting — the instrumented canvas counts exactly what the HUD
+// asks U8g2 for, an incremental update costs a fraction of a redraw, page
+// modes repeat the calls per page and the budget gate trips on a frame that
+// outgrows its kind.
+void test_draw_cost_budgets(void)
+{
+  using asap::display::arcStepsForPercent;
+  using asap::display::BufferMode;
+  using asap::display::DrawCost;
+  using asap::display::DrawPrimitive;
+  using asap::display::estimateCycles;
+  using asap::display::kHudArc;
+  using asap::display::withinDrawBudget;
+
+  DetectorDisplay display(kDummyPins, BufferMode::Full);
+  display.drawAnomalyIndicators(100, 100, 100, 100, 1, 2, 3, 0);
+  const DrawCost full = display.lastFrameCost();
+  TEST_ASSERT_EQUAL_UINT32(1, full.callsOf(DrawPrimitive::Clear));
+  TEST_ASSERT_EQUAL_UINT32(256U * 64U, full.unitsOf(DrawPrimitive::Clear));
+  TEST_ASSERT_EQUAL_UINT32(4, full.callsOf(DrawPrimitive::Xbmp));
+  TEST_ASSERT_EQUAL_UINT32(4U * 30U * 30U, full.unitsOf(DrawPrimitive::Xbmp));  // 30x30 icons
+  TEST_ASSERT_EQUAL_UINT32(4U * kHudArc.end[arcStepsForPercent(100)], full.callsOf(DrawPrimitive::Pixel));
+  TEST_ASSERT_EQUAL_UINT32(4, full.callsOf(DrawPrimitive::Str));
+  TEST_ASSERT_EQUAL_UINT32(4, full.callsOf(DrawPrimitive::StrWidth));
+  TEST_ASSERT_EQUAL_UINT32(1 + 2 + 3 + 1, full.unitsOf(DrawPrimitive::StrWidth));  // "I" "II" "III" "-"
+  TEST_ASSERT_EQUAL_UINT32(0, full.callsOf(DrawPrimitive::Box));
+  TEST_ASSERT_TRUE(withinDrawBudget(full, FrameKind::MainAnomaly));
+  // The same draw calls are far beyond what a status screen may cost.
+  TEST_ASSERT_FALSE(withinDrawBudget(full, FrameKind::Status));
+
+  // One ring shrinking: only the erased arc pixels, no clear, no icons.
+  display.drawAnomalyIndicators(90, 100, 100, 100, 1, 2, 3, 0);
+  const DrawCost step = display.lastFrameCost();
+#if ASAP_DISPLAY_INCREMENTAL_HUD
+  TEST_ASSERT_EQUAL_UINT32(0, step.callsOf(DrawPrimitive::Clear));
+  TEST_ASSERT_EQUAL_UINT32(0, step.callsOf(DrawPrimitive::Xbmp));
+  TEST_ASSERT_EQUAL_UINT32(kHudArc.end[arcStepsForPercent(100)] - kHudArc.end[arcStepsForPercent(90)],
+                           step.callsOf(DrawPrimitive::Pixel));
+  TEST_ASSERT_TRUE(estimateCycles(step) * 10 < estimateCycles(full));
+#endif
+
+  // An unchanged frame is skipped and costs nothing.
+  display.drawAnomalyIndicators(90, 100, 100, 100, 1, 2, 3, 0);
+  TEST_ASSERT_EQUAL_UINT32(0, display.lastFrameCost().totalCalls());
+
+  // Page modes draw everything once per page (firstPage() clears instead of
+  // clearBuffer()).
+  DetectorDisplay paged(kDummyPins, BufferMode::Page1);
+  paged.drawAnomalyIndicators(100, 100, 100, 100, 1, 2, 3, 0);
+  const DrawCost pages = paged.lastFrameCost();
+  TEST_ASSERT_EQUAL_UINT8(8, paged.pagesPerFrame());
+  TEST_ASSERT_EQUAL_UINT32(8U * full.callsOf(DrawPrimitive::Xbmp), pages.callsOf(DrawPrimitive::Xbmp));
+  TEST_ASSERT_EQUAL_UINT32(8U * full.callsOf(DrawPrimitive::Pixel), pages.callsOf(DrawPrimitive::Pixel));
+  TEST_ASSERT_TRUE(withinDrawBudget(pages, FrameKind::MainAnomaly, paged.pagesPerFrame()));
+
+  // The cycle model is linear: calls * perCall + units * per256Units / 256.
+  DrawCost box{};
+  box.add(DrawPrimitive::Box, 512);
+  const asap::display::DrawCalibration& cal =
+      asap::display::kStm32DrawCalibration[static_cast<uint8_t>(DrawPrimitive::Box)];
+  TEST_ASSERT_EQUAL_UINT32(cal.perCall + 2U * cal.per256Units, estimateCycles(box));
+
+  char msg[160];
+  std::snprintf(msg, sizeof(msg), "draw cost: HUD redraw %lu px ~%lu cyc, one ring step %lu px ~%lu cyc, paged x8 ~%lu cyc",
+                static_cast<unsigned long>(full.drawnPixels()), static_cast<unsigned long>(estimateCycles(full)),
+                static_cast<unsigned long>(step.drawnPixels()), static_cast<unsigned long>(estimateCycles(step)),
+                static_cast<unsigned long>(estimateCycles(pages)));
+  TEST_MESSAGE(msg);
+}
+#endif  // ARDUINO
+
+#ifndef ARDUINO
+// Incremental anomaly HUD — after every update the buffer must equal a fresh
+// full redraw of the same values, while small changes stay local.
+void test_incremental_anomaly_hud_matches_full_redraw(void)
+{
+  using asap::display::BufferMode;
+  using asap::display::kTileBufferBytes;
+
+  struct Step { uint8_t p[4]; uint8_t s[4]; bool rotate; };
+  const Step steps[] = {
+      {{10, 35, 65, 5}, {0, 1, 2, 3}, false},
+      {{11, 35, 65, 5}, {0, 1, 2, 3}, false},    // one channel creeps up 1%
+      {{11, 40, 60, 5}, {0, 2, 2, 3}, false},    // grow, shrink, stage change
+      {{0, 40, 60, 100}, {0, 2, 2, 0}, false},   // shrink to 0, full ring
+      {{0, 40, 60, 100}, {0, 2, 2, 0}, true},    // rotation forces full redraw
+      {{3, 45, 60, 99}, {1, 2, 2, 0}, true},     // increments while rotated
+  };
+
+  DetectorDisplay display(kDummyPins, BufferMode::Full);
+  TEST_ASSERT_TRUE(display.begin());
+  for (const Step& st : steps)
+  {
+    if (st.rotate != display.rotation180())
+    {
+      display.setRotation180(st.rotate);
+    }
+    display.drawAnomalyIndicators(st.p[0], st.p[1], st.p[2], st.p[3],
+                                  st.s[0], st.s[1], st.s[2], st.s[3]);
+
+    DetectorDisplay fresh(kDummyPins, BufferMode::Full);
+    fresh.setRotation180(st.rotate);
+    TEST_ASSERT_TRUE(fresh.begin());
+    fresh.drawAnomalyIndicators(st.p[0], st.p[1], st.p[2], st.p[3],
+                                st.s[0], st.s[1], st.s[2], st.s[3]);
+    TEST_ASSERT_TRUE(fresh.lastAnomalyFullRedraw());
+    TEST_ASSERT_EQUAL_MEMORY(fresh.frameBuffer(), display.frameBuffer(), kTileBufferBytes);
+  }
+
+#if ASAP_DISPLAY_INCREMENTAL_HUD
+  // Step 2 only touched the radiation ring: region and tiles stay local.
+  DetectorDisplay local(kDummyPins, BufferMode::Full);
+  TEST_ASSERT_TRUE(local.begin());
+  local.drawAnomalyIndicators(10, 35, 65, 5, 0, 1, 2, 3);
+  TEST_ASSERT_TRUE(local.lastAnomalyFullRedraw());
+  local.drawAnomalyIndicators(11, 35, 65, 5, 0, 1, 2, 3);
+  TEST_ASSERT_FALSE(local.lastAnomalyFullRedraw());
+  const asap::display::DirtyRect& r = local.lastAnomalyDirtyRect();
+  TEST_ASSERT_FALSE(r.empty());
+  TEST_ASSERT_TRUE(r.x0 >= 32 - 23 && r.x1 <= 32 + 23);
+  TEST_ASSERT_TRUE(r.y0 >= 0 && r.y1 <= 23 + 23);
+  TEST_ASSERT_TRUE(local.lastSentTileCount() <= 2);
+
+  // A different frame kind in between invalidates the incremental state.
+  local.renderCustom(asap::display::makeMenuRootFrame(0), FrameKind::Menu);
+  local.drawAnomalyIndicators(12, 35, 65, 5, 0, 1, 2, 3);
+  TEST_ASSERT_TRUE(local.lastAnomalyFullRedraw());
+#endif
+}
+#endif  // ARDUINO
+
+#ifndef ARDUINO
+// Async flush — panel bytes go through a FlushQueue drained by a simulated
+// SPI link. Small UI updates return while the bus is still busy, the queue
+// keeps byte order and D/C levels across wrap-around, and frames leave whole.
+void test_async_flush_simulated_bus(void)
+{
+  using asap::display::BufferMode;
+  using asap::display::FlushChunk;
+  using asap::display::FlushQueue;
+
+  // Queue round trip: segments split on D/C changes and survive the wrap.
+  FlushQueue queue;
+  uint8_t pattern[FlushQueue::kCapacity / 2 + 7];
+  for (size_t i = 0; i < sizeof(pattern); ++i)
+  {
+    pattern[i] = static_cast<uint8_t>(i * 31u + 7u);
+  }
+  for (uint8_t round = 0; round < 3; ++round)
+  {
+    queue.beginFrame(round);
+    queue.setDc(0);
+    queue.append(pattern, 3);
+    queue.setDc(1);
+    queue.append(pattern, sizeof(pattern));
+    queue.endTransfer();
+    TEST_ASSERT_FALSE(queue.empty());
+
+    size_t offset = 0;
+    uint8_t segments = 0;
+    FlushChunk chunk{};
+    while (queue.peek(chunk))
+    {
+      TEST_ASSERT_EQUAL_UINT16(round, chunk.frame);
+      const size_t segmentLength = (segments == 0) ? 3 : sizeof(pattern);
+      TEST_ASSERT_EQUAL_UINT8(segments == 0 ? 0 : 1, chunk.dc);
+      TEST_ASSERT_EQUAL_MEMORY(pattern + offset, chunk.data, chunk.length);
+      offset += chunk.length;
+      queue.consume(chunk.length);
+      if (chunk.segmentEnd)
+      {
+        TEST_ASSERT_EQUAL(segmentLength, offset);
+        offset = 0;
+        ++segments;
+      }
+    }
+    TEST_ASSERT_EQUAL_UINT8(2, segments);
+    TEST_ASSERT_TRUE(queue.empty());
+  }
+
+  // Display on a ~1 MB/s link (the 9 MHz SPI1 clock of the detector), with
+  // the detector's flags: async flush over dirty tiles.
+  DetectorDisplay display(kDummyPins, BufferMode::Full);
+  display.enableSimulatedBus(1000);
+  TEST_ASSERT_TRUE(display.begin());
+  const asap::display::SimulatedBus* bus = display.simulatedBus();
+  TEST_ASSERT_NOT_NULL(bus);
+
+  // A full frame (~9.3 KB on the wire) is larger than the queue: the flush
+  // queues what fits and returns; the rest goes out from later flushAsync()
+  // calls as the bus drains. The producer never waits on the bus.
+  display.renderCustom(asap::display::makeMenuRootFrame(0), FrameKind::Menu);
+  TEST_ASSERT_TRUE(display.isFlushing());
+  TEST_ASSERT_TRUE(display.flushPending());
+  uint32_t sentTiles = display.lastSentTileCount();
+  TEST_ASSERT_TRUE(sentTiles > 0 && sentTiles < 256);
+  uint32_t queuedFlushes = 1;
+  for (uint8_t ms = 0; ms < 50 && display.flushPending(); ++ms)
+  {
+    display.advanceBus(1);
+    display.flushAsync();
+    sentTiles += display.lastSentTileCount();
+    queuedFlushes += (display.lastSentTileCount() > 0) ? 1U : 0U;
+  }
+  TEST_ASSERT_FALSE(display.flushPending());
+  TEST_ASSERT_EQUAL_UINT32(256, sentTiles);
+  TEST_ASSERT_EQUAL_UINT32(0, bus->stallMs());
+  display.advanceBus(100);
+  TEST_ASSERT_FALSE(display.isFlushing());
+  const uint32_t sentAfterFull = bus->bytesSent();
+
+  // Caret moves fit in the queue whole: each render returns with the bus
+  // busy and nothing left pending.
+  for (uint8_t i = 1; i <= 3; ++i)
+  {
+    display.renderCustom(asap::display::makeMenuRootFrame(static_cast<uint8_t>(i % 3)),
+                         FrameKind::Menu);
+    TEST_ASSERT_TRUE(display.lastSentTileCount() > 0);
+    TEST_ASSERT_TRUE(display.isFlushing());
+    TEST_ASSERT_FALSE(display.flushPending());
+    display.advanceBus(1);
+  }
+  TEST_ASSERT_EQUAL_UINT32(0, bus->stallMs());
+
+  display.advanceBus(100);
+  TEST_ASSERT_FALSE(display.isFlushing());
+  TEST_ASSERT_TRUE(bus->bytesSent() > sentAfterFull);
+  TEST_ASSERT_EQUAL_UINT32(queuedFlushes + 3, bus->framesCompleted());
+  TEST_ASSERT_EQUAL_UINT32(0, bus->tornFrames());
+
+  // The UI comes back for the leftover tiles instead of sleeping on them.
+  using asap::ui::UIController;
+  DetectorDisplay uiDisplay(kDummyPins, BufferMode::Full);
+  uiDisplay.enableSimulatedBus(1000);
+  TEST_ASSERT_TRUE(uiDisplay.begin());
+  UIController ui(uiDisplay);
+  const asap::ui::InputSample idle{/*centerDown=*/false, asap::input::JoyAction::Neutral};
+  uint32_t now = 0;
+  uint32_t wake = ui.onTick(now, idle);
+  TEST_ASSERT_TRUE(uiDisplay.flushPending());
+  TEST_ASSERT_EQUAL_UINT32(now + UIController::kFlushRetryMs, wake);
+  while (uiDisplay.flushPending() && now < 50)
+  {
+    uiDisplay.advanceBus(wake - now);
+    now = wake;
+    wake = ui.onTick(now, idle);
+  }
+  TEST_ASSERT_FALSE(uiDisplay.flushPending());
+  TEST_ASSERT_TRUE(static_cast<int32_t>(wake - now) > 1);
+  TEST_ASSERT_EQUAL_UINT32(0, uiDisplay.simulatedBus()->stallMs());
+}
+#endif  // ARDUINO
+
+#ifndef ARDUINO
+namespace
+{
+// Previous snapshot writer: one tile-geometry lookup and one put() per pixel.
+bool WritePerPixelPgm(const uint8_t* buf, const std::filesystem::path& path)
+{
+  std::ofstream out(path, std::ios::binary);
+  out << "P5\n" << 256 << " " << 64 << "\n15\n";
+  for (uint16_t y = 0; y < 64; ++y)
+  {
+    for (uint16_t x = 0; x < 256; ++x)
+    {
+      const uint32_t index = static_cast<uint32_t>(y >> 3) * 256U + x;
+      const uint8_t bit = static_cast<uint8_t>((buf[index] >> (y & 7U)) & 1U);
+      out.put(static_cast<char>(bit ? 15 : 0));
+    }
+  }
+  return static_cast<bool>(out);
+}
+}  // namespace
+
+// Snapshot export — the bulk tile transpose must reproduce the per-pixel PGM
+// byte for byte, P4 must carry the same pixels packed, and the bulk path
+// should be clearly faster.
+void test_snapshot_bulk_export_matches_per_pixel(void)
+{
+  using asap::display::SnapshotFormat;
+
+  DetectorDisplay display(kDummyPins);
+  TEST_ASSERT_TRUE(display.begin());
+  display.drawAnomalyIndicators(37, 64, 12, 91, 1, 2, 0, 3);
+
+  const auto bulkPath = SnapshotPath("bench_bulk.pgm");
+  const auto refPath = SnapshotPath("bench_ref.pgm");
+  const auto pbmPath = SnapshotPath("bench_bulk.pbm");
+  TEST_ASSERT_TRUE(display.writeSnapshot(bulkPath.string().c_str()));
+  TEST_ASSERT_TRUE(WritePerPixelPgm(display.frameBuffer(), refPath));
+  const std::string bulk = ReadFileBytes(bulkPath);
+  TEST_ASSERT_EQUAL(ReadFileBytes(refPath).size(), bulk.size());
+  TEST_ASSERT_TRUE(ReadFileBytes(refPath) == bulk);
+
+  TEST_ASSERT_TRUE(display.writeSnapshot(pbmPath.string().c_str(), SnapshotFormat::Pbm1));
+  const std::string pbm = ReadFileBytes(pbmPath);
+  const std::string pbmHeader = "P4\n256 64\n";
+  TEST_ASSERT_EQUAL(pbmHeader.size() + 2048, pbm.size());
+  TEST_ASSERT_TRUE(pbm.compare(0, pbmHeader.size(), pbmHeader) == 0);
+  const size_t pgmHeader = bulk.size() - 256U * 64U;
+  for (uint32_t i = 0; i < 256U * 64U; ++i)
+  {
+    const uint8_t packed = static_cast<uint8_t>(pbm[pbmHeader.size() + i / 8U]);
+    const bool black = (packed & (0x80U >> (i % 8U))) != 0;
+    TEST_ASSERT_EQUAL(bulk[pgmHeader + i] == 0, black);
+  }
+
+  constexpr int kRuns = 50;
+  const auto t0 = std::chrono::steady_clock::now();
+  for (int i = 0; i < kRuns; ++i)
+  {
+    WritePerPixelPgm(display.frameBuffer(), refPath);
+  }
+  const auto t1 = std::chrono::steady_clock::now();
+  for (int i = 0; i < kRuns; ++i)
+  {
+    display.writeSnapshot(bulkPath.string().c_str());
+  }
+  const auto t2 = std::chrono::steady_clock::now();
+  for (int i = 0; i < kRuns; ++i)
+  {
+    display.writeSnapshot(pbmPath.string().c_str(), SnapshotFormat::Pbm1);
+  }
+  const auto t3 = std::chrono::steady_clock::now();
+  using us = std::chrono::microseconds;
+  const long long perPixel = std::chrono::duration_cast<us>(t1 - t0).count();
+  const long long bulkPgm = std::chrono::duration_cast<us>(t2 - t1).count();
+  const long long bulkPbm = std::chrono::duration_cast<us>(t3 - t2).count();
+  char msg[128];
+  std::snprintf(msg, sizeof(msg), "snapshot bench (%d runs): per-pixel P5 %lld us, bulk P5 %lld us, P4 %lld us",
+                kRuns, perPixel, bulkPgm, bulkPbm);
+  TEST_MESSAGE(msg);
+
+  RemoveIfExists(bulkPath);
+  RemoveIfExists(refPath);
+  RemoveIfExists(pbmPath);
+}
+#endif  // ARDUINO
+
+#ifndef ARDUINO
+// Golden comparator — hash match skips all disk writes, a changed frame gets
+// an actual + diff image and never overwrites the golden, update mode
+// rewrites golden and manifest.
+void test_snapshot_comparator_golden_flow(void)
+{
+  using asap::snapshot::SnapshotComparator;
+  using asap::snapshot::SnapshotStatus;
+
+  const auto dir = std::filesystem::temp_directory_path() / "asap_snapshot_comparator";
+  std::error_code ec;
+  std::filesystem::remove_all(dir, ec);
+  std::filesystem::create_directories(dir, ec);
+
+  DetectorDisplay display(kDummyPins);
+  TEST_ASSERT_TRUE(display.begin());
+  display.renderCustom(asap::display::makeMenuRootFrame(0), FrameKind::Menu);
+
+  {
+    SnapshotComparator update(dir, /*update=*/true);
+    const auto r = update.check("menu.pgm", display.frameBuffer());
+    TEST_ASSERT_EQUAL(static_cast<int>(SnapshotStatus::Updated), static_cast<int>(r.status));
+    TEST_ASSERT_TRUE(r.wroteImage);
+    TEST_ASSERT_TRUE(update.saveManifest());
+  }
+
+  SnapshotComparator compare(dir, /*update=*/false);
+  TEST_ASSERT_EQUAL_UINT32(1, compare.goldenCount());
+  const auto goldenTime = std::filesystem::last_write_time(dir / "menu.pgm");
+  const auto match = compare.check("menu.pgm", display.frameBuffer());
+  TEST_ASSERT_EQUAL(static_cast<int>(SnapshotStatus::Match), static_cast<int>(match.status));
+  TEST_ASSERT_FALSE(match.wroteImage);
+  TEST_ASSERT_TRUE(match.ok());
+
+  // Hash is taken over pixels, so it matches the PGM written for the golden.
+  uint8_t packed[asap::display::kPackedFrameBytes];
+  asap::display::packFrameRowMajor(display.frameBuffer(), packed);
+  TEST_ASSERT_TRUE(asap::snapshot::hashPackedFrame(packed) == match.hash);
+
+  display.renderCustom(asap::display::makeMenuRootFrame(1), FrameKind::Menu);
+  const auto mismatch = compare.check("menu.pgm", display.frameBuffer());
+  TEST_ASSERT_EQUAL(static_cast<int>(SnapshotStatus::Mismatch), static_cast<int>(mismatch.status));
+  TEST_ASSERT_FALSE(mismatch.ok());
+  TEST_ASSERT_TRUE(mismatch.diffPixels > 0);
+  TEST_ASSERT_TRUE(std::filesystem::exists(compare.diffDir() / "menu.pgm"));
+  TEST_ASSERT_TRUE(std::filesystem::exists(compare.diffDir() / "menu.diff.pgm"));
+  TEST_ASSERT_TRUE(goldenTime == std::filesystem::last_write_time(dir / "menu.pgm"));
+
+  const auto missing = compare.check("unknown.pgm", display.frameBuffer());
+  TEST_ASSERT_EQUAL(static_cast<int>(SnapshotStatus::Missing), static_cast<int>(missing.status));
+
+  std::filesystem::remove_all(dir, ec);
+}
+#endif  // ARDUINO
+
+#ifndef ARDUINO
+namespace
+{
+// Declarative snapshot matrix: anomaly stages x exposures, then every root
+// and config menu entry reached from a fresh boot.
+std::vector<asap::snapshot::SnapshotCase> BuildSnapshotMatrix()
+{
+  using asap::input::JoyAction;
+  using asap::snapshot::SnapshotCase;
+  using asap::snapshot::UiStep;
+  using asap::ui::UIController;
+
+  // Golden name of the capture after the step about to be pushed: unique per
+  // case and step, so no matrix frame shadows another in the manifest.
+  auto capture = [](const SnapshotCase& c) {
+    return "matrix_" + c.name + "_" + std::to_string(c.steps.size()) + ".pgm";
+  };
+
+  std::vector<SnapshotCase> cases;
+  const uint8_t exposures[4] = {0, 33, 66, 100};
+  for (uint8_t stage = 0; stage < 4; ++stage)
+  {
+    for (uint8_t e = 0; e < 4; ++e)
+    {
+      SnapshotCase c;
+      c.name = "anomaly_s" + std::to_string(stage) + "_e" + std::to_string(exposures[e]);
+      const uint8_t pc = exposures[e];
+      c.setup = [stage, pc](UIController& ui) {
+        ui.setAnomalyExposure(pc, static_cast<uint8_t>(100 - pc), pc, static_cast<uint8_t>(pc / 2));
+        ui.setAnomalyStage(stage, stage, stage, stage);
+      };
+      c.steps.push_back(UiStep{0, {false, JoyAction::Neutral}, capture(c)});
+      cases.push_back(std::move(c));
+    }
+  }
+
+  auto enterMenu = [](SnapshotCase& c) {
+    c.steps.push_back(UiStep{0, {false, JoyAction::Neutral}});
+    c.steps.push_back(UiStep{1000, {true, JoyAction::Neutral}});
+    c.steps.push_back(UiStep{2000, {true, JoyAction::Neutral}});
+  };
+  for (uint8_t root = 0; root < 3; ++root)
+  {
+    SnapshotCase c;
+    c.name = "menu_root_" + std::to_string(root);
+    enterMenu(c);
+    for (uint8_t i = 0; i < root; ++i)
+    {
+      c.steps.push_back(UiStep{static_cast<uint32_t>(2100 + i * 100), {false, JoyAction::Down}});
+    }
+    c.steps.push_back(UiStep{2500, {false, JoyAction::Neutral}, capture(c)});
+    c.steps.push_back(UiStep{2600, {false, JoyAction::Click}, capture(c)});
+    cases.push_back(std::move(c));
+  }
+  for (uint8_t item = 0; item < 5; ++item)
+  {
+    SnapshotCase c;
+    c.name = "menu_config_" + std::to_string(item);
+    enterMenu(c);
+    c.steps.push_back(UiStep{2100, {false, JoyAction::Down}});
+    c.steps.push_back(UiStep{2200, {false, JoyAction::Down}});
+    c.steps.push_back(UiStep{2300, {false, JoyAction::Click}});
+    for (uint8_t i = 0; i < item; ++i)
+    {
+      c.steps.push_back(UiStep{static_cast<uint32_t>(2400 + i * 100), {false, JoyAction::Down}});
+    }
+    c.steps.push_back(UiStep{3000, {false, JoyAction::Click}, capture(c)});
+    c.steps.push_back(UiStep{3100, {false, JoyAction::Right}, capture(c)});
+    cases.push_back(std::move(c));
+  }
+  return cases;
+}
+}  // namespace
+
+// Parallel snapshot runner — cases rendered on a thread pool come back in
+// declaration order, identical to a single-threaded run, every matrix frame
+// matches its golden, and a case replaying the serial tests reproduces theirs.
+void test_parallel_snapshot_runner(void)
+{
+  using asap::input::JoyAction;
+  using asap::snapshot::CaseOutput;
+  using asap::snapshot::SnapshotCase;
+  using asap::snapshot::SnapshotRunner;
+  using asap::snapshot::UiStep;
+  using asap::ui::UIController;
+
+  const std::vector<SnapshotCase> cases = BuildSnapshotMatrix();
+  const auto t0 = std::chrono::steady_clock::now();
+  const std::vector<CaseOutput> serial = SnapshotRunner(1).render(cases);
+  const auto t1 = std::chrono::steady_clock::now();
+  SnapshotRunner pool(4);
+  const std::vector<CaseOutput> parallel = pool.render(cases);
+  const auto t2 = std::chrono::steady_clock::now();
+
+  TEST_ASSERT_EQUAL_UINT32(cases.size(), parallel.size());
+  size_t frames = 0;
+  for (size_t i = 0; i < cases.size(); ++i)
+  {
+    TEST_ASSERT_EQUAL_STRING(cases[i].name.c_str(), parallel[i].name.c_str());
+    TEST_ASSERT_EQUAL_UINT32(serial[i].frames.size(), parallel[i].frames.size());
+    TEST_ASSERT_TRUE(!parallel[i].frames.empty());
+    for (size_t f = 0; f < parallel[i].frames.size(); ++f)
+    {
+      TEST_ASSERT_EQUAL_STRING(serial[i].frames[f].name.c_str(), parallel[i].frames[f].name.c_str());
+      TEST_ASSERT_TRUE(serial[i].frames[f].hash == parallel[i].frames[f].hash);
+      TEST_ASSERT_TRUE(serial[i].frames[f].frame == parallel[i].frames[f].frame);
+      ++frames;
+    }
+  }
+  // Different inputs must give different frames (cases are not aliased).
+  TEST_ASSERT_FALSE(parallel[0].frames[0].hash == parallel[15].frames[0].hash);
+
+  using us = std::chrono::microseconds;
+  char msg[128];
+  std::snprintf(msg, sizeof(msg), "snapshot runner: %u cases, %u frames, 1 thread %lld us, %u threads %lld us",
+                static_cast<unsigned>(cases.size()), static_cast<unsigned>(frames),
+                static_cast<long long>(std::chrono::duration_cast<us>(t1 - t0).count()),
+                pool.threads(),
+                static_cast<long long>(std::chrono::duration_cast<us>(t2 - t1).count()));
+  TEST_MESSAGE(msg);
+
+  // Replays of the serial HUD and navigation openings match their goldens.
+  std::vector<SnapshotCase> replay(2);
+  replay[0].name = "anomaly_hud_stages";
+  replay[0].setup = [](UIController& ui) {
+    ui.setAnomalyExposure(10, 35, 65, 5);
+    ui.setAnomalyStage(0, 1, 2, 3);
+  };
+  replay[0].steps.push_back(UiStep{0, {false, JoyAction::Neutral}, "000_anomaly_hud_stages_init.pgm"});
+  replay[1].name = "menu_navigation_opening";
+  replay[1].setup = [](UIController& ui) {
+    ui.setAnomalyExposure(25, 50, 75, 100);
+    ui.setAnomalyStage(0, 1, 2, 3);
+    ui.setAnomalyStrength(0);
+  };
+  replay[1].steps.push_back(UiStep{0, {false, JoyAction::Neutral}, "001_neutral.pgm"});
+  replay[1].steps.push_back(UiStep{50, {false, JoyAction::Neutral}, "002_neutral.pgm",
+                                   [](UIController& ui) { ui.setAnomalyStrength(50); }});
+  replay[1].steps.push_back(UiStep{2000, {true, JoyAction::Neutral}, "004_longpress.pgm"});
+  replay[1].steps.push_back(UiStep{3000, {true, JoyAction::Neutral}, "005_longpress.pgm"});
+  const std::vector<CaseOutput> replayed = pool.render(replay);
+  for (const std::vector<CaseOutput>* outputs : {&parallel, &replayed})
+  {
+    for (const auto& result : SnapshotRunner::compare(*outputs, Goldens()))
+    {
+      if (!result.second.ok())
+      {
+        TEST_FAIL_MESSAGE(asap::snapshot::describe(result.first, result.second).c_str());
+      }
+    }
+  }
+
+  // Every frame of the matrix is also a draw cost gate.
+  for (const std::vector<CaseOutput>* outputs : {&parallel, &replayed})
+  {
+    for (const CaseOutput& output : *outputs)
+    {
+      for (const auto& captured : output.frames)
+      {
+        CheckDrawBudget(captured.name.c_str(), captured.kind, captured.cost, captured.pages);
+      }
+    }
+  }
+}
+#endif  // ARDUINO
+
 // Removed: detailed config submenu walkthrough; simplified flow is covered in the main navigation test.
+#ifndef ARDUINO
+// Scheduler — earliest deadline first among due tasks, periodic catch-up
+// without bursts, ISR signals, and ten virtual hours on the host clock.
+void test_scheduler_edf_virtual_clock(void)
+{
+  using asap::core::Scheduler;
+  using asap::core::TaskId;
+  using asap::core::VirtualClock;
+
+  // EDF: three tasks due at once run by deadline, not by registration order.
+  {
+    VirtualClock clock;
+    Scheduler sched(clock.clock());
+    static std::string order;
+    order.clear();
+    const Scheduler::TaskFn tag = [](void* ctx, uint32_t) { order += *static_cast<char*>(ctx); };
+    char x = 'X', y = 'Y', z = 'Z';
+    sched.addOneShot(300, tag, &x);
+    sched.addOneShot(200, tag, &y);
+    sched.addOneShot(250, tag, &z);
+    clock.advance(400);
+    TEST_ASSERT_EQUAL_UINT8(3, sched.runDue());
+    TEST_ASSERT_EQUAL_STRING("YZX", order.c_str());
+    TEST_ASSERT_EQUAL_UINT32(200, sched.maxLatenessMs());
+    uint32_t next = 0;
+    TEST_ASSERT_FALSE(sched.nextDeadline(next));  // one-shots are spent
+  }
+
+  // Periodic: a stalled loop runs the task once and skips the missed periods;
+  // a signal runs a disarmed one-shot without touching periodic deadlines.
+  {
+    VirtualClock clock;
+    Scheduler sched(clock.clock());
+    static uint32_t ticks;
+    static uint32_t signalled;
+    ticks = 0;
+    signalled = 0;
+    sched.addPeriodic(100, [](void*, uint32_t) { ++ticks; }, nullptr, 100);
+    const TaskId irq = sched.addOneShot(0, [](void*, uint32_t) { ++signalled; }, nullptr);
+    sched.runDue();
+    TEST_ASSERT_EQUAL_UINT32(1, signalled);
+    clock.advance(1050);
+    sched.runDue();
+    TEST_ASSERT_EQUAL_UINT32(1, ticks);
+    TEST_ASSERT_EQUAL_UINT32(1, sched.overrunCount());
+    uint32_t next = 0;
+    TEST_ASSERT_TRUE(sched.nextDeadline(next));
+    TEST_ASSERT_EQUAL_UINT32(1150, next);
+    sched.signal(irq);
+    sched.runOnce();  // runs the signalled task, then sleeps to the next deadline
+    TEST_ASSERT_EQUAL_UINT32(2, signalled);
+    TEST_ASSERT_EQUAL_UINT32(1, ticks);
+    TEST_ASSERT_EQUAL_UINT32(1150, clock.nowMs());
+    sched.runOnce();
+    TEST_ASSERT_EQUAL_UINT32(2, ticks);
+  }
+
+  // Ten hours of a detector-like task mix in virtual time.
+  {
+    VirtualClock clock;
+    Scheduler sched(clock.clock());
+    static uint32_t fast, slow, rearmed;
+    static Scheduler* self;
+    static TaskId oneShot;
+    fast = slow = rearmed = 0;
+    self = &sched;
+    sched.addPeriodic(250, [](void*, uint32_t) { ++fast; }, nullptr);
+    sched.addPeriodic(60000, [](void*, uint32_t) { ++slow; }, nullptr);
+    // Self-rearming one-shot, like the UI task following its wakeup deadline.
+    oneShot = sched.addOneShot(0, [](void*, uint32_t now) {
+      ++rearmed;
+      self->setDeadline(oneShot, now + 10000);
+    }, nullptr);
+
+    constexpr uint32_t kTenHoursMs = 10UL * 60UL * 60UL * 1000UL;
+    const auto t0 = std::chrono::steady_clock::now();
+    while (clock.nowMs() < kTenHoursMs)
+    {
+      sched.runOnce();
+    }
+    const auto t1 = std::chrono::steady_clock::now();
+    TEST_ASSERT_EQUAL_UINT32(kTenHoursMs / 250, fast);
+    TEST_ASSERT_EQUAL_UINT32(kTenHoursMs / 60000, slow);
+    TEST_ASSERT_EQUAL_UINT32(kTenHoursMs / 10000, rearmed);
+    TEST_ASSERT_EQUAL_UINT32(0, sched.overrunCount());
+    TEST_ASSERT_EQUAL_UINT32(0, sched.maxLatenessMs());
+    TEST_ASSERT_EQUAL_UINT64(kTenHoursMs, clock.sleptMs());
+
+    char msg[128];
+    std::snprintf(msg, sizeof(msg), "scheduler: 10 h virtual, %lu runs, %lu sleeps in %.1f ms",
+                  static_cast<unsigned long>(sched.runCount()),
+                  static_cast<unsigned long>(sched.sleepCount()),
+                  std::chrono::duration<double, std::milli>(t1 - t0).count());
+    TEST_MESSAGE(msg);
+  }
+}
+#endif  // ARDUINO
+
+#ifndef ARDUINO
+// CC1101 driver against the register-level chip model: loopback with RSSI,
+// a dozen beacons bursting while the detector loop is busy, ring and TX
+// back-pressure, late interrupts draining several frames, FIFO overflow.
+void test_cc1101_virtual_medium_burst(void)
+{
+  using asap::radio::Cc1101;
+  using asap::radio::PacketRing;
+  using asap::radio::RxSlot;
+  using asap::radio::VirtualCc1101;
+  using asap::radio::VirtualMedium;
+
+  // Loopback: payload, RSSI and LQI arrive intact; the sender returns to RX.
+  {
+    VirtualMedium air;
+    VirtualCc1101 chipA(air), chipB(air);
+    Cc1101 a(chipA.port()), b(chipB.port());
+    TEST_ASSERT_TRUE(a.begin(3));
+    TEST_ASSERT_TRUE(b.begin(3));
+    chipA.attach(a);
+    chipB.attach(b);
+    air.setLinkRssi(chipB, chipA, -87);
+
+    const uint8_t hello[] = {'h', 'e', 'l', 'l', 'o'};
+    TEST_ASSERT_TRUE(a.send(hello, sizeof(hello)));
+    TEST_ASSERT_TRUE(a.txBusy());
+    air.advance(10);
+    TEST_ASSERT_FALSE(a.txBusy());
+    TEST_ASSERT_EQUAL_UINT32(1, a.txPackets());
+    TEST_ASSERT_EQUAL_HEX8(0x0D, chipA.marcState());  // back in RX
+    const RxSlot* slot = b.rx().peek();
+    TEST_ASSERT_NOT_NULL(slot);
+    TEST_ASSERT_EQUAL_UINT8(sizeof(hello), slot->length());
+    TEST_ASSERT_EQUAL_MEMORY(hello, slot->payload(), sizeof(hello));
+    TEST_ASSERT_EQUAL_INT16(-87, slot->rssiDbm());
+    TEST_ASSERT_EQUAL_UINT8(VirtualCc1101::kLqi, slot->lqi());
+    TEST_ASSERT_TRUE(slot->crcOk());
+    b.rx().release();
+    TEST_ASSERT_TRUE(b.rx().empty());
+    TEST_ASSERT_TRUE(a.rx().empty());  // no echo of its own packet
+
+    // Invalid lengths are refused before touching the chip.
+    uint8_t big[asap::radio::kMaxPayload + 1] = {};
+    TEST_ASSERT_FALSE(a.send(big, sizeof(big)));
+    TEST_ASSERT_FALSE(a.send(big, 0));
+  }
+
+  // Twelve beacons back to back while the detector's loop does not drain:
+  // every packet lands in its own slot, in order, none copied or dropped.
+  // Past the ring capacity the interrupt drops (and counts) what won't fit.
+  {
+    VirtualMedium air;
+    VirtualCc1101 detectorChip(air);
+    Cc1101 detector(detectorChip.port());
+    TEST_ASSERT_TRUE(detector.begin());
+    detectorChip.attach(detector);
+
+    constexpr int kBeacons = 12;
+    VirtualCc1101* chips[kBeacons];
+    Cc1101* beacons[kBeacons];
+    for (int i = 0; i < kBeacons; ++i)
+    {
+      chips[i] = new VirtualCc1101(air);
+      beacons[i] = new Cc1101(chips[i]->port());
+      TEST_ASSERT_TRUE(beacons[i]->begin());
+      chips[i]->attach(*beacons[i]);
+      air.setLinkRssi(detectorChip, *chips[i], static_cast<int16_t>(-50 - 3 * i));
+    }
+    for (int i = 0; i < kBeacons; ++i)
+    {
+      const uint8_t beacon[12] = {0xBE, static_cast<uint8_t>(i)};
+      TEST_ASSERT_TRUE(beacons[i]->send(beacon, sizeof(beacon)));
+      air.advance(5);  // 12 + 1 + 8 bytes at 5 bytes/ms
+    }
+    TEST_ASSERT_EQUAL_UINT32(0, air.collisions());
+    PacketRing& ring = detector.rx();
+    TEST_ASSERT_EQUAL_UINT8(kBeacons, ring.size());
+    TEST_ASSERT_EQUAL_UINT8(kBeacons, ring.highWater());
+    TEST_ASSERT_EQUAL_UINT32(kBeacons, detector.rxPackets());
+    TEST_ASSERT_EQUAL_UINT32(0, detector.rxDropped());
+    const uint8_t* firstFrame = ring.peek()->frame;
+
+    for (int i = 0; i < 6; ++i)
+    {
+      const uint8_t beacon[12] = {0xBE, static_cast<uint8_t>(kBeacons + i)};
+      TEST_ASSERT_TRUE(beacons[i]->send(beacon, sizeof(beacon)));
+      air.advance(5);
+    }
+    TEST_ASSERT_EQUAL_UINT8(PacketRing::kSlots, ring.size());
+    TEST_ASSERT_EQUAL_UINT32(kBeacons + 6 - PacketRing::kSlots, detector.rxDropped());
+    for (int i = 0; i < PacketRing::kSlots; ++i)
+    {
+      const RxSlot* slot = ring.peek();
+      TEST_ASSERT_EQUAL_HEX8(0xBE, slot->payload()[0]);
+      TEST_ASSERT_EQUAL_UINT8(i, slot->payload()[1]);
+      if (i < kBeacons)
+      {
+        TEST_ASSERT_EQUAL_INT16(-50 - 3 * i, slot->rssiDbm());
+      }
+      ring.release();
+    }
+    TEST_ASSERT_TRUE(ring.empty());
+    TEST_ASSERT_EQUAL_PTR(firstFrame, ring.acquire()->frame);  // slots are reused in place
+
+    // Two beacons keyed at once collide; nobody receives either.
+    const uint8_t beacon[4] = {0xBE};
+    TEST_ASSERT_TRUE(beacons[0]->send(beacon, sizeof(beacon)));
+    TEST_ASSERT_TRUE(beacons[1]->send(beacon, sizeof(beacon)));
+    air.advance(5);
+    TEST_ASSERT_EQUAL_UINT32(1, air.collisions());
+    TEST_ASSERT_TRUE(ring.empty());
+
+    for (int i = 0; i < kBeacons; ++i)
+    {
+      delete beacons[i];
+      delete chips[i];
+    }
+  }
+
+  // TX back-pressure: the queue holds kTxSlots packets (including the one on
+  // air) and refuses more until the GDO0 interrupt frees a slot.
+  {
+    VirtualMedium air;
+    VirtualCc1101 chipA(air), chipB(air);
+    Cc1101 a(chipA.port()), b(chipB.port());
+    TEST_ASSERT_TRUE(a.begin());
+    TEST_ASSERT_TRUE(b.begin());
+    chipA.attach(a);
+    chipB.attach(b);
+    uint8_t packet[20] = {};
+    for (uint8_t i = 0; i < Cc1101::kTxSlots; ++i)
+    {
+      packet[0] = i;
+      TEST_ASSERT_TRUE(a.send(packet, sizeof(packet)));
+    }
+    TEST_ASSERT_FALSE(a.send(packet, sizeof(packet)));
+    TEST_ASSERT_EQUAL_UINT8(Cc1101::kTxSlots, a.txQueued());
+    air.advance(asap::radio::airtimeMs(sizeof(packet)) - 1);
+    TEST_ASSERT_EQUAL_UINT8(Cc1101::kTxSlots, a.txQueued());
+    air.advance(1);  // first packet off air
+    TEST_ASSERT_EQUAL_UINT8(Cc1101::kTxSlots - 1, a.txQueued());
+    TEST_ASSERT_TRUE(a.send(packet, sizeof(packet)));
+    air.advance(100);
+    TEST_ASSERT_EQUAL_UINT32(Cc1101::kTxSlots + 1, a.txPackets());
+    TEST_ASSERT_EQUAL_UINT8(0, a.txQueued());
+    TEST_ASSERT_EQUAL_UINT32(Cc1101::kTxSlots + 1, b.rxPackets());
+    for (uint8_t i = 0; i < Cc1101::kTxSlots; ++i)
+    {
+      TEST_ASSERT_EQUAL_UINT8(i, b.rx().peek()->payload()[0]);
+      b.rx().release();
+    }
+  }
+
+  // Late interrupt: three frames wait in the FIFO behind one latched GDO0
+  // edge and a single handler run moves them all. A fourth overflows the
+  // FIFO; the chip must be flushed and the overflow is counted.
+  {
+    VirtualMedium air;
+    VirtualCc1101 chipA(air), chipB(air);
+    Cc1101 a(chipA.port()), b(chipB.port());
+    TEST_ASSERT_TRUE(a.begin());
+    TEST_ASSERT_TRUE(b.begin());
+    chipA.attach(a);
+    chipB.attach(b);
+    const uint8_t packet[14] = {0x55};  // 17 FIFO bytes per frame
+
+    chipB.setIrqMasked(true);
+    for (int i = 0; i < 3; ++i)
+    {
+      TEST_ASSERT_TRUE(a.send(packet, sizeof(packet)));
+      air.advance(5);
+    }
+    TEST_ASSERT_EQUAL_UINT8(51, chipB.rxFifoBytes());
+    TEST_ASSERT_TRUE(b.rx().empty());
+    const uint32_t before = chipB.interruptCount();
+    chipB.setIrqMasked(false);
+    TEST_ASSERT_EQUAL_UINT32(before + 1, chipB.interruptCount());
+    TEST_ASSERT_EQUAL_UINT8(3, b.rx().size());
+    TEST_ASSERT_EQUAL_UINT8(0, chipB.rxFifoBytes());
+
+    chipB.setIrqMasked(true);
+    for (int i = 0; i < 4; ++i)
+    {
+      TEST_ASSERT_TRUE(a.send(packet, sizeof(packet)));
+      air.advance(5);
+    }
+    TEST_ASSERT_EQUAL_HEX8(0x11, chipB.marcState());  // RXFIFO_OVERFLOW
+    chipB.setIrqMasked(false);
+    TEST_ASSERT_EQUAL_UINT32(1, b.fifoOverflows());
+    TEST_ASSERT_EQUAL_HEX8(0x0D, chipB.marcState());  // flushed, back in RX
+    TEST_ASSERT_EQUAL_UINT8(3, b.rx().size());
+    TEST_ASSERT_TRUE(a.send(packet, sizeof(packet)));
+    air.advance(5);
+    TEST_ASSERT_EQUAL_UINT8(4, b.rx().size());
+  }
+}
+#endif  // ARDUINO
+
+#ifndef ARDUINO
+// Packet schemas — encode/decode round trip through the radio ring, then a
+// deterministic fuzz (random frames, bit flips, truncation) and a decode
+// throughput benchmark.
+void test_proto_schema_fuzz_and_decode_rate(void)
+{
+  using namespace asap::proto;
+
+  // Round trip over a real ring slot: the view reads the slot in place.
+  {
+    Encoder<AnomalyMsg> enc(0x1234, 7);
+    enc.set<AnomalyMsg::Rad>(200).set<AnomalyMsg::Therm>(0).set<AnomalyMsg::Chem>(17).set<AnomalyMsg::Psy>(255);
+    enc.set<AnomalyMsg::BurstSeq>(3);
+    const uint8_t length = enc.seal();
+    TEST_ASSERT_EQUAL_UINT8(12, length);
+
+    asap::radio::VirtualMedium air;
+    asap::radio::VirtualCc1101 chipA(air), chipB(air);
+    asap::radio::Cc1101 a(chipA.port()), b(chipB.port());
+    TEST_ASSERT_TRUE(a.begin());
+    TEST_ASSERT_TRUE(b.begin());
+    chipA.attach(a);
+    chipB.attach(b);
+    TEST_ASSERT_TRUE(a.send(enc.data(), length));
+    air.advance(10);
+    const asap::radio::RxSlot* slot = b.rx().peek();
+    TEST_ASSERT_NOT_NULL(slot);
+    TEST_ASSERT_EQUAL(MsgType::Anomaly, peekType(slot->payload(), slot->length()));
+    const AnomalyView view(slot->payload(), slot->length());
+    TEST_ASSERT_TRUE(view.valid());
+    TEST_ASSERT_EQUAL_UINT16(0x1234, view.emitterId());
+    TEST_ASSERT_EQUAL_UINT8(7, view.seq());
+    TEST_ASSERT_EQUAL_UINT32(200, view.get<AnomalyMsg::Rad>());
+    TEST_ASSERT_EQUAL_UINT32(0, view.get<AnomalyMsg::Therm>());
+    TEST_ASSERT_EQUAL_UINT32(17, view.get<AnomalyMsg::Chem>());
+    TEST_ASSERT_EQUAL_UINT32(255, view.get<AnomalyMsg::Psy>());
+    TEST_ASSERT_EQUAL_UINT32(3, view.get<AnomalyMsg::BurstSeq>());
+    // The same bytes are not a valid packet of any other schema.
+    TEST_ASSERT_FALSE(BeaconView(slot->payload(), slot->length()).valid());
+    TEST_ASSERT_FALSE(GameConfigView(slot->payload(), slot->length()).valid());
+    b.rx().release();
+  }
+
+  // Signed and multi-byte fields, little endian on the wire.
+  {
+    Encoder<BeaconMsg> beacon(0xBEEF, 255);
+    beacon.set<BeaconMsg::TxPowerDbm>(-12).set<BeaconMsg::PeriodMs>(1500).set<BeaconMsg::Flags>(0x81);
+    beacon.seal();
+    const uint8_t expectHeader[] = {1, 1, 0xEF, 0xBE, 255, 0xF4, 0xDC, 0x05, 0x81};
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(expectHeader, beacon.data(), sizeof(expectHeader));
+    const BeaconView view(beacon.data(), beacon.size());
+    TEST_ASSERT_TRUE(view.valid());
+    TEST_ASSERT_EQUAL_INT32(-12, view.getSigned<BeaconMsg::TxPowerDbm>());
+    TEST_ASSERT_EQUAL_UINT32(1500, view.get<BeaconMsg::PeriodMs>());
+
+    Encoder<GameConfigMsg> config(1, 0);
+    config.set<GameConfigMsg::TargetId>(kBroadcastId).set<GameConfigMsg::Value>(-100000);
+    config.seal();
+    const GameConfigView cv(config.data(), config.size());
+    TEST_ASSERT_EQUAL_UINT32(kBroadcastId, cv.get<GameConfigMsg::TargetId>());
+    TEST_ASSERT_EQUAL_INT32(-100000, cv.getSigned<GameConfigMsg::Value>());
+
+    // Unknown version: rejected, and every accessor reads as zero.
+    uint8_t future[Encoder<BeaconMsg>::size()];
+    std::memcpy(future, beacon.data(), sizeof(future));
+    future[kVersionOffset] = 2;
+    const BeaconView stale(future, sizeof(future));
+    TEST_ASSERT_FALSE(stale.valid());
+    TEST_ASSERT_EQUAL_UINT32(0, stale.get<BeaconMsg::PeriodMs>());
+    TEST_ASSERT_EQUAL_UINT16(0, stale.emitterId());
+    TEST_ASSERT_EQUAL(MsgType::Unknown, peekType(future, kHeaderBytes));
+  }
+
+  // Fuzz: seeded random frames of every length; every single-bit flip and
+  // every truncation of a valid packet must be rejected. Run under ASan to
+  // also prove the views never read outside the frame.
+  {
+    uint32_t rng = 0x2545F491u;
+    auto next = [&rng]() {
+      rng ^= rng << 13;
+      rng ^= rng >> 17;
+      rng ^= rng << 5;
+      return rng;
+    };
+    uint32_t accepted = 0;
+    constexpr uint32_t kFrames = 200000;
+    for (uint32_t n = 0; n < kFrames; ++n)
+    {
+      const uint8_t length = static_cast<uint8_t>(next() % (asap::radio::kMaxPayload + 1));
+      uint8_t* frame = new uint8_t[length ? length : 1];  // exact size: ASan flags any overread
+      for (uint8_t i = 0; i < length; ++i)
+      {
+        frame[i] = static_cast<uint8_t>(next());
+      }
+      if (length > kVersionOffset && (n & 1))
+      {
+        frame[kTypeOffset] = static_cast<uint8_t>(1 + next() % 4);  // plausible header
+        frame[kVersionOffset] = 1;
+      }
+      accepted += BeaconView(frame, length).valid();
+      accepted += AnomalyView(frame, length).valid();
+      accepted += ArtifactView(frame, length).valid();
+      accepted += GameConfigView(frame, length).valid();
+      delete[] frame;
+    }
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(2, accepted);  // ~0.1 expected from the 16-bit CRC
+
+    Encoder<GameConfigMsg> enc(0x0042, 9);
+    enc.set<GameConfigMsg::Key>(5).set<GameConfigMsg::Value>(123456);
+    const uint8_t length = enc.seal();
+    uint8_t frame[Encoder<GameConfigMsg>::size()];
+    for (uint16_t bitIndex = 0; bitIndex < length * 8; ++bitIndex)
+    {
+      std::memcpy(frame, enc.data(), length);
+      frame[bitIndex / 8] ^= static_cast<uint8_t>(1U << (bitIndex % 8));
+      TEST_ASSERT_FALSE(GameConfigView(frame, length).valid());
+    }
+    for (uint8_t cut = 0; cut < length; ++cut)
+    {
+      TEST_ASSERT_FALSE(GameConfigView(enc.data(), cut).valid());
+    }
+  }
+
+  // Decode throughput: dispatch on type and read every field of a mixed
+  // stream, the detector's per-packet work.
+  {
+    constexpr int kKinds = 4;
+    uint8_t frames[kKinds][asap::radio::kMaxPayload];
+    uint8_t lengths[kKinds];
+    {
+      Encoder<BeaconMsg> e0(1, 1);
+      e0.set<BeaconMsg::PeriodMs>(1000);
+      lengths[0] = e0.seal();
+      std::memcpy(frames[0], e0.data(), lengths[0]);
+      Encoder<AnomalyMsg> e1(2, 2);
+      e1.set<AnomalyMsg::Rad>(90);
+      lengths[1] = e1.seal();
+      std::memcpy(frames[1], e1.data(), lengths[1]);
+      Encoder<ArtifactMsg> e2(3, 3);
+      e2.set<ArtifactMsg::Signature>(0xA5A5);
+      lengths[2] = e2.seal();
+      std::memcpy(frames[2], e2.data(), lengths[2]);
+      Encoder<GameConfigMsg> e3(4, 4);
+      e3.set<GameConfigMsg::Value>(7);
+      lengths[3] = e3.seal();
+      std::memcpy(frames[3], e3.data(), lengths[3]);
+    }
+    constexpr uint32_t kDecodes = 1000000;
+    volatile uint32_t sink = 0;
+    uint32_t validCount = 0;
+    const auto t0 = std::chrono::steady_clock::now();
+    for (uint32_t n = 0; n < kDecodes; ++n)
+    {
+      __asm__ __volatile__("" ::: "memory");  // frames are re-read, never folded
+      const uint8_t* f = frames[n % kKinds];
+      const uint8_t len = lengths[n % kKinds];
+      uint32_t acc = 0;
+      switch (peekType(f, len))
+      {
+        case MsgType::Beacon: {
+          const BeaconView v(f, len);
+          validCount += v.valid();
+          acc = v.emitterId() + v.get<BeaconMsg::PeriodMs>() + v.get<BeaconMsg::Flags>();
+          break;
+        }
+        case MsgType::Anomaly: {
+          const AnomalyView v(f, len);
+          validCount += v.valid();
+          acc = v.get<AnomalyMsg::Rad>() + v.get<AnomalyMsg::Therm>() + v.get<AnomalyMsg::Chem>() +
+                v.get<AnomalyMsg::Psy>();
+          break;
+        }
+        case MsgType::Artifact: {
+          const ArtifactView v(f, len);
+          validCount += v.valid();
+          acc = v.get<ArtifactMsg::Signature>() + v.get<ArtifactMsg::PingIndex>();
+          break;
+        }
+        case MsgType::GameConfig: {
+          const GameConfigView v(f, len);
+          validCount += v.valid();
+          acc = v.get<GameConfigMsg::Key>() + static_cast<uint32_t>(v.getSigned<GameConfigMsg::Value>());
+          break;
+        }
+        default:
+          break;
+      }
+      sink = sink + acc;
+    }
+    const auto t1 = std::chrono::steady_clock::now();
+    TEST_ASSERT_EQUAL_UINT32(kDecodes, validCount);
+    const double ms = std::chrono::duration<double, std::milli>(t1 - t0).count();
+    char msg[128];
+    std::snprintf(msg, sizeof(msg), "proto: %lu decodes in %.1f ms (%.1f M packets/s)",
+                  static_cast<unsigned long>(kDecodes), ms, kDecodes / ms / 1000.0);
+    TEST_MESSAGE(msg);
+  }
+}
+#endif  // ARDUINO
+
+#ifndef ARDUINO
+// World simulator — path-loss sanity, identical reports for any thread
+// count, and delivery falling as the channel gets crowded.
+void test_world_simulator_deterministic(void)
+{
+  using namespace asap::sim;
+
+  const PathLoss model;
+  TEST_ASSERT_TRUE(model.meanRssiDbm(10.0f) > model.meanRssiDbm(100.0f));
+  TEST_ASSERT_INT_WITHIN(1, -40 + 10 - 27, static_cast<int>(model.meanRssiDbm(10.0f)));
+  TEST_ASSERT_EQUAL_INT16(model.rssiDbm(42.0f, 7, 3, 9), model.rssiDbm(42.0f, 7, 9, 3));
+  TEST_ASSERT_TRUE(gaussian(7, 1) == gaussian(7, 1));
+  TEST_ASSERT_FALSE(gaussian(7, 1) == gaussian(8, 1));
+
+  std::vector<WorldConfig> configs(4);
+  for (size_t i = 0; i < configs.size(); ++i)
+  {
+    configs[i].seed = 100 + i;
+    configs[i].areaM = 300.0f;  // some links at the edge of range, so the map decides delivery
+    configs[i].durationMs = 60000;
+    configs[i].hudSampleMs = 5000;
+  }
+  const std::vector<WorldReport> serial = WorldRunner(1).run(configs);
+  const WorldRunner pool(4);
+  const std::vector<WorldReport> parallel = pool.run(configs);
+  TEST_ASSERT_EQUAL_UINT32(configs.size(), parallel.size());
+  for (size_t i = 0; i < configs.size(); ++i)
+  {
+    const WorldReport& a = serial[i];
+    const WorldReport& b = parallel[i];
+    TEST_ASSERT_TRUE(a.seed == b.seed);
+    TEST_ASSERT_EQUAL_UINT32(a.transmissions, b.transmissions);
+    TEST_ASSERT_EQUAL_UINT32(a.overlaps, b.overlaps);
+    TEST_ASSERT_TRUE(a.received == b.received && a.collided == b.collided && a.busy == b.busy);
+    TEST_ASSERT_TRUE(a.decoded == b.decoded && a.outOfRange == b.outOfRange);
+    TEST_ASSERT_EQUAL_UINT32(a.hud.size(), b.hud.size());
+    for (size_t h = 0; h < a.hud.size(); ++h)
+    {
+      TEST_ASSERT_EQUAL_UINT16(a.hud[h].trackingId, b.hud[h].trackingId);
+      TEST_ASSERT_EQUAL_INT16(a.hud[h].trackingRssiDbm, b.hud[h].trackingRssiDbm);
+      TEST_ASSERT_EQUAL_UINT32(a.hud[h].beacons, b.hud[h].beacons);
+    }
+    // Every emitter ticks once a second or faster, so most packets get
+    // through and every detector's HUD has picked up a beacon (auto
+    // tracking: the strongest one in its table).
+    TEST_ASSERT_EQUAL_UINT32(60000, a.simulatedMs);
+    TEST_ASSERT_TRUE(a.transmissions > 1000);
+    TEST_ASSERT_TRUE(a.deliveryRatio() > 0.9);
+    TEST_ASSERT_TRUE(a.decoded <= a.received);
+    for (size_t h = a.hud.size() - configs[i].detectors; h < a.hud.size(); ++h)
+    {
+      TEST_ASSERT_TRUE(a.hud[h].trackingId >= 1 && a.hud[h].trackingId <= configs[i].beacons);
+      TEST_ASSERT_TRUE(a.hud[h].trackingRssiDbm > -100);
+      TEST_ASSERT_TRUE(a.hud[h].beacons > 0);
+    }
+  }
+  TEST_ASSERT_FALSE(serial[0].received == serial[1].received && serial[0].collided == serial[1].collided);
+
+  // Ten times the emitters on the same map: far more packets are lost.
+  WorldConfig crowded = configs[0];
+  crowded.beacons = 120;
+  crowded.anomalies = 30;
+  crowded.artifacts = 10;
+  crowded.hudSampleMs = 0;
+  const WorldReport dense = World(crowded).run();
+  TEST_ASSERT_TRUE(dense.collisionRate() > 4 * serial[0].collisionRate());
+  TEST_ASSERT_TRUE(dense.deliveryRatio() < serial[0].deliveryRatio());
+
+  // A huge map: most pairs are out of range and do not count as losses.
+  WorldConfig sparse = configs[0];
+  sparse.areaM = 5000.0f;
+  sparse.hudSampleMs = 0;
+  const WorldReport far = World(sparse).run();
+  TEST_ASSERT_TRUE(far.outOfRange > far.inRange());
+
+  char msg[160];
+  std::snprintf(msg, sizeof(msg),
+                "world sim: %u devices, delivery %.1f%% (%.1f%% with %u devices), %.0fx real time, %u threads",
+                serial[0].devices, 100.0 * serial[0].deliveryRatio(), 100.0 * dense.deliveryRatio(),
+                dense.devices, serial[0].speedup(), pool.threads());
+  TEST_MESSAGE(msg);
+}
+#endif  // ARDUINO
+
+#ifndef ARDUINO
+// TDMA MAC — ID-derived slot hopping, following the sync beacon, per-slot
+// airtime, and collision probability against free-running emitters at 10,
+// 50 and 200 transmitters in the world simulator.
+void test_tdma_mac_slots_and_collisions(void)
+{
+  using asap::radio::SuperframeConfig;
+  using asap::radio::TdmaMac;
+
+  // One block of dataSlots IDs never shares a slot; IDs from two blocks
+  // with the same residue share one in 1 of 61 frames.
+  constexpr uint8_t kSlots = 61;
+  for (uint16_t frame = 0; frame < 200; ++frame)
+  {
+    uint64_t used[2] = {0, 0};
+    for (uint16_t id = 0; id < kSlots; ++id)
+    {
+      const uint8_t slot = TdmaMac::hopSlot(id, frame, kSlots);
+      TEST_ASSERT_TRUE(slot >= 1 && slot <= kSlots);
+      TEST_ASSERT_TRUE((used[slot / 64] & (1ull << (slot % 64))) == 0);
+      used[slot / 64] |= 1ull << (slot % 64);
+    }
+  }
+  unsigned shared = 0;
+  for (uint16_t frame = 0; frame < kSlots; ++frame)
+  {
+    shared += TdmaMac::hopSlot(5, frame, kSlots) == TdmaMac::hopSlot(5 + kSlots, frame, kSlots) ? 1 : 0;
+  }
+  TEST_ASSERT_EQUAL_UINT32(1, shared);
+
+  // The source opens superframes on its own clock; a follower powered up
+  // elsewhere in time adopts them from one sync beacon.
+  const SuperframeConfig shape;
+  TdmaMac source(shape.syncSourceId, shape);
+  TdmaMac follower(7, SuperframeConfig{10, 20, 2, 1});  // shape comes from the beacon
+  source.begin(1000, 1000);
+  follower.begin(50000, 1000);
+  TEST_ASSERT_EQUAL_UINT16(496, source.superframeMs());
+  TEST_ASSERT_EQUAL_UINT16(2, source.everyFrames());
+  TEST_ASSERT_TRUE(source.synced(1000));
+  TEST_ASSERT_FALSE(follower.synced(50000));
+  TEST_ASSERT_EQUAL_UINT32(1000 + 4 * 496, source.nextSyncMs(1001 + 3 * 496));
+  const uint32_t acquire = follower.acquireDelayMs();
+  TEST_ASSERT_TRUE(acquire >= 2u * follower.superframeMs() && acquire < 3u * follower.superframeMs());
+
+  // Sync for source frame 40 (source time 1000 + 40 * 496) heard by the
+  // follower, whose clock reads 70000 then, at the end of reception.
+  const uint8_t syncAir = asap::radio::airtimeMs(11);
+  TEST_ASSERT_EQUAL_UINT8(5, syncAir);
+  TEST_ASSERT_TRUE(follower.onSync(70000, 40, shape.slotMs, shape.dataSlots, syncAir));
+  TEST_ASSERT_FALSE(follower.onSync(70000 + 2 * 496, 42, shape.slotMs, shape.dataSlots, syncAir));
+  TEST_ASSERT_TRUE(follower.onSync(70000 + 4 * 496 + 3, 44, shape.slotMs, shape.dataSlots, syncAir));  // 3 ms off
+  TEST_ASSERT_FALSE(follower.onSync(70000 + 6 * 496 + 3, 46, shape.slotMs, shape.dataSlots, syncAir));
+  TEST_ASSERT_EQUAL_UINT16(496, follower.superframeMs());
+  TEST_ASSERT_EQUAL_UINT16(2, follower.everyFrames());
+  TEST_ASSERT_EQUAL_UINT32(4, follower.syncsHeard());
+  TEST_ASSERT_EQUAL_UINT32(2, follower.resyncs());
+  const uint32_t frame50 = 70000 + 3 - syncAir + 10 * 496;  // follower time of frame 50
+  TEST_ASSERT_EQUAL_UINT16(50, follower.frameAt(frame50));
+  TEST_ASSERT_EQUAL_UINT8(0, follower.slotAt(frame50));
+  TEST_ASSERT_EQUAL_UINT8(3, follower.slotAt(frame50 + 3 * 8 + 7));
+
+  // Own slots: odd frames only (ID 7, every 2nd frame), at the hop slot.
+  const uint32_t next = follower.nextDataSlotMs(frame50);
+  TEST_ASSERT_EQUAL_UINT32(frame50 + 496 + TdmaMac::hopSlot(7, 51, 61) * 8, next);
+  TEST_ASSERT_TRUE(follower.mayTransmit(next, 6));
+  TEST_ASSERT_TRUE(follower.mayTransmit(next + 2, 6));
+  TEST_ASSERT_FALSE(follower.mayTransmit(next + 3, 6));  // would spill over
+  TEST_ASSERT_FALSE(follower.mayTransmit(next - 1, 6));
+  TEST_ASSERT_EQUAL_UINT32(next + 2 * 496 + (TdmaMac::hopSlot(7, 53, 61) - TdmaMac::hopSlot(7, 51, 61)) * 8,
+                           follower.nextDataSlotMs(next + 1));
+
+  // Airtime lands on the slot each packet started in.
+  const uint8_t own = TdmaMac::hopSlot(7, 51, 61);
+  follower.noteTx(next, 5);
+  follower.noteTx(next + 496 * 2, 5);  // frame 53, same slot position as frame 51
+  follower.noteRx(frame50 + 2 * 8 + 1 + 5, 5);
+  TEST_ASSERT_EQUAL_UINT32(10, follower.slotAirtime(own).txMs);
+  TEST_ASSERT_EQUAL_UINT32(5, follower.slotAirtime(2).rxMs);
+  TEST_ASSERT_EQUAL_UINT32(0, follower.slotAirtime(2).txMs);
+  TEST_ASSERT_EQUAL_UINT32(10, follower.txAirtimeMs());
+
+  // Eight sync periods without a beacon: free-running again.
+  TEST_ASSERT_TRUE(follower.synced(70000 + 6 * 496 + 15 * 496));
+  TEST_ASSERT_FALSE(follower.synced(70000 + 6 * 496 + 17 * 496));
+
+  // World: free-running periods against TDMA with the same emitters. The
+  // last point carries 200 on a 251-slot superframe, one packet each per
+  // superframe (artifacts every third).
+  using namespace asap::sim;
+  struct Point
+  {
+    uint16_t emitters;
+    uint8_t slotMs;
+    uint8_t dataSlots;
+  };
+  const Point points[] = {{10, 8, 61}, {50, 8, 61}, {200, 8, 61}, {200, 7, 251}};
+  std::vector<WorldConfig> configs;
+  for (const Point& point : points)
+  {
+    for (int tdma = 0; tdma < 2; ++tdma)
+    {
+      WorldConfig config;
+      config.seed = 17;
+      config.beacons = static_cast<uint16_t>(point.emitters * 7 / 10);
+      config.anomalies = static_cast<uint16_t>(point.emitters * 2 / 10);
+      config.artifacts = static_cast<uint16_t>(point.emitters - config.beacons - config.anomalies);
+      config.detectors = 4;
+      config.durationMs = 60000;
+      config.hudSampleMs = 0;
+      config.tdma = tdma != 0;
+      config.superframe.slotMs = point.slotMs;
+      config.superframe.dataSlots = point.dataSlots;
+      if (point.dataSlots != 61)
+      {
+        const uint16_t frameMs = static_cast<uint16_t>((1 + point.dataSlots) * point.slotMs);
+        config.beaconPeriodMs = frameMs;
+        config.anomalyPeriodMs = frameMs;
+        config.artifactPeriodMs = static_cast<uint16_t>(3 * frameMs);
+      }
+      configs.push_back(config);
+    }
+  }
+  const std::vector<WorldReport> reports = WorldRunner().run(configs);
+  char msg[200];
+  int used = std::snprintf(msg, sizeof(msg), "tdma: p(collision) aloha/tdma");
+  for (size_t i = 0; i < 4; ++i)
+  {
+    const WorldReport& aloha = reports[2 * i];
+    const WorldReport& tdma = reports[2 * i + 1];
+    TEST_ASSERT_EQUAL_UINT16(tdma.emitters, tdma.syncedEmitters);
+    TEST_ASSERT_TRUE(tdma.txAirtimeMs > 0);
+    used += std::snprintf(msg + used, sizeof(msg) - used, " %u tx %.1f%%/%.1f%%", points[i].emitters,
+                          100.0 * aloha.collisionProbability(), 100.0 * tdma.collisionProbability());
+  }
+  // Up to one block of IDs per superframe the schedule is collision free;
+  // 200 emitters at the default rates need more slots than a superframe has
+  // and saturate either way.
+  TEST_ASSERT_TRUE(reports[2].collisionProbability() > 0.05);
+  TEST_ASSERT_EQUAL_UINT32(0, reports[3].overlapped);
+  TEST_ASSERT_TRUE(reports[3].deliveryRatio() > 0.99);
+  TEST_ASSERT_TRUE(reports[5].collisionProbability() > 0.5);
+  TEST_ASSERT_TRUE(reports[6].collisionProbability() > 0.2);
+  TEST_ASSERT_TRUE(reports[7].collisionProbability() < 0.01);
+  TEST_ASSERT_TRUE(reports[7].deliveryRatio() > 0.98);
+  TEST_MESSAGE(msg);
+
+  // The 50-emitter field with the beacon image as built: stakes slotted,
+  // asleep between their slots and the sync windows, beacon 1 the source.
+  WorldConfig stakes = configs[3];
+  stakes.dutyCycledBeacons = true;
+  const WorldReport field = World(stakes).run();
+  TEST_ASSERT_EQUAL_UINT16(35, field.dutyBeacons);
+  TEST_ASSERT_EQUAL_UINT16(field.emitters, field.syncedEmitters);
+  TEST_ASSERT_EQUAL_UINT32(0, field.overlapped);
+  TEST_ASSERT_TRUE(field.deliveryRatio() > 0.99);
+  TEST_ASSERT_TRUE(field.beaconDutyPpm < 30000);
+  std::snprintf(msg, sizeof(msg), "tdma: 50 tx with stakes: delivery %.2f%%, stake duty %.3f%%, %.3f mAh/h",
+                100.0 * field.deliveryRatio(), field.beaconDutyPpm / 10000.0, field.beaconAverageUa / 1000.0);
+  TEST_MESSAGE(msg);
+}
+#endif  // ARDUINO
+
+#ifndef ARDUINO
+// Detector tracking table: hash map semantics (probe runs survive deletion,
+// sequence gaps, EMA, age-out, full table) and a 256-emitter benchmark
+// against the linear scan a flat array would need.
+void test_tracking_table_256_emitters(void)
+{
+  using asap::proto::MsgType;
+  using asap::track::TrackEntry;
+  constexpr uint16_t kEmitters = 256;
+  static asap::track::TrackingTable<512> table;
+  table.clear();
+
+  // Two populations: a consecutive batch and random 16-bit IDs.
+  uint16_t ids[kEmitters];
+  uint32_t rng = 0x2545F491u;
+  auto next = [&rng]() {
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    return rng;
+  };
+  for (uint16_t i = 0; i < kEmitters; ++i)
+  {
+    if (i < kEmitters / 2)
+    {
+      ids[i] = static_cast<uint16_t>(i + 1);
+      continue;
+    }
+    bool unique;
+    do
+    {
+      ids[i] = static_cast<uint16_t>(next());
+      unique = ids[i] != 0 && ids[i] != asap::proto::kBroadcastId;
+      for (uint16_t j = 0; j < i && unique; ++j)
+      {
+        unique = ids[j] != ids[i];
+      }
+    } while (!unique);
+  }
+  auto kindOf = [](uint16_t i) { return i % 10 == 0 ? MsgType::Artifact : (i % 5 == 0 ? MsgType::Anomaly : MsgType::Beacon); };
+  auto rssiOf = [](uint16_t i) { return static_cast<int16_t>(-40 - (i * 37) % 60); };
+
+  for (uint16_t i = 0; i < kEmitters; ++i)
+  {
+    TEST_ASSERT_NOT_NULL(table.update(ids[i], kindOf(i), rssiOf(i), 0, 1000));
+  }
+  TEST_ASSERT_EQUAL_UINT16(kEmitters, table.size());
+  TEST_ASSERT_NULL(table.update(0, MsgType::Beacon, -50, 0, 1000));
+  for (uint16_t i = 0; i < kEmitters; ++i)
+  {
+    const TrackEntry* e = table.find(ids[i]);
+    TEST_ASSERT_NOT_NULL(e);
+    TEST_ASSERT_EQUAL_UINT16(ids[i], e->id);
+    TEST_ASSERT_EQUAL_INT16(rssiOf(i), e->rssiDbm());
+  }
+
+  // Sequence gaps count as missed packets; duplicates and wrap do not.
+  const uint16_t probeId = ids[3];
+  table.update(probeId, MsgType::Beacon, -50, 1, 1100);
+  table.update(probeId, MsgType::Beacon, -50, 4, 1200);    // 2, 3 missed
+  table.update(probeId, MsgType::Beacon, -50, 4, 1250);    // duplicate
+  table.update(probeId, MsgType::Beacon, -50, 255, 1300);  // reboot / reorder
+  table.update(probeId, MsgType::Beacon, -50, 1, 1400);    // 0 missed across wrap
+  const TrackEntry* probe = table.find(probeId);
+  TEST_ASSERT_EQUAL_UINT32(6, probe->packets);
+  TEST_ASSERT_EQUAL_UINT32(3, probe->missed);
+  TEST_ASSERT_EQUAL_UINT32(1000, probe->firstSeenMs);
+  TEST_ASSERT_EQUAL_UINT32(1400, probe->lastSeenMs);
+  // EMA (alpha 1/4) converges on a step in 1/16 dB without sticking short.
+  for (int k = 0; k < 40; ++k)
+  {
+    table.update(probeId, MsgType::Beacon, -90, static_cast<uint8_t>(2 + k), 1500 + k);
+  }
+  TEST_ASSERT_EQUAL_INT16(-90, table.find(probeId)->rssiDbm());
+  TEST_ASSERT_EQUAL_INT16(-90, table.find(probeId)->lastRssiDbm);
+
+  // strongest() against a brute-force ranking, per kind and overall.
+  const MsgType kinds[] = {MsgType::Unknown, MsgType::Beacon, MsgType::Anomaly, MsgType::Artifact};
+  for (MsgType kind : kinds)
+  {
+    const TrackEntry* top[6];
+    const uint8_t found = table.strongest(top, 6, kind);
+    TEST_ASSERT_EQUAL_UINT8(6, found);
+    for (uint8_t r = 0; r < found; ++r)
+    {
+      TEST_ASSERT_TRUE(kind == MsgType::Unknown || top[r]->kind == kind);
+      TEST_ASSERT_TRUE(r == 0 || top[r - 1]->rssiQ4 >= top[r]->rssiQ4);
+      uint16_t stronger = 0;
+      for (uint16_t i = 0; i < table.capacity(); ++i)
+      {
+        const TrackEntry* e = table.slot(i);
+        stronger += e && (kind == MsgType::Unknown || e->kind == kind) && e->rssiQ4 > top[r]->rssiQ4;
+      }
+      TEST_ASSERT_TRUE(stronger <= r);
+    }
+  }
+
+  // Deleting every other emitter must not cut any remaining probe run.
+  for (uint16_t i = 0; i < kEmitters; i += 2)
+  {
+    TEST_ASSERT_TRUE(table.remove(ids[i]));
+  }
+  TEST_ASSERT_FALSE(table.remove(ids[0]));
+  for (uint16_t i = 0; i < kEmitters; ++i)
+  {
+    TEST_ASSERT_EQUAL(i % 2 != 0, table.find(ids[i]) != nullptr);
+  }
+
+  // Age-out: only emitters quiet for longer than ageOutMs go, and one heard
+  // again after that restarts instead of counting the gap as missed.
+  table.setAgeOutMs(5000);
+  for (uint16_t i = 1; i < kEmitters; i += 4)
+  {
+    table.update(ids[i], kindOf(i), rssiOf(i), 1, 4000);
+  }
+  TEST_ASSERT_EQUAL_UINT16(0, table.expire(6000));
+  TEST_ASSERT_EQUAL_UINT16(kEmitters / 4 - 1, table.expire(6500));  // last heard at 1000
+  TEST_ASSERT_EQUAL_UINT16(kEmitters / 4 + 1, table.size());
+  TEST_ASSERT_EQUAL_UINT32(46, table.find(probeId)->packets);  // heard until 1539
+  table.update(probeId, MsgType::Beacon, -60, 200, 20000);
+  TEST_ASSERT_EQUAL_UINT32(1, table.find(probeId)->packets);
+  TEST_ASSERT_EQUAL_UINT32(0, table.find(probeId)->missed);
+  TEST_ASSERT_EQUAL_UINT32(20000, table.find(probeId)->firstSeenMs);
+  TEST_ASSERT_EQUAL_UINT16(kEmitters / 4, table.expire(9001));  // last heard at 4000
+  TEST_ASSERT_EQUAL_UINT16(1, table.size());
+
+  // Full table: new IDs are dropped, known ones still update.
+  asap::track::TrackingTable<16> small;
+  for (uint16_t id = 1; id <= small.maxSize(); ++id)
+  {
+    TEST_ASSERT_NOT_NULL(small.update(id, MsgType::Beacon, -50, 0, 0));
+  }
+  TEST_ASSERT_NULL(small.update(1000, MsgType::Beacon, -50, 0, 0));
+  TEST_ASSERT_NOT_NULL(small.update(5, MsgType::Beacon, -50, 1, 10));
+  TEST_ASSERT_EQUAL_UINT32(1, small.dropped());
+
+  // Benchmark: packets from 256 emitters in random order, then HUD queries.
+  table.clear();
+  table.setAgeOutMs(asap::track::TrackingTableBase::kDefaultAgeOutMs);
+  constexpr uint32_t kPackets = 1u << 20;
+  static uint16_t order[kPackets];
+  for (uint32_t k = 0; k < kPackets; ++k)
+  {
+    order[k] = static_cast<uint16_t>(next() % kEmitters);
+  }
+  struct Flat
+  {
+    uint16_t id;
+    int16_t rssiQ4;
+    uint32_t lastSeenMs;
+  };
+  static Flat flat[kEmitters];
+  uint16_t flatSize = 0;
+  using Clock = std::chrono::steady_clock;
+  const auto t0 = Clock::now();
+  for (uint32_t k = 0; k < kPackets; ++k)
+  {
+    const uint16_t i = order[k];
+    table.update(ids[i], kindOf(i), static_cast<int16_t>(rssiOf(i) - (k & 7)), static_cast<uint8_t>(k), k >> 4);
+  }
+  const auto t1 = Clock::now();
+  for (uint32_t k = 0; k < kPackets; ++k)
+  {
+    const uint16_t i = order[k];
+    uint16_t at = 0;
+    while (at < flatSize && flat[at].id != ids[i])
+    {
+      ++at;
+    }
+    if (at == flatSize)
+    {
+      flat[flatSize++] = Flat{ids[i], static_cast<int16_t>(rssiOf(i) * 16), 0};
+    }
+    flat[at].rssiQ4 = static_cast<int16_t>((16 * (rssiOf(i) - (k & 7)) + 3 * flat[at].rssiQ4) / 4);
+    flat[at].lastSeenMs = k >> 4;
+  }
+  const auto t2 = Clock::now();
+  constexpr int kQueries = 20000;
+  uint32_t checksum = 0;
+  for (int q = 0; q < kQueries; ++q)
+  {
+    const TrackEntry* top[4];
+    checksum += table.strongest(top, 4);
+    checksum += top[0]->id;
+  }
+  const auto t3 = Clock::now();
+  TEST_ASSERT_EQUAL_UINT16(kEmitters, table.size());
+  TEST_ASSERT_EQUAL_UINT16(kEmitters, flatSize);
+  TEST_ASSERT_TRUE(checksum > 0);
+
+  const double hashNs = std::chrono::duration<double, std::nano>(t1 - t0).count() / kPackets;
+  const double scanNs = std::chrono::duration<double, std::nano>(t2 - t1).count() / kPackets;
+  const double topUs = std::chrono::duration<double, std::micro>(t3 - t2).count() / kQueries;
+  char msg[160];
+  std::snprintf(msg, sizeof(msg),
+                "tracking bench (%u emitters, %u slots): update %.1f ns, linear scan %.1f ns (x%.1f), "
+                "top-4 %.2f us, longest probe %u",
+                kEmitters, table.capacity(), hashNs, scanNs, hashNs > 0 ? scanNs / hashNs : 0.0, topUs,
+                table.longestProbe());
+  TEST_MESSAGE(msg);
+}
+#endif  // ARDUINO
+
+#ifndef ARDUINO
+namespace
+{
+
+// RSSI trace of one emitter as the detector samples it: path loss at the
+// true distance plus fast fading, with a few deep fades (a body in the way,
+// a half-collided packet) that a robust filter should ignore.
+struct RssiTrace
+{
+  std::vector<int16_t> samples;  // dBm, as from the radio
+  std::vector<float> truth;      // mean level at that distance
+};
+
+RssiTrace MakeRssiTrace(const std::vector<float>& distanceM, uint64_t seed)
+{
+  asap::sim::PathLoss model;
+  RssiTrace trace;
+  for (size_t k = 0; k < distanceM.size(); ++k)
+  {
+    const float mean = model.meanRssiDbm(distanceM[k]);
+    float sample = mean + 3.0f * asap::sim::gaussian(seed, 2 * k);
+    if (asap::sim::gaussian(seed, 2 * k + 1) > 1.9f)  // ~3 %
+    {
+      sample -= 20.0f;
+    }
+    trace.truth.push_back(mean);
+    trace.samples.push_back(static_cast<int16_t>(sample < 0 ? sample - 0.5f : sample + 0.5f));
+  }
+  return trace;
+}
+
+std::vector<int16_t> RunFilter(asap::track::FilterKind kind, const asap::track::FilterConfig& config,
+                               const std::vector<int16_t>& samples)
+{
+  asap::track::TrackFilter filter;
+  filter.reset(kind);
+  std::vector<int16_t> out;
+  for (int16_t x : samples)
+  {
+    out.push_back(filter.feed(x, config));
+  }
+  return out;
+}
+
+// RMS of output (Q4) against truth delayed by `lag` samples, from `from`.
+double RmsErrorDb(const std::vector<int16_t>& outQ4, const std::vector<float>& truth, size_t lag, size_t from)
+{
+  double sum = 0.0;
+  size_t n = 0;
+  for (size_t k = from; k < outQ4.size(); ++k)
+  {
+    const double e = outQ4[k] / 16.0 - truth[k - lag];
+    sum += e * e;
+    ++n;
+  }
+  return n ? std::sqrt(sum / n) : 0.0;
+}
+
+}  // namespace
+
+// Filter bank: exact fixed-point behaviour of each filter, runtime selection
+// per emitter, and a noise / lag / cost table over synthetic traces (a beacon
+// standing at 25 m, a player walking past one) for choosing the field
+// default.
+void test_rssi_filter_bank_traces(void)
+{
+  using asap::track::FilterConfig;
+  using asap::track::FilterKind;
+  using asap::track::RssiFilter;
+  const FilterConfig config;
+
+  // EMA, alpha 1/4, in 1/16 dB.
+  RssiFilter<5> ema;
+  TEST_ASSERT_EQUAL_INT16(-60 * 16, ema.feed(-60, config));
+  TEST_ASSERT_EQUAL_INT16(-65 * 16, ema.feed(-80, config));
+  TEST_ASSERT_EQUAL_INT16(-1100, ema.feed(-80, config));  // -1040 + (-320 * 3 / 4) / 4
+
+  // Median of five: one spike never shows.
+  RssiFilter<5> median;
+  median.reset(FilterKind::Median);
+  const int16_t spiky[] = {-60, -61, -100, -59, -60, -60, -20};
+  int16_t last = 0;
+  for (int16_t x : spiky)
+  {
+    last = median.feed(x, config);
+  }
+  TEST_ASSERT_EQUAL_INT16(-60 * 16, last);
+  TEST_ASSERT_EQUAL_INT16(static_cast<int16_t>(-60.5 * 16), [] {
+    RssiFilter<5> m;
+    m.reset(FilterKind::Median);
+    m.feed(-60, FilterConfig{});
+    return m.feed(-61, FilterConfig{});  // two samples: mean of the middle pair
+  }());
+
+  // Hampel: a spike is replaced by the median, a sustained step is taken
+  // once it is the majority of the window.
+  RssiFilter<5> hampel;
+  hampel.reset(FilterKind::Hampel);
+  for (int k = 0; k < 5; ++k)
+  {
+    hampel.feed(static_cast<int16_t>(-60 - (k & 1)), config);
+  }
+  const int16_t settled = hampel.feed(-60, config);
+  const int16_t afterSpike = hampel.feed(-95, config);  // the median (-60) goes in instead
+  TEST_ASSERT_TRUE(afterSpike >= -61 * 16 && afterSpike <= -60 * 16);
+  TEST_ASSERT_EQUAL_UINT16(1, hampel.rejected());
+  hampel.feed(-80, config);
+  TEST_ASSERT_EQUAL_UINT16(2, hampel.rejected());  // window -60 -95 -80 -61 -60
+  const int16_t stepped = hampel.feed(-80, config);  // window -60 -95 -80 -80 -60: median -80
+  TEST_ASSERT_EQUAL_UINT16(2, hampel.rejected());
+  TEST_ASSERT_TRUE(stepped < settled - 4 * 16);
+
+  // Kalman: holds a constant level exactly and settles monotonically.
+  RssiFilter<5> kalman;
+  kalman.reset(FilterKind::Kalman);
+  for (int k = 0; k < 50; ++k)
+  {
+    TEST_ASSERT_EQUAL_INT16(-70 * 16, kalman.feed(-70, config));
+  }
+  int16_t prev = -70 * 16;
+  for (int k = 0; k < 200; ++k)
+  {
+    const int16_t y = kalman.feed(-90, config);
+    TEST_ASSERT_TRUE(y <= prev && y >= -90 * 16);
+    prev = y;
+  }
+  TEST_ASSERT_TRUE(prev <= -90 * 16 + 16);
+
+  // Runtime selection per emitter in the tracking table.
+  static asap::track::TrackingTable<16> table;
+  table.clear();
+  table.setDefaultFilter(FilterKind::Median);
+  table.update(7, asap::proto::MsgType::Beacon, -60, 0, 0);
+  table.update(8, asap::proto::MsgType::Beacon, -60, 0, 0);
+  TEST_ASSERT_TRUE(table.setFilter(8, FilterKind::Kalman));
+  TEST_ASSERT_FALSE(table.setFilter(9, FilterKind::Kalman));
+  TEST_ASSERT_EQUAL(FilterKind::Median, table.find(7)->filter.kind());
+  TEST_ASSERT_EQUAL(FilterKind::Kalman, table.find(8)->filter.kind());
+  table.update(7, asap::proto::MsgType::Beacon, -60, 1, 10);
+  table.update(7, asap::proto::MsgType::Beacon, -100, 2, 20);
+  TEST_ASSERT_EQUAL_INT16(-60, table.find(7)->rssiDbm());
+  table.update(8, asap::proto::MsgType::Beacon, -80, 1, 10);  // restarted: passes through
+  TEST_ASSERT_EQUAL_INT16(-80, table.find(8)->rssiDbm());
+
+  // The UI's tracking page shows the entry's filtered value as is.
+  DetectorDisplay display(kDummyPins);
+  TEST_ASSERT_TRUE(display.begin());
+  asap::ui::UIController ui(display);
+  ui.setTrackedEmitter(7, table.find(7)->rssiDbm());
+  TEST_ASSERT_EQUAL_INT16(-60, ui.trackingRssi());
+
+  // Traces: 600 s of a beacon at 25 m (1 Hz), and four passes of a player
+  // walking from 60 m to 3 m and back at 1.4 m/s (2 Hz samples).
+  std::vector<float> standing(600, 25.0f);
+  std::vector<float> walking;
+  for (int pass = 0; pass < 4; ++pass)
+  {
+    for (float t = 0; t < 2 * 57 / 1.4f; t += 0.5f)
+    {
+      const float d = 60.0f - 1.4f * t;
+      walking.push_back(d > 3.0f ? d : 3.0f + (3.0f - d));
+    }
+  }
+  const RssiTrace still = MakeRssiTrace(standing, 11);
+  const RssiTrace walk = MakeRssiTrace(walking, 12);
+
+  struct Candidate
+  {
+    const char* name;
+    FilterKind kind;
+    FilterConfig config;
+  };
+  FilterConfig slowEma;
+  slowEma.emaAlphaQ8 = 32;
+  const Candidate candidates[] = {
+      {"ema 1/4", FilterKind::Ema, FilterConfig{}}, {"ema 1/8", FilterKind::Ema, slowEma},
+      {"median5", FilterKind::Median, FilterConfig{}}, {"hampel5", FilterKind::Hampel, FilterConfig{}},
+      {"kalman", FilterKind::Kalman, FilterConfig{}},
+  };
+  const double rawNoise = [&] {
+    std::vector<int16_t> q4;
+    for (int16_t x : still.samples)
+    {
+      q4.push_back(static_cast<int16_t>(16 * x));
+    }
+    return RmsErrorDb(q4, still.truth, 0, 0);
+  }();
+  char msg[200];
+  std::snprintf(msg, sizeof(msg), "rssi filters: raw noise %.2f dB rms; columns: still rms dB, walk rms dB, lag samples, ns, cycles",
+                rawNoise);
+  TEST_MESSAGE(msg);
+
+  double emaNoise = 0.0;
+  for (const Candidate& c : candidates)
+  {
+    const std::vector<int16_t> outStill = RunFilter(c.kind, c.config, still.samples);
+    const std::vector<int16_t> outWalk = RunFilter(c.kind, c.config, walk.samples);
+    const double noise = RmsErrorDb(outStill, still.truth, 0, 20);
+    const double walkRms = RmsErrorDb(outWalk, walk.truth, 0, 20);
+    size_t lag = 0;
+    double best = walkRms;
+    for (size_t s = 1; s <= 10; ++s)
+    {
+      const double e = RmsErrorDb(outWalk, walk.truth, s, 20);
+      if (e < best)
+      {
+        best = e;
+        lag = s;
+      }
+    }
+    TEST_ASSERT_TRUE(noise < rawNoise);
+    TEST_ASSERT_TRUE(walkRms < 6.0);
+    if (c.kind == FilterKind::Ema && c.config.emaAlphaQ8 == 64)
+    {
+      emaNoise = noise;
+    }
+    else if (c.kind == FilterKind::Hampel || c.kind == FilterKind::Kalman)
+    {
+      TEST_ASSERT_TRUE(noise < emaNoise);  // the reason to have them
+    }
+
+    // Cost: the whole walking trace, many times over, through one filter.
+    constexpr int kRepeats = 400;
+    asap::track::TrackFilter filter;
+    filter.reset(c.kind);
+    int32_t sink = 0;
+    const auto t0 = std::chrono::steady_clock::now();
+#if defined(__x86_64__) || defined(__i386__)
+    const uint64_t c0 = __rdtsc();
+#endif
+    for (int r = 0; r < kRepeats; ++r)
+    {
+      for (int16_t x : walk.samples)
+      {
+        sink += filter.feed(x, c.config);
+      }
+    }
+#if defined(__x86_64__) || defined(__i386__)
+    const double cycles = static_cast<double>(__rdtsc() - c0) / (kRepeats * walk.samples.size());
+#else
+    const double cycles = 0.0;
+#endif
+    const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count() /
+                      (kRepeats * walk.samples.size());
+    TEST_ASSERT_TRUE(sink != 0);
+    std::snprintf(msg, sizeof(msg), "  %-8s %6.2f %6.2f %3u %6.1f %6.0f", c.name, noise, walkRms,
+                  static_cast<unsigned>(lag), ns, cycles);
+    TEST_MESSAGE(msg);
+  }
+}
+#endif  // ARDUINO
+
+#ifndef ARDUINO
+namespace
+{
+
+// Drive an ExposureEngine the way the detector's tasks do: anomaly packets
+// every periodMs until stopMs, and tick() only at the deadlines it asks for.
+// Counts ticks and HUD pushes (takeChanged()), and checks that every push
+// carries a visible change.
+struct ExposureRun
+{
+  uint32_t ticks = 0;
+  uint32_t pushes = 0;
+  uint32_t lastTickMs = 0;
+  uint32_t nextTickMs = 0;
+  bool armed = false;
+};
+
+void DriveExposure(asap::game::ExposureEngine& engine, ExposureRun& run, uint32_t fromMs, uint32_t untilMs,
+                   uint32_t periodMs, uint32_t stopMs, const uint8_t intensity[4], int16_t rssiDbm)
+{
+  uint32_t nextPacket = fromMs;
+  uint32_t& nextTick = run.nextTickMs;
+  asap::game::ExposureView shown = engine.view();
+  for (;;)
+  {
+    const bool packetDue = periodMs && nextPacket < stopMs && (!run.armed || nextPacket < nextTick);
+    const uint32_t at = packetDue ? nextPacket : nextTick;
+    if ((!packetDue && !run.armed) || at >= untilMs)
+    {
+      return;
+    }
+    if (packetDue)
+    {
+      if (engine.onAnomaly(intensity, rssiDbm, at))
+      {
+        run.armed = true;
+        nextTick = at + engine.config().tickMs;
+      }
+      nextPacket += periodMs;
+      continue;
+    }
+    ++run.ticks;
+    run.lastTickMs = at;
+    run.armed = engine.tick(at, nextTick);
+    if (engine.takeChanged())
+    {
+      ++run.pushes;
+      TEST_ASSERT_TRUE(std::memcmp(&shown, &engine.view(), sizeof(shown)) != 0);
+      shown = engine.view();
+    }
+    else
+    {
+      TEST_ASSERT_EQUAL_MEMORY(&shown, &engine.view(), sizeof(shown));
+    }
+  }
+}
+
+}  // namespace
+
+// Exposure engine: exact dose arithmetic, stage carry-over, decay of the
+// current ring, idling, HUD pushes only on visible change, and the same HUD
+// from two runs of a world with anomalies.
+void test_exposure_engine_deterministic(void)
+{
+  using namespace asap::game;
+  ExposureConfig config;
+  for (ChannelConfig& channel : config.channels)
+  {
+    channel.ringMs = 10000;
+  }
+  config.channels[kRad].decayHalfLifeMs = 0;
+  config.channels[kTherm].decayHalfLifeMs = 10000;
+  const uint8_t hot[4] = {255, 255, 0, 0};
+
+  // Packets 0..9500 ms, each field held 1200 ms: 10.7 s at full intensity.
+  const uint16_t tickLengths[] = {100, 37, 1000};
+  uint32_t radDose[3];
+  for (int i = 0; i < 3; ++i)
+  {
+    ExposureConfig c = config;
+    c.tickMs = tickLengths[i];
+    ExposureEngine engine(c);
+    ExposureRun run;
+    DriveExposure(engine, run, 0, 12000, 500, 10000, hot, -40);
+    radDose[i] = engine.dose(kRad);
+    TEST_ASSERT_TRUE(run.pushes < run.ticks || c.tickMs == 1000);
+  }
+  TEST_ASSERT_EQUAL_UINT32(65536ULL * 10700 / 10000, radDose[0]);  // 1.07 rings
+  TEST_ASSERT_EQUAL_UINT32(radDose[0], radDose[1]);
+  TEST_ASSERT_EQUAL_UINT32(radDose[0], radDose[2]);
+
+  ExposureEngine engine(config);
+  ExposureRun run;
+  DriveExposure(engine, run, 0, 11000, 500, 10000, hot, -40);
+  TEST_ASSERT_EQUAL_UINT8(1, engine.view().stage[kRad]);  // a full ring carried over
+  TEST_ASSERT_EQUAL_UINT8(6, engine.view().percent[kRad]);  // 0.07 ring, truncated
+  TEST_ASSERT_EQUAL_UINT8(0, engine.view().stage[kTherm]);  // decay keeps it short of a ring
+  const uint8_t thermAt11s = engine.view().percent[kTherm];
+  TEST_ASSERT_TRUE(thermAt11s > 40 && thermAt11s < 100);
+  TEST_ASSERT_EQUAL_UINT8(0, engine.view().percent[kChem]);
+  TEST_ASSERT_EQUAL_UINT8(0, engine.field(kRad));  // hold ran out at 10.7 s
+
+  // Unexposed: therm halves per half-life, rad holds, ticks slow to 1 s.
+  const uint32_t ticksBefore = run.ticks;
+  DriveExposure(engine, run, 11000, 21001, 0, 0, hot, -40);
+  TEST_ASSERT_INT_WITHIN(2, thermAt11s / 2, engine.view().percent[kTherm]);  // Euler, 1 s steps
+  TEST_ASSERT_EQUAL_UINT8(6, engine.view().percent[kRad]);  // 0.07 ring, truncated
+  TEST_ASSERT_UINT32_WITHIN(1, 10, run.ticks - ticksBefore);
+
+  // Drained to 0 %: the engine goes idle and stops asking for ticks.
+  DriveExposure(engine, run, 21001, 600000, 0, 0, hot, -40);
+  TEST_ASSERT_FALSE(run.armed);
+  TEST_ASSERT_FALSE(engine.active());
+  TEST_ASSERT_EQUAL_UINT8(0, engine.view().percent[kTherm]);
+  TEST_ASSERT_TRUE(run.lastTickMs < 150000);
+
+  // Out of proximity range nothing starts; point blank for long enough
+  // reaches stage III at a full ring and stops there.
+  const uint8_t weak[4] = {0, 0, 255, 0};
+  TEST_ASSERT_FALSE(engine.onAnomaly(weak, config.rssiFloorDbm, 700000));
+  TEST_ASSERT_EQUAL_UINT16(128, engine.proximityQ8((config.rssiFloorDbm + config.rssiFullDbm) / 2));
+  ExposureRun longRun;
+  DriveExposure(engine, longRun, 700000, 760000, 500, 760000, weak, -20);
+  TEST_ASSERT_EQUAL_UINT8(3, engine.view().stage[kChem]);
+  TEST_ASSERT_EQUAL_UINT8(100, engine.view().percent[kChem]);
+  TEST_ASSERT_EQUAL_UINT8(1, engine.view().stage[kRad]);  // latched through all of it
+
+  // World: the detectors' HUDs follow the anomalies around them, identically
+  // on every run.
+  using namespace asap::sim;
+  WorldConfig world;
+  world.seed = 5;
+  world.beacons = 1;
+  world.anomalies = 3;
+  world.artifacts = 0;
+  world.detectors = 4;
+  world.areaM = 30.0f;
+  world.durationMs = 180000;
+  world.hudSampleMs = 1000;
+  const std::vector<WorldReport> reports = WorldRunner(2).run({world, world});
+  TEST_ASSERT_EQUAL_UINT32(reports[0].hud.size(), reports[1].hud.size());
+  uint32_t exposed = 0;
+  uint8_t topStage = 0;
+  for (size_t h = 0; h < reports[0].hud.size(); ++h)
+  {
+    TEST_ASSERT_EQUAL_MEMORY(&reports[0].hud[h].exposure, &reports[1].hud[h].exposure, sizeof(ExposureView));
+    for (uint8_t c = 0; c < kChannelCount; ++c)
+    {
+      exposed += reports[0].hud[h].exposure.percent[c] != 0 || reports[0].hud[h].exposure.stage[c] != 0;
+      topStage = std::max(topStage, reports[0].hud[h].exposure.stage[c]);
+    }
+  }
+  TEST_ASSERT_TRUE(exposed > 0);
+  char msg[128];
+  std::snprintf(msg, sizeof(msg), "exposure: %lu ticks, %lu HUD pushes; world: %lu exposed samples, top stage %u",
+                static_cast<unsigned long>(run.ticks), static_cast<unsigned long>(run.pushes),
+                static_cast<unsigned long>(exposed), topStage);
+  TEST_MESSAGE(msg);
+}
+#endif  // ARDUINO
+
+#ifndef ARDUINO
+namespace
+{
+
+// Scheduler clock on the medium's time; the test loop advances the medium.
+uint32_t MediumNow(void* medium)
+{
+  return static_cast<asap::radio::VirtualMedium*>(medium)->nowMs();
+}
+
+void MediumSleep(void*, uint32_t)
+{
+}
+
+}  // namespace
+
+// Duty-cycled beacon: the precomputed schedule, the radio asleep between
+// bursts (and restored after SLEEP), every copy heard by a listener, and the
+// power account's duty cycle, airtime and current for an hour; then the
+// same engine for every beacon of a world.
+void test_beacon_duty_cycle_power(void)
+{
+  using asap::power::PowerReport;
+  using asap::power::RadioState;
+  using asap::roles::BeaconConfig;
+  using asap::roles::BeaconSchedule;
+
+  // The table averages exactly periodMs, stays within the jitter, and is a
+  // function of the ID alone.
+  BeaconConfig config{42};
+  config.burstPackets = 2;
+  const uint8_t airMs = 5;
+  const BeaconSchedule schedule(config, airMs);
+  const BeaconSchedule again(config, airMs);
+  BeaconConfig other = config;
+  other.id = 43;
+  const BeaconSchedule neighbour(other, airMs);
+  TEST_ASSERT_EQUAL_UINT32(BeaconSchedule::kIntervals * 1000u, schedule.cycleMs());
+  bool differs = false;
+  bool jittered = false;
+  for (uint8_t i = 0; i < BeaconSchedule::kIntervals; ++i)
+  {
+    TEST_ASSERT_UINT16_WITHIN(config.jitterMs, 1000, schedule.intervalMs(i));
+    TEST_ASSERT_EQUAL_UINT16(schedule.intervalMs(i), again.intervalMs(i));
+    differs |= schedule.intervalMs(i) != neighbour.intervalMs(i);
+    jittered |= schedule.intervalMs(i) != 1000;
+  }
+  TEST_ASSERT_TRUE(differs && jittered);
+  TEST_ASSERT_TRUE(schedule.firstDelayMs() < 1000);
+  TEST_ASSERT_EQUAL_UINT8(2, schedule.packets());
+  BeaconConfig crowded = config;
+  crowded.periodMs = 100;
+  crowded.jitterMs = 500;
+  crowded.burstPackets = 20;
+  const BeaconSchedule clamped(crowded, airMs);
+  TEST_ASSERT_EQUAL_UINT16(50, clamped.jitterMs());
+  TEST_ASSERT_TRUE(clamped.packets() < 20 && clamped.packets() >= 1);
+  // A long period with a large jitter must not wrap the 16-bit intervals.
+  BeaconConfig sparse = config;
+  sparse.periodMs = 60000;
+  sparse.jitterMs = 20000;
+  const BeaconSchedule wide(sparse, airMs);
+  TEST_ASSERT_EQUAL_UINT16(5535, wide.jitterMs());
+  TEST_ASSERT_EQUAL_UINT32(BeaconSchedule::kIntervals * 60000u, wide.cycleMs());
+  for (uint8_t i = 0; i < BeaconSchedule::kIntervals; ++i)
+  {
+    TEST_ASSERT_UINT16_WITHIN(5535, 60000, wide.intervalMs(i));
+  }
+
+  // One hour of a stake with a listener next to it.
+  asap::radio::VirtualMedium air;
+  asap::radio::VirtualCc1101 stakeChip(air), listenerChip(air);
+  asap::radio::Cc1101 stakeRadio(stakeChip.port()), listener(listenerChip.port());
+  TEST_ASSERT_TRUE(stakeRadio.begin());
+  TEST_ASSERT_TRUE(listener.begin());
+  stakeChip.attach(stakeRadio);
+  listenerChip.attach(listener);
+  asap::core::Scheduler scheduler(asap::core::SchedulerClock{&MediumNow, &MediumSleep, &air});
+  asap::roles::BeaconEngine stake(stakeRadio, config);
+  stake.begin(scheduler);
+  TEST_ASSERT_TRUE(stakeRadio.asleep());
+  TEST_ASSERT_EQUAL_HEX8(0x00, stakeChip.marcState());
+
+  constexpr uint32_t kHourMs = 3600000;
+  uint32_t heard = 0;
+  uint32_t chipAsleepMs = 0;  // as the chip model saw it
+  for (;;)
+  {
+    scheduler.runDue();
+    while (listener.rx().peek())
+    {
+      ++heard;
+      listener.rx().release();
+    }
+    const uint32_t nowMs = air.nowMs();
+    if (nowMs >= kHourMs)
+    {
+      break;
+    }
+    uint32_t nextMs = kHourMs;
+    uint32_t at = 0;
+    if (scheduler.nextDeadline(at) && at < nextMs)
+    {
+      nextMs = at;
+    }
+    if (air.nextEventMs(at) && at < nextMs)
+    {
+      nextMs = at;
+    }
+    const uint32_t stepMs = nextMs > nowMs ? nextMs - nowMs : 1;
+    chipAsleepMs += stakeChip.marcState() == 0x00 ? stepMs : 0;
+    air.advance(stepMs);
+  }
+  const PowerReport power = stake.power(air.nowMs());
+
+  const uint32_t expectBursts = (kHourMs - schedule.firstDelayMs()) / 1000 + 1;
+  TEST_ASSERT_UINT32_WITHIN(1, expectBursts, stake.bursts());
+  TEST_ASSERT_EQUAL_UINT32(2 * stake.bursts(), stake.sent());
+  TEST_ASSERT_EQUAL_UINT32(0, stake.deferred());
+  TEST_ASSERT_EQUAL_UINT32(0, stake.skipped());
+  TEST_ASSERT_EQUAL_UINT32(stake.sent(), heard);
+  TEST_ASSERT_EQUAL_UINT32(stake.bursts(), stakeChip.wakeups());
+  TEST_ASSERT_EQUAL_UINT32(stake.bursts(), stakeRadio.wakeups());
+  TEST_ASSERT_EQUAL_HEX8(0xC0, stakeChip.paTable());  // restored after SLEEP
+  TEST_ASSERT_EQUAL_UINT32(chipAsleepMs, power.radioMs[static_cast<uint8_t>(RadioState::Sleep)]);
+
+  // Accounting: TX is exactly the copies' airtime, the radio is awake for
+  // little more than one burst per second, and the board draws a small
+  // fraction of what an always-listening emitter would.
+  TEST_ASSERT_EQUAL_UINT32(stake.sent() * stake.packetAirMs(), power.radioMs[static_cast<uint8_t>(RadioState::Tx)]);
+  TEST_ASSERT_EQUAL_UINT32(kHourMs, power.elapsedMs);
+  TEST_ASSERT_UINT32_WITHIN(2 * stake.packetAirMs(), 2 * 3600 * stake.packetAirMs(), power.airtimeMsPerHour());
+  TEST_ASSERT_TRUE(power.dutyCyclePpm() < 30000);  // < 3 %
+  TEST_ASSERT_EQUAL_UINT32(stake.bursts(), power.radioWakes);
+  TEST_ASSERT_TRUE(power.mcuWakes >= 3 * stake.bursts());
+  // The RTC alarm ends STOP to the millisecond, so only a few ms around
+  // each burst are WFI.
+  TEST_ASSERT_TRUE(power.mcuSleepMs > 0 && power.mcuSleepMs < kHourMs / 50);
+  const uint32_t listeningUa = asap::power::PowerProfile{}.mcuRunUa + asap::power::PowerProfile{}.radioUa[2];
+  TEST_ASSERT_TRUE(power.averageUa() > 0 && power.averageUa() * 20 < listeningUa);
+  asap::power::PowerAccount waits;
+  waits.begin(0, RadioState::Sleep);
+  waits.mcuWait(ASAP_POWER_STOP_MIN_MS - 1);  // all WFI
+  waits.mcuWait(930);                          // STOP, then the lead and one RTC count
+  waits.mcuWait(930, /*stopAllowed=*/false);
+  TEST_ASSERT_EQUAL_UINT32(ASAP_POWER_STOP_MIN_MS - 1 + asap::power::kStopLeadMs + 1 + 930,
+                           waits.report(10000).mcuSleepMs);
+
+  // Every beacon of a world as a stake: detectors still hear them, and the
+  // report carries their power figures.
+  using namespace asap::sim;
+  WorldConfig world;
+  world.seed = 9;
+  world.beacons = 6;
+  world.anomalies = 1;
+  world.artifacts = 1;
+  world.detectors = 2;
+  world.areaM = 40.0f;
+  world.durationMs = 120000;
+  world.hudSampleMs = 0;
+  world.dutyCycledBeacons = true;
+  const std::vector<WorldReport> reports = WorldRunner(2).run({world, world});
+  TEST_ASSERT_EQUAL_UINT16(6, reports[0].dutyBeacons);
+  TEST_ASSERT_EQUAL_UINT32(reports[0].beaconAverageUa, reports[1].beaconAverageUa);
+  TEST_ASSERT_EQUAL_UINT64(reports[0].decoded, reports[1].decoded);
+  TEST_ASSERT_TRUE(reports[0].deliveryRatio() > 0.9);
+  TEST_ASSERT_TRUE(reports[0].beaconDutyPpm > 0 && reports[0].beaconDutyPpm < 30000);
+
+  char msg[128];
+  std::snprintf(msg, sizeof(msg), "stake: duty %.3f %%, airtime %lu ms/h, %.3f mAh/h (%lu h on 1000 mAh)",
+                power.dutyCyclePpm() / 10000.0, static_cast<unsigned long>(power.airtimeMsPerHour()),
+                power.averageUa() / 1000.0, static_cast<unsigned long>(power.batteryHours(1000)));
+  TEST_MESSAGE(msg);
+}
+#endif  // ARDUINO
+
+#ifndef ARDUINO
+// Tracking HUD on a detector: beacon IDs are 16-bit (folded from the MCU
+// UID), so the auto pick, a manual selection and the frame text must all
+// carry IDs above 255; a tracked beacon that ages out leaves the HUD.
+void test_detector_tracking_hud_wide_ids(void)
+{
+  using asap::radio::kMaxPayload;
+  asap::radio::VirtualMedium air;
+  asap::radio::VirtualCc1101 detectorChip(air), nearChip(air), farChip(air);
+  asap::radio::Cc1101 radio(detectorChip.port()), nearRadio(nearChip.port()), farRadio(farChip.port());
+  TEST_ASSERT_TRUE(radio.begin() && nearRadio.begin() && farRadio.begin());
+  nearChip.attach(nearRadio);
+  farChip.attach(farRadio);
+  air.setLinkRssi(detectorChip, nearChip, -55);
+  air.setLinkRssi(detectorChip, farChip, -70);
+
+  DetectorDisplay display(kDummyPins);
+  TEST_ASSERT_TRUE(display.begin());
+  asap::roles::DetectorRole detector(display, radio);
+  detectorChip.attach(radio, &asap::roles::DetectorRole::onRadioIrq, &detector);
+  asap::core::Scheduler scheduler(asap::core::SchedulerClock{&MediumNow, &MediumSleep, &air});
+  detector.begin(scheduler);
+
+  constexpr uint16_t kNearId = 0x1234;
+  constexpr uint16_t kFarId = 300;
+  uint8_t seq = 0;
+  // One beacon from each emitter a second, then the detector runs until the
+  // next second.
+  auto second = [&](bool nearOn, bool farOn) {
+    uint8_t payload[kMaxPayload];
+    if (nearOn)
+    {
+      TEST_ASSERT_TRUE(nearRadio.send(payload, asap::roles::encodeBeacon(kNearId, seq, 10, 1000, payload)));
+    }
+    air.advance(20);
+    if (farOn)
+    {
+      TEST_ASSERT_TRUE(farRadio.send(payload, asap::roles::encodeBeacon(kFarId, seq, 10, 1000, payload)));
+    }
+    ++seq;
+    const uint32_t endMs = air.nowMs() + 980;
+    for (;;)
+    {
+      scheduler.runDue();
+      const uint32_t nowMs = air.nowMs();
+      if (nowMs >= endMs)
+      {
+        break;
+      }
+      uint32_t nextMs = endMs;
+      uint32_t at = 0;
+      if (scheduler.nextDeadline(at) && at < nextMs)
+      {
+        nextMs = at;
+      }
+      if (air.nextEventMs(at) && at < nextMs)
+      {
+        nextMs = at;
+      }
+      air.advance(nextMs > nowMs ? nextMs - nowMs : 1);
+    }
+  };
+
+  // Auto mode: the stronger beacon, with its full ID.
+  for (int s = 0; s < 3; ++s)
+  {
+    second(true, true);
+  }
+  asap::ui::UIController& ui = detector.ui();
+  TEST_ASSERT_EQUAL_UINT32(6, detector.rxCounts().beacons);
+  TEST_ASSERT_EQUAL_UINT16(0, ui.trackingId());
+  TEST_ASSERT_EQUAL_UINT16(kNearId, ui.trackedId());
+  TEST_ASSERT_EQUAL_INT16(-55, ui.trackingRssi());
+
+  // Manual selection reaches an ID above 255.
+  ui.setTrackingId(kFarId);
+  second(true, true);
+  TEST_ASSERT_EQUAL_UINT16(kFarId, ui.trackedId());
+  TEST_ASSERT_EQUAL_INT16(-70, ui.trackingRssi());
+
+  // Frame text: up to five digits, the menu still pads to three.
+  TEST_ASSERT_EQUAL_STRING("TRACK 4660", asap::display::makeTrackingMainFrame(kNearId, -55).lines[0].text);
+  TEST_ASSERT_EQUAL_STRING("ID 300", asap::display::makeMenuTrackingFrame(kFarId).lines[1].text);
+  TEST_ASSERT_EQUAL_STRING("ID 65535", asap::display::makeMenuTrackingFrame(0xFFFF).lines[1].text);
+  TEST_ASSERT_EQUAL_STRING("ID 007", asap::display::makeMenuTrackingFrame(7).lines[1].text);
+
+  // The selected beacon goes quiet: once its entry ages out the HUD shows
+  // the selection with no reading.
+  const uint32_t quietMs = asap::track::TrackingTableBase::kDefaultAgeOutMs + 2 * asap::roles::DetectorRole::kExpireEveryMs;
+  for (uint32_t s = 0; s < quietMs / 1000; ++s)
+  {
+    second(true, false);
+  }
+  TEST_ASSERT_NULL(detector.tracks().find(kFarId));
+  TEST_ASSERT_EQUAL_UINT16(kFarId, ui.trackedId());
+  TEST_ASSERT_EQUAL_INT16(-100, ui.trackingRssi());
+
+  // Auto mode follows the remaining beacon, then nothing once it is gone too.
+  ui.setTrackingId(0);
+  second(true, false);
+  TEST_ASSERT_EQUAL_UINT16(kNearId, ui.trackedId());
+  for (uint32_t s = 0; s < quietMs / 1000; ++s)
+  {
+    second(false, false);
+  }
+  TEST_ASSERT_EQUAL_UINT16(0, detector.tracks().size());
+  TEST_ASSERT_EQUAL_UINT16(0, ui.trackedId());
+  TEST_ASSERT_EQUAL_INT16(-100, ui.trackingRssi());
+}
+#endif  // ARDUINO
+
+#ifndef ARDUINO
+// Emission engine: one seed replays one pattern, the burst timeline of a
+// fixed envelope is frame-exact, passes restart on quiet frames, the frames
+// feed the exposure model to the expected dose, and the per-packet cost is a
+// table read.
+void test_emission_engine_replay(void)
+{
+  using namespace asap::game;
+
+  // Fixed envelope (no random draws): a burst every 19 frames from frame 10.
+  EmissionConfig fixed;
+  fixed.frameMs = 500;
+  BurstEnvelope& rad = fixed.channels[kRad];
+  rad.floor = 10;
+  rad.peakMin = 110;
+  rad.peakMax = 110;
+  rad.attackMs = 1500;
+  rad.holdMs = 1000;
+  rad.decayMs = 2000;
+  rad.gapMinMs = 5000;
+  rad.gapMaxMs = 5000;
+  EmissionEngine engine(fixed);
+  const uint8_t burst[9] = {43, 76, 110, 110, 110, 85, 60, 35, 10};
+  uint16_t bursts = 0;
+  for (uint16_t k = 0; k < EmissionEngine::kFrames; ++k)
+  {
+    const EmissionFrame& f = engine.frame(k);
+    const bool inBurst = k >= 10 && (k - 10) % 19 < 9 && k <= 485 + 8;
+    TEST_ASSERT_EQUAL(inBurst, f.bursting(kRad));
+    TEST_ASSERT_EQUAL(inBurst && (k - 10) % 19 == 0, f.starts(kRad));
+    TEST_ASSERT_EQUAL_UINT8(inBurst ? burst[(k - 10) % 19] : 10, f.intensity[kRad]);
+    TEST_ASSERT_EQUAL_UINT8(0, f.intensity[kTherm] | f.intensity[kChem] | f.intensity[kPsy]);
+    bursts += f.starts(kRad);
+  }
+  TEST_ASSERT_EQUAL_UINT16(26, bursts);  // the 27th would straddle the end
+  TEST_ASSERT_EQUAL_UINT16(26, engine.burstsInTable(kRad));
+  TEST_ASSERT_FALSE(engine.frame(EmissionEngine::kFrames - 1).bursting(kRad));
+
+  // Each pass covers the table once, from a quiet frame.
+  for (uint32_t pass = 1; pass <= 20; ++pass)
+  {
+    for (uint16_t k = 0; k < EmissionEngine::kFrames; ++k)
+    {
+      engine.next();
+    }
+    TEST_ASSERT_EQUAL_UINT32(pass, engine.passes());
+    TEST_ASSERT_EQUAL_UINT8(0, engine.frame(engine.position()).flags & 0x0F);
+    TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(26 * pass), engine.burstSeq());
+  }
+
+  // A silent channel config is a constant floor.
+  EmissionConfig steady;
+  steady.channels[kChem].floor = 30;
+  EmissionEngine flat(steady);
+  for (uint16_t k = 0; k < 2000; ++k)
+  {
+    const EmissionFrame& f = flat.next();
+    TEST_ASSERT_EQUAL_UINT8(0, f.flags);
+    TEST_ASSERT_EQUAL_UINT8(30, f.intensity[kChem]);
+    TEST_ASSERT_EQUAL_UINT8(0, f.intensity[kRad]);
+  }
+  TEST_ASSERT_EQUAL_UINT8(0, flat.burstSeq());
+
+  // Replay: the same seed sends the same packets, another seed does not.
+  EmissionConfig zone;
+  zone.seed = 1234;
+  zone.channels[kRad].floor = 20;
+  zone.channels[kRad].peakMin = 60;
+  zone.channels[kRad].peakMax = 200;
+  zone.channels[kPsy].peakMin = 100;
+  zone.channels[kPsy].peakMax = 255;
+  zone.channels[kPsy].attackMs = 500;
+  zone.channels[kPsy].gapMaxMs = 20000;
+  EmissionEngine a(zone);
+  EmissionEngine b(zone);
+  zone.seed = 1235;
+  EmissionEngine other(zone);
+  bool differs = false;
+  uint32_t psyBursts = 0;
+  for (uint32_t k = 0; k < 5000; ++k)
+  {
+    const EmissionFrame& fa = a.next();
+    const EmissionFrame& fb = b.next();
+    const EmissionFrame& fo = other.next();
+    TEST_ASSERT_EQUAL_MEMORY(&fa, &fb, sizeof(EmissionFrame));
+    TEST_ASSERT_EQUAL_UINT8(a.burstSeq(), b.burstSeq());
+    differs |= std::memcmp(&fa, &fo, sizeof(EmissionFrame)) != 0;
+    psyBursts += fa.starts(kPsy);
+    TEST_ASSERT_TRUE(fa.intensity[kRad] >= 20 && fa.intensity[kRad] <= 200);
+    TEST_ASSERT_TRUE(fa.bursting(kPsy) || fa.intensity[kPsy] == 0);
+  }
+  TEST_ASSERT_TRUE(differs);
+  TEST_ASSERT_TRUE(psyBursts > 0);
+  TEST_ASSERT_EQUAL_UINT32(a.passes(), b.passes());
+  TEST_ASSERT_EQUAL_UINT16(a.position(), b.position());
+
+  // Into the detector's model: point blank, each frame's level held until the
+  // next packet, so the dose is the sum of the levels, exactly.
+  ExposureConfig exposure;
+  for (ChannelConfig& channel : exposure.channels)
+  {
+    channel.ringMs = 600000;
+    channel.decayHalfLifeMs = 0;
+  }
+  ExposureEngine detector(exposure);
+  EmissionEngine replay(fixed);
+  uint64_t levelSum = 0;
+  for (uint16_t k = 0; k < EmissionEngine::kFrames; ++k)
+  {
+    const EmissionFrame& f = replay.next();
+    levelSum += f.intensity[kRad];
+    detector.onAnomaly(f.intensity, exposure.rssiFullDbm, k * 500u, 7);
+    TEST_ASSERT_EQUAL_UINT8(f.intensity[kRad], detector.field(kRad));  // follows its own decay
+  }
+  uint32_t nextMs = 0;
+  detector.tick(EmissionEngine::kFrames * 500u, nextMs);
+  TEST_ASSERT_EQUAL_UINT32(levelSum * 500 * ExposureEngine::kRing / (255ULL * 600000), detector.dose(kRad));
+
+  // Another emitter's weaker field does not pull the burst down.
+  const uint8_t strong[4] = {200, 0, 0, 0};
+  const uint8_t faint[4] = {40, 0, 0, 0};
+  const uint8_t off[4] = {0, 0, 0, 0};
+  ExposureEngine two(exposure);
+  two.onAnomaly(strong, exposure.rssiFullDbm, 0, 1);
+  two.onAnomaly(faint, exposure.rssiFullDbm, 100, 2);
+  TEST_ASSERT_EQUAL_UINT8(200, two.field(kRad));
+  two.onAnomaly(faint, exposure.rssiFullDbm, 200, 1);
+  TEST_ASSERT_EQUAL_UINT8(40, two.field(kRad));
+  two.onAnomaly(off, exposure.rssiFullDbm, 300, 1);
+  TEST_ASSERT_EQUAL_UINT8(0, two.field(kRad));
+
+  // Cost: building the table once, and next() per packet.
+  using Clock = std::chrono::steady_clock;
+  constexpr int kBuilds = 200;
+  constexpr uint32_t kPackets = 2000000;
+  uint32_t sink = 0;
+  const auto t0 = Clock::now();
+  for (int i = 0; i < kBuilds; ++i)
+  {
+    zone.seed = 1000u + static_cast<uint32_t>(i);
+    EmissionEngine built(zone);
+    sink += built.frame(static_cast<uint16_t>(i)).intensity[kRad];
+  }
+  const auto t1 = Clock::now();
+  for (uint32_t k = 0; k < kPackets; ++k)
+  {
+    sink += a.next().intensity[k & 3] + a.burstSeq();
+  }
+  const auto t2 = Clock::now();
+  const double buildUs = std::chrono::duration<double, std::micro>(t1 - t0).count() / kBuilds;
+  const double nextNs = std::chrono::duration<double, std::nano>(t2 - t1).count() / kPackets;
+  TEST_ASSERT_TRUE(sink != 0);  // timings are reported, not gated: hosts vary
+  char msg[128];
+  std::snprintf(msg, sizeof(msg), "emission: build %.1f us (%u frames), next() %.2f ns/packet, %lu psy bursts",
+                buildUs, static_cast<unsigned>(EmissionEngine::kFrames), nextNs,
+                static_cast<unsigned long>(psyBursts));
+  TEST_MESSAGE(msg);
+}
+#endif  // ARDUINO
+
+#ifndef ARDUINO
+namespace
+{
+
+struct HiddenHour
+{
+  asap::power::PowerReport power;
+  uint32_t cycles = 0;
+  uint32_t sent = 0;
+  uint32_t skipped = 0;
+  uint32_t packetAirMs = 0;
+  uint32_t heard = 0;
+  uint32_t mismatches = 0;
+  uint32_t recognizedAtMs = 0;
+  bool recognized = false;
+};
+
+// A hidden artifact and a listener's correlator on the virtual medium for
+// durationMs. Every deadline is met late: by up to 999 ms (the STOP alarm
+// step) where ArtifactEngine::betweenCycles() allows STOP, or everywhere if
+// stopInCycle, and by up to a SysTick otherwise. Receptions are stamped
+// with +-3 ms of jitter.
+HiddenHour RunHiddenArtifact(const asap::roles::ArtifactConfig& config, uint32_t durationMs, bool stopInCycle)
+{
+  asap::radio::VirtualMedium air;
+  asap::radio::VirtualCc1101 artifactChip(air), listenerChip(air);
+  asap::radio::Cc1101 artifactRadio(artifactChip.port()), listener(listenerChip.port());
+  TEST_ASSERT_TRUE(artifactRadio.begin());
+  TEST_ASSERT_TRUE(listener.begin());
+  artifactChip.attach(artifactRadio);
+  listenerChip.attach(listener);
+  asap::core::Scheduler scheduler(asap::core::SchedulerClock{&MediumNow, &MediumSleep, &air});
+  asap::roles::ArtifactEngine artifact(artifactRadio, config);
+  TEST_ASSERT_EQUAL_UINT32(config.hiddenPeriodMs, artifact.cycleMs());
+  artifact.begin(scheduler);
+  TEST_ASSERT_TRUE(artifactRadio.asleep());
+
+  asap::core::Xorshift32 rng(config.id);
+  asap::game::ArtifactCorrelator detector;
+  HiddenHour hour;
+  uint32_t deadlineMs = 0;
+  uint32_t lateMs = 0;
+  for (;;)
+  {
+    scheduler.runDue();
+    while (const asap::radio::RxSlot* packet = listener.rx().peek())
+    {
+      const asap::proto::ArtifactView v(packet->payload(), packet->length());
+      TEST_ASSERT_TRUE(v.valid());
+      ++hour.heard;
+      const uint32_t timeMs = packet->timeMs + rng.below(7) - 3;
+      const asap::game::ArtifactCorrelator::Ping ping =
+          detector.onPing(v.emitterId(), static_cast<uint16_t>(v.get<asap::proto::ArtifactMsg::Signature>()),
+                          static_cast<uint8_t>(v.get<asap::proto::ArtifactMsg::PingIndex>()), timeMs);
+      TEST_ASSERT_TRUE(ping != asap::game::ArtifactCorrelator::Ping::Ignored);
+      hour.mismatches += ping == asap::game::ArtifactCorrelator::Ping::Mismatch;
+      hour.recognizedAtMs = ping == asap::game::ArtifactCorrelator::Ping::Recognized ? timeMs : hour.recognizedAtMs;
+      listener.rx().release();
+    }
+    const uint32_t nowMs = air.nowMs();
+    if (nowMs >= durationMs)
+    {
+      break;
+    }
+    uint32_t nextMs = durationMs;
+    uint32_t at = 0;
+    if (scheduler.nextDeadline(at))
+    {
+      if (at != deadlineMs)
+      {
+        deadlineMs = at;
+        lateMs = stopInCycle || artifact.betweenCycles() ? rng.below(1000) : rng.below(2);
+      }
+      nextMs = at + lateMs < nextMs ? at + lateMs : nextMs;
+    }
+    if (air.nextEventMs(at) && at < nextMs)
+    {
+      nextMs = at;
+    }
+    air.advance(nextMs > nowMs ? nextMs - nowMs : 1);
+  }
+  hour.power = artifact.power(air.nowMs());
+  hour.cycles = artifact.cycles();
+  hour.sent = artifact.sent();
+  hour.skipped = artifact.skipped();
+  hour.packetAirMs = artifact.packetAirMs();
+  hour.recognized = detector.recognized(config.id);
+  return hour;
+}
+
+}  // namespace
+
+// Artifact fingerprints: the gaps are a function of ID and signature, the
+// correlator recognizes an artifact from a few lossy, jittered pings and
+// not a fixed-period or random-timed decoy, a hidden artifact pings on its
+// fingerprint for an hour at a fraction of a stake's current, and the world
+// simulator reports false negatives and positives over every detector.
+void test_artifact_fingerprint_correlator(void)
+{
+  using asap::game::ArtifactCorrelator;
+  using asap::game::CorrelatorConfig;
+  using asap::game::Fingerprint;
+  using Ping = ArtifactCorrelator::Ping;
+
+  const Fingerprint f = Fingerprint::of(42, 0xA001);
+  const Fingerprint same = Fingerprint::of(42, 0xA001);
+  bool differs = false;
+  for (uint16_t id = 43; id < 53; ++id)
+  {
+    const Fingerprint other = Fingerprint::of(id, 0xA001);
+    for (uint8_t i = 0; i + 1 < Fingerprint::kPings; ++i)
+    {
+      differs |= other.gapMs[i] != f.gapMs[i];
+    }
+  }
+  TEST_ASSERT_TRUE(differs);
+  for (uint8_t i = 0; i + 1 < Fingerprint::kPings; ++i)
+  {
+    TEST_ASSERT_EQUAL_UINT16(f.gapMs[i], same.gapMs[i]);
+    TEST_ASSERT_TRUE(f.gapMs[i] >= Fingerprint::kGapBaseMs && f.gapMs[i] <= Fingerprint::kMaxGapMs);
+    TEST_ASSERT_EQUAL_UINT16(0, (f.gapMs[i] - Fingerprint::kGapBaseMs) % Fingerprint::kGapStepMs);
+  }
+  TEST_ASSERT_EQUAL_UINT32(f.gapMs[0] + f.gapMs[1], f.offsetMs(2));
+
+  // One clean cycle, a few ms late each time: recognized on its last gap.
+  ArtifactCorrelator c;
+  uint32_t t = 1000;
+  TEST_ASSERT_EQUAL(Ping::First, c.onPing(42, 0xA001, 0, t));
+  TEST_ASSERT_EQUAL(Ping::Match, c.onPing(42, 0xA001, 1, t += f.gapMs[0] + 3));
+  TEST_ASSERT_EQUAL(Ping::Match, c.onPing(42, 0xA001, 2, t += f.gapMs[1] - 5));
+  TEST_ASSERT_EQUAL(Ping::Recognized, c.onPing(42, 0xA001, 3, t += f.gapMs[2]));
+  TEST_ASSERT_TRUE(c.recognized(42));
+  // Next cycle after a rest, and a lost ping spanning two gaps.
+  TEST_ASSERT_EQUAL(Ping::NewCycle, c.onPing(42, 0xA001, 0, t += 5000));
+  TEST_ASSERT_EQUAL(Ping::Match, c.onPing(42, 0xA001, 2, t += f.offsetMs(2) + 2));
+  TEST_ASSERT_EQUAL(Ping::Mismatch, c.onPing(42, 0xA001, 3, t += f.gapMs[2] + 60));
+  TEST_ASSERT_TRUE(c.recognized(42));  // latched
+  TEST_ASSERT_EQUAL_UINT8(0, c.find(42)->score);
+  // A new signature is a new artifact; silence forgets it.
+  TEST_ASSERT_EQUAL(Ping::First, c.onPing(42, 0xA002, 0, t += 5000));
+  TEST_ASSERT_FALSE(c.recognized(42));
+  TEST_ASSERT_EQUAL(Ping::Ignored, c.onPing(42, 0xA002, Fingerprint::kPings, t));
+  TEST_ASSERT_EQUAL_UINT8(0, c.expire(t + CorrelatorConfig{}.forgetMs - 1));
+  TEST_ASSERT_EQUAL_UINT8(1, c.expire(t + CorrelatorConfig{}.forgetMs));
+  TEST_ASSERT_NULL(c.find(42));
+
+  // Slots: a recognized artifact survives a crowd of unrecognized ones.
+  ArtifactCorrelator full;
+  t = 0;
+  full.onPing(7, 1, 0, t);
+  const Fingerprint f7 = Fingerprint::of(7, 1);
+  for (uint8_t i = 1; i < Fingerprint::kPings; ++i)
+  {
+    full.onPing(7, 1, i, t += f7.gapMs[i - 1]);
+  }
+  TEST_ASSERT_TRUE(full.recognized(7));
+  for (uint16_t id = 100; id < 100 + 3 * ArtifactCorrelator::kSlots; ++id)
+  {
+    TEST_ASSERT_TRUE(full.onPing(id, 1, 0, t += 10) != Ping::Ignored);
+  }
+  TEST_ASSERT_TRUE(full.recognized(7));
+  TEST_ASSERT_EQUAL_UINT8(1, full.recognizedCount());
+
+  // Heard again after forgetMs without expire() in between: a new sighting
+  // that has to be recognized afresh, and forgotten slots are free to claim
+  // even when recognized.
+  const uint32_t forgetMs = CorrelatorConfig{}.forgetMs;
+  TEST_ASSERT_EQUAL(Ping::First, full.onPing(7, 1, 0, t += forgetMs));
+  TEST_ASSERT_FALSE(full.recognized(7));
+  TEST_ASSERT_EQUAL_UINT32(t, full.find(7)->firstMs);
+  TEST_ASSERT_EQUAL(Ping::Match, full.onPing(7, 1, 1, t += f7.gapMs[0]));
+  full.onPing(7, 1, 2, t += f7.gapMs[1]);
+  TEST_ASSERT_EQUAL(Ping::Recognized, full.onPing(7, 1, 3, t += f7.gapMs[2]));
+  TEST_ASSERT_EQUAL(Ping::First, full.onPing(500, 1, 0, t += forgetMs));
+  TEST_ASSERT_NOT_NULL(full.find(500));
+  TEST_ASSERT_EQUAL_UINT8(ArtifactCorrelator::kSlots - 1, full.expire(t));
+
+  // Noisy receptions: +-4 ms of timestamp jitter and 30 % of pings lost,
+  // for artifacts pinging five cycles; decoys ping the same packets at
+  // random gaps, or at a fixed period like ArtifactRole.
+  asap::core::Xorshift32 rng(2024);
+  constexpr uint16_t kTrials = 2000;
+  uint32_t missed = 0;
+  uint32_t decoyHits = 0;
+  uint32_t decoyPings = 0;
+  uint32_t pingsToRecognize = 0;
+  for (uint16_t trial = 0; trial < kTrials; ++trial)
+  {
+    const uint16_t id = static_cast<uint16_t>(1 + trial);
+    const uint16_t signature = static_cast<uint16_t>(rng.next());
+    const Fingerprint fp = Fingerprint::of(id, signature);
+    ArtifactCorrelator real;
+    uint32_t start = rng.below(60000);
+    uint32_t heard = 0;
+    for (uint8_t cycle = 0; cycle < 5 && !real.recognized(id); ++cycle, start += 5000 + rng.below(1250))
+    {
+      for (uint8_t i = 0; i < Fingerprint::kPings && !real.recognized(id); ++i)
+      {
+        if (rng.below(10) < 3)
+        {
+          continue;
+        }
+        ++heard;
+        real.onPing(id, signature, i, start + fp.offsetMs(i) + rng.below(9) - 4);
+      }
+    }
+    missed += !real.recognized(id);
+    pingsToRecognize += real.recognized(id) ? heard : 0;
+
+    ArtifactCorrelator decoy;
+    uint32_t at = rng.below(60000);
+    const bool fixed = trial & 1;
+    for (uint8_t k = 0; k < 5 * Fingerprint::kPings; ++k, ++decoyPings)
+    {
+      at += fixed ? 5000 : 100 + rng.below(2 * Fingerprint::kMaxGapMs);
+      decoy.onPing(id, signature, fixed ? k % Fingerprint::kPings : rng.below(Fingerprint::kPings), at);
+    }
+    decoyHits += decoy.recognized(id);
+  }
+  const double falseNegative = static_cast<double>(missed) / kTrials;
+  const double falsePositive = static_cast<double>(decoyHits) / kTrials;
+  TEST_ASSERT_TRUE(falseNegative < 0.02);
+  TEST_ASSERT_TRUE(falsePositive < 0.01);
+
+  // An hour of a hidden artifact next to a detector's correlator, with the
+  // detector's jitter on every reception and its MCU late to every deadline:
+  // by up to a SysTick inside a cycle, up to a STOP alarm step between cycles.
+  asap::roles::ArtifactConfig config{42, 0xA001};
+  config.hidden = true;
+  constexpr uint32_t kHourMs = 3600000;
+  const HiddenHour hour = RunHiddenArtifact(config, kHourMs, false);
+  TEST_ASSERT_UINT32_WITHIN(6, kHourMs / config.hiddenPeriodMs, hour.cycles);
+  TEST_ASSERT_UINT32_WITHIN(Fingerprint::kPings, Fingerprint::kPings * hour.cycles, hour.sent);
+  TEST_ASSERT_EQUAL_UINT32(0, hour.skipped);
+  TEST_ASSERT_EQUAL_UINT32(hour.sent, hour.heard);
+  TEST_ASSERT_EQUAL_UINT32(0, hour.mismatches);
+  TEST_ASSERT_TRUE(hour.recognized);
+  TEST_ASSERT_TRUE(hour.recognizedAtMs > 0 && hour.recognizedAtMs < 2 * config.hiddenPeriodMs + Fingerprint::kMaxSpanMs);
+  TEST_ASSERT_EQUAL_UINT32(hour.sent * hour.packetAirMs, hour.power.radioMs[static_cast<uint8_t>(asap::power::RadioState::Tx)]);
+  TEST_ASSERT_TRUE(hour.power.dutyCyclePpm() < 1000);  // < 0.1 %
+  // The same hour with STOP's alarm step inside the cycles too: the gaps
+  // drift by up to a second and the fingerprint no longer matches.
+  const HiddenHour stopped = RunHiddenArtifact(config, kHourMs, true);
+  TEST_ASSERT_TRUE(stopped.mismatches > stopped.heard / 4);
+  TEST_ASSERT_FALSE(stopped.recognized);
+
+  // Worlds: fingerprinted artifacts among decoys, normal and hidden.
+  using namespace asap::sim;
+  WorldConfig world;
+  world.seed = 17;
+  world.beacons = 4;
+  world.anomalies = 2;
+  world.artifacts = 4;
+  world.decoyArtifacts = 4;
+  world.detectors = 6;
+  world.areaM = 100.0f;
+  world.durationMs = 5UL * 60UL * 1000UL;
+  world.hudSampleMs = 0;
+  world.fingerprintedArtifacts = true;
+  WorldConfig hidden = world;
+  hidden.hiddenArtifacts = true;
+  hidden.durationMs = 10UL * 60UL * 1000UL;
+  const std::vector<WorldReport> reports = WorldRunner(3).run({world, world, hidden});
+  TEST_ASSERT_EQUAL_UINT16(4, reports[0].fingerprinted);
+  TEST_ASSERT_EQUAL_UINT32(reports[0].artifactsRecognized, reports[1].artifactsRecognized);
+  TEST_ASSERT_EQUAL_UINT64(reports[0].recognizeMsTotal, reports[1].recognizeMsTotal);
+  for (const WorldReport& r : reports)
+  {
+    TEST_ASSERT_TRUE(r.artifactPairs > 0 && r.decoyPairs > 0);
+    TEST_ASSERT_TRUE(r.falseNegativeRate() < 0.1);
+    TEST_ASSERT_EQUAL_UINT32(0, r.decoysRecognized);
+  }
+  TEST_ASSERT_TRUE(reports[2].artifactAverageUa < reports[0].artifactAverageUa);
+  TEST_ASSERT_TRUE(reports[2].meanRecognizeMs() > reports[0].meanRecognizeMs());
+
+  char msg[192];
+  std::snprintf(msg, sizeof(msg),
+                "artifact: %.2f%% missed (%.1f pings), %.2f%% decoys taken; hidden %.3f mAh/h, duty %.4f %%",
+                100.0 * falseNegative, kTrials > missed ? static_cast<double>(pingsToRecognize) / (kTrials - missed) : 0.0,
+                100.0 * falsePositive, hour.power.averageUa() / 1000.0, hour.power.dutyCyclePpm() / 10000.0);
+  TEST_MESSAGE(msg);
+}
+#endif  // ARDUINO
+
+#if !defined(ARDUINO) && ASAP_PROFILE
+// Render probes — histogram buckets stay within 25 % and the percentiles
+// within a bucket, saturation halves instead of stopping, and a UI session
+// fills the page, HUD, arc and flush probes (per thread) and dumps them.
+void test_render_profile_probes(void)
+{
+  using asap::profile::Histogram;
+  namespace profile = asap::profile;
+
+  uint8_t last = 0;
+  for (uint32_t v = 1; v < (1u << Histogram::kMaxBits); v += 1 + v / 97)
+  {
+    const uint8_t b = Histogram::bucketOf(v);
+    TEST_ASSERT_TRUE(b >= last && b < Histogram::kBuckets);
+    TEST_ASSERT_TRUE(Histogram::bucketFloor(b) <= v);
+    if (b + 1 < Histogram::kBuckets)
+    {
+      TEST_ASSERT_TRUE(v < Histogram::bucketFloor(static_cast<uint8_t>(b + 1)));
+    }
+    if (v >= 4)
+    {
+      TEST_ASSERT_TRUE(static_cast<uint64_t>(Histogram::bucketFloor(b)) * 5 / 4 >= v);
+    }
+    last = b;
+  }
+  TEST_ASSERT_EQUAL_UINT8(Histogram::kBuckets - 1, Histogram::bucketOf(UINT32_MAX));
+
+  // 98 % fast frames, 2 % slow ones: p50 sits on the fast bucket, p99 on
+  // the slow one, min/max/mean are exact.
+  Histogram h{};
+  for (uint32_t i = 0; i < 1000; ++i)
+  {
+    h.record(i % 50 == 0 ? 90000 : 1000);
+  }
+  TEST_ASSERT_EQUAL_UINT32(1000, h.count());
+  TEST_ASSERT_EQUAL_UINT32(1000, h.min());
+  TEST_ASSERT_EQUAL_UINT32(90000, h.max());
+  TEST_ASSERT_EQUAL_UINT32((980u * 1000u + 20u * 90000u) / 1000u, h.mean());
+  TEST_ASSERT_UINT32_WITHIN(250, 1000, h.percentile(50));
+  TEST_ASSERT_UINT32_WITHIN(22500, 90000, h.percentile(99));
+  TEST_ASSERT_TRUE(h.percentile(99) >= 90000 * 3 / 4);
+  TEST_ASSERT_EQUAL_UINT32(90000, h.percentile(100));
+  for (uint32_t i = 0; i < 200000; ++i)
+  {
+    h.record(1000);
+  }
+  TEST_ASSERT_EQUAL_UINT32(201000, h.count());
+  TEST_ASSERT_UINT32_WITHIN(250, 1000, h.percentile(99));
+
+  // A UI session: full HUD, incremental updates, menu pages.
+  using asap::input::JoyAction;
+  using asap::ui::State;
+  using asap::ui::UIController;
+  profile::reset();
+  DetectorDisplay display(kDummyPins);
+  TEST_ASSERT_TRUE(display.begin());
+  UIController ui(display);
+  uint32_t t = 0;
+  for (uint8_t i = 0; i < 20; ++i)
+  {
+    ui.setAnomalyExposure(static_cast<uint8_t>(i * 5), 30, static_cast<uint8_t>(100 - i * 5), 10);
+    ui.onTick(t += 100, {false, JoyAction::Neutral});
+  }
+  ui.onTick(t += 100, {true, JoyAction::Neutral});
+  ui.onTick(t += 1000, {true, JoyAction::Neutral});  // long-press: MenuRoot
+  ui.onTick(t += 100, {false, JoyAction::Neutral});
+  ui.onTick(t += 100, {false, JoyAction::Down});
+  TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(State::MenuRoot), static_cast<uint8_t>(ui.state()));
+
+  const Histogram& anomalyPage = profile::histogram(profile::kProbePage0 + static_cast<uint8_t>(State::MainAnomaly));
+  const Histogram& menuPage = profile::histogram(profile::kProbePage0 + static_cast<uint8_t>(State::MenuRoot));
+  const Histogram& arc = profile::histogram(profile::kProbeArc);
+  TEST_ASSERT_EQUAL_UINT32(20, anomalyPage.count());
+  TEST_ASSERT_EQUAL_UINT32(2, menuPage.count());
+  TEST_ASSERT_TRUE(arc.count() >= 4);
+  TEST_ASSERT_TRUE(profile::histogram(profile::kProbeSendBuffer).count() > 0);
+  TEST_ASSERT_TRUE(profile::histogram(profile::kProbeRenderFrame).count() > 0);
+  TEST_ASSERT_TRUE(profile::histogram(profile::kProbeAnomalyIndicators).count() +
+                       profile::histogram(profile::kProbeAnomalyUpdate).count() >
+                   0);
+  TEST_ASSERT_TRUE(anomalyPage.min() <= anomalyPage.percentile(50));
+  TEST_ASSERT_TRUE(anomalyPage.percentile(50) <= anomalyPage.percentile(99));
+  TEST_ASSERT_TRUE(anomalyPage.percentile(99) <= anomalyPage.max());
+  TEST_ASSERT_TRUE(anomalyPage.max() >= arc.max());  // probes nest
+
+  // Another thread profiles into its own table.
+  std::thread other([]() { profile::record(profile::kProbeArc, 5); });
+  other.join();
+  TEST_ASSERT_TRUE(profile::histogram(profile::kProbeArc).min() != 5);
+
+  std::string out;
+  profile::dump([](const char* line, void* context) {
+    *static_cast<std::string*>(context) += line;
+    *static_cast<std::string*>(context) += '\n';
+    TEST_MESSAGE(line);
+  }, &out);
+  TEST_ASSERT_TRUE(out.find("p99") != std::string::npos);
+  TEST_ASSERT_TRUE(out.find("arc") != std::string::npos);
+  TEST_ASSERT_TRUE(out.find("page 0") != std::string::npos);
+  TEST_ASSERT_TRUE(out.find("page 6") == std::string::npos);  // never rendered
+}
+#endif  // !ARDUINO && ASAP_PROFILE
+
 int main(int argc, char** argv)
 {
   (void)argc;
@@ -372,6 +3530,33 @@ int main(int argc, char** argv)
   RUN_TEST(test_snapshot_export_creates_pgm);
   RUN_TEST(test_anomaly_hud_stage_snapshots);
   RUN_TEST(test_ui_menu_navigation_snapshots);
+  RUN_TEST(test_dirty_tiles_menu_caret_move);
+  RUN_TEST(test_render_skip_unchanged_frames);
+  RUN_TEST(test_ui_invalidation_and_wakeup);
+  RUN_TEST(test_joystick_event_queue_drives_ui);
+  RUN_TEST(test_page_buffer_modes_match_full_buffer);
+  RUN_TEST(test_arc_table_matches_reference);
+  RUN_TEST(test_draw_cost_budgets);
+  RUN_TEST(test_incremental_anomaly_hud_matches_full_redraw);
+  RUN_TEST(test_async_flush_simulated_bus);
+  RUN_TEST(test_snapshot_bulk_export_matches_per_pixel);
+  RUN_TEST(test_snapshot_comparator_golden_flow);
+  RUN_TEST(test_parallel_snapshot_runner);
+  RUN_TEST(test_scheduler_edf_virtual_clock);
+  RUN_TEST(test_cc1101_virtual_medium_burst);
+  RUN_TEST(test_proto_schema_fuzz_and_decode_rate);
+  RUN_TEST(test_world_simulator_deterministic);
+  RUN_TEST(test_tdma_mac_slots_and_collisions);
+  RUN_TEST(test_tracking_table_256_emitters);
+  RUN_TEST(test_rssi_filter_bank_traces);
+  RUN_TEST(test_exposure_engine_deterministic);
+  RUN_TEST(test_beacon_duty_cycle_power);
+  RUN_TEST(test_detector_tracking_hud_wide_ids);
+  RUN_TEST(test_emission_engine_replay);
+  RUN_TEST(test_artifact_fingerprint_correlator);
+#endif
+#if !defined(ARDUINO) && ASAP_PROFILE
+  RUN_TEST(test_render_profile_probes);
 #endif
   // Joystick frame tests
   {
@@ -398,6 +3583,10 @@ int main(int argc, char** argv)
     DetectorDisplay d({0, 0, 0}); d.begin(); d.showJoystick(asap::input::JoyAction::Neutral);
     TEST_ASSERT_EQUAL_STRING("NEUTRAL", d.lastFrame().lines[0].text);
   }
+#ifndef ARDUINO
+  // Persist hashes accepted in update mode (ASAP_SNAPSHOT_UPDATE=1).
+  TEST_ASSERT_TRUE(Goldens().saveManifest());
+#endif
   return UNITY_END();
 }
 